@@ -0,0 +1,168 @@
+// Compares CommandFactory::createCommand with the std::regex parser it
+// used before, on a mix of commands against a small model.
+// Usage: bench_CommandParser [iterations]
+
+#include "../core/nlp/CommandFactory.h"
+#include "../core/nlp/Commands.h"
+#include "../core/model/MentalModel.h"
+#include <QCoreApplication>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <regex>
+
+using namespace qlink;
+
+namespace {
+
+std::string trim(const std::string& str) {
+    size_t first = str.find_first_not_of(" \t\n\r");
+    if (first == std::string::npos) return "";
+    size_t last = str.find_last_not_of(" \t\n\r");
+    return str.substr(first, last - first + 1);
+}
+
+std::string toLower(const std::string& str) {
+    std::string result = str;
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return result;
+}
+
+std::string findConceptIdByName(MentalModel* model, const std::string& name) {
+    std::string lowerName = toLower(name);
+    for (const auto& concept : model->getConcepts()) {
+        if (toLower(concept->getName()) == lowerName) {
+            return concept->getId();
+        }
+    }
+    return "";
+}
+
+// What CommandFactory::createCommand did before the grammar
+std::unique_ptr<ICommand> createWithRegex(const std::string& input, MentalModel* model) {
+    std::string trimmedInput = trim(input);
+    if (trimmedInput.empty()) return nullptr;
+
+    std::regex addConceptRegex(R"((add|create)\s+concept\s+[\"']?([^\"'\n]+?)[\"']?(?:\s+(?:with|having)\s+(?:description|desc)\s+[\"']?([^\"'\n]+?)[\"']?)?$)", std::regex::icase);
+    std::smatch match;
+    if (std::regex_search(trimmedInput, match, addConceptRegex)) {
+        std::string description = match[3].matched ? trim(match[3].str()) : "";
+        return std::make_unique<AddConceptCommand>(model, trim(match[2].str()), description);
+    }
+
+    std::regex removeConceptRegex(R"((remove|delete)\s+concept\s+[\"']?([^\"'\n]+?)[\"']?$)", std::regex::icase);
+    if (std::regex_search(trimmedInput, match, removeConceptRegex)) {
+        std::string conceptId = findConceptIdByName(model, trim(match[2].str()));
+        if (!conceptId.empty()) {
+            return std::make_unique<RemoveConceptCommand>(model, conceptId);
+        }
+    }
+
+    std::regex connectRegex(R"((connect|link|relate)\s+[\"']?([^\"'\n]+?)[\"']?\s+(?:to|with|and)\s+[\"']?([^\"'\n]+?)[\"']?(?:\s+(?:as|type|with type)\s+[\"']?([^\"'\n]+?)[\"']?)?(?:\s+(directed|undirected))?$)", std::regex::icase);
+    if (std::regex_search(trimmedInput, match, connectRegex)) {
+        std::string type = match[4].matched ? trim(match[4].str()) : "relates_to";
+        bool directed = match[5].matched && toLower(match[5].str()) == "directed";
+        std::string id1 = findConceptIdByName(model, trim(match[2].str()));
+        std::string id2 = findConceptIdByName(model, trim(match[3].str()));
+        if (!id1.empty() && !id2.empty()) {
+            return std::make_unique<CreateRelationshipCommand>(model, id1, id2, type, directed);
+        }
+    }
+
+    std::regex disconnectRegex(R"((disconnect|unlink|remove (?:link|relationship))\s+(?:between\s+)?[\"']?([^\"'\n]+?)[\"']?\s+(?:from|and)\s+[\"']?([^\"'\n]+?)[\"']?$)", std::regex::icase);
+    if (std::regex_search(trimmedInput, match, disconnectRegex)) {
+        std::string id1 = findConceptIdByName(model, trim(match[2].str()));
+        std::string id2 = findConceptIdByName(model, trim(match[3].str()));
+        if (!id1.empty() && !id2.empty()) {
+            for (const auto& rel : model->getRelationships()) {
+                if (rel->connects(id1, id2)) {
+                    return std::make_unique<DeleteRelationshipCommand>(model, rel->getId());
+                }
+            }
+        }
+    }
+
+    std::regex simpleAddRegex(R"(^add\s+[\"']?([^\"'\n]+?)[\"']?$)", std::regex::icase);
+    if (std::regex_search(trimmedInput, match, simpleAddRegex)) {
+        std::string conceptName = trim(match[1].str());
+        if (toLower(conceptName).find("relationship") == std::string::npos &&
+            toLower(conceptName).find("link") == std::string::npos) {
+            return std::make_unique<AddConceptCommand>(model, conceptName, "");
+        }
+    }
+    return nullptr;
+}
+
+template <typename F>
+double bestMillis(int runs, F&& body) {
+    double best = 1e300;
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    const int runs = 5;
+
+    MentalModel model("Benchmark");
+    const char* names[] = {"Machine Learning", "AI", "Statistics", "Neural Networks", "Data", "Python"};
+    for (const char* name : names) {
+        model.addConcept(std::make_unique<Concept>(name));
+    }
+    model.addRelationship(std::make_unique<Relationship>(model.getConcepts()[0]->getId(),
+                                                         model.getConcepts()[1]->getId(), "", false, 1.0));
+
+    const std::string inputs[] = {
+        "add concept Deep Learning",
+        "create concept \"Reinforcement Learning\" with description Learning from rewards",
+        "remove concept statistics",
+        "connect AI to Machine Learning as is_a directed",
+        "link Python and Data",
+        "relate Neural Networks with AI",
+        "disconnect Machine Learning from AI",
+        "remove link between AI and Machine Learning",
+        "add Transformers",
+        "this is not a command",
+    };
+
+    // Both parsers must agree on every input
+    for (const auto& input : inputs) {
+        auto grammar = CommandFactory::createCommand(input, &model);
+        auto regex = createWithRegex(input, &model);
+        if ((grammar == nullptr) != (regex == nullptr) ||
+            (grammar && grammar->getDescription() != regex->getDescription())) {
+            std::fprintf(stderr, "parsers disagree on: %s\n", input.c_str());
+            return 1;
+        }
+    }
+
+    size_t parsed = 0;
+    double regexMillis = bestMillis(runs, [&] {
+        for (size_t i = 0; i < iterations; ++i) {
+            for (const auto& input : inputs) parsed += createWithRegex(input, &model) != nullptr;
+        }
+    });
+    double grammarMillis = bestMillis(runs, [&] {
+        for (size_t i = 0; i < iterations; ++i) {
+            for (const auto& input : inputs) parsed += CommandFactory::createCommand(input, &model) != nullptr;
+        }
+    });
+
+    size_t commands = iterations * (sizeof(inputs) / sizeof(inputs[0]));
+    std::printf("commands=%zu parsed=%zu\n", commands, parsed / (2 * runs));
+    std::printf("%-8s %10s %14s\n", "", "ms", "ns/command");
+    std::printf("%-8s %10.1f %14.0f\n", "regex", regexMillis, regexMillis * 1e6 / commands);
+    std::printf("%-8s %10.1f %14.0f\n", "grammar", grammarMillis, grammarMillis * 1e6 / commands);
+    std::printf("speedup %.1fx\n", regexMillis / grammarMillis);
+    return 0;
+}
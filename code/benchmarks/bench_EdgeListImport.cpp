@@ -0,0 +1,81 @@
+// Measures how edge list import scales with worker threads.
+// Usage: bench_EdgeListImport [edgeCount] [maxThreads]
+// e.g. bench_EdgeListImport 10000000 8 for ten million edges on up to 8 cores
+
+#include "../core/persistence/GraphInterchange.h"
+#include "../core/model/MentalModel.h"
+#include <QCoreApplication>
+#include <QThreadPool>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+using namespace qlink;
+
+namespace {
+
+// About three edges per node, as in sparse real-world graphs
+std::string makeEdgeList(size_t edgeCount) {
+    std::mt19937 random(42);
+    size_t nodeCount = std::max<size_t>(edgeCount / 3, 1);
+    const char* types[] = {"causes", "requires", "part_of", "related_to"};
+    std::string csv = "source,target,type,weight\n";
+    csv.reserve(edgeCount * 40);
+    for (size_t i = 0; i < edgeCount; ++i) {
+        csv += "node";
+        csv += std::to_string(random() % nodeCount);
+        csv += ",node";
+        csv += std::to_string(random() % nodeCount);
+        csv += ',';
+        csv += types[i % 4];
+        csv += ",0.";
+        csv += std::to_string(random() % 100);
+        csv += '\n';
+    }
+    return csv;
+}
+
+template <typename F>
+double bestMillis(int runs, F&& body) {
+    double best = 1e300;
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    size_t edgeCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    int maxThreads = argc > 2 ? std::atoi(argv[2]) : 8;
+    const int runs = 3;
+
+    std::string csv = makeEdgeList(edgeCount);
+
+    ImportResult result;
+    double baseline = 0.0;
+    std::printf("file size: %.1f MB\n", csv.size() / (1024.0 * 1024.0));
+    std::printf("%8s %12s %10s %14s\n", "threads", "import (ms)", "speedup", "edges/s");
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        double millis = bestMillis(runs, [&] {
+            MentalModel model("Benchmark");
+            result = GraphImporter::importEdgeList(model, csv.data(), csv.size(), ',', &pool);
+        });
+        if (threads == 1) baseline = millis;
+        std::printf("%8d %12.1f %9.2fx %14.0f\n", threads, millis, baseline / millis,
+                    result.relationships / (millis / 1000.0));
+    }
+    std::printf("concepts=%zu relationships=%zu skipped=%zu\n", result.concepts, result.relationships,
+                result.skipped);
+    return 0;
+}
@@ -0,0 +1,181 @@
+// Compares MentalModel::toJson/fromJson with the QJsonDocument path
+// ModelManager used to take for the same text.
+// Usage: bench_JsonCodec [conceptCount]
+
+#include "../core/model/MentalModel.h"
+#include "../core/common/Timestamp.h"
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace qlink;
+
+namespace {
+
+std::unique_ptr<MentalModel> makeModel(size_t conceptCount) {
+    auto model = std::make_unique<MentalModel>("Benchmark");
+    std::mt19937 random(42);
+    std::string description = "A \"quoted\" description\nwith a second line and a path C:\\data";
+    for (size_t i = 0; i < conceptCount; ++i) {
+        auto concept = std::make_unique<Concept>("concept-" + std::to_string(i), "Concept " + std::to_string(i),
+                                                 description);
+        concept->addTag("tag" + std::to_string(i % 16));
+        concept->setPosition(Position(random() % 2000 / 3.0, random() % 2000 / 7.0));
+        model->addConcept(std::move(concept));
+    }
+    const char* types[] = {"causes", "requires", "part_of", "related_to"};
+    for (size_t i = 0; i < conceptCount; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            size_t other = random() % conceptCount;
+            model->addRelationship(std::make_unique<Relationship>(
+                "rel-" + std::to_string(i) + "-" + std::to_string(j), "concept-" + std::to_string(i),
+                "concept-" + std::to_string(other), types[(i + j) % 4], j == 0, 0.5 + j));
+        }
+    }
+    return model;
+}
+
+template <typename T>
+void writeTimes(QJsonObject& object, const T& entity) {
+    object["created"] = QString::fromStdString(formatTimestamp(entity.getCreated()));
+    object["modified"] = QString::fromStdString(formatTimestamp(entity.getModified()));
+}
+
+template <typename T>
+void readTimes(const QJsonObject& object, T& entity) {
+    Timestamp created;
+    Timestamp modified;
+    if (parseTimestamp(object["created"].toString().toStdString(), created) &&
+        parseTimestamp(object["modified"].toString().toStdString(), modified)) {
+        entity.setTimestamps(created, modified);
+    }
+}
+
+// What ModelManager::serializeConcept/serializeRelationship build
+QByteArray encodeWithQt(const MentalModel& model) {
+    QJsonObject root;
+    root["modelName"] = QString::fromStdString(model.getModelName());
+    QJsonArray concepts;
+    for (const auto& concept : model.getConcepts()) {
+        QJsonObject object;
+        object["id"] = QString::fromStdString(concept->getId());
+        object["name"] = QString::fromStdString(concept->getName());
+        object["description"] = QString::fromStdString(concept->getDescription());
+        QJsonObject position;
+        position["x"] = concept->getPosition().x;
+        position["y"] = concept->getPosition().y;
+        object["position"] = position;
+        QJsonArray tags;
+        for (const auto& tag : concept->getTags()) {
+            tags.append(QString::fromStdString(tag));
+        }
+        object["tags"] = tags;
+        writeTimes(object, *concept);
+        concepts.append(object);
+    }
+    root["concepts"] = concepts;
+    QJsonArray relationships;
+    for (const auto& relationship : model.getRelationships()) {
+        QJsonObject object;
+        object["id"] = QString::fromStdString(relationship->getId());
+        object["sourceConceptId"] = QString::fromStdString(relationship->getSourceConceptId());
+        object["targetConceptId"] = QString::fromStdString(relationship->getTargetConceptId());
+        object["type"] = QString::fromStdString(relationship->getType());
+        object["isDirected"] = relationship->getIsDirected();
+        object["weight"] = relationship->getWeight();
+        writeTimes(object, *relationship);
+        relationships.append(object);
+    }
+    root["relationships"] = relationships;
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+// What ModelManager::deserializeConcept/deserializeRelationship do
+std::unique_ptr<MentalModel> decodeWithQt(const QByteArray& json) {
+    QJsonObject root = QJsonDocument::fromJson(json).object();
+    auto model = std::make_unique<MentalModel>(root["modelName"].toString().toStdString());
+    std::vector<std::unique_ptr<Concept>> concepts;
+    for (const auto& value : root["concepts"].toArray()) {
+        QJsonObject object = value.toObject();
+        auto concept = std::make_unique<Concept>(object["id"].toString().toStdString(),
+                                                 object["name"].toString().toStdString(),
+                                                 object["description"].toString().toStdString());
+        for (const auto& tag : object["tags"].toArray()) {
+            concept->addTag(tag.toString().toStdString());
+        }
+        QJsonObject position = object["position"].toObject();
+        concept->setPosition(Position(position["x"].toDouble(), position["y"].toDouble()));
+        readTimes(object, *concept);
+        concepts.push_back(std::move(concept));
+    }
+    model->addConceptsBulk(std::move(concepts));
+    std::vector<std::unique_ptr<Relationship>> relationships;
+    for (const auto& value : root["relationships"].toArray()) {
+        QJsonObject object = value.toObject();
+        auto relationship = std::make_unique<Relationship>(
+            object["id"].toString().toStdString(), object["sourceConceptId"].toString().toStdString(),
+            object["targetConceptId"].toString().toStdString(), object["type"].toString().toStdString(),
+            object["isDirected"].toBool(), object["weight"].toDouble());
+        readTimes(object, *relationship);
+        relationships.push_back(std::move(relationship));
+    }
+    model->addRelationshipsBulk(std::move(relationships));
+    return model;
+}
+
+template <typename F>
+double bestMillis(int runs, F&& body) {
+    double best = 1e300;
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+void report(const char* label, double qtMillis, double nativeMillis, size_t bytes) {
+    double megabytes = bytes / (1024.0 * 1024.0);
+    std::printf("%-8s %10.1f %10.1f %12.1f %12.1f %8.2fx\n", label, qtMillis, nativeMillis,
+                megabytes / (qtMillis / 1000.0), megabytes / (nativeMillis / 1000.0), qtMillis / nativeMillis);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    size_t conceptCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const int runs = 5;
+
+    auto model = makeModel(conceptCount);
+    std::string native = model->toJson();
+    QByteArray qt = encodeWithQt(*model);
+
+    // Both codecs must read back the other's output unchanged
+    auto fromQt = MentalModel::fromJson(qt.toStdString());
+    auto fromNative = decodeWithQt(QByteArray::fromStdString(native));
+    if (!fromQt || fromQt->toJson() != native || fromNative->toJson() != native) {
+        std::fprintf(stderr, "round trip mismatch\n");
+        return 1;
+    }
+
+    double qtEncode = bestMillis(runs, [&] { qt = encodeWithQt(*model); });
+    double nativeEncode = bestMillis(runs, [&] { native = model->toJson(); });
+    size_t concepts = 0;
+    double qtDecode = bestMillis(runs, [&] { concepts = decodeWithQt(qt)->getConceptCount(); });
+    double nativeDecode = bestMillis(runs, [&] { concepts = MentalModel::fromJson(native)->getConceptCount(); });
+
+    std::printf("concepts=%zu document=%.1f MB\n", concepts, native.size() / (1024.0 * 1024.0));
+    std::printf("%-8s %10s %10s %12s %12s %9s\n", "", "Qt (ms)", "ours (ms)", "Qt (MB/s)", "ours (MB/s)",
+                "speedup");
+    report("encode", qtEncode, nativeEncode, native.size());
+    report("decode", qtDecode, nativeDecode, native.size());
+    return 0;
+}
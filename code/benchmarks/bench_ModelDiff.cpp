@@ -0,0 +1,100 @@
+// Times diff() and merge() on large models, with content hashes computed
+// on the first pass and cached after it, and applying the merge through
+// ApplyDiffCommand.
+// Usage: bench_ModelDiff [conceptCount] [editPercent]
+
+#include "../core/model/MentalModel.h"
+#include "../core/model/ModelDiff.h"
+#include "../core/nlp/Commands.h"
+#include <QCoreApplication>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace qlink;
+
+namespace {
+
+std::unique_ptr<MentalModel> makeModel(size_t conceptCount) {
+    auto model = std::make_unique<MentalModel>("Benchmark");
+    std::mt19937 random(42);
+    for (size_t i = 0; i < conceptCount; ++i) {
+        auto concept = std::make_unique<Concept>("concept-" + std::to_string(i), "Concept " + std::to_string(i),
+                                                 "A description of concept " + std::to_string(i));
+        concept->addTag("tag" + std::to_string(i % 16));
+        concept->setPosition(Position(random() % 2000 / 3.0, random() % 2000 / 7.0));
+        model->addConcept(std::move(concept));
+    }
+    for (size_t i = 0; i < conceptCount; ++i) {
+        model->addRelationship(std::make_unique<Relationship>(
+            "rel-" + std::to_string(i), "concept-" + std::to_string(i),
+            "concept-" + std::to_string(random() % conceptCount), "related_to", true, 1.0));
+    }
+    return model;
+}
+
+// Edit, remove and add about editPercent of the concepts and relationships
+void edit(MentalModel& model, size_t conceptCount, double editPercent, unsigned seed) {
+    std::mt19937 random(seed);
+    size_t edits = std::max<size_t>(1, static_cast<size_t>(conceptCount * editPercent / 100.0));
+    std::string suffix = "-" + std::to_string(seed);
+    for (size_t i = 0; i < edits; ++i) {
+        std::string id = std::to_string(random() % conceptCount);
+        if (Concept* concept = model.getConcept("concept-" + id)) {
+            concept->setDescription("Edited" + suffix);
+        }
+        if (Relationship* relationship = model.getRelationship("rel-" + id)) {
+            relationship->setWeight(0.5);
+        }
+        model.addConcept(std::make_unique<Concept>("added-" + std::to_string(i) + suffix, "Added", ""));
+    }
+    for (size_t i = 0; i < edits / 4; ++i) {
+        model.removeConcept("concept-" + std::to_string(random() % conceptCount));
+    }
+}
+
+template <typename F>
+double millis(F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    size_t conceptCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500000;
+    double editPercent = argc > 2 ? std::strtod(argv[2], nullptr) : 1.0;
+
+    auto base = makeModel(conceptCount);
+    auto ours = base->clone();
+    auto theirs = base->clone();
+    edit(*ours, conceptCount, editPercent, 1);
+    edit(*theirs, conceptCount, editPercent, 2);
+    size_t entities = base->getConceptCount() + base->getRelationshipCount();
+
+    ModelDiff changes;
+    double coldDiff = millis([&] { changes = diff(*base, *theirs); });
+    double warmDiff = millis([&] { changes = diff(*base, *theirs); });
+    ModelMerge result;
+    double mergeTime = millis([&] { result = merge(*base, *ours, *theirs); });
+
+    ApplyDiffCommand command(ours.get(), result.changes, "Merge");
+    double executeTime = millis([&] { command.execute(); });
+    double undoTime = millis([&] { command.undo(); });
+
+    std::printf("entities=%zu edits=%.1f%% diff=%zu merge=%zu conflicts=%zu\n", entities, editPercent,
+                changes.size(), result.changes.size(),
+                result.conflictingConcepts.size() + result.conflictingRelationships.size());
+    std::printf("%-16s %10s %14s\n", "", "ms", "entities/s");
+    std::printf("%-16s %10.1f %14.0f\n", "diff (cold)", coldDiff, entities / (coldDiff / 1000.0));
+    std::printf("%-16s %10.1f %14.0f\n", "diff (cached)", warmDiff, entities / (warmDiff / 1000.0));
+    std::printf("%-16s %10.1f %14.0f\n", "merge", mergeTime, entities / (mergeTime / 1000.0));
+    std::printf("%-16s %10.1f\n", "apply", executeTime);
+    std::printf("%-16s %10.1f\n", "undo", undoTime);
+    return 0;
+}
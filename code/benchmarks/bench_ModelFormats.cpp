@@ -0,0 +1,96 @@
+// Compares loading a model from JSON and from the binary format.
+// Usage: bench_ModelFormats [conceptCount] [relationshipsPerConcept]
+
+#include "../core/persistence/ModelManager.h"
+#include "../core/persistence/BinaryModelFormat.h"
+#include "../core/model/MentalModel.h"
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace qlink;
+
+namespace {
+
+std::unique_ptr<MentalModel> makeModel(int conceptCount, int relationshipsPerConcept) {
+    auto model = std::make_unique<MentalModel>("Benchmark");
+    std::mt19937 random(42);
+    for (int i = 0; i < conceptCount; ++i) {
+        std::string id = "concept-" + std::to_string(i);
+        auto concept = std::make_unique<Concept>(id, "Concept " + std::to_string(i),
+                                                 "Description of concept " + std::to_string(i));
+        concept->addTag("tag" + std::to_string(i % 16));
+        concept->setPosition(Position(random() % 2000, random() % 2000));
+        model->addConcept(std::move(concept));
+    }
+    const char* types[] = {"causes", "requires", "part_of", "related_to"};
+    for (int i = 0; i < conceptCount; ++i) {
+        for (int j = 0; j < relationshipsPerConcept; ++j) {
+            int other = static_cast<int>(random() % conceptCount);
+            model->addRelationship(std::make_unique<Relationship>(
+                "concept-" + std::to_string(i), "concept-" + std::to_string(other), types[(i + j) % 4]));
+        }
+    }
+    return model;
+}
+
+template <typename F>
+double bestMillis(int runs, F&& body) {
+    double best = 1e300;
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    int conceptCount = argc > 1 ? std::atoi(argv[1]) : 5000;
+    int relationshipsPerConcept = argc > 2 ? std::atoi(argv[2]) : 3;
+    const int runs = 5;
+
+    auto model = makeModel(conceptCount, relationshipsPerConcept);
+    QTemporaryDir dir;
+    QString jsonPath = dir.filePath("model.json");
+    QString binaryPath = dir.filePath("model.qlinkb");
+
+    ModelManager manager;
+    double jsonSave = bestMillis(runs, [&] { manager.saveModel(*model, jsonPath); });
+    double binarySave = bestMillis(runs, [&] { manager.saveModel(*model, binaryPath); });
+
+    double jsonLoad = bestMillis(runs, [&] { manager.loadModel(jsonPath); });
+    double binaryLoad = bestMillis(runs, [&] { manager.loadModel(binaryPath); });
+
+    // Topology only; JSON files below the parallel-load size are read in full regardless
+    ModelManager lazyManager;
+    lazyManager.setLazyLoading(true);
+    double jsonLazyLoad = bestMillis(runs, [&] { lazyManager.loadModel(jsonPath); });
+    double binaryLazyLoad = bestMillis(runs, [&] { lazyManager.loadModel(binaryPath); });
+
+    // Map and look up one concept without materializing the model
+    double binaryOpen = bestMillis(runs, [&] {
+        auto view = BinaryModelView::open(binaryPath.toStdString(), false);
+        view->getConcept(static_cast<uint32_t>(view->findConcept("concept-0")));
+    });
+
+    std::printf("concepts=%zu relationships=%zu\n", model->getConceptCount(), model->getRelationshipCount());
+    std::printf("%-28s %12s %12s\n", "", "json", "binary");
+    std::printf("%-28s %12lld %12lld\n", "file size (bytes)",
+                static_cast<long long>(QFileInfo(jsonPath).size()),
+                static_cast<long long>(QFileInfo(binaryPath).size()));
+    std::printf("%-28s %12.2f %12.2f\n", "save (ms)", jsonSave, binarySave);
+    std::printf("%-28s %12.2f %12.2f\n", "load full model (ms)", jsonLoad, binaryLoad);
+    std::printf("%-28s %12.2f %12.2f\n", "load lazily (ms)", jsonLazyLoad, binaryLazyLoad);
+    std::printf("%-28s %12s %12.2f\n", "map + lookup, no copy (ms)", "-", binaryOpen);
+    return 0;
+}
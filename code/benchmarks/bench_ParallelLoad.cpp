@@ -0,0 +1,99 @@
+// Measures how JSON model loading scales with worker threads.
+// Usage: bench_ParallelLoad [fileMegabytes] [maxThreads]
+// e.g. bench_ParallelLoad 500 8 for a 500 MB model on up to 8 cores
+
+#include "../core/persistence/ModelManager.h"
+#include "../core/model/MentalModel.h"
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QThreadPool>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace qlink;
+
+namespace {
+
+// Roughly what one concept and its relationships take in the file
+constexpr size_t BYTES_PER_CONCEPT = 900;
+
+std::unique_ptr<MentalModel> makeModel(size_t conceptCount) {
+    auto model = std::make_unique<MentalModel>("Benchmark");
+    std::mt19937 random(42);
+    std::string description(256, 'x');
+    for (size_t i = 0; i < conceptCount; ++i) {
+        auto concept = std::make_unique<Concept>("concept-" + std::to_string(i), "Concept " + std::to_string(i),
+                                                 description);
+        concept->addTag("tag" + std::to_string(i % 16));
+        concept->setPosition(Position(random() % 2000, random() % 2000));
+        model->addConcept(std::move(concept));
+    }
+    const char* types[] = {"causes", "requires", "part_of", "related_to"};
+    for (size_t i = 0; i < conceptCount; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            size_t other = random() % conceptCount;
+            model->addRelationship(std::make_unique<Relationship>(
+                "concept-" + std::to_string(i), "concept-" + std::to_string(other), types[(i + j) % 4]));
+        }
+    }
+    return model;
+}
+
+template <typename F>
+double bestMillis(int runs, F&& body) {
+    double best = 1e300;
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    int maxThreads = argc > 2 ? std::atoi(argv[2]) : 8;
+    const int runs = 3;
+
+    QTemporaryDir dir;
+    QString path = dir.filePath("model.json");
+    {
+        auto model = makeModel(megabytes * 1024 * 1024 / BYTES_PER_CONCEPT);
+        ModelManager::writeModelFile(*model, path);
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "cannot open %s\n", qPrintable(path));
+        return 1;
+    }
+    const char* data = reinterpret_cast<const char*>(file.map(0, file.size()));
+    size_t size = static_cast<size_t>(file.size());
+
+    size_t concepts = 0;
+    size_t relationships = 0;
+    double baseline = 0.0;
+    std::printf("file size: %.1f MB\n", size / (1024.0 * 1024.0));
+    std::printf("%8s %12s %10s\n", "threads", "load (ms)", "speedup");
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        double millis = bestMillis(runs, [&] {
+            auto model = ModelManager::parseModel(data, size, &pool);
+            concepts = model->getConceptCount();
+            relationships = model->getRelationshipCount();
+        });
+        if (threads == 1) baseline = millis;
+        std::printf("%8d %12.1f %9.2fx\n", threads, millis, baseline / millis);
+    }
+    std::printf("concepts=%zu relationships=%zu\n", concepts, relationships);
+    return 0;
+}
@@ -1,5 +1,12 @@
 #include "AIAssistant.h"
+#include "AIResponseCache.h"
+#include "AIResponseStore.h"
+#include "PromptBatcher.h"
+#include "RequestScheduler.h"
+#include "StreamParser.h"
+#include "GraphExplainer.h"
 #include "../model/Concept.h"
+#include "../model/MentalModel.h"
 #include "../common/QLinkException.h"
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
@@ -16,11 +23,30 @@
 #include <QDir>
 #include <QTextStream>
 #include <QIODevice>
+#include <QStandardPaths>
+#include <deque>
+#include <memory>
 #include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <iostream>
 
 namespace qlink {
 
+namespace {
+
+const char* const MODEL_NAME = "command-r-08-2024"; // Current active Cohere model
+
+// QTimer takes an int; a scheduler that can never admit waits milliseconds::max()
+int timerInterval(std::chrono::milliseconds wait) {
+    return static_cast<int>(std::clamp<std::chrono::milliseconds::rep>(wait.count(), 0,
+                                                                       std::numeric_limits<int>::max()));
+}
+
+} // namespace
+
 class AIAssistant::Impl {
 public:
     QNetworkAccessManager* networkManager;
@@ -29,21 +55,32 @@ public:
     bool serviceAvailable;
     int timeoutMs;
     
-    // Caching system
-    std::unordered_map<std::string, std::string> explanationCache;
-    std::unordered_map<std::string, std::string> descriptionCache;
-    std::unordered_map<std::string, std::vector<std::string>> suggestionCache;
+    // Answers by kind-prefixed key; suggestion lists are stored one per line
+    AIResponseCache cache;
+    
+    // Raw API responses kept across sessions; null when disabled
+    std::unique_ptr<AIResponseStore> responseStore;
+    
+    PromptBatcher batcher;
     
     Impl() : networkManager(new QNetworkAccessManager()), 
              apiEndpoint("https://api.cohere.ai/v1/chat"),
              serviceAvailable(false),
              timeoutMs(30000) {
+        QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        if (!cacheDir.isEmpty()) {
+            responseStore = std::make_unique<AIResponseStore>((cacheDir + "/ai_responses.qlrs").toStdString());
+        }
         loadFromEnvFile();
         serviceAvailable = !apiKey.isEmpty();
         qDebug() << "Cohere API key:" << (apiKey.isEmpty() ? "NOT FOUND" : "LOADED");
     }
     
     ~Impl() {
+        // Aborting in-flight replies must not run callbacks into a dead assistant
+        for (QNetworkReply* reply : networkManager->findChildren<QNetworkReply*>()) {
+            QObject::disconnect(reply, nullptr, networkManager, nullptr);
+        }
         delete networkManager;
     }
     
@@ -73,22 +110,434 @@ public:
         }
     }
     
-    QString makeApiRequest(const QString& prompt, const QString& systemMessage = "") {
-        if (!serviceAvailable) {
-            return "";
+    /**
+     * A prompt waiting for a free request slot
+     */
+    struct PendingRequest {
+        QString message; // System message and prompt combined
+        std::string storeKey; // Empty if the response is not persisted as a whole
+        std::vector<std::string> callKeys; // Calls answered by this request
+        int maxTokens;
+        std::function<void(const QString&)> done; // Empty string on failure
+        int attempt = 0; // Retries made so far
+        std::function<void(const std::string&)> onToken; // Set to stream the answer
+    };
+    
+    std::deque<PendingRequest> queue;
+    std::deque<PendingRequest> backgroundQueue; // Prefetches, sent only when queue is empty
+    int inFlight = 0;
+    int maxConcurrent = 4;
+    
+    // Rate limit, retries and circuit breaker
+    RequestScheduler scheduler;
+    LatencyTracker firstTokenLatency; // Streamed requests only
+    bool wakeScheduled = false;
+    int waitingRetries = 0;
+    
+    /**
+     * Callers waiting on one answer. Identical requests made while one is
+     * pending join it instead of sending the prompt again.
+     */
+    struct Call {
+        std::vector<std::pair<RequestId, std::function<void(const std::string&)>>> waiters;
+        std::vector<std::pair<RequestId, std::function<void(const std::string&)>>> tokenListeners;
+        std::string streamed; // Text streamed so far, for listeners that join late
+        QNetworkReply* reply = nullptr; // Null while queued
+        bool background = false; // Only prefetches are waiting
+    };
+    
+    std::unordered_map<std::string, Call> calls; // By cache key
+    RequestId nextRequestId = 1;
+    
+    /**
+     * Attach deliver to the pending call for key; start runs only if there
+     * is none, and must eventually lead to finishCall(key, ...)
+     */
+    RequestId joinCall(const std::string& key, std::function<void(const std::string&)> deliver,
+                       const std::function<void()>& start,
+                       std::function<void(const std::string&)> onToken = nullptr, bool background = false) {
+        RequestId id = nextRequestId++;
+        Call& call = calls[key];
+        bool first = call.waiters.empty();
+        bool promote = !first && call.background && !background;
+        if (first || promote) {
+            call.background = background;
+        }
+        call.waiters.emplace_back(id, std::move(deliver));
+        if (onToken) {
+            if (!call.streamed.empty()) {
+                onToken(call.streamed);
+            }
+            call.tokenListeners.emplace_back(id, std::move(onToken));
+        }
+        if (first) {
+            start();
+        } else if (promote) {
+            promoteQueued(key, calls[key].tokenListeners.size() > 0);
+        }
+        return isWaiting(key, id) ? id : 0;
+    }
+    
+    /**
+     * Somebody now waits on a prefetch: move it to the foreground queue,
+     * streaming it if they asked for that. One already sent just runs on.
+     */
+    void promoteQueued(const std::string& key, bool stream) {
+        auto it = std::find_if(backgroundQueue.begin(), backgroundQueue.end(), [&key](const PendingRequest& pending) {
+            return std::find(pending.callKeys.begin(), pending.callKeys.end(), key) != pending.callKeys.end();
+        });
+        if (it == backgroundQueue.end()) return;
+        
+        PendingRequest pending = std::move(*it);
+        backgroundQueue.erase(it);
+        if (stream && !pending.onToken) {
+            pending.onToken = [this, key](const std::string& token) { streamToken(key, token); };
+        }
+        queue.push_back(std::move(pending));
+        pumpQueue();
+    }
+    
+    /**
+     * Whether the live calls among keys are all prefetches
+     */
+    bool isBackground(const std::vector<std::string>& keys) const {
+        bool any = false;
+        for (const auto& key : keys) {
+            auto it = calls.find(key);
+            if (it == calls.end()) continue;
+            if (!it->second.background) return false;
+            any = true;
+        }
+        return any;
+    }
+    
+    bool isWaiting(const std::string& key, RequestId id) const {
+        auto it = calls.find(key);
+        if (it == calls.end()) return false;
+        const auto& waiters = it->second.waiters;
+        return std::any_of(waiters.begin(), waiters.end(), [id](const auto& entry) { return entry.first == id; });
+    }
+    
+    /**
+     * Hand value to everyone waiting on key
+     */
+    void finishCall(const std::string& key, const std::string& value) {
+        auto it = calls.find(key);
+        if (it == calls.end()) return;
+        
+        // A waiter may start a new call for the same key
+        auto waiters = std::move(it->second.waiters);
+        calls.erase(it);
+        for (const auto& waiter : waiters) {
+            waiter.second(value);
+        }
+    }
+    
+    bool cancel(RequestId id) {
+        for (auto it = calls.begin(); it != calls.end(); ++it) {
+            auto& waiters = it->second.waiters;
+            auto waiter = std::find_if(waiters.begin(), waiters.end(),
+                                       [id](const auto& entry) { return entry.first == id; });
+            if (waiter == waiters.end()) continue;
+            
+            waiters.erase(waiter);
+            auto& listeners = it->second.tokenListeners;
+            listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+                                           [id](const auto& entry) { return entry.first == id; }),
+                            listeners.end());
+            if (waiters.empty()) {
+                // Nobody wants the answer any more
+                std::string key = it->first;
+                QNetworkReply* reply = it->second.reply;
+                calls.erase(it);
+                dropCall(key, reply);
+            }
+            return true;
+        }
+        return false;
+    }
+    
+    void cancelAll() {
+        std::vector<std::pair<std::string, QNetworkReply*>> dropped;
+        for (const auto& entry : calls) {
+            dropped.emplace_back(entry.first, entry.second.reply);
+        }
+        calls.clear();
+        for (const auto& entry : dropped) {
+            dropCall(entry.first, entry.second);
+        }
+    }
+    
+    bool anyLive(const std::vector<std::string>& keys) const {
+        return std::any_of(keys.begin(), keys.end(), [this](const std::string& key) { return calls.count(key) > 0; });
+    }
+    
+    /**
+     * Stop the work behind a call that has already left calls, unless a
+     * batch request still answers other live calls
+     */
+    void dropCall(const std::string& key, QNetworkReply* reply) {
+        if (reply) {
+            bool shared = std::any_of(calls.begin(), calls.end(),
+                                      [reply](const auto& entry) { return entry.second.reply == reply; });
+            if (!shared) {
+                // finished fires from abort(); the handler sees the calls are gone
+                reply->abort();
+            }
+        } else {
+            auto dead = [this](const PendingRequest& pending) { return !anyLive(pending.callKeys); };
+            queue.erase(std::remove_if(queue.begin(), queue.end(), dead), queue.end());
+            backgroundQueue.erase(std::remove_if(backgroundQueue.begin(), backgroundQueue.end(), dead),
+                                  backgroundQueue.end());
+        }
+    }
+    
+    /**
+     * Combine system message and prompt for Cohere
+     */
+    static QString combineMessage(const QString& systemMessage, const QString& prompt) {
+        return systemMessage.isEmpty() ? prompt : systemMessage + "\n\n" + prompt;
+    }
+    
+    static std::string storeKeyFor(const QString& message) {
+        return AIResponseStore::makeKey(MODEL_NAME, message.toStdString());
+    }
+    
+    bool findStored(const std::string& storeKey, QString& response) {
+        std::string stored;
+        try {
+            if (!responseStore || !responseStore->find(storeKey, stored)) return false;
+        } catch (const FileIOException& e) {
+            // A damaged store is a miss; the request is sent instead
+            qWarning() << e.what();
+            return false;
+        }
+        response = QString::fromStdString(stored);
+        return true;
+    }
+    
+    /**
+     * Queue a prompt for the call at callKey; done runs once the reply has
+     * been handled, or right away if an earlier session already stored the
+     * response. Nothing runs if the call is cancelled first.
+     */
+    void enqueueRequest(const QString& prompt, const QString& systemMessage, const std::string& callKey,
+                        std::function<void(const QString&)> done, bool stream = false) {
+        QString message = combineMessage(systemMessage, prompt);
+        std::string storeKey = storeKeyFor(message);
+        QString stored;
+        if (findStored(storeKey, stored)) {
+            done(stored);
+            return;
+        }
+        
+        PendingRequest pending{message, std::move(storeKey), {callKey}, SINGLE_MAX_TOKENS, std::move(done)};
+        if (stream) {
+            pending.onToken = [this, callKey](const std::string& token) { streamToken(callKey, token); };
+        }
+        (isBackground(pending.callKeys) ? backgroundQueue : queue).push_back(std::move(pending));
+        pumpQueue();
+    }
+    
+    /**
+     * Pass a streamed fragment to the call's token listeners
+     */
+    void streamToken(const std::string& callKey, const std::string& token) {
+        auto it = calls.find(callKey);
+        if (it == calls.end()) return;
+        it->second.streamed += token;
+        
+        // A listener may cancel itself
+        auto listeners = it->second.tokenListeners;
+        for (const auto& listener : listeners) {
+            listener.second(token);
+        }
+    }
+    
+    // Answer lengths; a batch reserves its per-item share of the output budget
+    static constexpr int SINGLE_MAX_TOKENS = 150;
+    static constexpr int BATCH_TOKENS_PER_ITEM = 120;
+    
+    /**
+     * One question of a batch
+     */
+    struct BatchItem {
+        std::string callKey;
+        std::string line;                     // The item as listed in the batch prompt
+        std::string storeKey;                 // Where the single-item prompt's answer is persisted
+        std::function<void()> fetchSingle;    // Ask on its own if the batch answer misses it
+        std::function<void(const std::string&)> finish; // Cache and deliver an answer
+    };
+    
+    /**
+     * Ask items in as few requests as the token budgets allow; every item
+     * ends in finish() or fetchSingle()
+     */
+    void sendBatches(std::vector<BatchItem> items, const QString& systemMessage, const QString& instruction) {
+        // Answers from earlier sessions, stored under the single-item prompt
+        std::vector<BatchItem> missing;
+        for (auto& item : items) {
+            QString stored;
+            if (findStored(item.storeKey, stored)) {
+                item.finish(stored.toStdString());
+            } else {
+                missing.push_back(std::move(item));
+            }
         }
         
+        std::vector<std::string> lines;
+        for (const auto& item : missing) {
+            lines.push_back(item.line);
+        }
+        QString header = combineMessage(systemMessage, instruction);
+        // Plus the answer format formatItems() appends
+        int fixedTokens = PromptBatcher::estimateTokens(header.toStdString()) + 60;
+        
+        for (const auto& indices : batcher.pack(lines, fixedTokens, BATCH_TOKENS_PER_ITEM)) {
+            if (indices.size() == 1) {
+                missing[indices.front()].fetchSingle();
+                continue;
+            }
+            
+            auto batch = std::make_shared<std::vector<BatchItem>>();
+            std::vector<std::string> batchLines;
+            std::vector<std::string> callKeys;
+            for (size_t index : indices) {
+                batchLines.push_back(missing[index].line);
+                callKeys.push_back(missing[index].callKey);
+                batch->push_back(std::move(missing[index]));
+            }
+            
+            QString message = header + "\n\n" + QString::fromStdString(PromptBatcher::formatItems(batchLines));
+            int maxTokens = std::min(batcher.getLimits().maxOutputTokens,
+                                     static_cast<int>(batch->size()) * BATCH_TOKENS_PER_ITEM);
+            
+            queue.push_back(PendingRequest{message, std::string(), callKeys, maxTokens, [this, batch](const QString& response) {
+                auto answers = PromptBatcher::parseResponse(response.toStdString());
+                for (size_t i = 0; i < batch->size(); ++i) {
+                    BatchItem& item = (*batch)[i];
+                    if (!calls.count(item.callKey)) continue; // Cancelled meanwhile
+                    
+                    auto answer = answers.find(static_cast<int>(i) + 1);
+                    if (answer != answers.end()) {
+                        storeResponse(item.storeKey, QString::fromStdString(answer->second));
+                        item.finish(answer->second);
+                    } else {
+                        item.fetchSingle();
+                    }
+                }
+            }});
+        }
+        pumpQueue();
+    }
+    
+    void storeResponse(const std::string& storeKey, const QString& response) {
+        if (!responseStore || response.isEmpty()) return;
+        try {
+            responseStore->put(storeKey, response.toStdString());
+        } catch (const FileIOException& e) {
+            // Losing the persistent copy only costs a future request
+            qWarning() << e.what();
+        }
+    }
+    
+    /**
+     * Prefetches leave half the request slots free for answers someone is waiting on
+     */
+    bool canSendBackground() const {
+        return !backgroundQueue.empty() && inFlight < std::max(1, maxConcurrent / 2);
+    }
+    
+    void pumpQueue() {
+        while (inFlight < maxConcurrent && (!queue.empty() || canSendBackground())) {
+            std::deque<PendingRequest>& source = queue.empty() ? backgroundQueue : queue;
+            std::chrono::milliseconds wait(0);
+            switch (scheduler.admit(SchedulerClock::now(), wait)) {
+            case RequestScheduler::Admission::SEND: {
+                PendingRequest next = std::move(source.front());
+                source.pop_front();
+                sendRequest(std::move(next));
+                break;
+            }
+            case RequestScheduler::Admission::WAIT:
+                scheduleWake(wait);
+                return;
+            case RequestScheduler::Admission::HOLD:
+                // The probe's finished handler pumps again
+                return;
+            case RequestScheduler::Admission::FAIL_FAST:
+                failQueued();
+                return;
+            }
+        }
+    }
+    
+    void scheduleWake(std::chrono::milliseconds wait) {
+        if (wakeScheduled) return;
+        wakeScheduled = true;
+        QTimer::singleShot(timerInterval(wait), networkManager, [this]() {
+            wakeScheduled = false;
+            pumpQueue();
+        });
+    }
+    
+    /**
+     * The endpoint is down: answer everything queued with its fallback
+     * instead of letting each request wait out the timeout
+     */
+    void failQueued() {
+        std::deque<PendingRequest> failed;
+        failed.swap(queue);
+        std::move(backgroundQueue.begin(), backgroundQueue.end(), std::back_inserter(failed));
+        backgroundQueue.clear();
+        for (auto& pending : failed) {
+            if (anyLive(pending.callKeys)) {
+                pending.done(QString());
+            }
+        }
+    }
+    
+    static RequestScheduler::Outcome classify(QNetworkReply* reply) {
+        if (reply->error() == QNetworkReply::NoError) {
+            return RequestScheduler::Outcome::SUCCESS;
+        }
+        int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (status == 429) return RequestScheduler::Outcome::RATE_LIMITED;
+        if (status >= 500) return RequestScheduler::Outcome::SERVER_ERROR;
+        if (status > 0) return RequestScheduler::Outcome::CLIENT_ERROR;
+        return RequestScheduler::Outcome::NETWORK_ERROR;
+    }
+    
+    static std::chrono::milliseconds retryAfter(QNetworkReply* reply) {
+        // Only the delay-seconds form; HTTP dates are rare for API rate limits
+        bool ok = false;
+        int seconds = reply->rawHeader("Retry-After").trimmed().toInt(&ok);
+        return std::chrono::milliseconds(ok && seconds > 0 ? seconds * 1000LL : 0);
+    }
+    
+    void retryLater(PendingRequest pending, std::chrono::milliseconds delay) {
+        ++pending.attempt;
+        ++waitingRetries;
+        auto retry = std::make_shared<PendingRequest>(std::move(pending));
+        QTimer::singleShot(timerInterval(delay), networkManager, [this, retry]() {
+            --waitingRetries;
+            // Retries go ahead of new work of their priority; cancelled ones are dropped
+            if (anyLive(retry->callKeys)) {
+                (isBackground(retry->callKeys) ? backgroundQueue : queue).push_front(std::move(*retry));
+            }
+            pumpQueue();
+        });
+    }
+    
+    void sendRequest(PendingRequest pending) {
         QJsonObject requestBody;
-        requestBody["model"] = "command-r-08-2024"; // Current active Cohere model
-        requestBody["max_tokens"] = 150;
+        requestBody["model"] = MODEL_NAME;
+        requestBody["max_tokens"] = pending.maxTokens;
         requestBody["temperature"] = 0.7;
-        
-        // Combine system message and prompt for Cohere
-        QString fullMessage = prompt;
-        if (!systemMessage.isEmpty()) {
-            fullMessage = systemMessage + "\n\n" + prompt;
+        requestBody["message"] = pending.message;
+        if (pending.onToken) {
+            requestBody["stream"] = true;
         }
-        requestBody["message"] = fullMessage;
         
         QJsonDocument doc(requestBody);
         QByteArray data = doc.toJson();
@@ -96,136 +545,521 @@ public:
         QNetworkRequest request((QUrl(apiEndpoint)));
         request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
         request.setRawHeader("Authorization", ("Bearer " + apiKey).toUtf8());
-        request.setTransferTimeout(30000);
+        request.setTransferTimeout(timeoutMs);
         
         QNetworkReply* reply = networkManager->post(request, data);
+        ++inFlight;
         
-        // Wait for response with timeout
-        QEventLoop loop;
-        QTimer timer;
-        timer.setSingleShot(true);
+        for (const auto& key : pending.callKeys) {
+            auto call = calls.find(key);
+            if (call != calls.end()) {
+                call->second.reply = reply;
+            }
+        }
         
-        QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-        QObject::connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
+        // Replies are children of the network manager, so this never fires after we are gone
+        auto sent = std::make_shared<PendingRequest>(std::move(pending));
+        auto started = SchedulerClock::now();
         
-        timer.start(timeoutMs);
-        loop.exec();
+        std::shared_ptr<StreamParser> parser;
+        if (sent->onToken) {
+            auto firstToken = std::make_shared<bool>(true);
+            parser = std::make_shared<StreamParser>([this, sent, started, firstToken](const std::string& token) {
+                if (*firstToken) {
+                    *firstToken = false;
+                    firstTokenLatency.record(std::chrono::duration_cast<std::chrono::milliseconds>(
+                        SchedulerClock::now() - started));
+                }
+                sent->onToken(token);
+            });
+            QObject::connect(reply, &QNetworkReply::readyRead, networkManager, [reply, parser]() {
+                // Error bodies are not part of the stream; finished reports them
+                if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) return;
+                QByteArray chunk = reply->readAll();
+                parser->feed(chunk.constData(), static_cast<size_t>(chunk.size()));
+            });
+        }
         
-        QString result;
-        if (timer.isActive()) {
-            timer.stop();
-            if (reply->error() == QNetworkReply::NoError) {
-                QByteArray responseData = reply->readAll();
-                QJsonDocument responseDoc = QJsonDocument::fromJson(responseData);
-                QJsonObject responseObj = responseDoc.object();
-                
-                // Cohere returns the response in a "text" field
-                if (responseObj.contains("text")) {
-                    result = responseObj["text"].toString().trimmed();
+        QObject::connect(reply, &QNetworkReply::finished, networkManager, [this, reply, sent, started, parser]() {
+            reply->deleteLater();
+            --inFlight;
+            
+            if (!anyLive(sent->callKeys)) {
+                // Cancelled: the reply was aborted and nobody is waiting
+                scheduler.onAbandoned();
+                pumpQueue();
+                return;
+            }
+            for (const auto& key : sent->callKeys) {
+                auto call = calls.find(key);
+                if (call != calls.end() && call->second.reply == reply) {
+                    call->second.reply = nullptr;
                 }
-            } else {
-                qWarning() << "Cohere API request failed:" << reply->errorString();
-                QByteArray errorData = reply->readAll();
-                qWarning() << "Error response:" << errorData;
             }
-        } else {
+            
+            auto now = SchedulerClock::now();
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - started);
+            std::chrono::milliseconds delay(0);
+            bool retry = scheduler.onFinished(now, classify(reply), elapsed, sent->attempt, retryAfter(reply), delay);
+            // Tokens already shown cannot be taken back, so a broken stream is not retried
+            if (retry && !(parser && parser->getTokenCount() > 0)) {
+                qWarning() << "Cohere API request failed, retrying in" << delay.count() << "ms";
+                retryLater(std::move(*sent), delay);
+                pumpQueue();
+                return;
+            }
+            
+            QString result = parser ? readStream(reply, *parser) : readReply(reply);
+            if (!sent->storeKey.empty()) {
+                storeResponse(sent->storeKey, result);
+            }
+            pumpQueue();
+            sent->done(result);
+        });
+    }
+    
+    /**
+     * The text a concept contributes to an explanation prompt
+     */
+    struct ConceptText {
+        std::string id; // For the graph fallback
+        std::string name;
+        std::string description;
+    };
+    
+    static ConceptText textOf(const Concept& concept) {
+        return ConceptText{concept.getId(), concept.getName(), concept.getDescription()};
+    }
+    
+    const MentalModel* model = nullptr; // Evidence for local explanations
+    
+    /**
+     * Explanation from the graph alone, empty if either concept is not in the model
+     */
+    std::string graphExplanation(const ConceptText& first, const ConceptText& second) const {
+        return model ? GraphExplainer::explain(*model, first.id, second.id) : std::string();
+    }
+    
+    static QString explanationSystemMessage() {
+        return "You are an expert at explaining relationships between concepts in knowledge graphs. "
+               "Provide concise, insightful explanations about how two concepts might be related.";
+    }
+    
+    static QString explanationPrompt(const ConceptText& first, const ConceptText& second) {
+        return QString("Explain the potential relationship between these two concepts:\n"
+                       "1. %1: %2\n"
+                       "2. %3: %4\n\n"
+                       "Provide a brief explanation of how they might be connected or related.")
+            .arg(QString::fromStdString(first.name))
+            .arg(QString::fromStdString(first.description))
+            .arg(QString::fromStdString(second.name))
+            .arg(QString::fromStdString(second.description));
+    }
+    
+    static QString descriptionSystemMessage() {
+        return "You are an expert at providing clear, concise descriptions of concepts. "
+               "Provide educational and informative descriptions suitable for knowledge management.";
+    }
+    
+    static QString descriptionPrompt(const std::string& conceptName) {
+        return QString("Provide a brief, informative description of the concept: %1\n\n"
+                       "Keep it concise (1-2 sentences) and focus on the key aspects that would be "
+                       "useful in a knowledge graph or mental model.")
+            .arg(QString::fromStdString(conceptName));
+    }
+    
+    /**
+     * Cache an answer and hand it to the waiting callers; an empty response
+     * becomes the fallback, cached only until the negative TTL runs out
+     */
+    void finishAnswer(const std::string& cacheKey, const std::string& response, const std::string& fallback) {
+        bool failed = response.empty();
+        const std::string& result = failed ? fallback : response;
+        cache.store(cacheKey, result, failed);
+        finishCall(cacheKey, result);
+    }
+    
+    std::string explanationFallback(const ConceptText& first, const ConceptText& second) const {
+        std::string local = graphExplanation(first, second);
+        if (!local.empty()) return local;
+        return "Unable to generate explanation at this time. These concepts may share "
+               "common themes, dependencies, or be part of the same domain.";
+    }
+    
+    static std::string descriptionFallback(const std::string& conceptName) {
+        return "A concept representing " + conceptName + " in your knowledge model.";
+    }
+    
+    // Answers while no API key is configured
+    std::string offlineExplanation(const ConceptText& first, const ConceptText& second) const {
+        std::string local = graphExplanation(first, second);
+        if (!local.empty()) return local;
+        return "These concepts may be related based on their shared connections. " +
+               first.name + " and " + second.name + " could have conceptual similarities or dependencies.";
+    }
+    
+    /**
+     * Cache and deliver an explanation; only a failed request pays for the fallback
+     */
+    void finishExplanation(const std::string& cacheKey, const std::string& response,
+                           const ConceptText& first, const ConceptText& second) {
+        finishAnswer(cacheKey, response, response.empty() ? explanationFallback(first, second) : std::string());
+    }
+    
+    static std::string offlineDescription(const std::string& conceptName) {
+        return "A concept in your mental model: " + conceptName;
+    }
+    
+    void fetchExplanation(const std::string& cacheKey, const ConceptText& first, const ConceptText& second,
+                          bool stream = false) {
+        enqueueRequest(explanationPrompt(first, second), explanationSystemMessage(), cacheKey,
+                       [this, cacheKey, first, second](const QString& response) {
+            finishExplanation(cacheKey, response.toStdString(), first, second);
+        }, stream);
+    }
+    
+    void fetchDescription(const std::string& cacheKey, const std::string& conceptName) {
+        enqueueRequest(descriptionPrompt(conceptName), descriptionSystemMessage(), cacheKey,
+                       [this, cacheKey, conceptName](const QString& response) {
+            finishAnswer(cacheKey, response.toStdString(), descriptionFallback(conceptName));
+        });
+    }
+    
+    QString readReply(QNetworkReply* reply) {
+        QString result;
+        if (reply->error() == QNetworkReply::NoError) {
+            QByteArray responseData = reply->readAll();
+            QJsonDocument responseDoc = QJsonDocument::fromJson(responseData);
+            QJsonObject responseObj = responseDoc.object();
+            
+            // Cohere returns the response in a "text" field
+            if (responseObj.contains("text")) {
+                result = responseObj["text"].toString().trimmed();
+            }
+        } else if (reply->error() == QNetworkReply::OperationCanceledError) {
             qWarning() << "Cohere API request timed out";
-            reply->abort();
+        } else {
+            qWarning() << "Cohere API request failed:" << reply->errorString();
+            QByteArray errorData = reply->readAll();
+            qWarning() << "Error response:" << errorData;
         }
-        
-        reply->deleteLater();
         return result;
     }
+    
+    QString readStream(QNetworkReply* reply, StreamParser& parser) {
+        if (reply->error() != QNetworkReply::NoError) {
+            return readReply(reply);
+        }
+        QByteArray rest = reply->readAll();
+        parser.feed(rest.constData(), static_cast<size_t>(rest.size()));
+        parser.finish();
+        return QString::fromStdString(parser.getText()).trimmed();
+    }
+};
+
+namespace {
+
+/**
+ * Run an async call inside a local event loop and return its result
+ */
+template <typename Result, typename Start>
+Result waitFor(Start&& start) {
+    Result result{};
+    bool finished = false;
+    QEventLoop loop;
+    start([&](const Result& value) {
+        result = value;
+        finished = true;
+        loop.quit();
+    });
+    if (!finished) {
+        loop.exec();
+    }
+    return result;
+}
+
+/**
+ * Suggestion lists are cached as one entry per line
+ */
+std::string joinLines(const std::vector<std::string>& lines) {
+    std::string joined;
+    for (const auto& line : lines) {
+        if (!joined.empty()) joined += '\n';
+        joined += line;
+    }
+    return joined;
+}
+
+std::vector<std::string> splitLines(const std::string& joined) {
+    std::vector<std::string> lines;
+    size_t start = 0;
+    while (start <= joined.size()) {
+        size_t end = joined.find('\n', start);
+        if (end == std::string::npos) end = joined.size();
+        lines.push_back(joined.substr(start, end - start));
+        start = end + 1;
+    }
+    return lines;
+}
+
+/**
+ * Collects the per-item answers of a batch call and reports once all are in
+ */
+struct BatchResults {
+    std::vector<std::string> results;
+    size_t remaining;
+    AIAssistant::BatchCallback callback;
+    
+    BatchResults(size_t count, AIAssistant::BatchCallback callback)
+        : results(count), remaining(count), callback(std::move(callback)) {}
+    
+    void set(size_t index, const std::string& value) {
+        results[index] = value;
+        if (--remaining == 0) {
+            callback(results);
+        }
+    }
 };
 
+} // namespace
+
 AIAssistant::AIAssistant() : pImpl(std::make_unique<Impl>()) {
 }
 
 AIAssistant::~AIAssistant() = default;
 
-std::string AIAssistant::explainConnection(const Concept& concept1, const Concept& concept2) {
-    // Create cache key
-    std::string cacheKey = concept1.getName() + "|" + concept2.getName();
+AIAssistant::RequestId AIAssistant::explainConnectionAsync(const Concept& concept1, const Concept& concept2, TextCallback callback) {
+    // Either order asks the same question
+    std::string cacheKey = "explain:" + AIResponseCache::connectionKey(concept1.getName(), concept2.getName());
     
     // Check cache first
-    auto it = pImpl->explanationCache.find(cacheKey);
-    if (it != pImpl->explanationCache.end()) {
-        return it->second;
+    std::string cached;
+    if (pImpl->cache.find(cacheKey, cached)) {
+        callback(cached);
+        return 0;
     }
     
+    // Offline fallbacks are cheap and not cached, so a key set later takes effect at once
     if (!isServiceAvailable()) {
-        std::string fallback = "These concepts may be related based on their shared connections. " +
-                              concept1.getName() + " and " + concept2.getName() + 
-                              " could have conceptual similarities or dependencies.";
-        pImpl->explanationCache[cacheKey] = fallback;
-        return fallback;
+        callback(pImpl->offlineExplanation(Impl::textOf(concept1), Impl::textOf(concept2)));
+        return 0;
     }
     
-    QString systemMessage = "You are an expert at explaining relationships between concepts in knowledge graphs. "
-                           "Provide concise, insightful explanations about how two concepts might be related.";
+    Impl* impl = pImpl.get();
+    Impl::ConceptText first = Impl::textOf(concept1);
+    Impl::ConceptText second = Impl::textOf(concept2);
+    return impl->joinCall(cacheKey, callback, [impl, cacheKey, first, second]() {
+        impl->fetchExplanation(cacheKey, first, second);
+    });
+}
+
+AIAssistant::RequestId AIAssistant::explainConnectionStreaming(const Concept& concept1, const Concept& concept2,
+                                                              TextCallback onToken, TextCallback onComplete) {
+    std::string cacheKey = "explain:" + AIResponseCache::connectionKey(concept1.getName(), concept2.getName());
     
-    QString prompt = QString("Explain the potential relationship between these two concepts:\n"
-                           "1. %1: %2\n"
-                           "2. %3: %4\n\n"
-                           "Provide a brief explanation of how they might be connected or related.")
-                    .arg(QString::fromStdString(concept1.getName()))
-                    .arg(QString::fromStdString(concept1.getDescription()))
-                    .arg(QString::fromStdString(concept2.getName()))
-                    .arg(QString::fromStdString(concept2.getDescription()));
+    std::string cached;
+    if (pImpl->cache.find(cacheKey, cached)) {
+        onToken(cached);
+        onComplete(cached);
+        return 0;
+    }
+    
+    if (!isServiceAvailable()) {
+        std::string offline = pImpl->offlineExplanation(Impl::textOf(concept1), Impl::textOf(concept2));
+        onToken(offline);
+        onComplete(offline);
+        return 0;
+    }
     
-    QString response = pImpl->makeApiRequest(prompt, systemMessage);
-    std::string result = response.toStdString();
+    // A call that is already running unstreamed, or a fallback, delivers its text in one piece
+    auto received = std::make_shared<bool>(false);
+    TextCallback listener = [received, onToken](const std::string& token) {
+        *received = true;
+        onToken(token);
+    };
+    TextCallback deliver = [received, onToken, onComplete](const std::string& text) {
+        if (!*received) {
+            onToken(text);
+        }
+        onComplete(text);
+    };
     
-    if (result.empty()) {
-        result = "Unable to generate explanation at this time. These concepts may share "
-                "common themes, dependencies, or be part of the same domain.";
+    Impl* impl = pImpl.get();
+    Impl::ConceptText first = Impl::textOf(concept1);
+    Impl::ConceptText second = Impl::textOf(concept2);
+    return impl->joinCall(cacheKey, deliver, [impl, cacheKey, first, second]() {
+        impl->fetchExplanation(cacheKey, first, second, true);
+    }, listener);
+}
+
+AIAssistant::RequestId AIAssistant::prefetchExplanation(const Concept& concept1, const Concept& concept2) {
+    std::string cacheKey = "explain:" + AIResponseCache::connectionKey(concept1.getName(), concept2.getName());
+    if (!isServiceAvailable() || pImpl->cache.contains(cacheKey)) {
+        return 0;
     }
     
-    // Cache the result
-    pImpl->explanationCache[cacheKey] = result;
-    return result;
+    Impl* impl = pImpl.get();
+    Impl::ConceptText first = Impl::textOf(concept1);
+    Impl::ConceptText second = Impl::textOf(concept2);
+    return impl->joinCall(cacheKey, [](const std::string&) {}, [impl, cacheKey, first, second]() {
+        impl->fetchExplanation(cacheKey, first, second);
+    }, nullptr, true);
 }
 
-std::string AIAssistant::generateConceptDescription(const std::string& conceptName) {
+std::string AIAssistant::explainConnectionLocally(const Concept& concept1, const Concept& concept2) const {
+    return pImpl->offlineExplanation(Impl::textOf(concept1), Impl::textOf(concept2));
+}
+
+void AIAssistant::setModel(const MentalModel* model) {
+    pImpl->model = model;
+}
+
+std::string AIAssistant::explainConnection(const Concept& concept1, const Concept& concept2) {
+    return waitFor<std::string>([&](TextCallback done) {
+        explainConnectionAsync(concept1, concept2, done);
+    });
+}
+
+AIAssistant::RequestId AIAssistant::generateConceptDescriptionAsync(const std::string& conceptName, TextCallback callback) {
+    std::string cacheKey = "describe:" + conceptName;
+    
     // Check cache first
-    auto it = pImpl->descriptionCache.find(conceptName);
-    if (it != pImpl->descriptionCache.end()) {
-        return it->second;
+    std::string cached;
+    if (pImpl->cache.find(cacheKey, cached)) {
+        callback(cached);
+        return 0;
     }
     
     if (!isServiceAvailable()) {
-        std::string fallback = "A concept in your mental model: " + conceptName;
-        pImpl->descriptionCache[conceptName] = fallback;
-        return fallback;
+        callback(Impl::offlineDescription(conceptName));
+        return 0;
     }
     
-    QString systemMessage = "You are an expert at providing clear, concise descriptions of concepts. "
-                           "Provide educational and informative descriptions suitable for knowledge management.";
+    Impl* impl = pImpl.get();
+    return impl->joinCall(cacheKey, callback, [impl, cacheKey, conceptName]() {
+        impl->fetchDescription(cacheKey, conceptName);
+    });
+}
+
+std::string AIAssistant::generateConceptDescription(const std::string& conceptName) {
+    return waitFor<std::string>([&](TextCallback done) {
+        generateConceptDescriptionAsync(conceptName, done);
+    });
+}
+
+void AIAssistant::explainConnectionsAsync(const std::vector<ConceptPair>& pairs, BatchCallback callback) {
+    if (pairs.empty()) {
+        callback({});
+        return;
+    }
     
-    QString prompt = QString("Provide a brief, informative description of the concept: %1\n\n"
-                           "Keep it concise (1-2 sentences) and focus on the key aspects that would be "
-                           "useful in a knowledge graph or mental model.")
-                    .arg(QString::fromStdString(conceptName));
+    Impl* impl = pImpl.get();
+    auto results = std::make_shared<BatchResults>(pairs.size(), std::move(callback));
+    std::vector<Impl::BatchItem> items;
     
-    QString response = pImpl->makeApiRequest(prompt, systemMessage);
-    std::string result = response.toStdString();
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        const Concept& concept1 = *pairs[i].first;
+        const Concept& concept2 = *pairs[i].second;
+        std::string cacheKey = "explain:" + AIResponseCache::connectionKey(concept1.getName(), concept2.getName());
+        
+        std::string cached;
+        if (impl->cache.find(cacheKey, cached)) {
+            results->set(i, cached);
+            continue;
+        }
+        
+        Impl::ConceptText first = Impl::textOf(concept1);
+        Impl::ConceptText second = Impl::textOf(concept2);
+        if (!isServiceAvailable()) {
+            results->set(i, impl->offlineExplanation(first, second));
+            continue;
+        }
+        
+        impl->joinCall(cacheKey, [results, i](const std::string& value) { results->set(i, value); }, [&]() {
+            QString single = Impl::combineMessage(Impl::explanationSystemMessage(), Impl::explanationPrompt(first, second));
+            std::string line = first.name + (first.description.empty() ? "" : " (" + first.description + ")") +
+                               " and " + second.name + (second.description.empty() ? "" : " (" + second.description + ")");
+            items.push_back(Impl::BatchItem{
+                cacheKey, line, Impl::storeKeyFor(single),
+                [impl, cacheKey, first, second]() { impl->fetchExplanation(cacheKey, first, second); },
+                [impl, cacheKey, first, second](const std::string& answer) {
+                    impl->finishExplanation(cacheKey, answer, first, second);
+                }});
+        });
+    }
     
-    if (result.empty()) {
-        result = "A concept representing " + conceptName + " in your knowledge model.";
+    if (!items.empty()) {
+        impl->sendBatches(std::move(items), Impl::explanationSystemMessage(),
+                          "Explain briefly how the two concepts of each of the following pairs might be "
+                          "connected or related.");
+    }
+}
+
+std::vector<std::string> AIAssistant::explainConnections(const std::vector<ConceptPair>& pairs) {
+    return waitFor<std::vector<std::string>>([&](BatchCallback done) {
+        explainConnectionsAsync(pairs, done);
+    });
+}
+
+void AIAssistant::generateConceptDescriptionsAsync(const std::vector<std::string>& conceptNames,
+                                                   BatchCallback callback) {
+    if (conceptNames.empty()) {
+        callback({});
+        return;
     }
     
-    // Cache the result
-    pImpl->descriptionCache[conceptName] = result;
-    return result;
+    Impl* impl = pImpl.get();
+    auto results = std::make_shared<BatchResults>(conceptNames.size(), std::move(callback));
+    std::vector<Impl::BatchItem> items;
+    
+    for (size_t i = 0; i < conceptNames.size(); ++i) {
+        const std::string& conceptName = conceptNames[i];
+        std::string cacheKey = "describe:" + conceptName;
+        
+        std::string cached;
+        if (impl->cache.find(cacheKey, cached)) {
+            results->set(i, cached);
+            continue;
+        }
+        if (!isServiceAvailable()) {
+            results->set(i, Impl::offlineDescription(conceptName));
+            continue;
+        }
+        
+        // Duplicate names join the first one's call
+        impl->joinCall(cacheKey, [results, i](const std::string& value) { results->set(i, value); }, [&]() {
+            QString single = Impl::combineMessage(Impl::descriptionSystemMessage(), Impl::descriptionPrompt(conceptName));
+            items.push_back(Impl::BatchItem{
+                cacheKey, conceptName, Impl::storeKeyFor(single),
+                [impl, cacheKey, conceptName]() { impl->fetchDescription(cacheKey, conceptName); },
+                [impl, cacheKey, conceptName](const std::string& answer) {
+                    impl->finishAnswer(cacheKey, answer, Impl::descriptionFallback(conceptName));
+                }});
+        });
+    }
+    
+    if (!items.empty()) {
+        impl->sendBatches(std::move(items), Impl::descriptionSystemMessage(),
+                          "Provide a brief, informative description (1-2 sentences) of each of the following "
+                          "concepts, focusing on the key aspects that would be useful in a knowledge graph or "
+                          "mental model.");
+    }
 }
 
-std::vector<std::string> AIAssistant::suggestRelatedConcepts(const Concept& concept) {
-    std::string cacheKey = concept.getName();
+std::vector<std::string> AIAssistant::generateConceptDescriptions(const std::vector<std::string>& conceptNames) {
+    return waitFor<std::vector<std::string>>([&](BatchCallback done) {
+        generateConceptDescriptionsAsync(conceptNames, done);
+    });
+}
+
+AIAssistant::RequestId AIAssistant::suggestRelatedConceptsAsync(const Concept& concept, ListCallback callback) {
+    std::string cacheKey = "suggest:" + concept.getName();
     
     // Check cache first
-    auto it = pImpl->suggestionCache.find(cacheKey);
-    if (it != pImpl->suggestionCache.end()) {
-        return it->second;
+    std::string cached;
+    if (pImpl->cache.find(cacheKey, cached)) {
+        callback(splitLines(cached));
+        return 0;
     }
     
     if (!isServiceAvailable()) {
@@ -241,8 +1075,8 @@ std::vector<std::string> AIAssistant::suggestRelatedConcepts(const Concept& conc
             fallback.push_back("Similar concepts");
             fallback.push_back("Related topics");
         }
-        pImpl->suggestionCache[cacheKey] = fallback;
-        return fallback;
+        callback(fallback);
+        return 0;
     }
     
     QString systemMessage = "You are an expert at suggesting related concepts for knowledge graphs. "
@@ -265,31 +1099,43 @@ std::vector<std::string> AIAssistant::suggestRelatedConcepts(const Concept& conc
                         return tagStr;
                     }()));
     
-    QString response = pImpl->makeApiRequest(prompt, systemMessage);
-    
-    std::vector<std::string> suggestions;
-    if (!response.isEmpty()) {
-        QStringList lines = response.split('\n', Qt::SkipEmptyParts);
-        for (const QString& line : lines) {
-            QString trimmed = line.trimmed();
-            if (!trimmed.isEmpty() && suggestions.size() < 5) {
-                // Remove any numbering or bullet points
-                trimmed = trimmed.replace(QRegularExpression("^[0-9]+\\.\\s*"), "");
-                trimmed = trimmed.replace(QRegularExpression("^[-*]\\s*"), "");
-                suggestions.push_back(trimmed.toStdString());
+    Impl* impl = pImpl.get();
+    auto deliver = [callback](const std::string& value) { callback(splitLines(value)); };
+    return impl->joinCall(cacheKey, deliver, [impl, prompt, systemMessage, cacheKey]() {
+        impl->enqueueRequest(prompt, systemMessage, cacheKey, [impl, cacheKey](const QString& response) {
+            std::vector<std::string> suggestions;
+            if (!response.isEmpty()) {
+                QStringList lines = response.split('\n', Qt::SkipEmptyParts);
+                for (const QString& line : lines) {
+                    QString trimmed = line.trimmed();
+                    if (!trimmed.isEmpty() && suggestions.size() < 5) {
+                        // Remove any numbering or bullet points
+                        trimmed = trimmed.replace(QRegularExpression("^[0-9]+\\.\\s*"), "");
+                        trimmed = trimmed.replace(QRegularExpression("^[-*]\\s*"), "");
+                        suggestions.push_back(trimmed.toStdString());
+                    }
+                }
             }
-        }
-    }
-    
-    if (suggestions.empty()) {
-        suggestions.push_back("Related concept 1");
-        suggestions.push_back("Related concept 2");
-        suggestions.push_back("Related concept 3");
-    }
-    
-    // Cache the result
-    pImpl->suggestionCache[cacheKey] = suggestions;
-    return suggestions;
+            
+            bool failed = suggestions.empty();
+            if (failed) {
+                suggestions.push_back("Related concept 1");
+                suggestions.push_back("Related concept 2");
+                suggestions.push_back("Related concept 3");
+            }
+            
+            // Cache the result; failures only until the negative TTL runs out
+            std::string value = joinLines(suggestions);
+            impl->cache.store(cacheKey, value, failed);
+            impl->finishCall(cacheKey, value);
+        });
+    });
+}
+
+std::vector<std::string> AIAssistant::suggestRelatedConcepts(const Concept& concept) {
+    return waitFor<std::vector<std::string>>([&](ListCallback done) {
+        suggestRelatedConceptsAsync(concept, done);
+    });
 }
 
 bool AIAssistant::isServiceAvailable() const {
@@ -309,16 +1155,93 @@ void AIAssistant::setTimeout(int milliseconds) {
     pImpl->timeoutMs = milliseconds;
 }
 
+void AIAssistant::setMaxConcurrentRequests(int maxRequests) {
+    pImpl->maxConcurrent = std::max(1, maxRequests);
+    pImpl->pumpQueue();
+}
+
+int AIAssistant::getMaxConcurrentRequests() const {
+    return pImpl->maxConcurrent;
+}
+
+bool AIAssistant::cancelRequest(RequestId id) {
+    return pImpl->cancel(id);
+}
+
+void AIAssistant::cancelAllRequests() {
+    pImpl->cancelAll();
+}
+
+size_t AIAssistant::getPendingRequestCount() const {
+    return pImpl->queue.size() + pImpl->backgroundQueue.size() +
+           static_cast<size_t>(pImpl->inFlight + pImpl->waitingRetries);
+}
+
+void AIAssistant::setRateLimit(double requestsPerSecond, int burst) {
+    RequestScheduler::Config config = pImpl->scheduler.getConfig();
+    config.requestsPerSecond = requestsPerSecond;
+    config.burst = std::max(1, burst);
+    pImpl->scheduler.setConfig(config);
+}
+
+void AIAssistant::setRetryPolicy(int maxRetries, int baseDelayMs, int maxDelayMs) {
+    RequestScheduler::Config config = pImpl->scheduler.getConfig();
+    config.maxRetries = std::max(0, maxRetries);
+    config.baseBackoff = std::chrono::milliseconds(baseDelayMs);
+    config.maxBackoff = std::chrono::milliseconds(maxDelayMs);
+    pImpl->scheduler.setConfig(config);
+}
+
+void AIAssistant::setCircuitBreaker(int failureThreshold, int openMs) {
+    RequestScheduler::Config config = pImpl->scheduler.getConfig();
+    config.failureThreshold = std::max(1, failureThreshold);
+    config.openDuration = std::chrono::milliseconds(openMs);
+    pImpl->scheduler.setConfig(config);
+}
+
+bool AIAssistant::isCircuitOpen() const {
+    return pImpl->scheduler.getCircuitState(SchedulerClock::now()) == CircuitBreaker::State::OPEN;
+}
+
+LatencyTracker::Percentiles AIAssistant::getLatencyStats() const {
+    return pImpl->scheduler.getLatency();
+}
+
+LatencyTracker::Percentiles AIAssistant::getFirstTokenLatencyStats() const {
+    return pImpl->firstTokenLatency.getPercentiles();
+}
+
+void AIAssistant::setResponseStorePath(const QString& filePath) {
+    if (filePath.isEmpty()) {
+        pImpl->responseStore.reset();
+    } else {
+        pImpl->responseStore = std::make_unique<AIResponseStore>(filePath.toStdString());
+    }
+}
+
+void AIAssistant::setCacheLimits(size_t maxBytes, int ttlSeconds, int negativeTtlSeconds) {
+    pImpl->cache.setMaxBytes(maxBytes);
+    pImpl->cache.setTtl(std::chrono::seconds(ttlSeconds));
+    pImpl->cache.setNegativeTtl(std::chrono::seconds(negativeTtlSeconds));
+}
+
 void AIAssistant::clearCache() {
-    pImpl->explanationCache.clear();
-    pImpl->descriptionCache.clear();
-    pImpl->suggestionCache.clear();
+    pImpl->cache.clear();
+    if (pImpl->responseStore) {
+        pImpl->responseStore->clear();
+    }
 }
 
 size_t AIAssistant::getCacheSize() const {
-    return pImpl->explanationCache.size() + 
-           pImpl->descriptionCache.size() + 
-           pImpl->suggestionCache.size();
+    return pImpl->cache.size();
+}
+
+size_t AIAssistant::getCacheBytes() const {
+    return pImpl->cache.getByteSize();
+}
+
+AIResponseCache::Stats AIAssistant::getCacheStats() const {
+    return pImpl->cache.getStats();
 }
 
 } // namespace qlink
\ No newline at end of file
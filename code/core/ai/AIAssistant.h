@@ -1,8 +1,13 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <vector>
+#include <functional>
+#include <utility>
+#include "AIResponseCache.h"
+#include "RequestScheduler.h"
 
 class QString;
 
@@ -10,15 +15,84 @@ namespace qlink {
 
 // Forward declarations
 class Concept;
+class MentalModel;
 
 /**
  * AI assistant for generating explanations and suggestions using Cohere API
+ *
+ * Every operation has an asynchronous variant that returns immediately and
+ * reports through a callback on the calling thread's event loop. Up to
+ * getMaxConcurrentRequests() requests are in flight at once; the rest wait
+ * in a FIFO queue. Cached answers and offline fallbacks are delivered
+ * before the async call returns.
+ *
+ * A call that asks for an answer already being fetched joins that request
+ * rather than sending the prompt again, and every caller gets the result.
+ * Cancelling a caller only stops its callback; the request itself is
+ * dropped from the queue or aborted once nobody is waiting for it.
+ *
+ * Callbacks are dropped if the assistant is destroyed first.
  */
 class AIAssistant {
 public:
+    using TextCallback = std::function<void(const std::string&)>;
+    using ListCallback = std::function<void(const std::vector<std::string>&)>;
+    using RequestId = uint64_t;
+    using BatchCallback = std::function<void(const std::vector<std::string>&)>;
+    using ConceptPair = std::pair<const Concept*, const Concept*>;
+
     AIAssistant();
     ~AIAssistant();
     
+    /**
+     * Asynchronous variants of the methods below
+     * @return id for cancelRequest(), or 0 if the callback already ran
+     */
+    RequestId explainConnectionAsync(const Concept& concept1, const Concept& concept2, TextCallback callback);
+    RequestId generateConceptDescriptionAsync(const std::string& conceptName, TextCallback callback);
+    RequestId suggestRelatedConceptsAsync(const Concept& concept, ListCallback callback);
+    
+    /**
+     * Explain a connection, passing each fragment of the answer to onToken as
+     * the API streams it, then the whole text to onComplete. Cached answers
+     * and fallbacks arrive as a single fragment. The complete text is cached.
+     * @return id for cancelRequest(), or 0 if both callbacks already ran
+     */
+    RequestId explainConnectionStreaming(const Concept& concept1, const Concept& concept2,
+                                         TextCallback onToken, TextCallback onComplete);
+    
+    /**
+     * Explanation built from the model's graph alone (see GraphExplainer):
+     * instant, and the answer whenever the AI service is unavailable or a
+     * request fails. Falls back to a generic sentence for concepts outside
+     * the model.
+     */
+    std::string explainConnectionLocally(const Concept& concept1, const Concept& concept2) const;
+    
+    /**
+     * Model whose graph backs local explanations; not owned
+     */
+    void setModel(const MentalModel* model);
+    
+    /**
+     * Fetch an explanation into the cache before anyone asks for it.
+     * Prefetches wait until no other request is queued, use at most half of
+     * the concurrent request slots and go through the rate limit like any
+     * other request. Asking for the same explanation meanwhile moves the
+     * prefetch to the front.
+     * @return id for cancelRequest(), or 0 if there is nothing to fetch
+     */
+    RequestId prefetchExplanation(const Concept& concept1, const Concept& concept2);
+    
+    /**
+     * Stop a callback from running
+     * @return false if it already ran or was cancelled
+     */
+    bool cancelRequest(RequestId id);
+    void cancelAllRequests();
+    
+    // The blocking methods below run the async variant inside a local event loop
+    
     /**
      * Generate explanation for why two concepts might be connected
      */
@@ -34,6 +108,17 @@ public:
      */
     std::vector<std::string> suggestRelatedConcepts(const Concept& concept);
     
+    /**
+     * Batch variants: uncached items are packed into as few structured
+     * prompts as the token budget allows, and any item missing from a batch
+     * answer is asked again on its own. Results are in input order; the
+     * callback runs once, when all of them are in.
+     */
+    void generateConceptDescriptionsAsync(const std::vector<std::string>& conceptNames, BatchCallback callback);
+    void explainConnectionsAsync(const std::vector<ConceptPair>& pairs, BatchCallback callback);
+    std::vector<std::string> generateConceptDescriptions(const std::vector<std::string>& conceptNames);
+    std::vector<std::string> explainConnections(const std::vector<ConceptPair>& pairs);
+    
     /**
      * Check if AI service is available
      */
@@ -45,12 +130,57 @@ public:
     void setApiKey(const QString& apiKey);
     void setApiEndpoint(const QString& endpoint);
     void setTimeout(int milliseconds);
+    void setMaxConcurrentRequests(int maxRequests);
+    int getMaxConcurrentRequests() const;
+    
+    /**
+     * Requests queued (prefetches included), in flight or waiting to be retried
+     */
+    size_t getPendingRequestCount() const;
+    
+    /**
+     * Request scheduling; see RequestScheduler for the defaults.
+     * Rate-limited (429) and server error (5xx) replies are retried with
+     * jittered exponential backoff. After failureThreshold failures in a
+     * row, requests get their fallback answer at once for openMs, then a
+     * single probe request decides whether the endpoint is back.
+     */
+    void setRateLimit(double requestsPerSecond, int burst);
+    void setRetryPolicy(int maxRetries, int baseDelayMs, int maxDelayMs);
+    void setCircuitBreaker(int failureThreshold, int openMs);
+    bool isCircuitOpen() const;
+    
+    /**
+     * Latency of recent requests, including failed attempts
+     */
+    LatencyTracker::Percentiles getLatencyStats() const;
+    
+    /**
+     * Time from sending a streamed request to its first fragment
+     */
+    LatencyTracker::Percentiles getFirstTokenLatencyStats() const;
+    
+    /**
+     * File that keeps API responses across sessions. Defaults to
+     * ai_responses.qlrs in the application's cache directory; an empty path
+     * turns the persistent cache off. While another process has the file
+     * open, nothing is kept.
+     */
+    void setResponseStorePath(const QString& filePath);
+    
+    /**
+     * Limits of the in-memory cache: a byte budget, how long answers stay
+     * and how long fallbacks for failed requests stay before a retry
+     */
+    void setCacheLimits(size_t maxBytes, int ttlSeconds, int negativeTtlSeconds);
     
     /**
-     * Cache management
+     * Cache management; clearCache() also empties the persistent store
      */
     void clearCache();
     size_t getCacheSize() const;
+    size_t getCacheBytes() const;
+    AIResponseCache::Stats getCacheStats() const;
 
 private:
     class Impl;
@@ -0,0 +1,98 @@
+#include "AIResponseCache.h"
+
+namespace qlink {
+
+AIResponseCache::AIResponseCache(size_t maxBytes, std::chrono::milliseconds ttl,
+                                 std::chrono::milliseconds negativeTtl)
+    : maxBytes(maxBytes), ttl(ttl), negativeTtl(negativeTtl), clock([]() { return Clock::now(); }) {
+}
+
+bool AIResponseCache::find(const std::string& key, std::string& value) {
+    auto it = index.find(key);
+    if (it == index.end()) {
+        ++misses;
+        return false;
+    }
+
+    if (it->second->expires <= clock()) {
+        erase(it);
+        ++expirations;
+        ++misses;
+        return false;
+    }
+
+    // Move to the front of the LRU list
+    entries.splice(entries.begin(), entries, it->second);
+    value = it->second->value;
+    ++hits;
+    return true;
+}
+
+bool AIResponseCache::contains(const std::string& key) const {
+    auto it = index.find(key);
+    return it != index.end() && it->second->expires > clock();
+}
+
+void AIResponseCache::store(const std::string& key, const std::string& value, bool negative) {
+    auto existing = index.find(key);
+    if (existing != index.end()) {
+        erase(existing);
+    }
+
+    std::chrono::milliseconds lifetime = negative ? negativeTtl : ttl;
+    if (lifetime.count() <= 0) return;
+
+    entries.push_front(Entry{key, value, clock() + lifetime});
+    index[key] = entries.begin();
+    bytes += entryBytes(entries.front());
+    evictToBudget();
+}
+
+std::string AIResponseCache::connectionKey(const std::string& first, const std::string& second) {
+    // The first name is length-prefixed, so no split of other names gives the same key
+    const std::string& lower = first < second ? first : second;
+    const std::string& upper = first < second ? second : first;
+    return std::to_string(lower.size()) + ':' + lower + '|' + upper;
+}
+
+void AIResponseCache::clear() {
+    entries.clear();
+    index.clear();
+    bytes = 0;
+}
+
+void AIResponseCache::setMaxBytes(size_t newMaxBytes) {
+    maxBytes = newMaxBytes;
+    evictToBudget();
+}
+
+AIResponseCache::Stats AIResponseCache::getStats() const {
+    Stats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.evictions = evictions;
+    stats.expirations = expirations;
+    stats.entries = entries.size();
+    stats.bytes = bytes;
+    return stats;
+}
+
+size_t AIResponseCache::entryBytes(const Entry& entry) {
+    // The key is held twice: in the entry and in the index
+    return sizeof(Entry) + 2 * entry.key.size() + entry.value.size();
+}
+
+void AIResponseCache::erase(std::unordered_map<std::string, EntryList::iterator>::iterator it) {
+    bytes -= entryBytes(*it->second);
+    entries.erase(it->second);
+    index.erase(it);
+}
+
+void AIResponseCache::evictToBudget() {
+    while (bytes > maxBytes && !entries.empty()) {
+        erase(index.find(entries.back().key));
+        ++evictions;
+    }
+}
+
+} // namespace qlink
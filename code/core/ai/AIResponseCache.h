@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace qlink {
+
+/**
+ * In-memory cache of AI answers with a byte budget.
+ *
+ * Entries are evicted least recently used first once their keys and values
+ * exceed the budget, and expire after a time to live. Fallback answers
+ * stored for failed requests are negative entries with their own, shorter
+ * TTL, so a failure is retried once that runs out instead of sticking
+ * for the whole session.
+ */
+class AIResponseCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;   // Dropped to stay within the byte budget
+        size_t expirations = 0; // Dropped because their TTL ran out
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+    explicit AIResponseCache(size_t maxBytes = 4 * 1024 * 1024,
+                             std::chrono::milliseconds ttl = std::chrono::hours(24),
+                             std::chrono::milliseconds negativeTtl = std::chrono::minutes(1));
+
+    /**
+     * @return true and fills value if key has a live entry
+     */
+    bool find(const std::string& key, std::string& value);
+
+    /**
+     * Whether key has a live entry; unlike find() this counts as neither a
+     * hit nor a use
+     */
+    bool contains(const std::string& key) const;
+
+    /**
+     * Insert or replace an entry
+     * @param negative the value stands in for a failed request
+     */
+    void store(const std::string& key, const std::string& value, bool negative = false);
+
+    /**
+     * Cache key for the connection between two concepts, the same for both orders
+     */
+    static std::string connectionKey(const std::string& first, const std::string& second);
+
+    void clear();
+    size_t size() const { return entries.size(); }
+    size_t getByteSize() const { return bytes; }
+    size_t getMaxBytes() const { return maxBytes; }
+    void setMaxBytes(size_t newMaxBytes);
+
+    /**
+     * A TTL of zero keeps entries of that kind out of the cache
+     */
+    void setTtl(std::chrono::milliseconds newTtl) { ttl = newTtl; }
+    void setNegativeTtl(std::chrono::milliseconds newTtl) { negativeTtl = newTtl; }
+
+    Stats getStats() const;
+
+    /**
+     * Replace the time source, for tests
+     */
+    void setClock(std::function<Clock::time_point()> now) { clock = std::move(now); }
+
+private:
+    struct Entry {
+        std::string key;
+        std::string value;
+        Clock::time_point expires;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    static size_t entryBytes(const Entry& entry);
+    void erase(std::unordered_map<std::string, EntryList::iterator>::iterator it);
+    void evictToBudget();
+
+    size_t maxBytes;
+    std::chrono::milliseconds ttl;
+    std::chrono::milliseconds negativeTtl;
+    std::function<Clock::time_point()> clock;
+
+    EntryList entries; // Most recently used first
+    std::unordered_map<std::string, EntryList::iterator> index;
+    size_t bytes = 0;
+
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t expirations = 0;
+};
+
+} // namespace qlink
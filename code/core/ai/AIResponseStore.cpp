@@ -0,0 +1,331 @@
+#include "AIResponseStore.h"
+#include "../common/Hash.h"
+#include "../common/QLinkException.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QLockFile>
+#include <QDebug>
+#include <cctype>
+#include <cstring>
+
+namespace qlink {
+
+namespace {
+
+// File: "QLRS" + uint32 version, then records back to back.
+// Record: RecordHeader, key bytes, response bytes.
+constexpr char FILE_MAGIC[4] = {'Q', 'L', 'R', 'S'};
+constexpr uint32_t FILE_VERSION = 1;
+constexpr uint64_t FILE_HEADER_SIZE = 8;
+constexpr uint32_t RECORD_MARKER = 0x52454331; // "REC1"
+
+struct RecordHeader {
+    uint32_t marker;
+    uint32_t keyLength;
+    uint32_t valueLength;
+    uint32_t checksum; // Over keyHash, lengths, key and response
+    uint64_t keyHash;
+};
+static_assert(sizeof(RecordHeader) == 24, "RecordHeader must have no padding");
+
+uint32_t recordChecksum(const RecordHeader& header, const char* key, const char* value) {
+    uint64_t hash = fnv1a(&header.keyHash, sizeof(header.keyHash));
+    hash = fnv1a(&header.keyLength, sizeof(header.keyLength), hash);
+    hash = fnv1a(&header.valueLength, sizeof(header.valueLength), hash);
+    hash = fnv1a(key, header.keyLength, hash);
+    hash = fnv1a(value, header.valueLength, hash);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+uint64_t recordSize(uint32_t keyLength, uint32_t valueLength) {
+    return sizeof(RecordHeader) + keyLength + valueLength;
+}
+
+QByteArray encodeRecord(const std::string& key, const std::string& value) {
+    RecordHeader header;
+    header.marker = RECORD_MARKER;
+    header.keyLength = static_cast<uint32_t>(key.size());
+    header.valueLength = static_cast<uint32_t>(value.size());
+    header.keyHash = fnv1a(key.data(), key.size());
+    header.checksum = recordChecksum(header, key.data(), value.data());
+
+    QByteArray record;
+    record.reserve(static_cast<int>(recordSize(header.keyLength, header.valueLength)));
+    record.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    record.append(key.data(), static_cast<int>(key.size()));
+    record.append(value.data(), static_cast<int>(value.size()));
+    return record;
+}
+
+QByteArray fileHeader() {
+    QByteArray header(FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.append(reinterpret_cast<const char*>(&FILE_VERSION), sizeof(FILE_VERSION));
+    return header;
+}
+
+} // namespace
+
+AIResponseStore::AIResponseStore(const std::string& filePath) : filePath(filePath) {
+}
+
+AIResponseStore::~AIResponseStore() {
+    closeLog();
+    lock.reset(); // Unlocks
+}
+
+std::string AIResponseStore::makeKey(const std::string& modelName, const std::string& prompt) {
+    std::string key = modelName;
+    key += '\n';
+    bool pendingSpace = false;
+    for (char c : prompt) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            pendingSpace = true;
+            continue;
+        }
+        // Collapse whitespace runs to one space and drop leading/trailing ones
+        if (pendingSpace && key.back() != '\n') {
+            key += ' ';
+        }
+        pendingSpace = false;
+        key += c;
+    }
+    return key;
+}
+
+bool AIResponseStore::find(const std::string& key, std::string& response) {
+    if (!ensureOpen()) return false;
+
+    auto range = index.equal_range(fnv1a(key.data(), key.size()));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (keyMatches(it->second, key)) {
+            const char* record = recordAt(it->second);
+            response.assign(record + sizeof(RecordHeader) + it->second.keyLength, it->second.valueLength);
+            return true;
+        }
+    }
+    return false;
+}
+
+void AIResponseStore::put(const std::string& key, const std::string& response) {
+    if (!ensureOpen()) {
+        if (lockedOut) return;
+        throw FileIOException("Cannot open AI response store: " + filePath);
+    }
+
+    QByteArray record = encodeRecord(key, response);
+    if (!file->seek(static_cast<qint64>(logSize)) || file->write(record) != record.size() || !file->flush()) {
+        // Drop whatever part of the record made it to disk
+        file->resize(static_cast<qint64>(logSize));
+        throw FileIOException("Cannot write AI response store: " + filePath);
+    }
+
+    Location location{logSize, static_cast<uint32_t>(key.size()), static_cast<uint32_t>(response.size())};
+    logSize += static_cast<uint64_t>(record.size());
+
+    uint64_t hash = fnv1a(key.data(), key.size());
+    auto range = index.equal_range(hash);
+    bool replaced = false;
+    for (auto it = range.first; it != range.second; ++it) {
+        if (keyMatches(it->second, key)) {
+            deadBytes += recordSize(it->second.keyLength, it->second.valueLength);
+            it->second = location;
+            replaced = true;
+            break;
+        }
+    }
+    if (!replaced) {
+        index.emplace(hash, location);
+    }
+
+    maybeCompact();
+}
+
+void AIResponseStore::compact() {
+    if (!ensureOpen() || deadBytes == 0) return;
+
+    QSaveFile out(QString::fromStdString(filePath));
+    if (!out.open(QIODevice::WriteOnly)) {
+        throw FileIOException("Cannot compact AI response store: " + filePath);
+    }
+    out.write(fileHeader());
+    for (const auto& entry : index) {
+        const char* record = recordAt(entry.second);
+        out.write(record, static_cast<qint64>(recordSize(entry.second.keyLength, entry.second.valueLength)));
+    }
+
+    // The old log must be unmapped and closed before it can be replaced
+    closeLog();
+    if (!out.commit()) {
+        throw FileIOException("Cannot compact AI response store: " + filePath);
+    }
+    ensureOpen();
+}
+
+void AIResponseStore::clear() {
+    closeLog();
+    QFile::remove(QString::fromStdString(filePath));
+    lock.reset();
+    openFailed = false;
+    lockedOut = false;
+}
+
+size_t AIResponseStore::size() {
+    return ensureOpen() ? index.size() : 0;
+}
+
+void AIResponseStore::setCompactionThreshold(double deadRatio, uint64_t minCompactBytes) {
+    compactionRatio = deadRatio;
+    minCompactionBytes = minCompactBytes;
+}
+
+bool AIResponseStore::ensureOpen() {
+    if (opened) return true;
+    if (openFailed) return false;
+
+    opened = openLog();
+    if (!opened) {
+        if (!lockedOut) {
+            qWarning() << "Cannot open AI response store" << QString::fromStdString(filePath);
+        }
+        closeLog();
+        lock.reset();
+        openFailed = true;
+    }
+    return opened;
+}
+
+bool AIResponseStore::openLog() {
+    QString path = QString::fromStdString(filePath);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    // Kept across compactions, so no other process gets in while the log is
+    // replaced; only the lock of an owner that died is stale
+    if (!lock) {
+        lock = std::make_unique<QLockFile>(path + ".lock");
+        lock->setStaleLockTime(0);
+        if (!lock->tryLock(0)) {
+            lockedOut = true;
+            qWarning() << "AI response store is in use by another process, not keeping responses:" << path;
+            return false;
+        }
+    }
+
+    file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::ReadWrite)) {
+        return false;
+    }
+
+    QByteArray header = file->read(FILE_HEADER_SIZE);
+    if (header != fileHeader()) {
+        if (!header.isEmpty()) {
+            qWarning() << "AI response store has an unknown format, starting a new one:" << path;
+        }
+        file->resize(0);
+        file->seek(0);
+        if (file->write(fileHeader()) != static_cast<qint64>(FILE_HEADER_SIZE) || !file->flush()) {
+            return false;
+        }
+    }
+
+    if (!remap()) {
+        return false;
+    }
+    scanLog();
+    return true;
+}
+
+void AIResponseStore::closeLog() {
+    if (file) {
+        if (mapped) {
+            file->unmap(mapped);
+        }
+        file->close();
+        file.reset();
+    }
+    mapped = nullptr;
+    mappedSize = 0;
+    logSize = 0;
+    index.clear();
+    deadBytes = 0;
+    opened = false;
+}
+
+void AIResponseStore::scanLog() {
+    uint64_t offset = FILE_HEADER_SIZE;
+
+    // Only headers and checksummed bytes are touched; responses are not copied
+    while (offset + sizeof(RecordHeader) <= mappedSize) {
+        RecordHeader header;
+        std::memcpy(&header, mapped + offset, sizeof(header));
+        if (header.marker != RECORD_MARKER) break;
+
+        uint64_t size = recordSize(header.keyLength, header.valueLength);
+        if (size > mappedSize - offset) break;
+
+        const char* key = reinterpret_cast<const char*>(mapped + offset + sizeof(header));
+        const char* value = key + header.keyLength;
+        if (recordChecksum(header, key, value) != header.checksum) break;
+
+        Location location{offset, header.keyLength, header.valueLength};
+        auto range = index.equal_range(header.keyHash);
+        bool replaced = false;
+        for (auto it = range.first; it != range.second; ++it) {
+            if (keyMatches(it->second, std::string(key, header.keyLength))) {
+                deadBytes += recordSize(it->second.keyLength, it->second.valueLength);
+                it->second = location;
+                replaced = true;
+                break;
+            }
+        }
+        if (!replaced) {
+            index.emplace(header.keyHash, location);
+        }
+        offset += size;
+    }
+
+    logSize = offset;
+    if (logSize < mappedSize) {
+        // A crash mid-append leaves a torn record; later appends go after the last good one
+        qWarning() << "Truncating damaged tail of AI response store:" << (mappedSize - logSize) << "bytes";
+        file->resize(static_cast<qint64>(logSize));
+    }
+}
+
+bool AIResponseStore::remap() {
+    if (mapped) {
+        file->unmap(mapped);
+        mapped = nullptr;
+        mappedSize = 0;
+    }
+    qint64 fileSize = file->size();
+    mapped = file->map(0, fileSize);
+    if (!mapped) {
+        return false;
+    }
+    mappedSize = static_cast<uint64_t>(fileSize);
+    return true;
+}
+
+const char* AIResponseStore::recordAt(const Location& location) {
+    uint64_t end = location.offset + recordSize(location.keyLength, location.valueLength);
+    if (end > mappedSize && !remap()) {
+        throw FileIOException("Cannot map AI response store: " + filePath);
+    }
+    return reinterpret_cast<const char*>(mapped + location.offset);
+}
+
+bool AIResponseStore::keyMatches(const Location& location, const std::string& key) {
+    if (location.keyLength != key.size()) return false;
+    const char* record = recordAt(location);
+    return std::memcmp(record + sizeof(RecordHeader), key.data(), key.size()) == 0;
+}
+
+void AIResponseStore::maybeCompact() {
+    if (logSize < minCompactionBytes) return;
+    if (static_cast<double>(deadBytes) <= compactionRatio * static_cast<double>(logSize)) return;
+    compact();
+}
+
+} // namespace qlink
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class QFile;
+class QLockFile;
+
+namespace qlink {
+
+/**
+ * Persistent cache of AI responses, shared by every model and session.
+ *
+ * The file is an append-only log of (key, response) records read through a
+ * memory map. Opening it only scans record headers to build a hash index;
+ * response text stays on disk until it is looked up, so a warm lookup is a
+ * hash probe plus a copy out of the map.
+ *
+ * Every record carries a checksum. A torn or corrupt tail left by a crash
+ * is cut off on open, keeping everything before it. Overwritten records are
+ * reclaimed by compact(), which rewrites the live records into a temporary
+ * file and atomically replaces the log, so a crash mid-compaction leaves the
+ * old log intact.
+ *
+ * Not thread-safe. One process at a time owns the log through a lock file
+ * beside it; a store that finds the log locked by another process keeps
+ * nothing: find() misses and put() does nothing.
+ */
+class AIResponseStore {
+public:
+    /**
+     * The file is opened lazily, on first use
+     */
+    explicit AIResponseStore(const std::string& filePath);
+    ~AIResponseStore();
+
+    AIResponseStore(const AIResponseStore&) = delete;
+    AIResponseStore& operator=(const AIResponseStore&) = delete;
+
+    /**
+     * Cache key for a prompt: model name plus the prompt with whitespace
+     * runs collapsed and the ends trimmed
+     */
+    static std::string makeKey(const std::string& modelName, const std::string& prompt);
+
+    /**
+     * @return true and fills response if key is stored
+     * @throws FileIOException if the log cannot be mapped
+     */
+    bool find(const std::string& key, std::string& response);
+
+    /**
+     * Append a record; a later put for the same key replaces the earlier one.
+     * Does nothing while another process owns the log.
+     * @throws FileIOException if the log cannot be written
+     */
+    void put(const std::string& key, const std::string& response);
+
+    /**
+     * Rewrite the log with only the live records
+     * @throws FileIOException if the new log cannot be written
+     */
+    void compact();
+
+    /**
+     * Remove every record and the file itself
+     */
+    void clear();
+
+    size_t size();
+    const std::string& getFilePath() const { return filePath; }
+
+    /**
+     * Bytes held by records that have since been overwritten
+     */
+    uint64_t getDeadBytes() const { return deadBytes; }
+
+    /**
+     * put() compacts once dead records take up more than this share of a
+     * log larger than minCompactBytes
+     */
+    void setCompactionThreshold(double deadRatio, uint64_t minCompactBytes);
+
+private:
+    struct Location {
+        uint64_t offset;    // Start of the record header
+        uint32_t keyLength;
+        uint32_t valueLength;
+    };
+
+    bool ensureOpen();
+    bool openLog();
+    void closeLog();
+    void scanLog();
+    bool remap();
+    const char* recordAt(const Location& location);
+    bool keyMatches(const Location& location, const std::string& key);
+    void maybeCompact();
+
+    std::string filePath;
+    std::unique_ptr<QLockFile> lock; // Held while the log is open
+    std::unique_ptr<QFile> file;
+    bool opened = false;
+    bool openFailed = false; // Do not retry a log we could not open
+    bool lockedOut = false;  // Because another process owns it
+
+    unsigned char* mapped = nullptr;
+    uint64_t mappedSize = 0;
+    uint64_t logSize = 0; // End of the last valid record
+
+    // Key hash -> records with that hash; collisions are resolved by comparing keys
+    std::unordered_multimap<uint64_t, Location> index;
+    uint64_t deadBytes = 0;
+
+    double compactionRatio = 0.5;
+    uint64_t minCompactionBytes = 1 << 20;
+};
+
+} // namespace qlink
@@ -8,10 +8,10 @@
 namespace qlink {
 
 /**
- * Common Neighbors algorithm for link prediction using igraph
+ * Common Neighbors algorithm for link prediction
  * score = number of common neighbors between two concepts
  */
-class CommonNeighborPredictor : public IGraphLinkPredictor {
+class CommonNeighborPredictor : public ILinkPredictor {
     Q_OBJECT
 
 public:
@@ -0,0 +1,46 @@
+#include "ExplanationPrefetcher.h"
+#include "../model/Concept.h"
+
+namespace qlink {
+
+ExplanationPrefetcher::ExplanationPrefetcher(AIAssistant* assistant) : assistant(assistant) {
+}
+
+ExplanationPrefetcher::~ExplanationPrefetcher() {
+    cancel();
+}
+
+void ExplanationPrefetcher::setAssistant(AIAssistant* newAssistant) {
+    cancel();
+    assistant = newAssistant;
+}
+
+void ExplanationPrefetcher::prefetch(const std::vector<AIAssistant::ConceptPair>& pairs) {
+    if (!assistant) return;
+
+    // Join the new requests before dropping the old ones, so a pair in both
+    // sets keeps its call alive instead of being aborted and sent again
+    std::vector<AIAssistant::RequestId> previous;
+    previous.swap(pending);
+    for (const auto& pair : pairs) {
+        if (!pair.first || !pair.second) continue;
+        AIAssistant::RequestId id = assistant->prefetchExplanation(*pair.first, *pair.second);
+        if (id != 0) {
+            pending.push_back(id);
+        }
+    }
+    for (AIAssistant::RequestId id : previous) {
+        assistant->cancelRequest(id);
+    }
+}
+
+void ExplanationPrefetcher::cancel() {
+    if (assistant) {
+        for (AIAssistant::RequestId id : pending) {
+            assistant->cancelRequest(id);
+        }
+    }
+    pending.clear();
+}
+
+} // namespace qlink
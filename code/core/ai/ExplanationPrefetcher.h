@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include "AIAssistant.h"
+
+namespace qlink {
+
+/**
+ * Keeps explanations for what the user is looking at warm in the
+ * assistant's cache.
+ *
+ * Each prefetch() replaces the previous set: pairs that are still wanted
+ * keep their running request, the others are cancelled.
+ */
+class ExplanationPrefetcher {
+public:
+    explicit ExplanationPrefetcher(AIAssistant* assistant = nullptr);
+    ~ExplanationPrefetcher();
+
+    ExplanationPrefetcher(const ExplanationPrefetcher&) = delete;
+    ExplanationPrefetcher& operator=(const ExplanationPrefetcher&) = delete;
+
+    /**
+     * Cancels outstanding prefetches before switching
+     */
+    void setAssistant(AIAssistant* newAssistant);
+
+    /**
+     * Prefetch explanations for pairs, most likely to be opened first
+     */
+    void prefetch(const std::vector<AIAssistant::ConceptPair>& pairs);
+
+    void cancel();
+
+private:
+    AIAssistant* assistant;
+    std::vector<AIAssistant::RequestId> pending;
+};
+
+} // namespace qlink
@@ -0,0 +1,166 @@
+#include "GraphExplainer.h"
+#include "../model/MentalModel.h"
+#include <algorithm>
+#include <iterator>
+
+namespace qlink {
+
+namespace {
+
+/**
+ * "a", "a and b", "a, b and c", "a, b, c and 2 more"
+ */
+std::string joinNames(const std::vector<std::string>& names) {
+    size_t listed = std::min(names.size(), GraphExplainer::MAX_LISTED);
+    size_t rest = names.size() - listed;
+
+    std::string text;
+    for (size_t i = 0; i < listed; ++i) {
+        if (i > 0) {
+            text += (i + 1 == listed && rest == 0) ? " and " : ", ";
+        }
+        text += names[i];
+    }
+    if (rest > 0) {
+        text += " and " + std::to_string(rest) + " more";
+    }
+    return text;
+}
+
+/**
+ * Relationship types are identifiers like "part_of"; an untyped one is a plain link
+ */
+std::string phrase(const std::string& type) {
+    if (type.empty()) return "is related to";
+    std::string text = type;
+    std::replace(text.begin(), text.end(), '_', ' ');
+    return text;
+}
+
+std::vector<std::string> neighborIds(const MentalModel& model, const std::string& conceptId) {
+    std::vector<std::string> ids;
+    for (const Relationship* relationship : model.getConceptRelationships(conceptId)) {
+        std::string other = relationship->getOtherConcept(conceptId);
+        if (!other.empty() && other != conceptId) {
+            ids.push_back(other);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+} // namespace
+
+bool GraphExplainer::gather(const MentalModel& model, const std::string& firstId, const std::string& secondId,
+                            Evidence& evidence) {
+    const Concept* first = model.getConcept(firstId);
+    const Concept* second = model.getConcept(secondId);
+    if (!first || !second) return false;
+
+    evidence = Evidence();
+
+    std::vector<std::string> pathIds = model.findShortestPath(firstId, secondId);
+    for (size_t i = 0; i < pathIds.size(); ++i) {
+        const Concept* concept = model.getConcept(pathIds[i]);
+        evidence.path.push_back(concept ? concept->getName() : pathIds[i]);
+        if (i == 0) continue;
+
+        // The strongest relationship between the two stands for the step
+        const Relationship* link = nullptr;
+        for (const Relationship* relationship : model.getConceptRelationships(pathIds[i - 1])) {
+            // Paths ignore direction, so match either way round
+            if (relationship->getOtherConcept(pathIds[i - 1]) == pathIds[i] &&
+                (!link || relationship->getWeight() > link->getWeight())) {
+                link = relationship;
+            }
+        }
+        if (!link) continue;
+        const Concept* source = model.getConcept(link->getSourceConceptId());
+        const Concept* target = model.getConcept(link->getTargetConceptId());
+        if (source && target) {
+            evidence.steps.push_back(Step{source->getName(), link->getType(), target->getName()});
+        }
+    }
+
+    std::vector<std::string> firstNeighbors = neighborIds(model, firstId);
+    std::vector<std::string> secondNeighbors = neighborIds(model, secondId);
+    std::vector<std::string> shared;
+    std::set_intersection(firstNeighbors.begin(), firstNeighbors.end(), secondNeighbors.begin(),
+                          secondNeighbors.end(), std::back_inserter(shared));
+    for (const std::string& id : shared) {
+        if (const Concept* neighbor = model.getConcept(id)) {
+            evidence.sharedNeighbors.push_back(neighbor->getName());
+        }
+    }
+    std::sort(evidence.sharedNeighbors.begin(), evidence.sharedNeighbors.end());
+
+    std::vector<std::string> firstTags = first->getTags();
+    std::vector<std::string> secondTags = second->getTags();
+    std::sort(firstTags.begin(), firstTags.end());
+    std::sort(secondTags.begin(), secondTags.end());
+    std::set_intersection(firstTags.begin(), firstTags.end(), secondTags.begin(), secondTags.end(),
+                          std::back_inserter(evidence.sharedTags));
+    evidence.sharedTags.erase(std::unique(evidence.sharedTags.begin(), evidence.sharedTags.end()),
+                              evidence.sharedTags.end());
+    return true;
+}
+
+std::string GraphExplainer::describe(const std::string& firstName, const std::string& secondName,
+                                     const Evidence& evidence) {
+    std::vector<std::string> sentences;
+
+    std::vector<std::string> steps;
+    for (const Step& step : evidence.steps) {
+        steps.push_back(step.source + " " + phrase(step.type) + " " + step.target);
+    }
+
+    if (evidence.path.size() == 2 && !steps.empty()) {
+        sentences.push_back("In your model, " + steps.front() + ".");
+    } else if (evidence.path.size() > 2) {
+        std::vector<std::string> between(evidence.path.begin() + 1, evidence.path.end() - 1);
+        std::string sentence = "In your model, " + firstName + " and " + secondName + " are linked through ";
+        for (size_t i = 0; i < between.size(); ++i) {
+            sentence += (i == 0 ? "" : i + 1 == between.size() ? " and " : ", ") + between[i];
+        }
+        if (!steps.empty()) {
+            sentence += ": ";
+            for (size_t i = 0; i < steps.size(); ++i) {
+                sentence += (i == 0 ? "" : i + 1 == steps.size() ? ", and " : ", ") + steps[i];
+            }
+        }
+        sentences.push_back(sentence + ".");
+    } else {
+        sentences.push_back(firstName + " and " + secondName + " are not connected in your model yet.");
+    }
+
+    // A two-step path through their only shared neighbour already says it all
+    bool neighborsShown = evidence.path.size() == 3 && evidence.sharedNeighbors.size() == 1;
+    if (!evidence.sharedNeighbors.empty() && !neighborsShown) {
+        sentences.push_back("Both are connected to " + joinNames(evidence.sharedNeighbors) + ".");
+    }
+    if (!evidence.sharedTags.empty()) {
+        sentences.push_back("Both are tagged " + joinNames(evidence.sharedTags) + ".");
+    }
+    if (evidence.path.empty() && evidence.sharedTags.empty()) {
+        sentences.push_back("Linking them, or tagging what they have in common, would show how they relate.");
+    }
+
+    std::string text;
+    for (const std::string& sentence : sentences) {
+        text += (text.empty() ? "" : " ") + sentence;
+    }
+    return text;
+}
+
+std::string GraphExplainer::explain(const MentalModel& model, const std::string& firstId,
+                                    const std::string& secondId) {
+    Evidence evidence;
+    if (!gather(model, firstId, secondId, evidence)) return std::string();
+
+    const Concept* first = model.getConcept(firstId);
+    const Concept* second = model.getConcept(secondId);
+    return describe(first->getName(), second->getName(), evidence);
+}
+
+} // namespace qlink
@@ -0,0 +1,169 @@
+#include "GraphSnapshot.h"
+#include "../model/MentalModel.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace qlink {
+
+std::shared_ptr<const GraphSnapshot> GraphSnapshot::fromModel(const MentalModel& model,
+                                                              const std::set<std::string>& relationshipTypes) {
+    std::shared_ptr<GraphSnapshot> snapshot(new GraphSnapshot());
+    const auto& concepts = model.getConcepts();
+    const auto& relationships = model.getRelationships();
+
+    snapshot->modelVersion = model.getVersion();
+    snapshot->conceptIds.reserve(concepts.size());
+    std::unordered_map<std::string, int> conceptToVertex;
+    conceptToVertex.reserve(concepts.size());
+    for (const auto& concept : concepts) {
+        conceptToVertex.emplace(concept->getId(), static_cast<int>(snapshot->conceptIds.size()));
+        snapshot->conceptIds.push_back(concept->getId());
+    }
+
+    // Resolve endpoints once, skipping filtered types, dangling references and self-loops.
+    // Each relationship becomes two undirected arcs, and one or two directed arcs.
+    std::vector<Edge> undirectedArcs;
+    std::vector<Edge> directedArcs;
+    undirectedArcs.reserve(relationships.size() * 2);
+    directedArcs.reserve(relationships.size() * 2);
+    for (const auto& relationship : relationships) {
+        if (!relationshipTypes.empty() && relationshipTypes.count(relationship->getType()) == 0) {
+            continue;
+        }
+        auto sourceIt = conceptToVertex.find(relationship->getSourceConceptId());
+        auto targetIt = conceptToVertex.find(relationship->getTargetConceptId());
+        if (sourceIt == conceptToVertex.end() || targetIt == conceptToVertex.end() ||
+            sourceIt->second == targetIt->second) {
+            continue;
+        }
+
+        int source = sourceIt->second;
+        int target = targetIt->second;
+        double weight = relationship->getWeight();
+        undirectedArcs.push_back(Edge{source, target, weight});
+        undirectedArcs.push_back(Edge{target, source, weight});
+        directedArcs.push_back(Edge{source, target, weight});
+        if (!relationship->getIsDirected()) {
+            directedArcs.push_back(Edge{target, source, weight});
+        }
+    }
+
+    int vertexCount = snapshot->vertexCount();
+    snapshot->undirected.build(vertexCount, undirectedArcs);
+    snapshot->outgoing.build(vertexCount, directedArcs);
+    for (auto& arc : directedArcs) {
+        std::swap(arc.source, arc.target);
+    }
+    snapshot->incoming.build(vertexCount, directedArcs);
+
+    return snapshot;
+}
+
+void GraphSnapshot::Adjacency::build(int vertexCount, const std::vector<Edge>& arcs) {
+    // Counting pass, then scatter arcs into their source rows
+    std::vector<int> fill(vertexCount + 1, 0);
+    for (const auto& arc : arcs) {
+        ++fill[arc.source + 1];
+    }
+    for (int v = 0; v < vertexCount; ++v) {
+        fill[v + 1] += fill[v];
+    }
+    std::vector<std::pair<int, double>> scattered(arcs.size());
+    std::vector<int> cursor(fill.begin(), fill.end() - 1);
+    for (const auto& arc : arcs) {
+        scattered[cursor[arc.source]++] = std::make_pair(arc.target, arc.weight);
+    }
+
+    // Sort each row and merge parallel arcs while compacting
+    offsets.assign(vertexCount + 1, 0);
+    neighbors.clear();
+    weights.clear();
+    neighbors.reserve(scattered.size());
+    weights.reserve(scattered.size());
+    strengths.assign(vertexCount, 0.0);
+    for (int v = 0; v < vertexCount; ++v) {
+        auto rowBegin = scattered.begin() + fill[v];
+        auto rowEnd = scattered.begin() + fill[v + 1];
+        std::sort(rowBegin, rowEnd,
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (auto it = rowBegin; it != rowEnd; ++it) {
+            if (static_cast<int>(neighbors.size()) > offsets[v] && neighbors.back() == it->first) {
+                weights.back() += it->second;
+            } else {
+                neighbors.push_back(it->first);
+                weights.push_back(it->second);
+            }
+            strengths[v] += it->second;
+        }
+        offsets[v + 1] = static_cast<int>(neighbors.size());
+    }
+}
+
+bool GraphSnapshot::areAdjacent(int vertex1, int vertex2) const {
+    // Search the shorter row
+    if (degree(vertex1) > degree(vertex2)) {
+        std::swap(vertex1, vertex2);
+    }
+    return std::binary_search(neighborsBegin(vertex1), neighborsEnd(vertex1), vertex2);
+}
+
+bool TopKPairs::better(const ScoredPair& a, const ScoredPair& b) {
+    if (a.score != b.score) return a.score > b.score;
+    if (a.source != b.source) return a.source < b.source;
+    return a.target < b.target;
+}
+
+bool TopKPairs::offer(double score, int source, int target) {
+    if (k == 0) return false;
+    ScoredPair pair{score, source, target};
+    if (static_cast<int>(heap.size()) < k) {
+        heap.push_back(pair);
+        std::push_heap(heap.begin(), heap.end(), better);
+        return true;
+    }
+    if (better(pair, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), better);
+        heap.back() = pair;
+        std::push_heap(heap.begin(), heap.end(), better);
+        return true;
+    }
+    return false;
+}
+
+bool TopKPairs::merge(const TopKPairs& other) {
+    bool changed = false;
+    for (const auto& pair : other.heap) {
+        changed |= offer(pair.score, pair.source, pair.target);
+    }
+    return changed;
+}
+
+double TopKPairs::threshold() const {
+    return heap.empty() ? 0.0 : heap.front().score;
+}
+
+std::vector<ScoredPair> TopKPairs::sorted() const {
+    std::vector<ScoredPair> result = heap;
+    std::sort(result.begin(), result.end(), better);
+    return result;
+}
+
+std::vector<LinkSuggestion> TopKPairs::toSuggestions(const GraphSnapshot& snapshot,
+                                                     const std::string& algorithmName) const {
+    std::vector<LinkSuggestion> suggestions;
+    auto pairs = sorted();
+    suggestions.reserve(pairs.size());
+
+    double maxScore = pairs.empty() || pairs.front().score <= 0.0 ? 1.0 : pairs.front().score;
+    for (const auto& pair : pairs) {
+        // Normalize confidence to 0.3-1.0 range for better visibility
+        double confidence = 0.3 + (pair.score / maxScore) * 0.7;
+        std::string explanation = algorithmName + " score: " + std::to_string(pair.score) +
+                                  " (normalized: " + std::to_string(confidence) + ")";
+        suggestions.emplace_back(snapshot.conceptId(pair.source), snapshot.conceptId(pair.target),
+                                 "relates_to", confidence, explanation, algorithmName);
+    }
+    return suggestions;
+}
+
+} // namespace qlink
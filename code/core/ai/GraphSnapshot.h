@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "../common/DataStructures.h"
+
+namespace qlink {
+
+class MentalModel;
+
+/**
+ * Immutable compressed-sparse-row copy of a mental model's topology.
+ * Built once on the thread that owns the model, then shared read-only
+ * with prediction workers so they never touch the live model.
+ *
+ * Three adjacency views are kept side by side, each with a flat weight
+ * array parallel to its neighbour array:
+ * - undirected: every relationship in both rows
+ * - out/in: directed relationships only from source to target, undirected
+ *   ones in both directions
+ */
+class GraphSnapshot {
+public:
+    /**
+     * Capture the model's concepts (as vertices, in model order) and its
+     * relationships as a simple graph (no loops; parallel relationships are
+     * merged by adding their weights)
+     * @param relationshipTypes Only include relationships of these types; empty means all
+     */
+    static std::shared_ptr<const GraphSnapshot> fromModel(const MentalModel& model,
+                                                          const std::set<std::string>& relationshipTypes = {});
+
+    int vertexCount() const { return static_cast<int>(conceptIds.size()); }
+
+    // Undirected view
+    int degree(int vertex) const { return undirected.degree(vertex); }
+    double strength(int vertex) const { return undirected.strengths[vertex]; }
+    const int* neighborsBegin(int vertex) const { return undirected.neighborsBegin(vertex); }
+    const int* neighborsEnd(int vertex) const { return undirected.neighborsEnd(vertex); }
+    const double* weightsBegin(int vertex) const { return undirected.weightsBegin(vertex); }
+    bool areAdjacent(int vertex1, int vertex2) const;
+
+    // Directed views
+    int outDegree(int vertex) const { return outgoing.degree(vertex); }
+    double outStrength(int vertex) const { return outgoing.strengths[vertex]; }
+    const int* outNeighborsBegin(int vertex) const { return outgoing.neighborsBegin(vertex); }
+    const int* outNeighborsEnd(int vertex) const { return outgoing.neighborsEnd(vertex); }
+    const double* outWeightsBegin(int vertex) const { return outgoing.weightsBegin(vertex); }
+
+    int inDegree(int vertex) const { return incoming.degree(vertex); }
+    double inStrength(int vertex) const { return incoming.strengths[vertex]; }
+    const int* inNeighborsBegin(int vertex) const { return incoming.neighborsBegin(vertex); }
+    const int* inNeighborsEnd(int vertex) const { return incoming.neighborsEnd(vertex); }
+    const double* inWeightsBegin(int vertex) const { return incoming.weightsBegin(vertex); }
+
+    const std::string& conceptId(int vertex) const { return conceptIds[vertex]; }
+    uint64_t getModelVersion() const { return modelVersion; }
+
+private:
+    GraphSnapshot() = default;
+
+    struct Edge {
+        int source;
+        int target;
+        double weight;
+    };
+
+    /**
+     * One CSR adjacency structure with its weights
+     */
+    struct Adjacency {
+        std::vector<int> offsets;      // Row offsets, vertexCount() + 1 entries
+        std::vector<int> neighbors;    // Sorted neighbour lists, concatenated
+        std::vector<double> weights;   // Parallel to neighbors
+        std::vector<double> strengths; // Row weight sums
+
+        int degree(int vertex) const { return offsets[vertex + 1] - offsets[vertex]; }
+        const int* neighborsBegin(int vertex) const { return neighbors.data() + offsets[vertex]; }
+        const int* neighborsEnd(int vertex) const { return neighbors.data() + offsets[vertex + 1]; }
+        const double* weightsBegin(int vertex) const { return weights.data() + offsets[vertex]; }
+
+        void build(int vertexCount, const std::vector<Edge>& arcs);
+    };
+
+    std::vector<std::string> conceptIds; // Vertex -> concept ID
+    Adjacency undirected;
+    Adjacency outgoing;
+    Adjacency incoming;
+    uint64_t modelVersion = 0;
+};
+
+/**
+ * A scored, currently unconnected vertex pair (source < target)
+ */
+struct ScoredPair {
+    double score;
+    int source;
+    int target;
+};
+
+/**
+ * Keeps the K best scored pairs seen so far.
+ * Ties are broken by vertex order so results don't depend on thread timing.
+ */
+class TopKPairs {
+public:
+    explicit TopKPairs(int k = 10) : k(k > 0 ? k : 0) {}
+
+    /**
+     * @return true if the pair was retained
+     */
+    bool offer(double score, int source, int target);
+    bool merge(const TopKPairs& other);
+
+    bool isFull() const { return static_cast<int>(heap.size()) >= k; }
+
+    /**
+     * Score of the worst retained pair; a new pair must beat it once full
+     */
+    double threshold() const;
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    int capacity() const { return k; }
+
+    /**
+     * @return pairs ordered best first
+     */
+    std::vector<ScoredPair> sorted() const;
+
+    /**
+     * Convert to suggestions, normalising confidence to 0.3-1.0 like the
+     * igraph-based predictors do
+     */
+    std::vector<LinkSuggestion> toSuggestions(const GraphSnapshot& snapshot,
+                                              const std::string& algorithmName) const;
+
+    // Strict weak ordering: "better" pairs compare less
+    static bool better(const ScoredPair& a, const ScoredPair& b);
+
+private:
+    int k;
+    std::vector<ScoredPair> heap; // Worst retained pair at the front
+};
+
+} // namespace qlink
@@ -2,13 +2,15 @@
 #include "CommonNeighborPredictor.h"
 #include "JaccardCoefficientPredictor.h"
 #include "PreferentialAttachmentPredictor.h"
+#include "NeighborhoodPredictor.h"
 #include "../model/MentalModel.h"
 #include <stdexcept>
 #include <algorithm>
 
 namespace qlink {
 
-void IGraphLinkPredictor::convertToIGraph(const MentalModel& model, igraph_t* graph, std::map<std::string, int>& conceptToVertex) {
+void IGraphLinkPredictor::convertToIGraph(const MentalModel& model, igraph_t* graph, std::map<std::string, int>& conceptToVertex,
+                                          igraph_vector_t* weights) {
     const auto& concepts = model.getConcepts();
     const auto& relationships = model.getRelationships();
     
@@ -18,18 +20,37 @@ void IGraphLinkPredictor::convertToIGraph(const MentalModel& model, igraph_t* gr
     }
     
     // Initialize graph and add edges
-    igraph_empty(graph, static_cast<int>(concepts.size()), IGRAPH_UNDIRECTED);
+    igraph_empty(graph, static_cast<int>(concepts.size()), options.directed ? IGRAPH_DIRECTED : IGRAPH_UNDIRECTED);
     
     igraph_vector_int_t edges;
     igraph_vector_int_init(&edges, 0);
+    if (weights) {
+        igraph_vector_init(weights, 0);
+    }
+    
+    auto addEdge = [&](int source, int target, double weight) {
+        igraph_vector_int_push_back(&edges, source);
+        igraph_vector_int_push_back(&edges, target);
+        if (weights) {
+            igraph_vector_push_back(weights, options.weighted ? weight : 1.0);
+        }
+    };
     
     for (const auto& relationship : relationships) {
+        if (!options.relationshipTypes.empty() &&
+            options.relationshipTypes.count(relationship->getType()) == 0) {
+            continue;
+        }
+        
         auto sourceIt = conceptToVertex.find(relationship->getSourceConceptId());
         auto targetIt = conceptToVertex.find(relationship->getTargetConceptId());
         
         if (sourceIt != conceptToVertex.end() && targetIt != conceptToVertex.end()) {
-            igraph_vector_int_push_back(&edges, sourceIt->second);
-            igraph_vector_int_push_back(&edges, targetIt->second);
+            addEdge(sourceIt->second, targetIt->second, relationship->getWeight());
+            // In a directed graph an undirected relationship goes both ways
+            if (options.directed && !relationship->getIsDirected()) {
+                addEdge(targetIt->second, sourceIt->second, relationship->getWeight());
+            }
         }
     }
     
@@ -54,9 +75,12 @@ std::vector<LinkSuggestion> IGraphLinkPredictor::convertSimilarityToSuggestions(
     }
     
     // Extract similarities for unconnected pairs
+    // Directed predictions are ordered, so both halves of the matrix count
     int numVertices = static_cast<int>(conceptToVertex.size());
     for (int i = 0; i < numVertices; ++i) {
-        for (int j = i + 1; j < numVertices; ++j) {
+        for (int j = options.directed ? 0 : i + 1; j < numVertices; ++j) {
+            if (i == j) continue;
+            
             const std::string& concept1Id = vertexToConcept[i];
             const std::string& concept2Id = vertexToConcept[j];
             
@@ -112,6 +136,16 @@ std::unique_ptr<ILinkPredictor> LinkPredictorFactory::createPredictor(LinkPredic
             return std::make_unique<JaccardCoefficientPredictor>();
         case LinkPredictorFactory::AlgorithmType::PREFERENTIAL_ATTACHMENT:
             return std::make_unique<PreferentialAttachmentPredictor>();
+        case LinkPredictorFactory::AlgorithmType::ADAMIC_ADAR:
+            return std::make_unique<NeighborhoodPredictor<metrics::AdamicAdar>>();
+        case LinkPredictorFactory::AlgorithmType::RESOURCE_ALLOCATION:
+            return std::make_unique<NeighborhoodPredictor<metrics::ResourceAllocation>>();
+        case LinkPredictorFactory::AlgorithmType::SALTON_INDEX:
+            return std::make_unique<NeighborhoodPredictor<metrics::Salton>>();
+        case LinkPredictorFactory::AlgorithmType::SORENSEN_INDEX:
+            return std::make_unique<NeighborhoodPredictor<metrics::Sorensen>>();
+        case LinkPredictorFactory::AlgorithmType::HUB_PROMOTED_INDEX:
+            return std::make_unique<NeighborhoodPredictor<metrics::HubPromoted>>();
         default:
             throw std::runtime_error("Unknown algorithm type");
     }
@@ -121,7 +155,12 @@ std::vector<LinkPredictorFactory::AlgorithmType> LinkPredictorFactory::getAvaila
     return {
         LinkPredictorFactory::AlgorithmType::COMMON_NEIGHBORS,
         LinkPredictorFactory::AlgorithmType::JACCARD_COEFFICIENT,
-        LinkPredictorFactory::AlgorithmType::PREFERENTIAL_ATTACHMENT
+        LinkPredictorFactory::AlgorithmType::PREFERENTIAL_ATTACHMENT,
+        LinkPredictorFactory::AlgorithmType::ADAMIC_ADAR,
+        LinkPredictorFactory::AlgorithmType::RESOURCE_ALLOCATION,
+        LinkPredictorFactory::AlgorithmType::SALTON_INDEX,
+        LinkPredictorFactory::AlgorithmType::SORENSEN_INDEX,
+        LinkPredictorFactory::AlgorithmType::HUB_PROMOTED_INDEX
     };
 }
 
@@ -133,9 +172,24 @@ std::string LinkPredictorFactory::getAlgorithmName(LinkPredictorFactory::Algorit
             return "Jaccard Coefficient";
         case LinkPredictorFactory::AlgorithmType::PREFERENTIAL_ATTACHMENT:
             return "Preferential Attachment";
+        case LinkPredictorFactory::AlgorithmType::ADAMIC_ADAR:
+            return metrics::AdamicAdar::name();
+        case LinkPredictorFactory::AlgorithmType::RESOURCE_ALLOCATION:
+            return metrics::ResourceAllocation::name();
+        case LinkPredictorFactory::AlgorithmType::SALTON_INDEX:
+            return metrics::Salton::name();
+        case LinkPredictorFactory::AlgorithmType::SORENSEN_INDEX:
+            return metrics::Sorensen::name();
+        case LinkPredictorFactory::AlgorithmType::HUB_PROMOTED_INDEX:
+            return metrics::HubPromoted::name();
         default:
             return "Unknown Algorithm";
     }
 }
 
+bool LinkPredictorFactory::isNeighborhoodLocal(LinkPredictorFactory::AlgorithmType type) {
+    // Everything except preferential attachment scores shared neighbourhoods
+    return type != LinkPredictorFactory::AlgorithmType::PREFERENTIAL_ATTACHMENT;
+}
+
 } // namespace qlink
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <set>
 #include "../common/DataStructures.h"
 #include <igraph/igraph.h>
 
@@ -12,6 +13,15 @@ namespace qlink {
 
 class MentalModel;
 
+/**
+ * Which relationships a predictor looks at, and how
+ */
+struct LinkPredictionOptions {
+    bool weighted = false;                   // Use relationship weights instead of counting edges
+    bool directed = false;                   // Follow relationship direction; suggestions are then ordered
+    std::set<std::string> relationshipTypes; // Only consider these types; empty means all
+};
+
 /**
  * Interface for link prediction algorithms (Strategy Pattern)
  */
@@ -41,6 +51,20 @@ public:
      * @return Algorithm description
      */
     virtual std::string getDescription() const = 0;
+    
+    /**
+     * Whether scores only depend on the neighbourhoods of connected concepts.
+     * Such results survive edits confined to isolated concepts, which lets
+     * SuggestionCache keep them instead of recomputing.
+     * @return false if isolated concepts can receive a non-zero score
+     */
+    virtual bool isNeighborhoodLocal() const { return true; }
+    
+    void setOptions(const LinkPredictionOptions& newOptions) { options = newOptions; }
+    const LinkPredictionOptions& getOptions() const { return options; }
+
+protected:
+    LinkPredictionOptions options;
 };
 
 /**
@@ -54,9 +78,11 @@ protected:
     explicit IGraphLinkPredictor(QObject *parent = nullptr) : ILinkPredictor(parent) {}
     
     /**
-     * Convert MentalModel to igraph structure
+     * Convert MentalModel to igraph structure, honouring the predictor's options
+     * @param weights If given, initialised and filled with one weight per edge (1 when unweighted)
      */
-    void convertToIGraph(const MentalModel& model, igraph_t* graph, std::map<std::string, int>& conceptToVertex);
+    void convertToIGraph(const MentalModel& model, igraph_t* graph, std::map<std::string, int>& conceptToVertex,
+                         igraph_vector_t* weights = nullptr);
     
     /**
      * Convert igraph similarity matrix to LinkSuggestions
@@ -82,12 +108,22 @@ public:
     enum class AlgorithmType {
         COMMON_NEIGHBORS,
         JACCARD_COEFFICIENT,
-        PREFERENTIAL_ATTACHMENT
+        PREFERENTIAL_ATTACHMENT,
+        ADAMIC_ADAR,
+        RESOURCE_ALLOCATION,
+        SALTON_INDEX,
+        SORENSEN_INDEX,
+        HUB_PROMOTED_INDEX
     };
     
     static std::unique_ptr<ILinkPredictor> createPredictor(AlgorithmType type);
     static std::vector<AlgorithmType> getAvailableAlgorithms();
     static std::string getAlgorithmName(AlgorithmType type);
+    
+    /**
+     * Same as createPredictor(type)->isNeighborhoodLocal(), without creating one
+     */
+    static bool isNeighborhoodLocal(AlgorithmType type);
 };
 
 } // namespace qlink
\ No newline at end of file
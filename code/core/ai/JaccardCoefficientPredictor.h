@@ -4,14 +4,13 @@
 #include "../model/MentalModel.h"
 #include <vector>
 #include <string>
-#include <set>
 
 namespace qlink {
 
 /**
- * Link predictor using Jaccard Coefficient algorithm with igraph
+ * Link predictor using Jaccard Coefficient algorithm
  */
-class JaccardCoefficientPredictor : public IGraphLinkPredictor {
+class JaccardCoefficientPredictor : public ILinkPredictor {
     Q_OBJECT
 
 public:
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ILinkPredictor.h"
+#include "NeighborhoodScorer.h"
+
+namespace qlink {
+
+/**
+ * Run a neighbourhood metric over the whole model
+ */
+template <typename Metric>
+std::vector<LinkSuggestion> predictNeighborhoodLinks(const MentalModel& model, int maxSuggestions,
+                                                     const LinkPredictionOptions& options = {}) {
+    auto snapshot = GraphSnapshot::fromModel(model, options.relationshipTypes);
+    TopKPairs top(maxSuggestions);
+    withNeighborhoodScorer<Metric>(*snapshot, options.weighted, options.directed,
+                                   [&top](auto& scorer) { scorer.scoreAll(top); });
+    return top.toSuggestions(*snapshot, Metric::name());
+}
+
+/**
+ * ILinkPredictor adapter for a NeighborhoodScorer metric, so a new metric
+ * only needs its policy struct to show up as a predictor
+ */
+template <typename Metric>
+class NeighborhoodPredictor : public ILinkPredictor {
+public:
+    explicit NeighborhoodPredictor(QObject *parent = nullptr) : ILinkPredictor(parent) {}
+
+    std::vector<LinkSuggestion> predictLinks(const MentalModel& model, int maxSuggestions = 10) override {
+        return predictNeighborhoodLinks<Metric>(model, maxSuggestions, options);
+    }
+    std::string getAlgorithmName() const override { return Metric::name(); }
+    std::string getDescription() const override { return Metric::description(); }
+};
+
+} // namespace qlink
@@ -0,0 +1,365 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "GraphSnapshot.h"
+
+namespace qlink {
+
+/**
+ * Scoring policies for NeighborhoodScorer.
+ *
+ * A metric sees every common neighbour z of a candidate pair (u, v) once:
+ * contribution() gets the weights of u-z and z-v and the degree of z, and
+ * the contributions are summed. finalize() turns that sum into the score
+ * using the degrees of u and v. Without weights every weight is 1 and
+ * degrees are neighbour counts, so sums of 1 are common neighbour counts.
+ */
+namespace metrics {
+
+/**
+ * score = |N(u) ∩ N(v)|
+ */
+struct CommonNeighbors {
+    static const char* name() { return "Common Neighbors"; }
+    static const char* description() {
+        return "Predicts links based on the number of common neighbors between concepts";
+    }
+    static double contribution(double sourceWeight, double targetWeight, double) {
+        return (sourceWeight + targetWeight) / 2.0;
+    }
+    static double finalize(double common, double, double) { return common; }
+};
+
+/**
+ * score = |N(u) ∩ N(v)| / |N(u) ∪ N(v)|
+ */
+struct Jaccard {
+    static const char* name() { return "Jaccard Coefficient"; }
+    static const char* description() {
+        return "Predicts links using the Jaccard coefficient: |intersection| / |union| of neighbors";
+    }
+    static double contribution(double sourceWeight, double targetWeight, double) {
+        return (sourceWeight + targetWeight) / 2.0;
+    }
+    static double finalize(double common, double sourceDegree, double targetDegree) {
+        double unionSize = sourceDegree + targetDegree - common;
+        return unionSize > 0.0 ? common / unionSize : 0.0;
+    }
+};
+
+/**
+ * score = sum over common neighbours z of 1 / log(degree(z))
+ */
+struct AdamicAdar {
+    static const char* name() { return "Adamic-Adar"; }
+    static const char* description() {
+        return "Predicts links from common neighbors, weighting rarely connected neighbors higher: "
+               "sum of 1 / log(degree)";
+    }
+    static double contribution(double sourceWeight, double targetWeight, double commonDegree) {
+        // Degree 1 would divide by zero; such a neighbour can't be shared anyway
+        return commonDegree > 1.0 ? (sourceWeight + targetWeight) / 2.0 / std::log(commonDegree) : 0.0;
+    }
+    static double finalize(double sum, double, double) { return sum; }
+};
+
+/**
+ * score = sum over common neighbours z of 1 / degree(z)
+ */
+struct ResourceAllocation {
+    static const char* name() { return "Resource Allocation"; }
+    static const char* description() {
+        return "Predicts links by the share of each common neighbor's connections: sum of 1 / degree";
+    }
+    static double contribution(double sourceWeight, double targetWeight, double commonDegree) {
+        return commonDegree > 0.0 ? (sourceWeight + targetWeight) / 2.0 / commonDegree : 0.0;
+    }
+    static double finalize(double sum, double, double) { return sum; }
+};
+
+/**
+ * score = |N(u) ∩ N(v)| / sqrt(degree(u) * degree(v))
+ */
+struct Salton {
+    static const char* name() { return "Salton Index"; }
+    static const char* description() {
+        return "Predicts links using cosine similarity of neighborhoods: common / sqrt(degree(u) x degree(v))";
+    }
+    static double contribution(double sourceWeight, double targetWeight, double) {
+        return (sourceWeight + targetWeight) / 2.0;
+    }
+    static double finalize(double common, double sourceDegree, double targetDegree) {
+        double product = sourceDegree * targetDegree;
+        return product > 0.0 ? common / std::sqrt(product) : 0.0;
+    }
+};
+
+/**
+ * score = 2 |N(u) ∩ N(v)| / (degree(u) + degree(v))
+ */
+struct Sorensen {
+    static const char* name() { return "Sorensen Index"; }
+    static const char* description() {
+        return "Predicts links using the Sorensen index: 2 x common / (degree(u) + degree(v))";
+    }
+    static double contribution(double sourceWeight, double targetWeight, double) {
+        return (sourceWeight + targetWeight) / 2.0;
+    }
+    static double finalize(double common, double sourceDegree, double targetDegree) {
+        double total = sourceDegree + targetDegree;
+        return total > 0.0 ? 2.0 * common / total : 0.0;
+    }
+};
+
+/**
+ * score = |N(u) ∩ N(v)| / min(degree(u), degree(v))
+ */
+struct HubPromoted {
+    static const char* name() { return "Hub Promoted Index"; }
+    static const char* description() {
+        return "Predicts links favoring hubs: common neighbors / min(degree(u), degree(v))";
+    }
+    static double contribution(double sourceWeight, double targetWeight, double) {
+        return (sourceWeight + targetWeight) / 2.0;
+    }
+    static double finalize(double common, double sourceDegree, double targetDegree) {
+        double smaller = std::min(sourceDegree, targetDegree);
+        return smaller > 0.0 ? common / smaller : 0.0;
+    }
+};
+
+} // namespace metrics
+
+/**
+ * Adjacency access for NeighborhoodScorer, specialised per graph flavour
+ * so the scorer's inner loops compile down to plain pointer walks.
+ *
+ * A candidate pair (u, v) is scored over paths u - z - v: the first hop
+ * comes from forEachSourceNeighbor(u), the second from
+ * forEachTargetNeighbor(z). Weighted views pass the relationship weights
+ * and use strengths (weight sums) as degrees; unweighted views pass 1.
+ */
+template <bool Weighted, bool Directed>
+class NeighborhoodView;
+
+/**
+ * Undirected: relationship direction is ignored and pairs are unordered
+ */
+template <bool Weighted>
+class NeighborhoodView<Weighted, false> {
+public:
+    static constexpr bool ordered = false;
+
+    explicit NeighborhoodView(const GraphSnapshot& graph) : graph(graph) {}
+
+    int vertexCount() const { return graph.vertexCount(); }
+    double sourceDegree(int vertex) const { return degree(vertex); }
+    double targetDegree(int vertex) const { return degree(vertex); }
+    double commonDegree(int vertex) const { return degree(vertex); }
+
+    template <typename Visit>
+    void forEachAdjacent(int vertex, Visit&& visit) const {
+        for (const int* n = graph.neighborsBegin(vertex); n != graph.neighborsEnd(vertex); ++n) {
+            visit(*n);
+        }
+    }
+
+    template <typename Visit>
+    void forEachSourceNeighbor(int vertex, Visit&& visit) const {
+        visitRow(graph.neighborsBegin(vertex), graph.neighborsEnd(vertex), graph.weightsBegin(vertex), visit);
+    }
+
+    template <typename Visit>
+    void forEachTargetNeighbor(int vertex, Visit&& visit) const {
+        visitRow(graph.neighborsBegin(vertex), graph.neighborsEnd(vertex), graph.weightsBegin(vertex), visit);
+    }
+
+private:
+    double degree(int vertex) const {
+        if constexpr (Weighted) {
+            return graph.strength(vertex);
+        } else {
+            return graph.degree(vertex);
+        }
+    }
+
+    template <typename Visit>
+    static void visitRow(const int* begin, const int* end, const double* weights, Visit& visit) {
+        for (const int* n = begin; n != end; ++n, ++weights) {
+            if constexpr (Weighted) {
+                visit(*n, *weights);
+            } else {
+                visit(*n, 1.0);
+            }
+        }
+    }
+
+    const GraphSnapshot& graph;
+};
+
+/**
+ * Directed: scores ordered pairs u -> v over paths u -> z -> v, so the
+ * source degree is u's out-degree and the target degree v's in-degree.
+ * Undirected relationships count in both directions.
+ */
+template <bool Weighted>
+class NeighborhoodView<Weighted, true> {
+public:
+    static constexpr bool ordered = true;
+
+    explicit NeighborhoodView(const GraphSnapshot& graph) : graph(graph) {}
+
+    int vertexCount() const { return graph.vertexCount(); }
+
+    double sourceDegree(int vertex) const {
+        if constexpr (Weighted) {
+            return graph.outStrength(vertex);
+        } else {
+            return graph.outDegree(vertex);
+        }
+    }
+
+    double targetDegree(int vertex) const {
+        if constexpr (Weighted) {
+            return graph.inStrength(vertex);
+        } else {
+            return graph.inDegree(vertex);
+        }
+    }
+
+    // A common neighbour passes the source's influence on through its out-links
+    double commonDegree(int vertex) const { return sourceDegree(vertex); }
+
+    /**
+     * Concepts linked to vertex either way; those are never suggested
+     */
+    template <typename Visit>
+    void forEachAdjacent(int vertex, Visit&& visit) const {
+        for (const int* n = graph.neighborsBegin(vertex); n != graph.neighborsEnd(vertex); ++n) {
+            visit(*n);
+        }
+    }
+
+    template <typename Visit>
+    void forEachSourceNeighbor(int vertex, Visit&& visit) const {
+        forEachOut(vertex, visit);
+    }
+
+    template <typename Visit>
+    void forEachTargetNeighbor(int vertex, Visit&& visit) const {
+        forEachOut(vertex, visit);
+    }
+
+private:
+    template <typename Visit>
+    void forEachOut(int vertex, Visit& visit) const {
+        const double* weight = graph.outWeightsBegin(vertex);
+        for (const int* n = graph.outNeighborsBegin(vertex); n != graph.outNeighborsEnd(vertex); ++n, ++weight) {
+            if constexpr (Weighted) {
+                visit(*n, *weight);
+            } else {
+                visit(*n, 1.0);
+            }
+        }
+    }
+
+    const GraphSnapshot& graph;
+};
+
+/**
+ * Scores unconnected vertex pairs that share at least one neighbour.
+ *
+ * For each source u the scorer walks two hops out, accumulating the metric's
+ * contribution per reachable target, so only pairs with a common neighbour
+ * are ever touched. Metric, weighting and direction are template
+ * parameters: every combination gets its own fully inlined loop.
+ *
+ * Not thread-safe; give each worker its own scorer over a shared snapshot.
+ */
+template <typename Metric, bool Weighted = false, bool Directed = false>
+class NeighborhoodScorer {
+public:
+    using View = NeighborhoodView<Weighted, Directed>;
+
+    explicit NeighborhoodScorer(const GraphSnapshot& graph)
+        : view(graph),
+          accumulated(graph.vertexCount(), 0.0),
+          adjacentMark(graph.vertexCount(), -1),
+          touchedMark(graph.vertexCount(), -1) {}
+
+    static const char* name() { return Metric::name(); }
+
+    /**
+     * Offer every scored pair starting at source to top: (source, v) with
+     * v > source for undirected views, source -> v for directed ones
+     */
+    void scoreSource(int source, TopKPairs& top) {
+        view.forEachAdjacent(source, [this, source](int neighbor) {
+            adjacentMark[neighbor] = source;
+        });
+
+        view.forEachSourceNeighbor(source, [this, source](int common, double sourceWeight) {
+            double commonDegree = view.commonDegree(common);
+            view.forEachTargetNeighbor(common, [&](int target, double targetWeight) {
+                if (View::ordered ? target == source : target <= source) return;
+                if (touchedMark[target] != source) {
+                    touchedMark[target] = source;
+                    touched.push_back(target);
+                }
+                accumulated[target] += Metric::contribution(sourceWeight, targetWeight, commonDegree);
+            });
+        });
+
+        double sourceDegree = view.sourceDegree(source);
+        for (int target : touched) {
+            double sum = accumulated[target];
+            accumulated[target] = 0.0;
+            if (adjacentMark[target] == source) continue;
+
+            double score = Metric::finalize(sum, sourceDegree, view.targetDegree(target));
+            if (score > 0.0) {
+                top.offer(score, source, target);
+            }
+        }
+        touched.clear();
+    }
+
+    void scoreRange(int begin, int end, TopKPairs& top) {
+        for (int source = begin; source < end; ++source) {
+            scoreSource(source, top);
+        }
+    }
+
+    void scoreAll(TopKPairs& top) { scoreRange(0, view.vertexCount(), top); }
+
+private:
+    View view;
+    std::vector<double> accumulated; // Contribution sums for the current source
+    std::vector<int> adjacentMark;   // Source that last marked the vertex as its neighbour
+    std::vector<int> touchedMark;    // Source that last reached the vertex in two hops
+    std::vector<int> touched;
+};
+
+/**
+ * Pick the scorer flavour at runtime and hand it to fn
+ */
+template <typename Metric, typename Fn>
+void withNeighborhoodScorer(const GraphSnapshot& graph, bool weighted, bool directed, Fn&& fn) {
+    if (weighted && directed) {
+        NeighborhoodScorer<Metric, true, true> scorer(graph);
+        fn(scorer);
+    } else if (weighted) {
+        NeighborhoodScorer<Metric, true, false> scorer(graph);
+        fn(scorer);
+    } else if (directed) {
+        NeighborhoodScorer<Metric, false, true> scorer(graph);
+        fn(scorer);
+    } else {
+        NeighborhoodScorer<Metric> scorer(graph);
+        fn(scorer);
+    }
+}
+
+} // namespace qlink
@@ -16,8 +16,9 @@ std::vector<LinkSuggestion> PreferentialAttachmentPredictor::predictLinks(const
     
     // Convert to igraph
     igraph_t graph;
+    igraph_vector_t weights;
     std::map<std::string, int> conceptToVertex;
-    convertToIGraph(model, &graph, conceptToVertex);
+    convertToIGraph(model, &graph, conceptToVertex, &weights);
     
     // Calculate similarity matrix for preferential attachment
     igraph_matrix_t similarity;
@@ -27,23 +28,26 @@ std::vector<LinkSuggestion> PreferentialAttachmentPredictor::predictLinks(const
     igraph_matrix_resize(&similarity, numVertices, numVertices);
     igraph_matrix_fill(&similarity, 0.0);
     
-    // Get degrees for all vertices
-    igraph_vector_int_t degrees;
-    igraph_vector_int_init(&degrees, numVertices);
-    igraph_degree(&graph, &degrees, igraph_vss_all(), IGRAPH_ALL, IGRAPH_NO_LOOPS);
+    // Get degrees (weight sums when weighted) for all vertices;
+    // a directed link u -> v pairs u's outgoing with v's incoming degree
+    igraph_vector_t outDegrees, inDegrees;
+    igraph_vector_init(&outDegrees, numVertices);
+    igraph_vector_init(&inDegrees, numVertices);
+    igraph_strength(&graph, &outDegrees, igraph_vss_all(), options.directed ? IGRAPH_OUT : IGRAPH_ALL,
+                    IGRAPH_NO_LOOPS, &weights);
+    igraph_strength(&graph, &inDegrees, igraph_vss_all(), options.directed ? IGRAPH_IN : IGRAPH_ALL,
+                    IGRAPH_NO_LOOPS, &weights);
     
     // Calculate preferential attachment scores
     for (int i = 0; i < numVertices; ++i) {
-        for (int j = i + 1; j < numVertices; ++j) {
-            double degree_i = (double)VECTOR(degrees)[i];
-            double degree_j = (double)VECTOR(degrees)[j];
+        for (int j = 0; j < numVertices; ++j) {
+            if (i == j) continue;
+            double degree_i = VECTOR(outDegrees)[i];
+            double degree_j = VECTOR(inDegrees)[j];
             
             // Preferential attachment score = degree(i) * degree(j)
             // Add 1 to handle isolated nodes
-            double score = (degree_i + 1) * (degree_j + 1);
-            
-            MATRIX(similarity, i, j) = score;
-            MATRIX(similarity, j, i) = score;
+            MATRIX(similarity, i, j) = (degree_i + 1) * (degree_j + 1);
         }
     }
     
@@ -51,7 +55,9 @@ std::vector<LinkSuggestion> PreferentialAttachmentPredictor::predictLinks(const
     auto suggestions = convertSimilarityToSuggestions(&similarity, conceptToVertex, model, maxSuggestions, "Preferential Attachment");
     
     // Cleanup
-    igraph_vector_int_destroy(&degrees);
+    igraph_vector_destroy(&outDegrees);
+    igraph_vector_destroy(&inDegrees);
+    igraph_vector_destroy(&weights);
     igraph_matrix_destroy(&similarity);
     cleanupIGraph(&graph);
     
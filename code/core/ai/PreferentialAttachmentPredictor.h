@@ -26,6 +26,9 @@ public:
     
     std::string getAlgorithmName() const override;
     std::string getDescription() const override;
+    
+    // Degree + 1 scoring gives isolated concepts a non-zero score
+    bool isNeighborhoodLocal() const override { return false; }
 
 };
 
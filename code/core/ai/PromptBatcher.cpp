@@ -0,0 +1,77 @@
+#include "PromptBatcher.h"
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace qlink {
+
+int PromptBatcher::estimateTokens(const std::string& text) {
+    return static_cast<int>((text.size() + 3) / 4);
+}
+
+std::vector<std::vector<size_t>> PromptBatcher::pack(const std::vector<std::string>& items, int fixedPromptTokens,
+                                                     int outputTokensPerItem) const {
+    std::vector<std::vector<size_t>> batches;
+    std::vector<size_t> current;
+    int promptTokens = fixedPromptTokens;
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        // The item number and line break cost a couple of tokens too
+        int itemTokens = estimateTokens(items[i]) + 2;
+        bool fits = promptTokens + itemTokens <= limits.maxPromptTokens &&
+                    static_cast<int>(current.size() + 1) * outputTokensPerItem <= limits.maxOutputTokens &&
+                    static_cast<int>(current.size()) < limits.maxItems;
+        if (!fits && !current.empty()) {
+            batches.push_back(std::move(current));
+            current.clear();
+            promptTokens = fixedPromptTokens;
+        }
+        // An item too large for any batch still goes out, on its own
+        current.push_back(i);
+        promptTokens += itemTokens;
+    }
+    if (!current.empty()) {
+        batches.push_back(std::move(current));
+    }
+    return batches;
+}
+
+std::string PromptBatcher::formatItems(const std::vector<std::string>& items) {
+    std::string text;
+    for (size_t i = 0; i < items.size(); ++i) {
+        text += std::to_string(i + 1) + ". " + items[i] + "\n";
+    }
+    text += "\nAnswer with only a JSON array containing one object per item, in the form "
+            "[{\"id\": <item number>, \"text\": \"<answer>\"}]. Do not add anything else.";
+    return text;
+}
+
+std::unordered_map<int, std::string> PromptBatcher::parseResponse(const std::string& response) {
+    std::unordered_map<int, std::string> answers;
+
+    // Models like to wrap JSON in prose or code fences; keep the outermost array
+    size_t begin = response.find('[');
+    size_t end = response.rfind(']');
+    if (begin == std::string::npos || end == std::string::npos || end < begin) {
+        return answers;
+    }
+
+    QJsonDocument document = QJsonDocument::fromJson(
+        QByteArray(response.data() + begin, static_cast<int>(end - begin + 1)));
+    if (!document.isArray()) {
+        return answers;
+    }
+
+    for (const QJsonValue& value : document.array()) {
+        QJsonObject item = value.toObject();
+        int id = item["id"].isString() ? item["id"].toString().toInt() : item["id"].toInt();
+        std::string text = item["text"].toString().trimmed().toStdString();
+        if (id > 0 && !text.empty()) {
+            answers[id] = text;
+        }
+    }
+    return answers;
+}
+
+} // namespace qlink
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace qlink {
+
+/**
+ * Packs many small AI questions into a few structured prompts and reads
+ * the per-item answers back out.
+ *
+ * A batch prompt lists its items numbered from 1 and asks for a JSON array
+ * of {"id": n, "text": "..."} objects. Items are packed greedily in order
+ * while the prompt stays within its token budget and the expected answers
+ * fit in the reply's output budget. Token counts are estimated at about
+ * four characters per token, which is close enough for budgeting.
+ */
+class PromptBatcher {
+public:
+    struct Limits {
+        int maxPromptTokens = 6000;
+        int maxOutputTokens = 4000;
+        int maxItems = 25;
+    };
+
+    PromptBatcher() = default;
+    explicit PromptBatcher(const Limits& limits) : limits(limits) {}
+
+    static int estimateTokens(const std::string& text);
+
+    /**
+     * Split items into batches of indices
+     * @param fixedPromptTokens tokens every batch prompt spends on its instructions
+     * @param outputTokensPerItem answer length to reserve per item
+     */
+    std::vector<std::vector<size_t>> pack(const std::vector<std::string>& items, int fixedPromptTokens,
+                                          int outputTokensPerItem) const;
+
+    /**
+     * The item list of a batch prompt, plus the answer format to follow
+     */
+    static std::string formatItems(const std::vector<std::string>& items);
+
+    /**
+     * Answers by item number; items missing from the reply or with an empty
+     * answer are left out
+     */
+    static std::unordered_map<int, std::string> parseResponse(const std::string& response);
+
+    const Limits& getLimits() const { return limits; }
+
+private:
+    Limits limits;
+};
+
+} // namespace qlink
@@ -0,0 +1,196 @@
+#include "RequestScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace qlink {
+
+TokenBucket::TokenBucket(double ratePerSecond, double capacity)
+    : ratePerSecond(ratePerSecond), capacity(capacity), tokens(capacity) {
+}
+
+void TokenBucket::refill(SchedulerClock::time_point now) {
+    if (!started) {
+        started = true;
+        lastRefill = now;
+        return;
+    }
+    std::chrono::duration<double> elapsed = now - lastRefill;
+    if (elapsed.count() > 0.0) {
+        tokens = std::min(capacity, tokens + elapsed.count() * ratePerSecond);
+        lastRefill = now;
+    }
+}
+
+bool TokenBucket::tryAcquire(SchedulerClock::time_point now) {
+    refill(now);
+    if (tokens < 1.0) return false;
+    tokens -= 1.0;
+    return true;
+}
+
+std::chrono::milliseconds TokenBucket::timeUntilAvailable(SchedulerClock::time_point now) {
+    refill(now);
+    if (tokens >= 1.0) return std::chrono::milliseconds(0);
+    if (ratePerSecond <= 0.0) return std::chrono::milliseconds::max();
+    double seconds = (1.0 - tokens) / ratePerSecond;
+    return std::chrono::milliseconds(static_cast<int64_t>(std::ceil(seconds * 1000.0)));
+}
+
+void TokenBucket::configure(double newRatePerSecond, double newCapacity) {
+    ratePerSecond = newRatePerSecond;
+    capacity = newCapacity;
+    tokens = std::min(tokens, capacity);
+}
+
+CircuitBreaker::CircuitBreaker(int failureThreshold, std::chrono::milliseconds openDuration)
+    : failureThreshold(failureThreshold), openDuration(openDuration) {
+}
+
+CircuitBreaker::State CircuitBreaker::getState(SchedulerClock::time_point now) {
+    if (!open) return State::CLOSED;
+    return now - openedAt >= openDuration ? State::HALF_OPEN : State::OPEN;
+}
+
+bool CircuitBreaker::allowRequest(SchedulerClock::time_point now) {
+    switch (getState(now)) {
+    case State::CLOSED:
+        return true;
+    case State::OPEN:
+        return false;
+    case State::HALF_OPEN:
+        if (probing) return false;
+        probing = true;
+        return true;
+    }
+    return false;
+}
+
+void CircuitBreaker::recordSuccess() {
+    consecutiveFailures = 0;
+    open = false;
+    probing = false;
+}
+
+void CircuitBreaker::recordFailure(SchedulerClock::time_point now) {
+    ++consecutiveFailures;
+    // A failed probe reopens at once
+    if (probing || consecutiveFailures >= failureThreshold) {
+        open = true;
+        openedAt = now;
+    }
+    probing = false;
+}
+
+void CircuitBreaker::configure(int newFailureThreshold, std::chrono::milliseconds newOpenDuration) {
+    failureThreshold = newFailureThreshold;
+    openDuration = newOpenDuration;
+}
+
+LatencyTracker::LatencyTracker(size_t window) : window(std::max<size_t>(window, 1)) {
+    samples.reserve(this->window);
+}
+
+void LatencyTracker::record(std::chrono::milliseconds latency) {
+    double value = static_cast<double>(latency.count());
+    if (samples.size() < window) {
+        samples.push_back(value);
+    } else {
+        samples[next] = value;
+    }
+    next = (next + 1) % window;
+}
+
+LatencyTracker::Percentiles LatencyTracker::getPercentiles() const {
+    Percentiles result;
+    result.samples = samples.size();
+    if (samples.empty()) return result;
+
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    // Nearest-rank percentiles
+    auto rank = [&sorted](double p) {
+        size_t index = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+        return sorted[std::min(sorted.size(), std::max<size_t>(index, 1)) - 1];
+    };
+    result.p50 = rank(0.50);
+    result.p90 = rank(0.90);
+    result.p99 = rank(0.99);
+    result.max = sorted.back();
+    return result;
+}
+
+RequestScheduler::RequestScheduler() : RequestScheduler(Config()) {
+}
+
+RequestScheduler::RequestScheduler(const Config& config)
+    : config(config),
+      bucket(config.requestsPerSecond, config.burst),
+      breaker(config.failureThreshold, config.openDuration),
+      random(std::random_device()()) {
+}
+
+RequestScheduler::Admission RequestScheduler::admit(SchedulerClock::time_point now, std::chrono::milliseconds& wait) {
+    CircuitBreaker::State state = breaker.getState(now);
+    if (state == CircuitBreaker::State::OPEN) {
+        return Admission::FAIL_FAST;
+    }
+    if (state == CircuitBreaker::State::HALF_OPEN && breaker.isProbing()) {
+        return Admission::HOLD;
+    }
+
+    // Check the rate limit before claiming the probe, so a WAIT leaves it free
+    wait = bucket.timeUntilAvailable(now);
+    if (wait.count() > 0) {
+        return Admission::WAIT;
+    }
+    if (!breaker.allowRequest(now)) {
+        return Admission::HOLD;
+    }
+    bucket.tryAcquire(now);
+    return Admission::SEND;
+}
+
+bool RequestScheduler::onFinished(SchedulerClock::time_point now, Outcome outcome,
+                                  std::chrono::milliseconds elapsed, int attempt,
+                                  std::chrono::milliseconds retryAfter, std::chrono::milliseconds& retryDelay) {
+    latency.record(elapsed);
+
+    switch (outcome) {
+    case Outcome::SUCCESS:
+    case Outcome::CLIENT_ERROR:
+        breaker.recordSuccess();
+        return false;
+    case Outcome::RATE_LIMITED:
+        // The endpoint is alive, just busy; a probe that got this far counts as success
+        breaker.recordSuccess();
+        break;
+    case Outcome::SERVER_ERROR:
+    case Outcome::NETWORK_ERROR:
+        breaker.recordFailure(now);
+        break;
+    }
+
+    if (outcome == Outcome::NETWORK_ERROR || attempt >= config.maxRetries) return false;
+    if (breaker.getState(now) != CircuitBreaker::State::CLOSED) return false;
+
+    retryDelay = std::max(backoffDelay(attempt), retryAfter);
+    return true;
+}
+
+std::chrono::milliseconds RequestScheduler::backoffDelay(int attempt) {
+    int64_t ceiling = config.baseBackoff.count();
+    for (int i = 0; i < attempt && ceiling < config.maxBackoff.count(); ++i) {
+        ceiling *= 2;
+    }
+    ceiling = std::min<int64_t>(ceiling, config.maxBackoff.count());
+    std::uniform_int_distribution<int64_t> jitter(0, std::max<int64_t>(ceiling, 0));
+    return std::chrono::milliseconds(jitter(random));
+}
+
+void RequestScheduler::setConfig(const Config& newConfig) {
+    config = newConfig;
+    bucket.configure(config.requestsPerSecond, config.burst);
+    breaker.configure(config.failureThreshold, config.openDuration);
+}
+
+} // namespace qlink
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace qlink {
+
+using SchedulerClock = std::chrono::steady_clock;
+
+/**
+ * Classic token bucket: holds up to capacity tokens and regains
+ * ratePerSecond of them every second. Each request spends one.
+ */
+class TokenBucket {
+public:
+    TokenBucket(double ratePerSecond, double capacity);
+
+    /**
+     * Spend a token if one is available
+     */
+    bool tryAcquire(SchedulerClock::time_point now);
+
+    /**
+     * How long until tryAcquire() can succeed
+     */
+    std::chrono::milliseconds timeUntilAvailable(SchedulerClock::time_point now);
+
+    void configure(double ratePerSecond, double capacity);
+
+private:
+    void refill(SchedulerClock::time_point now);
+
+    double ratePerSecond;
+    double capacity;
+    double tokens;
+    SchedulerClock::time_point lastRefill;
+    bool started = false;
+};
+
+/**
+ * Stops traffic to an endpoint that keeps failing.
+ *
+ * Closed: requests flow, consecutive failures are counted. Once they reach
+ * the threshold the breaker opens and requests fail fast. After the open
+ * period it is half-open: one probe request goes through, and its outcome
+ * closes the breaker again or reopens it for another period.
+ */
+class CircuitBreaker {
+public:
+    enum class State { CLOSED, OPEN, HALF_OPEN };
+
+    CircuitBreaker(int failureThreshold, std::chrono::milliseconds openDuration);
+
+    State getState(SchedulerClock::time_point now);
+
+    /**
+     * Whether a request may go out now; in the half-open state only the
+     * first caller gets through until the probe reports back
+     */
+    bool allowRequest(SchedulerClock::time_point now);
+
+    bool isProbing() const { return probing; }
+
+    void recordSuccess();
+    void recordFailure(SchedulerClock::time_point now);
+
+    /**
+     * The probe was abandoned; let another request try
+     */
+    void releaseProbe() { probing = false; }
+
+    void configure(int failureThreshold, std::chrono::milliseconds openDuration);
+
+private:
+    int failureThreshold;
+    std::chrono::milliseconds openDuration;
+    int consecutiveFailures = 0;
+    bool open = false;
+    bool probing = false;
+    SchedulerClock::time_point openedAt;
+};
+
+/**
+ * Request latency over a sliding window of recent samples
+ */
+class LatencyTracker {
+public:
+    struct Percentiles {
+        size_t samples = 0;
+        double p50 = 0.0; // Milliseconds
+        double p90 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    explicit LatencyTracker(size_t window = 256);
+
+    void record(std::chrono::milliseconds latency);
+    Percentiles getPercentiles() const;
+
+private:
+    std::vector<double> samples; // Ring buffer
+    size_t window;
+    size_t next = 0;
+};
+
+/**
+ * Decides when AI requests may go out and whether failed ones are retried.
+ *
+ * Combines a token bucket rate limit, retries with jittered exponential
+ * backoff for rate-limited (429) and server error (5xx) replies, and a
+ * circuit breaker that fails requests fast while the endpoint is down.
+ * Contains no I/O; the caller reports what happened.
+ */
+class RequestScheduler {
+public:
+    struct Config {
+        double requestsPerSecond = 5.0;
+        int burst = 10;
+        int maxRetries = 3;
+        std::chrono::milliseconds baseBackoff{500};
+        std::chrono::milliseconds maxBackoff{8000};
+        int failureThreshold = 5;
+        std::chrono::milliseconds openDuration{30000};
+    };
+
+    enum class Admission {
+        SEND,      // Go ahead; a rate limit token has been spent
+        WAIT,      // Try again after the returned delay
+        HOLD,      // Wait for the circuit breaker's probe to report back
+        FAIL_FAST  // The endpoint is considered down
+    };
+
+    enum class Outcome {
+        SUCCESS,
+        RATE_LIMITED, // 429: retried, but the endpoint is healthy
+        SERVER_ERROR, // 5xx: retried, counts against the endpoint
+        CLIENT_ERROR, // Other HTTP errors: the request itself is wrong
+        NETWORK_ERROR // Timeout or no connection: counts against the endpoint
+    };
+
+    RequestScheduler();
+    explicit RequestScheduler(const Config& config);
+
+    /**
+     * @param wait set to the delay for WAIT
+     */
+    Admission admit(SchedulerClock::time_point now, std::chrono::milliseconds& wait);
+
+    /**
+     * Report a finished attempt
+     * @param attempt retries already made for this request
+     * @param retryAfter the server's Retry-After hint, zero if none
+     * @param retryDelay set to the delay before retrying
+     * @return whether to retry
+     */
+    bool onFinished(SchedulerClock::time_point now, Outcome outcome, std::chrono::milliseconds latency,
+                    int attempt, std::chrono::milliseconds retryAfter, std::chrono::milliseconds& retryDelay);
+
+    /**
+     * Report an attempt that was aborted before it finished
+     */
+    void onAbandoned() { breaker.releaseProbe(); }
+
+    /**
+     * Full-jitter backoff: uniform in [0, min(maxBackoff, baseBackoff * 2^attempt)]
+     */
+    std::chrono::milliseconds backoffDelay(int attempt);
+
+    void setConfig(const Config& newConfig);
+    const Config& getConfig() const { return config; }
+
+    CircuitBreaker::State getCircuitState(SchedulerClock::time_point now) { return breaker.getState(now); }
+    LatencyTracker::Percentiles getLatency() const { return latency.getPercentiles(); }
+
+    /**
+     * Make the backoff jitter reproducible, for tests
+     */
+    void seed(uint32_t value) { random.seed(value); }
+
+private:
+    Config config;
+    TokenBucket bucket;
+    CircuitBreaker breaker;
+    LatencyTracker latency;
+    std::mt19937 random;
+};
+
+} // namespace qlink
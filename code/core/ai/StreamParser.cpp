@@ -0,0 +1,83 @@
+#include "StreamParser.h"
+#include <QByteArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace qlink {
+
+StreamParser::StreamParser(TokenCallback onToken) : onToken(std::move(onToken)) {
+}
+
+void StreamParser::feed(const char* data, size_t size) {
+    pending.append(data, size);
+
+    size_t start = 0;
+    size_t newline;
+    while ((newline = pending.find('\n', start)) != std::string::npos) {
+        size_t end = newline;
+        if (end > start && pending[end - 1] == '\r') --end;
+        parseLine(pending.substr(start, end - start));
+        start = newline + 1;
+    }
+    pending.erase(0, start);
+}
+
+void StreamParser::finish() {
+    if (!pending.empty()) {
+        std::string line;
+        line.swap(pending);
+        parseLine(line);
+    }
+}
+
+void StreamParser::parseLine(const std::string& line) {
+    if (line.empty()) return;
+
+    // Server-sent events: only data lines carry payload; "event:", "id:" and comments are skipped
+    if (line[0] == '{') {
+        parseEvent(line);
+    } else if (line.compare(0, 5, "data:") == 0) {
+        size_t payload = line.find_first_not_of(' ', 5);
+        if (payload == std::string::npos) return;
+        if (line.compare(payload, std::string::npos, "[DONE]") == 0) {
+            complete = true;
+        } else {
+            parseEvent(line.substr(payload));
+        }
+    }
+}
+
+void StreamParser::parseEvent(const std::string& json) {
+    QJsonObject event = QJsonDocument::fromJson(QByteArray(json.data(), static_cast<int>(json.size()))).object();
+    if (event.isEmpty()) return;
+
+    QString fragment;
+    if (event.contains("event_type")) {
+        // Cohere v1: {"event_type": "text-generation", "text": "..."}
+        QString type = event["event_type"].toString();
+        if (type == "text-generation") {
+            fragment = event["text"].toString();
+        } else if (type == "stream-end") {
+            complete = true;
+        }
+    } else {
+        // Cohere v2: {"type": "content-delta", "delta": {"message": {"content": {"text": "..."}}}}
+        QString type = event["type"].toString();
+        if (type == "content-delta") {
+            fragment = event["delta"].toObject()["message"].toObject()["content"].toObject()["text"].toString();
+        } else if (type == "message-end") {
+            complete = true;
+        }
+    }
+
+    if (!fragment.isEmpty()) {
+        std::string token = fragment.toStdString();
+        text += token;
+        ++tokenCount;
+        if (onToken) {
+            onToken(token);
+        }
+    }
+}
+
+} // namespace qlink
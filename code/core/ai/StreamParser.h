@@ -0,0 +1,57 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace qlink {
+
+/**
+ * Incremental parser for streamed chat completions.
+ *
+ * Accepts the Cohere v1 stream (one JSON event per line) as well as
+ * server-sent events ("data: {...}" lines, as used by Cohere v2), fed in
+ * whatever pieces the network delivers. Each text fragment is passed to
+ * the token callback as soon as its line is complete.
+ */
+class StreamParser {
+public:
+    using TokenCallback = std::function<void(const std::string&)>;
+
+    explicit StreamParser(TokenCallback onToken);
+
+    /**
+     * Parse the next piece of the body; a trailing partial line is kept
+     * until the rest arrives
+     */
+    void feed(const char* data, size_t size);
+    void feed(const std::string& data) { feed(data.data(), data.size()); }
+
+    /**
+     * Parse a final line that was not terminated by a newline
+     */
+    void finish();
+
+    /**
+     * All text received so far
+     */
+    const std::string& getText() const { return text; }
+
+    /**
+     * Whether the stream's end event has been seen
+     */
+    bool isComplete() const { return complete; }
+
+    size_t getTokenCount() const { return tokenCount; }
+
+private:
+    void parseLine(const std::string& line);
+    void parseEvent(const std::string& json);
+
+    TokenCallback onToken;
+    std::string pending; // Unterminated tail of the last piece
+    std::string text;
+    bool complete = false;
+    size_t tokenCount = 0;
+};
+
+} // namespace qlink
@@ -0,0 +1,180 @@
+#include "SuggestionCache.h"
+#include "ILinkPredictor.h"
+#include "../model/MentalModel.h"
+#include <functional>
+
+namespace qlink {
+
+size_t SuggestionCache::KeyHash::operator()(const Key& key) const {
+    size_t seed = std::hash<uint64_t>()(key.modelVersion);
+    auto combine = [&seed](size_t value) {
+        seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    };
+    combine(std::hash<std::string>()(key.algorithm));
+    combine(std::hash<int>()(key.maxSuggestions));
+    combine(std::hash<double>()(key.threshold));
+    return seed;
+}
+
+SuggestionCache::SuggestionCache(size_t capacity)
+    : capacity(capacity > 0 ? capacity : 1) {
+}
+
+std::vector<LinkSuggestion> SuggestionCache::getOrCompute(ILinkPredictor& predictor, const MentalModel& model,
+                                                          int maxSuggestions, double threshold) {
+    std::vector<LinkSuggestion> result;
+    if (find(model, predictor.getAlgorithmName(), maxSuggestions, threshold, result)) {
+        return result;
+    }
+
+    for (auto& suggestion : predictor.predictLinks(model, maxSuggestions)) {
+        if (suggestion.confidence >= threshold) {
+            result.push_back(std::move(suggestion));
+        }
+    }
+
+    store(model, predictor.getAlgorithmName(), maxSuggestions, threshold, result,
+          predictor.isNeighborhoodLocal());
+    return result;
+}
+
+bool SuggestionCache::find(const MentalModel& model, const std::string& algorithm, int maxSuggestions,
+                           double threshold, std::vector<LinkSuggestion>& suggestions) {
+    auto it = index.find(Key{model.getVersion(), algorithm, maxSuggestions, threshold});
+    if (it == index.end()) {
+        ++misses;
+        return false;
+    }
+
+    // Move to the front of the LRU list
+    entries.splice(entries.begin(), entries, it->second);
+    suggestions = it->second->suggestions;
+    ++hits;
+    return true;
+}
+
+void SuggestionCache::store(const MentalModel& model, const std::string& algorithm, int maxSuggestions,
+                            double threshold, const std::vector<LinkSuggestion>& suggestions,
+                            bool neighborhoodLocal) {
+    if (supportVersion != model.getVersion()) {
+        rebuildSupport(model);
+    }
+
+    Key key{model.getVersion(), algorithm, maxSuggestions, threshold};
+    auto existing = index.find(key);
+    if (existing != index.end()) {
+        entries.erase(existing->second);
+        index.erase(existing);
+    }
+
+    entries.push_front(Entry{key, suggestions, neighborhoodLocal});
+    index[key] = entries.begin();
+    evictToCapacity();
+}
+
+void SuggestionCache::onModelChanged(const ModelChangeEvent& event, const MentalModel& model) {
+    uint64_t currentVersion = model.getVersion();
+    uint64_t previousVersion = currentVersion - 1;
+
+    // Entries from older versions missed an event somewhere, they can't be rebased
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->key.modelVersion != previousVersion) {
+            index.erase(it->key);
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (entries.empty() || supportVersion != previousVersion) {
+        clear();
+        return;
+    }
+
+    switch (event.type) {
+        case ChangeType::CONCEPT_MODIFIED:
+            // Names, descriptions and positions don't feed into any score
+            break;
+        case ChangeType::CONCEPT_ADDED:
+            // A new concept is isolated, so it's outside every support set
+            dropWhere(false, true);
+            break;
+        case ChangeType::CONCEPT_REMOVED:
+            dropWhere(support.count(event.entityId) > 0, true);
+            break;
+        case ChangeType::RELATIONSHIP_ADDED: {
+            const Relationship* relationship = model.getRelationship(event.entityId);
+            bool touchesSupport = !relationship ||
+                                  support.count(relationship->getSourceConceptId()) > 0 ||
+                                  support.count(relationship->getTargetConceptId()) > 0;
+            dropWhere(touchesSupport, true);
+            if (!touchesSupport) {
+                // Both endpoints were isolated; from now on they are part of the support
+                support.insert(relationship->getSourceConceptId());
+                support.insert(relationship->getTargetConceptId());
+            }
+            break;
+        }
+        case ChangeType::RELATIONSHIP_REMOVED:
+        case ChangeType::RELATIONSHIP_MODIFIED:
+        case ChangeType::MODEL_CLEARED:
+        default:
+            // Every existing relationship's endpoints are in the support set
+            dropWhere(true, true);
+            break;
+    }
+
+    if (entries.empty()) {
+        clear();
+        return;
+    }
+
+    // Rebase the survivors onto the new version
+    index.clear();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        it->key.modelVersion = currentVersion;
+        index[it->key] = it;
+    }
+    supportVersion = currentVersion;
+}
+
+void SuggestionCache::clear() {
+    entries.clear();
+    index.clear();
+    support.clear();
+    supportVersion = UINT64_MAX;
+}
+
+void SuggestionCache::setCapacity(size_t newCapacity) {
+    capacity = newCapacity > 0 ? newCapacity : 1;
+    evictToCapacity();
+}
+
+void SuggestionCache::rebuildSupport(const MentalModel& model) {
+    support.clear();
+    for (const auto& relationship : model.getRelationships()) {
+        support.insert(relationship->getSourceConceptId());
+        support.insert(relationship->getTargetConceptId());
+    }
+    supportVersion = model.getVersion();
+}
+
+void SuggestionCache::evictToCapacity() {
+    while (entries.size() > capacity) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
+
+void SuggestionCache::dropWhere(bool dropLocal, bool dropNonLocal) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        bool drop = it->neighborhoodLocal ? dropLocal : dropNonLocal;
+        if (drop) {
+            index.erase(it->key);
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace qlink
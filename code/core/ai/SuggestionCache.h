@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "../common/DataStructures.h"
+
+namespace qlink {
+
+class MentalModel;
+class ILinkPredictor;
+
+/**
+ * Memoizes link prediction results (keyed by model version, algorithm,
+ * maxSuggestions and confidence threshold) in a bounded LRU.
+ *
+ * Neighbourhood-local results only depend on concepts that had at least one
+ * relationship when they were computed (the support set). Edits that stay
+ * outside that set - adding a concept, or linking two isolated concepts -
+ * cannot change those results, so such entries are carried over to the new
+ * model version instead of being dropped.
+ */
+class SuggestionCache {
+public:
+    explicit SuggestionCache(size_t capacity = 32);
+
+    /**
+     * Return cached suggestions if present, otherwise run the predictor,
+     * filter by threshold and cache the result
+     */
+    std::vector<LinkSuggestion> getOrCompute(ILinkPredictor& predictor, const MentalModel& model,
+                                             int maxSuggestions, double threshold);
+
+    /**
+     * Look up a result computed against the model's current version
+     * @return true and fills suggestions on a hit
+     */
+    bool find(const MentalModel& model, const std::string& algorithm, int maxSuggestions,
+              double threshold, std::vector<LinkSuggestion>& suggestions);
+
+    /**
+     * Store a result computed against the model's current version
+     * @param neighborhoodLocal see ILinkPredictor::isNeighborhoodLocal()
+     */
+    void store(const MentalModel& model, const std::string& algorithm, int maxSuggestions,
+               double threshold, const std::vector<LinkSuggestion>& suggestions,
+               bool neighborhoodLocal = true);
+
+    /**
+     * Drop the entries a model change can affect and rebase the rest onto
+     * the new model version. Call after the model has applied the change.
+     */
+    void onModelChanged(const ModelChangeEvent& event, const MentalModel& model);
+
+    void clear();
+    size_t size() const { return entries.size(); }
+    size_t getCapacity() const { return capacity; }
+    void setCapacity(size_t newCapacity);
+    size_t getHitCount() const { return hits; }
+    size_t getMissCount() const { return misses; }
+
+private:
+    struct Key {
+        uint64_t modelVersion;
+        std::string algorithm;
+        int maxSuggestions;
+        double threshold;
+
+        bool operator==(const Key& other) const {
+            return modelVersion == other.modelVersion && maxSuggestions == other.maxSuggestions &&
+                   threshold == other.threshold && algorithm == other.algorithm;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        Key key;
+        std::vector<LinkSuggestion> suggestions;
+        bool neighborhoodLocal;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    void rebuildSupport(const MentalModel& model);
+    void evictToCapacity();
+    void dropWhere(bool dropLocal, bool dropNonLocal);
+
+    size_t capacity;
+    EntryList entries; // Most recently used first
+    std::unordered_map<Key, EntryList::iterator, KeyHash> index;
+
+    // Concepts with at least one relationship as of supportVersion
+    std::unordered_set<std::string> support;
+    uint64_t supportVersion = UINT64_MAX;
+
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+} // namespace qlink
@@ -0,0 +1,250 @@
+#include "SuggestionJob.h"
+#include "NeighborhoodScorer.h"
+#include <QThreadPool>
+#include <QTimer>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace qlink {
+
+namespace {
+
+// Source vertices claimed per step; small enough for fine-grained progress
+// and quick cancellation, large enough to keep the atomic off the hot path
+constexpr int VERTEX_CHUNK = 64;
+
+/**
+ * Preferential attachment scores every unconnected pair, not just those
+ * sharing a neighbour, so it doesn't fit NeighborhoodScorer. It reuses the
+ * scorer's views for degrees, weights and direction.
+ */
+template <bool Weighted, bool Directed>
+class PreferentialAttachmentScorer {
+public:
+    using View = NeighborhoodView<Weighted, Directed>;
+
+    explicit PreferentialAttachmentScorer(const GraphSnapshot& graph)
+        : view(graph), adjacentMark(graph.vertexCount(), -1) {}
+
+    void scoreSource(int source, TopKPairs& top) {
+        view.forEachAdjacent(source, [this, source](int neighbor) {
+            adjacentMark[neighbor] = source;
+        });
+        // Preferential attachment score = (degree(u) + 1) * (degree(v) + 1)
+        double sourceDegree = view.sourceDegree(source);
+        for (int target = View::ordered ? 0 : source + 1; target < view.vertexCount(); ++target) {
+            if (target == source || adjacentMark[target] == source) continue;
+            double score = (sourceDegree + 1) * (view.targetDegree(target) + 1);
+            if (score > 0.0) {
+                top.offer(score, source, target);
+            }
+        }
+    }
+
+private:
+    View view;
+    std::vector<int> adjacentMark;
+};
+
+} // namespace
+
+struct SuggestionJob::SharedState {
+    std::shared_ptr<const GraphSnapshot> snapshot;
+    LinkPredictorFactory::AlgorithmType algorithm;
+    int maxSuggestions;
+    bool weighted;
+    bool directed;
+
+    std::atomic<int> nextVertex{0};
+    std::atomic<int> processedVertices{0};
+    std::atomic<int> activeWorkers{0};
+    std::atomic<bool> cancelRequested{false};
+
+    mutable std::mutex resultsMutex;
+    TopKPairs best;
+    uint64_t revision = 0; // Bumped whenever best changes
+
+    SharedState(std::shared_ptr<const GraphSnapshot> graph, LinkPredictorFactory::AlgorithmType type, int k,
+                bool weighted, bool directed)
+        : snapshot(std::move(graph)), algorithm(type), maxSuggestions(k), weighted(weighted), directed(directed),
+          best(k) {}
+
+    void runWorker() {
+        switch (algorithm) {
+            case LinkPredictorFactory::AlgorithmType::COMMON_NEIGHBORS:
+                scoreMetric<metrics::CommonNeighbors>();
+                break;
+            case LinkPredictorFactory::AlgorithmType::JACCARD_COEFFICIENT:
+                scoreMetric<metrics::Jaccard>();
+                break;
+            case LinkPredictorFactory::AlgorithmType::ADAMIC_ADAR:
+                scoreMetric<metrics::AdamicAdar>();
+                break;
+            case LinkPredictorFactory::AlgorithmType::RESOURCE_ALLOCATION:
+                scoreMetric<metrics::ResourceAllocation>();
+                break;
+            case LinkPredictorFactory::AlgorithmType::SALTON_INDEX:
+                scoreMetric<metrics::Salton>();
+                break;
+            case LinkPredictorFactory::AlgorithmType::SORENSEN_INDEX:
+                scoreMetric<metrics::Sorensen>();
+                break;
+            case LinkPredictorFactory::AlgorithmType::HUB_PROMOTED_INDEX:
+                scoreMetric<metrics::HubPromoted>();
+                break;
+            case LinkPredictorFactory::AlgorithmType::PREFERENTIAL_ATTACHMENT:
+            default:
+                if (weighted && directed) {
+                    scoreChunks(PreferentialAttachmentScorer<true, true>(*snapshot));
+                } else if (weighted) {
+                    scoreChunks(PreferentialAttachmentScorer<true, false>(*snapshot));
+                } else if (directed) {
+                    scoreChunks(PreferentialAttachmentScorer<false, true>(*snapshot));
+                } else {
+                    scoreChunks(PreferentialAttachmentScorer<false, false>(*snapshot));
+                }
+                break;
+        }
+        activeWorkers.fetch_sub(1);
+    }
+
+    template <typename Metric>
+    void scoreMetric() {
+        withNeighborhoodScorer<Metric>(*snapshot, weighted, directed,
+                                       [this](auto& scorer) { scoreChunks(scorer); });
+    }
+
+    template <typename Scorer>
+    void scoreChunks(Scorer&& scorer) {
+        int vertexCount = snapshot->vertexCount();
+
+        while (!cancelRequested.load(std::memory_order_relaxed)) {
+            int begin = nextVertex.fetch_add(VERTEX_CHUNK);
+            if (begin >= vertexCount) break;
+            int end = std::min(vertexCount, begin + VERTEX_CHUNK);
+
+            TopKPairs chunkBest(maxSuggestions);
+            for (int source = begin; source < end; ++source) {
+                scorer.scoreSource(source, chunkBest);
+            }
+
+            if (!chunkBest.empty()) {
+                std::lock_guard<std::mutex> lock(resultsMutex);
+                if (best.merge(chunkBest)) {
+                    ++revision;
+                }
+            }
+            processedVertices.fetch_add(end - begin);
+        }
+    }
+};
+
+SuggestionJob::SuggestionJob(std::shared_ptr<const GraphSnapshot> snapshot,
+                             LinkPredictorFactory::AlgorithmType algorithm,
+                             int maxSuggestions, const LinkPredictionOptions& options, QObject* parent)
+    : QObject(parent),
+      state(std::make_shared<SharedState>(std::move(snapshot), algorithm, maxSuggestions,
+                                          options.weighted, options.directed)),
+      algorithm(algorithm),
+      pollTimer(new QTimer(this)),
+      started(false),
+      lastReportedProgress(-1),
+      lastReportedRevision(0) {
+    pollTimer->setInterval(POLL_INTERVAL_MS);
+    connect(pollTimer, &QTimer::timeout, this, &SuggestionJob::poll);
+}
+
+SuggestionJob::~SuggestionJob() {
+    // Workers share the state, so they can finish after we are gone
+    state->cancelRequested = true;
+}
+
+void SuggestionJob::start(QThreadPool* pool) {
+    if (started) return;
+    started = true;
+
+    if (!pool) {
+        pool = QThreadPool::globalInstance();
+    }
+
+    int vertexCount = state->snapshot->vertexCount();
+    int chunks = (vertexCount + VERTEX_CHUNK - 1) / VERTEX_CHUNK;
+    int workers = std::max(1, std::min(pool->maxThreadCount(), chunks));
+
+    state->activeWorkers = workers;
+    auto shared = state;
+    for (int i = 0; i < workers; ++i) {
+        pool->start([shared]() { shared->runWorker(); });
+    }
+    pollTimer->start();
+}
+
+void SuggestionJob::cancel() {
+    state->cancelRequested = true;
+}
+
+bool SuggestionJob::isRunning() const {
+    return started && state->activeWorkers.load() > 0;
+}
+
+bool SuggestionJob::isCancelled() const {
+    return state->cancelRequested.load();
+}
+
+int SuggestionJob::getProcessedVertices() const {
+    return state->processedVertices.load();
+}
+
+int SuggestionJob::getTotalVertices() const {
+    return state->snapshot->vertexCount();
+}
+
+std::string SuggestionJob::getAlgorithmName() const {
+    return LinkPredictorFactory::getAlgorithmName(algorithm);
+}
+
+uint64_t SuggestionJob::getModelVersion() const {
+    return state->snapshot->getModelVersion();
+}
+
+std::vector<LinkSuggestion> SuggestionJob::currentResults() const {
+    TopKPairs best;
+    {
+        std::lock_guard<std::mutex> lock(state->resultsMutex);
+        best = state->best;
+    }
+    return best.toSuggestions(*state->snapshot, getAlgorithmName());
+}
+
+void SuggestionJob::poll() {
+    bool done = state->activeWorkers.load() == 0;
+
+    int processed = state->processedVertices.load();
+    if (processed != lastReportedProgress) {
+        lastReportedProgress = processed;
+        emit progressChanged(processed, getTotalVertices());
+    }
+
+    if (done) {
+        pollTimer->stop();
+        if (state->cancelRequested) {
+            emit cancelled();
+        } else {
+            emit finished(currentResults());
+        }
+        return;
+    }
+
+    uint64_t revision;
+    {
+        std::lock_guard<std::mutex> lock(state->resultsMutex);
+        revision = state->revision;
+    }
+    if (revision != lastReportedRevision) {
+        lastReportedRevision = revision;
+        emit partialResults(currentResults());
+    }
+}
+
+} // namespace qlink
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QObject>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ILinkPredictor.h"
+#include "GraphSnapshot.h"
+#include "../common/DataStructures.h"
+
+class QThreadPool;
+class QTimer;
+
+namespace qlink {
+
+/**
+ * Runs one link prediction algorithm on a worker pool against an immutable
+ * GraphSnapshot. Source vertices are handed out to workers in small chunks,
+ * so the job reports real progress, stops promptly when cancelled, and
+ * streams the best suggestions found so far.
+ *
+ * Workers never emit signals themselves; the job polls their shared state
+ * from its own (UI) thread and only emits when something changed, keeping
+ * the event loop responsive.
+ */
+class SuggestionJob : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @param snapshot Graph to score; relationship type filtering happens when it is built
+     * @param options Only weighted and directed are used
+     */
+    SuggestionJob(std::shared_ptr<const GraphSnapshot> snapshot,
+                  LinkPredictorFactory::AlgorithmType algorithm,
+                  int maxSuggestions = 10, const LinkPredictionOptions& options = {},
+                  QObject* parent = nullptr);
+    ~SuggestionJob();
+
+    /**
+     * Start scoring on the given pool (the global pool if null)
+     */
+    void start(QThreadPool* pool = nullptr);
+
+    /**
+     * Ask workers to stop; cancelled() is emitted once they have
+     */
+    void cancel();
+
+    bool isRunning() const;
+    bool isCancelled() const;
+    int getProcessedVertices() const;
+    int getTotalVertices() const;
+    LinkPredictorFactory::AlgorithmType getAlgorithm() const { return algorithm; }
+    std::string getAlgorithmName() const;
+    uint64_t getModelVersion() const;
+
+    /**
+     * Best suggestions found so far, ranked by confidence
+     */
+    std::vector<LinkSuggestion> currentResults() const;
+
+signals:
+    void progressChanged(int processedVertices, int totalVertices);
+    void partialResults(const std::vector<LinkSuggestion>& suggestions);
+    void finished(const std::vector<LinkSuggestion>& suggestions);
+    void cancelled();
+
+private slots:
+    void poll();
+
+private:
+    struct SharedState;
+
+    std::shared_ptr<SharedState> state;
+    LinkPredictorFactory::AlgorithmType algorithm;
+    QTimer* pollTimer;
+    bool started;
+    int lastReportedProgress;
+    uint64_t lastReportedRevision;
+
+    // Poll often enough for smooth progress without flooding the UI thread
+    static constexpr int POLL_INTERVAL_MS = 33;
+};
+
+} // namespace qlink
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace qlink {
+
+constexpr uint64_t FNV1A_SEED = 14695981039346656037ULL;
+
+/**
+ * 64-bit FNV-1a; pass the previous result as hash to continue over more bytes
+ */
+inline uint64_t fnv1a(const void* data, size_t length, uint64_t hash = FNV1A_SEED) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * Continue hash over one field of a record, length first, so that adjacent
+ * fields cannot run together
+ */
+inline uint64_t fnv1aField(std::string_view text, uint64_t hash = FNV1A_SEED) {
+    uint64_t length = text.size();
+    hash = fnv1a(&length, sizeof(length), hash);
+    return fnv1a(text.data(), text.size(), hash);
+}
+
+} // namespace qlink
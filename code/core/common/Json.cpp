@@ -0,0 +1,412 @@
+#include "Json.h"
+#include "QLinkException.h"
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+
+#if !(defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L)
+#include <iomanip>
+#include <locale>
+#include <sstream>
+#endif
+
+namespace qlink {
+
+namespace {
+
+constexpr int MAX_DEPTH = 64;
+
+bool isWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+} // namespace
+
+void appendUtf8(std::string& out, uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+void appendNumber(std::string& out, double value) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+#else
+    std::ostringstream stream;
+    stream.imbue(std::locale::classic());
+    stream << std::setprecision(17) << value;
+    out += stream.str();
+#endif
+}
+
+void JsonWriter::beginObject() {
+    open('{');
+}
+
+void JsonWriter::endObject() {
+    --depth;
+    out += '}';
+}
+
+void JsonWriter::beginArray() {
+    open('[');
+}
+
+void JsonWriter::endArray() {
+    --depth;
+    out += ']';
+}
+
+void JsonWriter::key(std::string_view name) {
+    beginValue();
+    out += '"';
+    appendEscaped(out, name);
+    out += "\":";
+    afterKey = true;
+}
+
+void JsonWriter::string(std::string_view text) {
+    beginValue();
+    out += '"';
+    appendEscaped(out, text);
+    out += '"';
+}
+
+void JsonWriter::number(double value) {
+    beginValue();
+    if (!std::isfinite(value)) {
+        out += "null"; // JSON has no infinities or NaN
+        return;
+    }
+    appendNumber(out, value);
+}
+
+void JsonWriter::boolean(bool value) {
+    beginValue();
+    out += value ? "true" : "false";
+}
+
+void JsonWriter::null() {
+    beginValue();
+    out += "null";
+}
+
+void JsonWriter::appendEscaped(std::string& out, std::string_view text) {
+    size_t plain = 0; // Start of the run that needs no escaping
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out.append(text.data() + plain, i - plain);
+        plain = i + 1;
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default: {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\u%04x", c);
+                out += code;
+            }
+        }
+    }
+    out.append(text.data() + plain, text.size() - plain);
+}
+
+void JsonWriter::beginValue() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (depth == 0) return;
+    uint64_t bit = uint64_t(1) << (depth - 1);
+    if (hasMembers & bit) {
+        out += ',';
+    } else {
+        hasMembers |= bit;
+    }
+}
+
+void JsonWriter::open(char bracket) {
+    if (depth == MAX_DEPTH) {
+        throw QLinkException("JSON nesting deeper than 64 levels");
+    }
+    beginValue();
+    out += bracket;
+    hasMembers &= ~(uint64_t(1) << depth);
+    ++depth;
+}
+
+JsonReader::Type JsonReader::peek() {
+    skipWhitespace();
+    if (position >= input.size()) fail("unexpected end of input");
+    switch (input[position]) {
+        case '{': return Type::Object;
+        case '[': return Type::Array;
+        case '"': return Type::String;
+        case 't':
+        case 'f': return Type::Bool;
+        case 'n': return Type::Null;
+        default: return Type::Number;
+    }
+}
+
+void JsonReader::beginObject() {
+    open('{');
+}
+
+bool JsonReader::nextMember(std::string_view& key) {
+    if (!nextInScope('}')) return false;
+    skipWhitespace();
+    key = readString(keyScratch);
+    skipWhitespace();
+    expect(':');
+    return true;
+}
+
+void JsonReader::beginArray() {
+    open('[');
+}
+
+bool JsonReader::nextElement() {
+    return nextInScope(']');
+}
+
+std::string_view JsonReader::readString() {
+    skipWhitespace();
+    return readString(scratch);
+}
+
+double JsonReader::readNumber() {
+    skipWhitespace();
+    size_t start = position;
+    auto digits = [this]() {
+        size_t first = position;
+        while (position < input.size() && isDigit(input[position])) ++position;
+        return position - first;
+    };
+
+    // JSON grammar: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    if (position < input.size() && input[position] == '-') ++position;
+    size_t intStart = position;
+    size_t intDigits = digits();
+    if (intDigits == 0) fail("expected a value");
+    if (intDigits > 1 && input[intStart] == '0') fail("leading zero in number");
+    if (position < input.size() && input[position] == '.') {
+        ++position;
+        if (digits() == 0) fail("expected digits after the decimal point");
+    }
+    if (position < input.size() && (input[position] == 'e' || input[position] == 'E')) {
+        ++position;
+        if (position < input.size() && (input[position] == '+' || input[position] == '-')) ++position;
+        if (digits() == 0) fail("expected digits in the exponent");
+    }
+
+    double value = 0.0;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto result = std::from_chars(input.data() + start, input.data() + position, value);
+    if (result.ec == std::errc::result_out_of_range) {
+        // Out of range: keep the sign and direction, like strtod
+        bool negative = input[start] == '-';
+        bool tiny = input.substr(start, position - start).find("e-") != std::string_view::npos ||
+                    input.substr(start, position - start).find("E-") != std::string_view::npos;
+        value = tiny ? 0.0 : HUGE_VAL;
+        if (negative) value = -value;
+    } else if (result.ec != std::errc()) {
+        fail("invalid number");
+    }
+#else
+    std::istringstream stream(std::string(input.substr(start, position - start)));
+    stream.imbue(std::locale::classic());
+    stream >> value;
+#endif
+    return value;
+}
+
+bool JsonReader::readBool() {
+    skipWhitespace();
+    if (consumeLiteral("true")) return true;
+    if (consumeLiteral("false")) return false;
+    fail("expected true or false");
+}
+
+void JsonReader::readNull() {
+    skipWhitespace();
+    if (!consumeLiteral("null")) fail("expected null");
+}
+
+void JsonReader::skipValue() {
+    std::string_view key;
+    switch (peek()) {
+        case Type::Object:
+            beginObject();
+            while (nextMember(key)) skipValue();
+            break;
+        case Type::Array:
+            beginArray();
+            while (nextElement()) skipValue();
+            break;
+        case Type::String:
+            readString();
+            break;
+        case Type::Number:
+            readNumber();
+            break;
+        case Type::Bool:
+            readBool();
+            break;
+        case Type::Null:
+            readNull();
+            break;
+    }
+}
+
+void JsonReader::finish() {
+    skipWhitespace();
+    if (position != input.size()) fail("garbage at the end of the document");
+}
+
+void JsonReader::open(char bracket) {
+    skipWhitespace();
+    expect(bracket);
+    if (depth == MAX_DEPTH) fail("nesting deeper than 64 levels");
+    hasMembers &= ~(uint64_t(1) << depth);
+    ++depth;
+}
+
+bool JsonReader::nextInScope(char closer) {
+    skipWhitespace();
+    if (position >= input.size()) fail("unexpected end of input");
+    uint64_t bit = uint64_t(1) << (depth - 1);
+    if (input[position] == closer) {
+        ++position;
+        --depth;
+        return false;
+    }
+    if (hasMembers & bit) {
+        expect(',');
+    } else {
+        hasMembers |= bit;
+    }
+    return true;
+}
+
+std::string_view JsonReader::readString(std::string& buffer) {
+    expect('"');
+    size_t start = position;
+    while (position < input.size()) {
+        char c = input[position];
+        if (c == '"') {
+            ++position;
+            return input.substr(start, position - 1 - start);
+        }
+        if (c == '\\') break;
+        if (static_cast<unsigned char>(c) < 0x20) fail("control character in string");
+        ++position;
+    }
+    if (position >= input.size()) fail("unterminated string");
+
+    // Escaped: decode into the buffer
+    buffer.assign(input.data() + start, position - start);
+    while (true) {
+        if (position >= input.size()) fail("unterminated string");
+        char c = input[position++];
+        if (c == '"') return buffer;
+        if (static_cast<unsigned char>(c) < 0x20) fail("control character in string");
+        if (c != '\\') {
+            buffer += c;
+            continue;
+        }
+
+        if (position >= input.size()) fail("unterminated string");
+        char escaped = input[position++];
+        switch (escaped) {
+            case '"': buffer += '"'; break;
+            case '\\': buffer += '\\'; break;
+            case '/': buffer += '/'; break;
+            case 'b': buffer += '\b'; break;
+            case 'f': buffer += '\f'; break;
+            case 'n': buffer += '\n'; break;
+            case 'r': buffer += '\r'; break;
+            case 't': buffer += '\t'; break;
+            case 'u': {
+                uint32_t codePoint = readHex4();
+                if (codePoint >= 0xD800 && codePoint < 0xDC00) {
+                    // High surrogate; the low half must follow as another escape
+                    if (!consumeLiteral("\\u")) fail("unpaired surrogate");
+                    uint32_t low = readHex4();
+                    if (low < 0xDC00 || low >= 0xE000) fail("unpaired surrogate");
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                } else if (codePoint >= 0xDC00 && codePoint < 0xE000) {
+                    // Low surrogate with no high half before it
+                    fail("unpaired surrogate");
+                }
+                appendUtf8(buffer, codePoint);
+                break;
+            }
+            default:
+                fail("invalid escape sequence");
+        }
+    }
+}
+
+void JsonReader::skipWhitespace() {
+    while (position < input.size() && isWhitespace(input[position])) {
+        ++position;
+    }
+}
+
+void JsonReader::expect(char expected) {
+    if (position >= input.size() || input[position] != expected) {
+        fail(std::string("expected '") + expected + "'");
+    }
+    ++position;
+}
+
+bool JsonReader::consumeLiteral(std::string_view literal) {
+    if (input.substr(position, literal.size()) != literal) return false;
+    position += literal.size();
+    return true;
+}
+
+uint32_t JsonReader::readHex4() {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (position >= input.size()) fail("invalid \\u escape");
+        char digit = input[position++];
+        value <<= 4;
+        if (digit >= '0' && digit <= '9') value |= digit - '0';
+        else if (digit >= 'a' && digit <= 'f') value |= digit - 'a' + 10;
+        else if (digit >= 'A' && digit <= 'F') value |= digit - 'A' + 10;
+        else fail("invalid \\u escape");
+    }
+    return value;
+}
+
+void JsonReader::fail(const std::string& message) const {
+    throw ParseException("JSON parse error at byte " + std::to_string(position) + ": " + message);
+}
+
+} // namespace qlink
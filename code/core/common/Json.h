@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace qlink {
+
+/**
+ * Compact JSON writer appending to a caller-owned buffer.
+ *
+ * Keeps no state but the nesting, so the only allocations are the buffer's
+ * own growth; clearing and reusing one buffer across calls avoids even
+ * those. Numbers are written locale-independently with the shortest form
+ * that reads back exactly. Nesting is limited to 64 levels.
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out(out) {}
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /**
+     * Name the next value inside an object
+     */
+    void key(std::string_view name);
+
+    void string(std::string_view text);
+    void number(double value);
+    void boolean(bool value);
+    void null();
+
+    /**
+     * Append text as the contents of a JSON string, without the quotes
+     */
+    static void appendEscaped(std::string& out, std::string_view text);
+
+private:
+    void beginValue();
+    void open(char bracket);
+
+    std::string& out;
+    uint64_t hasMembers = 0; // One bit per open scope
+    int depth = 0;
+    bool afterKey = false;
+};
+
+/**
+ * Pull parser over JSON text held in memory.
+ *
+ * Strings come back as views into the input; only strings with escape
+ * sequences are decoded, into a scratch buffer that the next read reuses.
+ * Malformed input throws ParseException naming the byte offset.
+ * Typical use:
+ *
+ *   reader.beginObject();
+ *   std::string_view key;
+ *   while (reader.nextMember(key)) {
+ *       if (key == "name") name = reader.readString();
+ *       else reader.skipValue();
+ *   }
+ */
+class JsonReader {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    explicit JsonReader(std::string_view input) : input(input) {}
+
+    /**
+     * Type of the next value
+     */
+    Type peek();
+
+    void beginObject();
+
+    /**
+     * Advance to the next member of the current object
+     * @return false, having consumed the closing brace, when there are no more
+     */
+    bool nextMember(std::string_view& key);
+
+    void beginArray();
+
+    /**
+     * @return false, having consumed the closing bracket, when there are no more elements
+     */
+    bool nextElement();
+
+    /**
+     * @return a view valid until the next read
+     */
+    std::string_view readString();
+    double readNumber();
+    bool readBool();
+    void readNull();
+    void skipValue();
+
+    /**
+     * Require that nothing but whitespace follows
+     */
+    void finish();
+
+    size_t getOffset() const { return position; }
+
+private:
+    void open(char bracket);
+    bool nextInScope(char closer);
+    std::string_view readString(std::string& buffer);
+    void skipWhitespace();
+    void expect(char expected);
+    bool consumeLiteral(std::string_view literal);
+    uint32_t readHex4();
+    [[noreturn]] void fail(const std::string& message) const;
+
+    std::string_view input;
+    size_t position = 0;
+    std::string scratch;
+    std::string keyScratch; // Keys stay valid while their value is read
+    uint64_t hasMembers = 0; // One bit per open scope
+    int depth = 0;
+};
+
+/**
+ * Append a Unicode code point as UTF-8
+ */
+void appendUtf8(std::string& out, uint32_t codePoint);
+
+/**
+ * Append the shortest text that reads back as exactly value, whatever the locale
+ */
+void appendNumber(std::string& out, double value);
+
+} // namespace qlink
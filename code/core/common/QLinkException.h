@@ -51,6 +51,15 @@ public:
         : QLinkException("File I/O Error: " + msg) {}
 };
 
+/**
+ * Exception thrown for malformed text that cannot be parsed
+ */
+class ParseException : public QLinkException {
+public:
+    explicit ParseException(const std::string& msg) 
+        : QLinkException("Parse Error: " + msg) {}
+};
+
 /**
  * Exception thrown for NLP processing errors
  */
@@ -0,0 +1,146 @@
+#include "Timestamp.h"
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+
+namespace qlink {
+
+namespace {
+
+constexpr int64_t MILLIS_PER_DAY = 86400000;
+
+// Proleptic Gregorian calendar; see Howard Hinnant's chrono-compatible date algorithms
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+void civilFromDays(int64_t days, int64_t& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned shiftedMonth = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    year = static_cast<int64_t>(yearOfEra) + era * 400 + (month <= 2);
+}
+
+bool readDigits(std::string_view text, size_t& pos, size_t count, unsigned& value) {
+    if (text.size() - pos < count) return false;
+    value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        char c = text[pos + i];
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + static_cast<unsigned>(c - '0');
+    }
+    pos += count;
+    return true;
+}
+
+bool expect(std::string_view text, size_t& pos, char c) {
+    if (pos >= text.size() || text[pos] != c) return false;
+    ++pos;
+    return true;
+}
+
+} // namespace
+
+Timestamp currentTimestamp() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+std::string formatTimestamp(Timestamp timestamp) {
+    int64_t days = timestamp / MILLIS_PER_DAY;
+    int64_t millis = timestamp % MILLIS_PER_DAY;
+    if (millis < 0) {
+        millis += MILLIS_PER_DAY;
+        --days;
+    }
+    int64_t year;
+    unsigned month;
+    unsigned day;
+    civilFromDays(days, year, month, day);
+
+    char buffer[40];
+    int length = std::snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02uT%02d:%02d:%02d.%03dZ",
+                               static_cast<long long>(year), month, day,
+                               static_cast<int>(millis / 3600000), static_cast<int>(millis / 60000 % 60),
+                               static_cast<int>(millis / 1000 % 60), static_cast<int>(millis % 1000));
+    return std::string(buffer, static_cast<size_t>(length));
+}
+
+bool parseTimestamp(std::string_view text, Timestamp& timestamp) {
+    size_t pos = 0;
+    unsigned year, month, day, hour, minute, second;
+    if (!readDigits(text, pos, 4, year) || !expect(text, pos, '-') || !readDigits(text, pos, 2, month) ||
+        !expect(text, pos, '-') || !readDigits(text, pos, 2, day) || !expect(text, pos, 'T') ||
+        !readDigits(text, pos, 2, hour) || !expect(text, pos, ':') || !readDigits(text, pos, 2, minute) ||
+        !expect(text, pos, ':') || !readDigits(text, pos, 2, second)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return false;
+    }
+
+    int64_t millis = 0;
+    if (pos < text.size() && text[pos] == '.') {
+        ++pos;
+        size_t digits = 0;
+        int64_t scale = 100;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+            // Digits past milliseconds are dropped
+            millis += (text[pos] - '0') * scale;
+            scale /= 10;
+            ++pos;
+            ++digits;
+        }
+        if (digits == 0) return false;
+    }
+
+    int64_t offsetMinutes = 0;
+    bool local = pos == text.size();
+    if (!local) {
+        char sign = text[pos++];
+        if (sign == 'Z') {
+            // UTC
+        } else if (sign == '+' || sign == '-') {
+            unsigned offsetHours, offsetMinute;
+            if (!readDigits(text, pos, 2, offsetHours) || !expect(text, pos, ':') ||
+                !readDigits(text, pos, 2, offsetMinute)) {
+                return false;
+            }
+            offsetMinutes = (sign == '-' ? -1 : 1) * static_cast<int64_t>(offsetHours * 60 + offsetMinute);
+        } else {
+            return false;
+        }
+    }
+    if (pos != text.size()) return false;
+
+    if (local) {
+        std::tm time{};
+        time.tm_year = static_cast<int>(year) - 1900;
+        time.tm_mon = static_cast<int>(month) - 1;
+        time.tm_mday = static_cast<int>(day);
+        time.tm_hour = static_cast<int>(hour);
+        time.tm_min = static_cast<int>(minute);
+        time.tm_sec = static_cast<int>(second);
+        time.tm_isdst = -1; // Whatever daylight saving time said then
+        time.tm_wday = -1;  // Set by mktime only if it succeeds
+        std::time_t seconds = std::mktime(&time);
+        if (time.tm_wday < 0) return false;
+        timestamp = static_cast<int64_t>(seconds) * 1000 + millis;
+        return true;
+    }
+    timestamp = daysFromCivil(year, month, day) * MILLIS_PER_DAY +
+                ((static_cast<int64_t>(hour) * 60 + minute - offsetMinutes) * 60 + second) * 1000 + millis;
+    return true;
+}
+
+} // namespace qlink
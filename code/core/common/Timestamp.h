@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace qlink {
+
+/**
+ * Milliseconds since the Unix epoch, UTC
+ */
+using Timestamp = int64_t;
+
+Timestamp currentTimestamp();
+
+/**
+ * ISO 8601 in UTC with milliseconds, e.g. "2024-05-01T09:30:00.250Z"
+ */
+std::string formatTimestamp(Timestamp timestamp);
+
+/**
+ * Read what formatTimestamp writes, with or without fractional seconds
+ * and with a 'Z' or ±hh:mm offset. Text without an offset is local time,
+ * as QDateTime::currentDateTime().toString(Qt::ISODate) writes it.
+ * @return false if text is not such a date and time
+ */
+bool parseTimestamp(std::string_view text, Timestamp& timestamp);
+
+} // namespace qlink
@@ -1,4 +1,7 @@
 #include "Concept.h"
+#include "ConceptPayloads.h"
+#include "../common/Hash.h"
+#include "../common/Json.h"
 #include <algorithm>
 #include <sstream>
 #include <random>
@@ -7,37 +10,144 @@
 namespace qlink {
 
 Concept::Concept(const std::string& name, const std::string& description)
-    : id(generateId()), name(name), description(description), position(0.0, 0.0) {
+    : id(generateId()), name(name), description(description), position(0.0, 0.0),
+      created(currentTimestamp()), modified(created) {
 }
 
 Concept::Concept(const std::string& id, const std::string& name, const std::string& description)
-    : id(id), name(name), description(description), position(0.0, 0.0) {
+    : id(id), name(name), description(description), position(0.0, 0.0),
+      created(currentTimestamp()), modified(created) {
+}
+
+Concept::Concept(const Concept& other)
+    : id(other.id), name(other.name), description(other.getDescription()), tags(other.getTags()),
+      position(other.position), created(other.created), modified(other.modified), dirty(other.dirty),
+      contentHash(other.contentHash), contentHashValid(other.contentHashValid) {
+}
+
+Concept::~Concept() {
+    if (payloadCache) {
+        payloadCache->forget(*this);
+    }
 }
 
 void Concept::setName(const std::string& name) {
+    if (this->name == name) return;
     this->name = name;
+    touch();
 }
 
 void Concept::setDescription(const std::string& description) {
+    if (getDescription() == description) return;
+    ownPayload();
     this->description = description;
+    touch();
 }
 
 void Concept::setPosition(const Position& position) {
+    if (this->position == position) return;
     this->position = position;
+    touch();
 }
 
 void Concept::addTag(const std::string& tag) {
     if (!hasTag(tag)) {
+        ownPayload();
         tags.push_back(tag);
+        touch();
     }
 }
 
 void Concept::removeTag(const std::string& tag) {
+    if (!hasTag(tag)) return;
+    ownPayload();
     tags.erase(std::remove(tags.begin(), tags.end(), tag), tags.end());
+    touch();
 }
 
 bool Concept::hasTag(const std::string& tag) const {
-    return std::find(tags.begin(), tags.end(), tag) != tags.end();
+    const auto& current = getTags();
+    return std::find(current.begin(), current.end(), tag) != current.end();
+}
+
+void Concept::assignContent(const Concept& other) {
+    setName(other.getName());
+    setDescription(other.getDescription());
+    setPosition(other.getPosition());
+    if (getTags() != other.getTags()) {
+        ownPayload();
+        tags = other.getTags();
+        touch();
+    }
+    setTimestamps(other.created, other.modified);
+}
+
+uint64_t Concept::getContentHash() const {
+    if (!contentHashValid) {
+        uint64_t hash = fnv1aField(name);
+        hash = fnv1aField(getDescription(), hash);
+        const auto& current = getTags();
+        uint64_t tagCount = current.size();
+        hash = fnv1a(&tagCount, sizeof(tagCount), hash);
+        for (const auto& tag : current) {
+            hash = fnv1aField(tag, hash);
+        }
+        hash = fnv1a(&position.x, sizeof(position.x), hash);
+        contentHash = fnv1a(&position.y, sizeof(position.y), hash);
+        contentHashValid = true;
+    }
+    return contentHash;
+}
+
+void Concept::setTimestamps(Timestamp created, Timestamp modified) {
+    this->created = created;
+    this->modified = modified;
+}
+
+void Concept::setLazyPayload(ConceptPayloadCache* cache, uint32_t index) {
+    if (payloadCache) {
+        payloadCache->forget(*this);
+    }
+    payloadCache = cache;
+    payloadIndex = index;
+    std::string().swap(description);
+    std::vector<std::string>().swap(tags);
+    payloadLoaded = cache == nullptr;
+    contentHashValid = false;
+}
+
+std::unique_ptr<Concept> Concept::copyLazily(ConceptPayloadCache* cache) const {
+    if (!payloadCache || !cache) {
+        return std::make_unique<Concept>(*this);
+    }
+    auto copy = std::make_unique<Concept>(id, name, std::string());
+    copy->position = position;
+    copy->created = created;
+    copy->modified = modified;
+    copy->dirty = dirty;
+    copy->setLazyPayload(cache, payloadIndex);
+    copy->contentHash = contentHash;
+    copy->contentHashValid = contentHashValid;
+    return copy;
+}
+
+void Concept::loadPayload() const {
+    payloadCache->use(*this);
+}
+
+// Called before an edit: the source no longer has the payload, so the
+// cache must not drop it
+void Concept::ownPayload() {
+    if (!payloadCache) return;
+    payloadCache->use(*this);
+    payloadCache->forget(*this);
+    payloadCache = nullptr;
+}
+
+void Concept::touch() {
+    modified = currentTimestamp();
+    dirty = true;
+    contentHashValid = false;
 }
 
 bool Concept::operator==(const Concept& other) const {
@@ -47,32 +157,103 @@ bool Concept::operator==(const Concept& other) const {
 std::string Concept::toString() const {
     std::ostringstream oss;
     oss << "Concept[" << id << "]: " << name;
-    if (!description.empty()) {
-        oss << " - " << description;
+    if (!getDescription().empty()) {
+        oss << " - " << getDescription();
     }
     return oss.str();
 }
 
 std::string Concept::toJson() const {
-    std::ostringstream oss;
-    oss << "{";
-    oss << "\"id\":\"" << id << "\",";
-    oss << "\"name\":\"" << name << "\",";
-    oss << "\"description\":\"" << description << "\",";
-    oss << "\"position\":{\"x\":" << position.x << ",\"y\":" << position.y << "},";
-    oss << "\"tags\":[";
-    for (size_t i = 0; i < tags.size(); ++i) {
-        if (i > 0) oss << ",";
-        oss << "\"" << tags[i] << "\"";
+    std::string json;
+    JsonWriter writer(json);
+    writeJson(writer);
+    return json;
+}
+
+void Concept::writeJson(JsonWriter& writer) const {
+    writer.beginObject();
+    writer.key("id");
+    writer.string(id);
+    writer.key("name");
+    writer.string(name);
+    writer.key("description");
+    writer.string(getDescription());
+    writer.key("position");
+    writer.beginObject();
+    writer.key("x");
+    writer.number(position.x);
+    writer.key("y");
+    writer.number(position.y);
+    writer.endObject();
+    writer.key("tags");
+    writer.beginArray();
+    for (const auto& tag : getTags()) {
+        writer.string(tag);
     }
-    oss << "]}";
-    return oss.str();
+    writer.endArray();
+    writer.key("created");
+    writer.string(formatTimestamp(created));
+    writer.key("modified");
+    writer.string(formatTimestamp(modified));
+    writer.endObject();
+}
+
+std::unique_ptr<Concept> Concept::fromJson(JsonReader& reader) {
+    std::string id;
+    std::string name;
+    std::string description;
+    std::vector<std::string> tags;
+    Position position(0.0, 0.0);
+    Timestamp created = 0;
+    Timestamp modified = 0;
+    bool stamped = false;
+
+    reader.beginObject();
+    std::string_view key;
+    while (reader.nextMember(key)) {
+        if (key == "id") {
+            id = reader.readString();
+        } else if (key == "name") {
+            name = reader.readString();
+        } else if (key == "description") {
+            description = reader.readString();
+        } else if (key == "tags") {
+            reader.beginArray();
+            while (reader.nextElement()) {
+                tags.emplace_back(reader.readString());
+            }
+        } else if (key == "position") {
+            reader.beginObject();
+            std::string_view axis;
+            while (reader.nextMember(axis)) {
+                if (axis == "x") position.x = reader.readNumber();
+                else if (axis == "y") position.y = reader.readNumber();
+                else reader.skipValue();
+            }
+        } else if ((key == "created" || key == "modified") && reader.peek() == JsonReader::Type::String) {
+            // Unreadable times are left at the load time
+            stamped = parseTimestamp(reader.readString(), key == "created" ? created : modified) || stamped;
+        } else {
+            reader.skipValue();
+        }
+    }
+
+    if (id.empty() || name.empty()) {
+        return nullptr;
+    }
+    auto concept = std::make_unique<Concept>(id, name, description);
+    concept->tags = std::move(tags);
+    concept->position = position;
+    if (stamped) {
+        concept->setTimestamps(created ? created : modified, modified ? modified : created);
+    }
+    return concept;
 }
 
 std::string Concept::generateId() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, 15);
+    // One engine per thread, so entities can be created on load workers
+    thread_local std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<> dis(0, 15);
     
     std::ostringstream oss;
     oss << "concept_";
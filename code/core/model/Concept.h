@@ -4,9 +4,14 @@
 #include <vector>
 #include <memory>
 #include "../common/DataStructures.h"
+#include "../common/Timestamp.h"
 
 namespace qlink {
 
+class JsonReader;
+class JsonWriter;
+class ConceptPayloadCache;
+
 /**
  * Represents a concept node in the mental model
  */
@@ -14,23 +19,46 @@ class Concept {
 private:
     std::string id;
     std::string name;
-    std::string description;
-    std::vector<std::string> tags;
+    mutable std::string description; // The payload; see setLazyPayload
+    mutable std::vector<std::string> tags;
     Position position;
+    Timestamp created;
+    Timestamp modified;
+    bool dirty = true; // Changed since markClean(); new concepts start out dirty
+
+    // Set while the payload is read through a cache rather than owned
+    ConceptPayloadCache* payloadCache = nullptr;
+    uint32_t payloadIndex = 0;
+    mutable bool payloadLoaded = true;
+
+    mutable uint64_t contentHash = 0;
+    mutable bool contentHashValid = false;
+
+    friend class ConceptPayloadCache;
 
 public:
     // Constructors
     Concept(const std::string& name, const std::string& description = "");
     Concept(const std::string& id, const std::string& name, const std::string& description);
+
+    /**
+     * The copy owns its payload, loading a lazy one if need be
+     */
+    Concept(const Concept& other);
+    Concept& operator=(const Concept&) = delete;
+    ~Concept();
     
-    // Getters
+    // Getters; a lazy concept's payload is loaded on first use
     const std::string& getId() const { return id; }
     const std::string& getName() const { return name; }
-    const std::string& getDescription() const { return description; }
-    const std::vector<std::string>& getTags() const { return tags; }
+    const std::string& getDescription() const { usePayload(); return description; }
+    const std::vector<std::string>& getTags() const { usePayload(); return tags; }
     const Position& getPosition() const { return position; }
+    Timestamp getCreated() const { return created; }
+    Timestamp getModified() const { return modified; }
     
-    // Setters
+    // Setters; each one that changes something stamps the modification time
+    // and marks the concept dirty
     void setName(const std::string& name);
     void setDescription(const std::string& description);
     void setPosition(const Position& position);
@@ -39,6 +67,51 @@ public:
     void addTag(const std::string& tag);
     void removeTag(const std::string& tag);
     bool hasTag(const std::string& tag) const;
+
+    /**
+     * Take other's name, description, tags, position and times, changing
+     * only what differs; the id stays
+     */
+    void assignContent(const Concept& other);
+    
+    /**
+     * Hash of the name, description, tags and position, but not the id or
+     * times, so equal content in two models hashes the same. Computed once
+     * and kept until the concept changes.
+     */
+    uint64_t getContentHash() const;
+    
+    // Change tracking
+
+    /**
+     * Restore timestamps read from a file; leaves the dirty flag alone
+     */
+    void setTimestamps(Timestamp created, Timestamp modified);
+    bool isDirty() const { return dirty; }
+    void markClean() { dirty = false; }
+    void markDirty() { dirty = true; }
+    
+    // Lazy payloads, for models too large to hold every description
+
+    /**
+     * Drop the description and tags and read them from cache's source, at
+     * index, when they are next used. The cache, which must outlive the
+     * concept, may drop them again; editing them makes the concept own them.
+     */
+    void setLazyPayload(ConceptPayloadCache* cache, uint32_t index);
+    bool hasLazyPayload() const { return payloadCache != nullptr; }
+
+    /**
+     * Whether the description and tags are in memory; always true for a
+     * concept that owns them
+     */
+    bool isPayloadLoaded() const { return payloadLoaded; }
+
+    /**
+     * Copy that reads a lazy payload through cache instead of loading it;
+     * a plain copy if this concept owns its payload
+     */
+    std::unique_ptr<Concept> copyLazily(ConceptPayloadCache* cache) const;
     
     // Utility methods
     bool operator==(const Concept& other) const;
@@ -46,8 +119,21 @@ public:
     
     // JSON serialization
     std::string toJson() const;
+    void writeJson(JsonWriter& writer) const;
+
+    /**
+     * Read one concept object; unknown keys are skipped
+     * @throws ParseException on malformed input
+     */
+    static std::unique_ptr<Concept> fromJson(JsonReader& reader);
 
 private:
+    void usePayload() const {
+        if (payloadCache) loadPayload();
+    }
+    void loadPayload() const;
+    void ownPayload();
+    void touch();
     static std::string generateId();
 };
 
@@ -0,0 +1,55 @@
+#include "ConceptPayloads.h"
+#include "Concept.h"
+#include <algorithm>
+
+namespace qlink {
+
+ConceptPayloadCache::ConceptPayloadCache(std::shared_ptr<const ConceptPayloadSource> source, size_t capacity)
+    : source(std::move(source)), capacity(std::max(capacity, MIN_CAPACITY)) {
+}
+
+void ConceptPayloadCache::setCapacity(size_t capacity) {
+    this->capacity = std::max(capacity, MIN_CAPACITY);
+    trim();
+}
+
+void ConceptPayloadCache::use(const Concept& concept) {
+    // Repeated reads of one concept are the common case
+    if (!recent.empty() && recent.front() == &concept) return;
+
+    auto found = positions.find(&concept);
+    if (found != positions.end()) {
+        recent.splice(recent.begin(), recent, found->second);
+        return;
+    }
+
+    ConceptPayload payload = source->load(concept.payloadIndex);
+    ++loadCount;
+    concept.description = std::move(payload.description);
+    concept.tags = std::move(payload.tags);
+    concept.payloadLoaded = true;
+    recent.push_front(&concept);
+    positions.emplace(&concept, recent.begin());
+    trim();
+}
+
+void ConceptPayloadCache::forget(const Concept& concept) {
+    auto found = positions.find(&concept);
+    if (found == positions.end()) return;
+    recent.erase(found->second);
+    positions.erase(found);
+}
+
+void ConceptPayloadCache::trim() {
+    while (positions.size() > capacity) {
+        const Concept* evicted = recent.back();
+        // Swapped out rather than cleared, so the memory goes too
+        std::string().swap(evicted->description);
+        std::vector<std::string>().swap(evicted->tags);
+        evicted->payloadLoaded = false;
+        positions.erase(evicted);
+        recent.pop_back();
+    }
+}
+
+} // namespace qlink
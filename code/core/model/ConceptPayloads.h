@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace qlink {
+
+class Concept;
+
+/**
+ * The part of a concept that lazy loading leaves on disk
+ */
+struct ConceptPayload {
+    std::string description;
+    std::vector<std::string> tags;
+};
+
+/**
+ * Where lazily loaded payloads are read from, by the index the loader gave
+ * each concept. Clones of a model share the source, so load() may be called
+ * from several threads at once.
+ */
+class ConceptPayloadSource {
+public:
+    virtual ~ConceptPayloadSource() = default;
+
+    /**
+     * @throws QLinkException if the payload cannot be read
+     */
+    virtual ConceptPayload load(uint32_t index) const = 0;
+};
+
+/**
+ * Materialized payloads of one model's lazy concepts (see
+ * Concept::setLazyPayload). Reading a concept's description or tags loads
+ * them into the concept; beyond the capacity, the least recently read are
+ * dropped again.
+ *
+ * A reference returned by getDescription() or getTags() of a lazy concept
+ * is therefore valid only until capacity other lazy concepts of the model
+ * have been read. Concepts whose payload was edited own it from then on.
+ *
+ * Not thread-safe: like the model, a cache is used from one thread.
+ */
+class ConceptPayloadCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+    static constexpr size_t MIN_CAPACITY = 2; // Two payloads can always be compared
+
+    explicit ConceptPayloadCache(std::shared_ptr<const ConceptPayloadSource> source,
+                                 size_t capacity = DEFAULT_CAPACITY);
+
+    ConceptPayloadCache(const ConceptPayloadCache&) = delete;
+    ConceptPayloadCache& operator=(const ConceptPayloadCache&) = delete;
+
+    const std::shared_ptr<const ConceptPayloadSource>& getSource() const { return source; }
+
+    size_t getCapacity() const { return capacity; }
+    void setCapacity(size_t capacity);
+
+    /**
+     * Payloads held now
+     */
+    size_t getLoadedCount() const { return positions.size(); }
+
+    /**
+     * Payloads read from the source so far
+     */
+    uint64_t getLoadCount() const { return loadCount; }
+
+private:
+    friend class Concept;
+
+    // Load concept's payload if it is not held, and mark it most recently used
+    void use(const Concept& concept);
+    void forget(const Concept& concept);
+    void trim();
+
+    std::shared_ptr<const ConceptPayloadSource> source;
+    size_t capacity;
+    std::list<const Concept*> recent; // Most recently used first
+    std::unordered_map<const Concept*, std::list<const Concept*>::iterator> positions;
+    uint64_t loadCount = 0;
+};
+
+} // namespace qlink
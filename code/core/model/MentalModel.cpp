@@ -1,12 +1,108 @@
 #include "MentalModel.h"
+#include "../common/Json.h"
+#include "../common/QLinkException.h"
 #include <algorithm>
 #include <set>
 #include <queue>
-#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 #include <QString>
 
 namespace qlink {
 
+namespace {
+
+// Drop an id from an index; a remaining entity with the same id takes its place
+template <typename T>
+void unindex(std::unordered_map<std::string, T*>& index, const std::vector<std::unique_ptr<T>>& entities,
+             const std::string& id) {
+    index.erase(id);
+    for (const auto& entity : entities) {
+        if (entity->getId() == id) {
+            index.emplace(id, entity.get());
+            return;
+        }
+    }
+}
+
+// Record that the entity at position is going away: a removal if it was
+// there at the last markClean(), else just one addition fewer
+template <typename T>
+void trackRemoval(const std::unique_ptr<T>& entity, size_t position, size_t& cleanCount,
+                  std::unordered_set<T*>& modified, std::vector<std::string>& removedIds) {
+    modified.erase(entity.get());
+    if (position < cleanCount) {
+        removedIds.push_back(entity->getId());
+        --cleanCount;
+    }
+}
+
+// Take the marked entities out of entities in one pass, keeping the order
+// of the rest, and track and unindex them as removeConcept does one at a time
+template <typename T>
+std::vector<std::unique_ptr<T>> eraseMarked(std::vector<std::unique_ptr<T>>& entities,
+                                            const std::unordered_set<const T*>& marked,
+                                            std::unordered_map<std::string, T*>& index, size_t& cleanCount,
+                                            std::unordered_set<T*>& modified, std::vector<std::string>& removedIds) {
+    std::vector<std::unique_ptr<T>> erased;
+    if (marked.empty()) return erased;
+    size_t kept = 0;
+    size_t cleanErased = 0;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        T* entity = entities[i].get();
+        if (!marked.count(entity)) {
+            if (kept != i) entities[kept] = std::move(entities[i]);
+            ++kept;
+            continue;
+        }
+        modified.erase(entity);
+        if (i < cleanCount) {
+            removedIds.push_back(entity->getId());
+            ++cleanErased;
+        }
+        auto found = index.find(entity->getId());
+        if (found != index.end() && found->second == entity) index.erase(found);
+        erased.push_back(std::move(entities[i]));
+    }
+    entities.resize(kept);
+    cleanCount -= cleanErased;
+    if (index.size() != entities.size()) {
+        // Duplicates of an erased id become the ones its lookups find
+        for (const auto& entity : entities) {
+            index.emplace(entity->getId(), entity.get());
+        }
+    }
+    return erased;
+}
+
+// Entities after cleanCount were added; the rest of those announced as modified were modified
+template <typename T>
+void collectChanges(const std::vector<std::unique_ptr<T>>& entities, size_t cleanCount,
+                    const std::unordered_set<T*>& modified, std::vector<const T*>& added,
+                    std::vector<const T*>& changed) {
+    added.reserve(entities.size() - cleanCount);
+    for (size_t i = cleanCount; i < entities.size(); ++i) {
+        added.push_back(entities[i].get());
+    }
+    if (modified.empty()) return;
+    std::unordered_set<const T*> addedSet(added.begin(), added.end());
+    for (T* entity : modified) {
+        if (!addedSet.count(entity)) changed.push_back(entity);
+    }
+}
+
+} // namespace
+
+bool ModelChanges::isEmpty() const {
+    return !cleared && !renamed && addedConcepts.empty() && modifiedConcepts.empty() && removedConcepts.empty() &&
+           addedRelationships.empty() && modifiedRelationships.empty() && removedRelationships.empty();
+}
+
+bool ModelChanges::keepsStructure() const {
+    return !cleared && addedConcepts.empty() && removedConcepts.empty() && addedRelationships.empty() &&
+           removedRelationships.empty();
+}
+
 MentalModel::MentalModel(const std::string& name, QObject* parent)
     : QObject(parent), modelName(name) {
 }
@@ -17,6 +113,7 @@ MentalModel::~MentalModel() = default;
 void MentalModel::addConcept(std::unique_ptr<Concept> concept) {
     if (!concept) return;
     std::string conceptId = concept->getId();
+    conceptIndex.emplace(conceptId, concept.get());
     concepts.push_back(std::move(concept));
     emit conceptAdded(QString::fromStdString(conceptId));
     notifyChange(ModelChangeEvent(ChangeType::CONCEPT_ADDED, conceptId));
@@ -28,7 +125,10 @@ void MentalModel::removeConcept(const std::string& conceptId) {
     while (relIt != relationships.end()) {
         if ((*relIt)->connectsTo(conceptId)) {
             std::string relationshipId = (*relIt)->getId();
+            trackRemoval(*relIt, static_cast<size_t>(relIt - relationships.begin()), cleanRelationshipCount,
+                         modifiedRelationships, removedRelationshipIds);
             relIt = relationships.erase(relIt);
+            unindex(relationshipIndex, relationships, relationshipId);
             emit relationshipRemoved(QString::fromStdString(relationshipId));
         } else {
             ++relIt;
@@ -41,32 +141,37 @@ void MentalModel::removeConcept(const std::string& conceptId) {
             return concept->getId() == conceptId;
         });
     if (it != concepts.end()) {
+        trackRemoval(*it, static_cast<size_t>(it - concepts.begin()), cleanConceptCount, modifiedConcepts,
+                     removedConceptIds);
         concepts.erase(it);
+        unindex(conceptIndex, concepts, conceptId);
         emit conceptRemoved(QString::fromStdString(conceptId));
         notifyChange(ModelChangeEvent(ChangeType::CONCEPT_REMOVED, conceptId));
     }
 }
 
 Concept* MentalModel::getConcept(const std::string& conceptId) {
-    auto it = std::find_if(concepts.begin(), concepts.end(),
-        [&conceptId](const std::unique_ptr<Concept>& concept) {
-            return concept->getId() == conceptId;
-        });
-    return (it != concepts.end()) ? it->get() : nullptr;
+    auto it = conceptIndex.find(conceptId);
+    return (it != conceptIndex.end()) ? it->second : nullptr;
 }
 
 const Concept* MentalModel::getConcept(const std::string& conceptId) const {
-    auto it = std::find_if(concepts.begin(), concepts.end(),
-        [&conceptId](const std::unique_ptr<Concept>& concept) {
-            return concept->getId() == conceptId;
-        });
-    return (it != concepts.end()) ? it->get() : nullptr;
+    auto it = conceptIndex.find(conceptId);
+    return (it != conceptIndex.end()) ? it->second : nullptr;
 }
 
 const std::vector<std::unique_ptr<Concept>>& MentalModel::getConcepts() const {
     return concepts;
 }
 
+void MentalModel::addConceptsBulk(std::vector<std::unique_ptr<Concept>> newConcepts) {
+    concepts.reserve(concepts.size() + newConcepts.size());
+    conceptIndex.reserve(conceptIndex.size() + newConcepts.size());
+    for (auto& concept : newConcepts) {
+        addConcept(std::move(concept));
+    }
+}
+
 // Relationship management
 void MentalModel::addRelationship(std::unique_ptr<Relationship> relationship) {
     if (!relationship) return;
@@ -76,6 +181,7 @@ void MentalModel::addRelationship(std::unique_ptr<Relationship> relationship) {
         return; // Don't add relationship if concepts don't exist
     }
     std::string relationshipId = relationship->getId();
+    relationshipIndex.emplace(relationshipId, relationship.get());
     relationships.push_back(std::move(relationship));
     emit relationshipAdded(QString::fromStdString(relationshipId));
     notifyChange(ModelChangeEvent(ChangeType::RELATIONSHIP_ADDED, relationshipId));
@@ -87,32 +193,108 @@ void MentalModel::removeRelationship(const std::string& relationshipId) {
             return relationship->getId() == relationshipId;
         });
     if (it != relationships.end()) {
+        trackRemoval(*it, static_cast<size_t>(it - relationships.begin()), cleanRelationshipCount,
+                     modifiedRelationships, removedRelationshipIds);
         relationships.erase(it);
+        unindex(relationshipIndex, relationships, relationshipId);
         emit relationshipRemoved(QString::fromStdString(relationshipId));
         notifyChange(ModelChangeEvent(ChangeType::RELATIONSHIP_REMOVED, relationshipId));
     }
 }
 
+void MentalModel::notifyConceptModified(const std::string& conceptId) {
+    if (Concept* concept = getConcept(conceptId)) {
+        modifiedConcepts.insert(concept);
+        notifyChange(ModelChangeEvent(ChangeType::CONCEPT_MODIFIED, conceptId));
+    }
+}
+
+void MentalModel::notifyRelationshipModified(const std::string& relationshipId) {
+    if (Relationship* relationship = getRelationship(relationshipId)) {
+        modifiedRelationships.insert(relationship);
+        notifyChange(ModelChangeEvent(ChangeType::RELATIONSHIP_MODIFIED, relationshipId));
+    }
+}
+
 Relationship* MentalModel::getRelationship(const std::string& relationshipId) {
-    auto it = std::find_if(relationships.begin(), relationships.end(),
-        [&relationshipId](const std::unique_ptr<Relationship>& relationship) {
-            return relationship->getId() == relationshipId;
-        });
-    return (it != relationships.end()) ? it->get() : nullptr;
+    auto it = relationshipIndex.find(relationshipId);
+    return (it != relationshipIndex.end()) ? it->second : nullptr;
 }
 
 const Relationship* MentalModel::getRelationship(const std::string& relationshipId) const {
-    auto it = std::find_if(relationships.begin(), relationships.end(),
-        [&relationshipId](const std::unique_ptr<Relationship>& relationship) {
-            return relationship->getId() == relationshipId;
-        });
-    return (it != relationships.end()) ? it->get() : nullptr;
+    auto it = relationshipIndex.find(relationshipId);
+    return (it != relationshipIndex.end()) ? it->second : nullptr;
 }
 
 const std::vector<std::unique_ptr<Relationship>>& MentalModel::getRelationships() const {
     return relationships;
 }
 
+size_t MentalModel::addRelationshipsBulk(std::vector<std::unique_ptr<Relationship>> newRelationships) {
+    relationships.reserve(relationships.size() + newRelationships.size());
+    relationshipIndex.reserve(relationshipIndex.size() + newRelationships.size());
+    size_t added = 0;
+    for (auto& relationship : newRelationships) {
+        // addRelationship checks the endpoints through the index
+        size_t before = relationships.size();
+        addRelationship(std::move(relationship));
+        added += relationships.size() - before;
+    }
+    return added;
+}
+
+std::vector<std::unique_ptr<Concept>> MentalModel::removeConceptsBulk(
+    const std::vector<std::string>& conceptIds, std::vector<std::unique_ptr<Relationship>>* removedRelationships) {
+    std::unordered_set<std::string> ids;
+    std::unordered_set<const Concept*> marked;
+    for (const auto& id : conceptIds) {
+        if (const Concept* concept = getConcept(id)) {
+            ids.insert(id);
+            marked.insert(concept);
+        }
+    }
+    std::unordered_set<const Relationship*> markedRelationships;
+    if (!ids.empty()) {
+        for (const auto& relationship : relationships) {
+            if (ids.count(relationship->getSourceConceptId()) || ids.count(relationship->getTargetConceptId())) {
+                markedRelationships.insert(relationship.get());
+            }
+        }
+    }
+
+    auto erasedRelationships = eraseMarked(relationships, markedRelationships, relationshipIndex,
+                                           cleanRelationshipCount, modifiedRelationships, removedRelationshipIds);
+    for (const auto& relationship : erasedRelationships) {
+        emit relationshipRemoved(QString::fromStdString(relationship->getId()));
+    }
+    auto erased = eraseMarked(concepts, marked, conceptIndex, cleanConceptCount, modifiedConcepts, removedConceptIds);
+    for (const auto& concept : erased) {
+        emit conceptRemoved(QString::fromStdString(concept->getId()));
+        notifyChange(ModelChangeEvent(ChangeType::CONCEPT_REMOVED, concept->getId()));
+    }
+    if (removedRelationships) {
+        *removedRelationships = std::move(erasedRelationships);
+    }
+    return erased;
+}
+
+std::vector<std::unique_ptr<Relationship>> MentalModel::removeRelationshipsBulk(
+    const std::vector<std::string>& relationshipIds) {
+    std::unordered_set<const Relationship*> marked;
+    for (const auto& id : relationshipIds) {
+        if (const Relationship* relationship = getRelationship(id)) {
+            marked.insert(relationship);
+        }
+    }
+    auto erased = eraseMarked(relationships, marked, relationshipIndex, cleanRelationshipCount,
+                              modifiedRelationships, removedRelationshipIds);
+    for (const auto& relationship : erased) {
+        emit relationshipRemoved(QString::fromStdString(relationship->getId()));
+        notifyChange(ModelChangeEvent(ChangeType::RELATIONSHIP_REMOVED, relationship->getId()));
+    }
+    return erased;
+}
+
 // Graph operations
 std::vector<Concept*> MentalModel::getConnectedConcepts(const std::string& conceptId) {
     std::vector<Concept*> connected;
@@ -177,11 +359,20 @@ bool MentalModel::areConnected(const std::string& concept1Id, const std::string&
 
 // graph operations
 std::vector<std::string> MentalModel::findShortestPath(const std::string& startConceptId, 
-                                                      const std::string& endConceptId) {
+                                                      const std::string& endConceptId) const {
     if (startConceptId == endConceptId) {
         return {startConceptId};
     }
     
+    // Index neighbours once instead of scanning every relationship per visited concept
+    std::unordered_map<std::string, std::vector<const std::string*>> neighbors;
+    for (const auto& relationship : relationships) {
+        const std::string& source = relationship->getSourceConceptId();
+        const std::string& target = relationship->getTargetConceptId();
+        neighbors[source].push_back(&target);
+        neighbors[target].push_back(&source);
+    }
+    
     // BFS to find shortest path
     std::queue<std::string> queue;
     std::set<std::string> visited;
@@ -208,13 +399,12 @@ std::vector<std::string> MentalModel::findShortestPath(const std::string& startC
         }
         
         // Explore neighbors
-        auto connectedConcepts = getConnectedConcepts(current);
-        for (const auto& concept : connectedConcepts) {
-            std::string conceptId = concept->getId();
-            if (visited.find(conceptId) == visited.end()) {
-                visited.insert(conceptId);
-                parent[conceptId] = current;
-                queue.push(conceptId);
+        auto adjacent = neighbors.find(current);
+        if (adjacent == neighbors.end()) continue;
+        for (const std::string* conceptId : adjacent->second) {
+            if (visited.insert(*conceptId).second) {
+                parent[*conceptId] = current;
+                queue.push(*conceptId);
             }
         }
     }
@@ -253,7 +443,9 @@ const std::string& MentalModel::getModelName() const {
 }
 
 void MentalModel::setModelName(const std::string& name) {
+    if (modelName == name) return;
     modelName = name;
+    renamed = true;
 }
 
 size_t MentalModel::getConceptCount() const {
@@ -264,9 +456,104 @@ size_t MentalModel::getRelationshipCount() const {
     return relationships.size();
 }
 
+uint64_t MentalModel::getVersion() const {
+    return version;
+}
+
+ModelChanges MentalModel::getChanges() const {
+    ModelChanges changes;
+    changes.cleared = cleared;
+    changes.renamed = renamed;
+    collectChanges(concepts, cleanConceptCount, modifiedConcepts, changes.addedConcepts, changes.modifiedConcepts);
+    collectChanges(relationships, cleanRelationshipCount, modifiedRelationships, changes.addedRelationships,
+                   changes.modifiedRelationships);
+    changes.removedConcepts = removedConceptIds;
+    changes.removedRelationships = removedRelationshipIds;
+    return changes;
+}
+
+bool MentalModel::hasChanges() const {
+    return cleared || renamed || cleanConceptCount != concepts.size() ||
+           cleanRelationshipCount != relationships.size() || !modifiedConcepts.empty() ||
+           !modifiedRelationships.empty() || !removedConceptIds.empty() || !removedRelationshipIds.empty();
+}
+
+void MentalModel::markClean() {
+    for (size_t i = cleanConceptCount; i < concepts.size(); ++i) {
+        concepts[i]->markClean();
+    }
+    for (Concept* concept : modifiedConcepts) {
+        concept->markClean();
+    }
+    for (size_t i = cleanRelationshipCount; i < relationships.size(); ++i) {
+        relationships[i]->markClean();
+    }
+    for (Relationship* relationship : modifiedRelationships) {
+        relationship->markClean();
+    }
+    cleanConceptCount = concepts.size();
+    cleanRelationshipCount = relationships.size();
+    modifiedConcepts.clear();
+    modifiedRelationships.clear();
+    removedConceptIds.clear();
+    removedRelationshipIds.clear();
+    cleared = false;
+    renamed = false;
+}
+
+void MentalModel::markUnsaved() {
+    for (const auto& concept : concepts) {
+        concept->markDirty();
+    }
+    for (const auto& relationship : relationships) {
+        relationship->markDirty();
+    }
+    cleanConceptCount = 0;
+    cleanRelationshipCount = 0;
+    modifiedConcepts.clear();
+    modifiedRelationships.clear();
+    removedConceptIds.clear();
+    removedRelationshipIds.clear();
+    cleared = true;
+}
+
+std::unique_ptr<MentalModel> MentalModel::clone() const {
+    auto copy = std::make_unique<MentalModel>(modelName);
+    if (payloadCache) {
+        copy->setPayloadSource(payloadCache->getSource(), payloadCache->getCapacity());
+    }
+    copy->concepts.reserve(concepts.size());
+    for (const auto& concept : concepts) {
+        copy->concepts.push_back(concept->copyLazily(copy->payloadCache.get()));
+    }
+    copy->relationships.reserve(relationships.size());
+    for (const auto& relationship : relationships) {
+        copy->relationships.push_back(std::make_unique<Relationship>(*relationship));
+    }
+    copy->version = version;
+    copy->rebuildIndexes();
+    return copy;
+}
+
+ConceptPayloadCache* MentalModel::setPayloadSource(std::shared_ptr<const ConceptPayloadSource> source,
+                                                   size_t cacheCapacity) {
+    payloadCache = std::make_unique<ConceptPayloadCache>(std::move(source), cacheCapacity);
+    return payloadCache.get();
+}
+
 void MentalModel::clear() {
     concepts.clear();
+    payloadCache.reset(); // No concept reads through it any more
     relationships.clear();
+    conceptIndex.clear();
+    relationshipIndex.clear();
+    cleanConceptCount = 0;
+    cleanRelationshipCount = 0;
+    modifiedConcepts.clear();
+    modifiedRelationships.clear();
+    removedConceptIds.clear();
+    removedRelationshipIds.clear();
+    cleared = true;
     notifyChange(ModelChangeEvent(ChangeType::MODEL_CLEARED, "all"));
 }
 
@@ -355,32 +642,85 @@ ModelStatistics MentalModel::getStatistics() const {
     return stats;
 }
 
-// JSON serialization (basic implementation)
 std::string MentalModel::toJson() const {
-    std::stringstream ss;
-    ss << "{";
-    ss << "\"modelName\":\"" << modelName << "\",";
-    ss << "\"concepts\":[";
-    for (size_t i = 0; i < concepts.size(); ++i) {
-        if (i > 0) ss << ",";
-        ss << concepts[i]->toJson();
+    std::string json;
+    // Concept records run to about a hundred bytes before descriptions
+    json.reserve(128 * concepts.size() + 128 * relationships.size() + 64);
+    JsonWriter writer(json);
+    writer.beginObject();
+    writer.key("modelName");
+    writer.string(modelName);
+    writer.key("concepts");
+    writer.beginArray();
+    for (const auto& concept : concepts) {
+        concept->writeJson(writer);
     }
-    ss << "],\"relationships\":[";
-    for (size_t i = 0; i < relationships.size(); ++i) {
-        if (i > 0) ss << ",";
-        ss << relationships[i]->toJson();
+    writer.endArray();
+    writer.key("relationships");
+    writer.beginArray();
+    for (const auto& relationship : relationships) {
+        relationship->writeJson(writer);
     }
-    ss << "]}";
-    return ss.str();
+    writer.endArray();
+    writer.endObject();
+    return json;
 }
 
 std::unique_ptr<MentalModel> MentalModel::fromJson(const std::string& json) {
-    // TODO: Implement proper JSON parsing in Task 4.1
-    // For now, return nullptr to indicate not implemented
-    return nullptr;
+    std::string name;
+    std::vector<std::unique_ptr<Concept>> parsedConcepts;
+    std::vector<std::unique_ptr<Relationship>> parsedRelationships;
+    try {
+        JsonReader reader(json);
+        reader.beginObject();
+        std::string_view key;
+        while (reader.nextMember(key)) {
+            if (key == "modelName" || key == "name") {
+                // ModelManager's files say "name"
+                name = reader.readString();
+            } else if (key == "concepts") {
+                reader.beginArray();
+                while (reader.nextElement()) {
+                    auto concept = Concept::fromJson(reader);
+                    if (concept) parsedConcepts.push_back(std::move(concept));
+                }
+            } else if (key == "relationships") {
+                reader.beginArray();
+                while (reader.nextElement()) {
+                    auto relationship = Relationship::fromJson(reader);
+                    if (relationship) parsedRelationships.push_back(std::move(relationship));
+                }
+            } else {
+                reader.skipValue();
+            }
+        }
+        reader.finish();
+    } catch (const ParseException&) {
+        return nullptr;
+    }
+
+    // Concepts first so relationships resolve their endpoints wherever they appeared
+    auto model = std::make_unique<MentalModel>(name);
+    model->addConceptsBulk(std::move(parsedConcepts));
+    model->addRelationshipsBulk(std::move(parsedRelationships));
+    return model;
+}
+
+void MentalModel::rebuildIndexes() {
+    conceptIndex.clear();
+    conceptIndex.reserve(concepts.size());
+    for (const auto& concept : concepts) {
+        conceptIndex.emplace(concept->getId(), concept.get());
+    }
+    relationshipIndex.clear();
+    relationshipIndex.reserve(relationships.size());
+    for (const auto& relationship : relationships) {
+        relationshipIndex.emplace(relationship->getId(), relationship.get());
+    }
 }
 
 void MentalModel::notifyChange(const ModelChangeEvent& event) {
+    ++version;
     emit modelChanged(event);
 }
 
@@ -4,9 +4,13 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
 #include <QObject>
 #include "Concept.h"
 #include "Relationship.h"
+#include "ConceptPayloads.h"
 #include "../common/DataStructures.h"
 
 namespace qlink {
@@ -16,6 +20,28 @@ class Concept;
 class Relationship;
 struct ModelChangeEvent;
 
+/**
+ * What changed in a model since MentalModel::markClean()
+ */
+struct ModelChanges {
+    bool cleared = false; // Everything there at markClean() was dropped first
+    bool renamed = false;
+    std::vector<const Concept*> addedConcepts;
+    std::vector<const Concept*> modifiedConcepts;
+    std::vector<std::string> removedConcepts;
+    std::vector<const Relationship*> addedRelationships;
+    std::vector<const Relationship*> modifiedRelationships;
+    std::vector<std::string> removedRelationships; // Including those removed with their concepts
+
+    bool isEmpty() const;
+
+    /**
+     * Whether the entities there at markClean() are all still there, in
+     * the same order, and no others were added
+     */
+    bool keepsStructure() const;
+};
+
 /**
  * Main container for concepts and relationships (Observer Pattern via Qt signals)
  */
@@ -33,6 +59,25 @@ public:
     const Concept* getConcept(const std::string& conceptId) const;
     const std::vector<std::unique_ptr<Concept>>& getConcepts() const;
     
+    /**
+     * Add many concepts at once, e.g. when loading. Storage is reserved up
+     * front; observers are notified per concept as with addConcept.
+     */
+    void addConceptsBulk(std::vector<std::unique_ptr<Concept>> newConcepts);
+    
+    /**
+     * Remove many concepts, and the relationships involving them, in one
+     * pass over the model instead of one per concept. Observers are
+     * notified as with removeConcept. The removed entities are handed back;
+     * lazy concepts among them read this model's payload cache, so copy
+     * them to keep them longer than the model.
+     * @param removedRelationships If given, receives the relationships removed with the concepts
+     * @return the removed concepts, in model order
+     */
+    std::vector<std::unique_ptr<Concept>> removeConceptsBulk(
+        const std::vector<std::string>& conceptIds,
+        std::vector<std::unique_ptr<Relationship>>* removedRelationships = nullptr);
+    
     // Relationship management
     void addRelationship(std::unique_ptr<Relationship> relationship);
     void removeRelationship(const std::string& relationshipId);
@@ -40,6 +85,27 @@ public:
     const Relationship* getRelationship(const std::string& relationshipId) const;
     const std::vector<std::unique_ptr<Relationship>>& getRelationships() const;
     
+    /**
+     * Add many relationships at once, resolving endpoints through the id
+     * index. Relationships whose concepts do not exist are skipped.
+     * @return the number of relationships added
+     */
+    size_t addRelationshipsBulk(std::vector<std::unique_ptr<Relationship>> newRelationships);
+    
+    /**
+     * Remove many relationships in one pass over the model
+     * @return the removed relationships, in model order
+     */
+    std::vector<std::unique_ptr<Relationship>> removeRelationshipsBulk(const std::vector<std::string>& relationshipIds);
+    
+    /**
+     * Announce an edit made directly through a Concept or Relationship
+     * pointer, so observers see it like any other change and the edit is
+     * tracked for the next save
+     */
+    void notifyConceptModified(const std::string& conceptId);
+    void notifyRelationshipModified(const std::string& relationshipId);
+    
     // Graph operations
     std::vector<Concept*> getConnectedConcepts(const std::string& conceptId);
     std::vector<const Concept*> getConnectedConcepts(const std::string& conceptId) const;
@@ -48,7 +114,7 @@ public:
     bool areConnected(const std::string& concept1Id, const std::string& concept2Id) const;
     
     std::vector<std::string> findShortestPath(const std::string& startConceptId, 
-                                             const std::string& endConceptId);
+                                             const std::string& endConceptId) const;
     std::vector<Concept*> getOrphanedConcepts();
     double getConceptImportance(const std::string& conceptId);
     
@@ -58,6 +124,51 @@ public:
     size_t getConceptCount() const;
     size_t getRelationshipCount() const;
     
+    /**
+     * Monotonic content version, bumped on every change notification.
+     * Lets caches tell whether results computed earlier are still current.
+     */
+    uint64_t getVersion() const;
+    
+    // Change tracking, for saves that write only what changed
+
+    /**
+     * Entities added, modified (as announced through notify*Modified) and
+     * removed since markClean(). Takes time in the number of changes, not
+     * the size of the model.
+     */
+    ModelChanges getChanges() const;
+    bool hasChanges() const;
+
+    /**
+     * Take the current content as saved: clears the changes and the dirty
+     * flags of the entities they name
+     */
+    void markClean();
+
+    /**
+     * Take nothing as saved, e.g. after a save that markClean() ran ahead
+     * of failed: every entity counts as added, so the next save writes all
+     */
+    void markUnsaved();
+    
+    // Lazy payloads (see ConceptPayloadCache)
+
+    /**
+     * Read the payloads of lazy concepts from source, through a cache the
+     * model owns; loaders call this before adding concepts they give to
+     * Concept::setLazyPayload. Replaces the cache, so not for a model that
+     * already has lazy concepts.
+     * @return the new cache
+     */
+    ConceptPayloadCache* setPayloadSource(std::shared_ptr<const ConceptPayloadSource> source,
+                                          size_t cacheCapacity = ConceptPayloadCache::DEFAULT_CAPACITY);
+
+    /**
+     * Null unless the model was loaded lazily
+     */
+    ConceptPayloadCache* getPayloadCache() const { return payloadCache.get(); }
+    
     // Model validation
     bool isValid() const;
     std::vector<std::string> getValidationErrors() const;
@@ -69,8 +180,22 @@ public:
     void clear();
     bool isEmpty() const;
     
+    /**
+     * Deep copy with the same name, content and version, without a parent
+     * and without emitting signals. Lets a worker read a consistent model
+     * while this one keeps changing. Lazy concepts stay lazy, behind a
+     * cache of the copy's own over the same source.
+     */
+    std::unique_ptr<MentalModel> clone() const;
+    
     // JSON serialization
     std::string toJson() const;
+
+    /**
+     * Parse what toJson or ModelManager writes; relationships whose
+     * concepts are missing are dropped
+     * @return nullptr if the text is not valid JSON
+     */
     static std::unique_ptr<MentalModel> fromJson(const std::string& json);
 
 signals:
@@ -82,10 +207,29 @@ signals:
 
 private:
     void notifyChange(const ModelChangeEvent& event);
+    void rebuildIndexes();
     
+    // Declared first, so it outlives the concepts that use it
+    std::unique_ptr<ConceptPayloadCache> payloadCache;
     std::vector<std::unique_ptr<Concept>> concepts;
     std::vector<std::unique_ptr<Relationship>> relationships;
+    
+    // Id lookups; with duplicate ids the first entity wins, as in a linear search
+    std::unordered_map<std::string, Concept*> conceptIndex;
+    std::unordered_map<std::string, Relationship*> relationshipIndex;
     std::string modelName;
+    uint64_t version = 0;
+
+    // Since markClean(): entities below these positions were there then, and
+    // added ones follow them, since additions append and removals shift both
+    size_t cleanConceptCount = 0;
+    size_t cleanRelationshipCount = 0;
+    std::unordered_set<Concept*> modifiedConcepts;
+    std::unordered_set<Relationship*> modifiedRelationships;
+    std::vector<std::string> removedConceptIds;
+    std::vector<std::string> removedRelationshipIds;
+    bool cleared = false;
+    bool renamed = false;
 };
 
 } // namespace qlink
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "ModelDiff.h"
+#include "MentalModel.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace qlink {
+
+namespace {
+
+const Concept* find(const MentalModel& model, const std::string& id, const Concept*) {
+    return model.getConcept(id);
+}
+
+const Relationship* find(const MentalModel& model, const std::string& id, const Relationship*) {
+    return model.getRelationship(id);
+}
+
+template <typename Entity>
+const Entity* find(const MentalModel& model, const std::string& id) {
+    return find(model, id, static_cast<const Entity*>(nullptr));
+}
+
+// Absence is a version too: two absent entities are the same
+template <typename Entity>
+bool sameVersion(const Entity* first, const Entity* second) {
+    if (!first || !second) return first == second;
+    return first == second || first->getContentHash() == second->getContentHash();
+}
+
+// Whether entity is the one its id finds; with duplicate ids only the first counts
+template <typename Entity>
+bool isIndexed(const MentalModel& model, const Entity& entity) {
+    return find<Entity>(model, entity.getId()) == &entity;
+}
+
+template <typename Entity>
+void diffEntities(const MentalModel& from, const MentalModel& to,
+                  const std::vector<std::unique_ptr<Entity>>& fromEntities,
+                  const std::vector<std::unique_ptr<Entity>>& toEntities,
+                  std::vector<const Entity*>& added, std::vector<const Entity*>& modified,
+                  std::vector<std::string>& removed) {
+    for (const auto& entity : toEntities) {
+        if (!isIndexed(to, *entity)) continue;
+        const Entity* previous = find<Entity>(from, entity->getId());
+        if (!previous) {
+            added.push_back(entity.get());
+        } else if (!sameVersion(previous, static_cast<const Entity*>(entity.get()))) {
+            modified.push_back(entity.get());
+        }
+    }
+    for (const auto& entity : fromEntities) {
+        if (isIndexed(from, *entity) && !find<Entity>(to, entity->getId())) {
+            removed.push_back(entity->getId());
+        }
+    }
+}
+
+template <typename Entity>
+class EntityMerge {
+public:
+    EntityMerge(ConflictResolution resolution, std::vector<const Entity*>& added,
+                std::vector<const Entity*>& modified, std::vector<std::string>& removed,
+                std::vector<std::string>& conflicts)
+        : resolution(resolution), added(added), modified(modified), removed(removed), conflicts(conflicts) {}
+
+    void run(const MentalModel& base, const MentalModel& ours, const MentalModel& theirs,
+             const std::vector<std::unique_ptr<Entity>>& baseEntities,
+             const std::vector<std::unique_ptr<Entity>>& theirEntities) {
+        // Everything theirs has, so everything theirs added or changed
+        for (const auto& entity : theirEntities) {
+            if (!isIndexed(theirs, *entity)) continue;
+            const std::string& id = entity->getId();
+            settle(id, find<Entity>(base, id), find<Entity>(ours, id), entity.get());
+        }
+        // And what theirs removed
+        for (const auto& entity : baseEntities) {
+            if (!isIndexed(base, *entity) || find<Entity>(theirs, entity->getId())) continue;
+            const std::string& id = entity->getId();
+            settle(id, entity.get(), find<Entity>(ours, id), nullptr);
+        }
+    }
+
+private:
+    void settle(const std::string& id, const Entity* baseVersion, const Entity* ourVersion,
+                const Entity* theirVersion) {
+        if (sameVersion(theirVersion, baseVersion) || sameVersion(ourVersion, theirVersion)) {
+            // Theirs did not change it, or both sides changed it the same way
+            return;
+        }
+        if (!sameVersion(ourVersion, baseVersion)) {
+            conflicts.push_back(id);
+            if (resolution == ConflictResolution::KEEP_OURS) return;
+        }
+        if (!theirVersion) {
+            removed.push_back(id);
+        } else if (!ourVersion) {
+            added.push_back(theirVersion);
+        } else {
+            modified.push_back(theirVersion);
+        }
+    }
+
+    ConflictResolution resolution;
+    std::vector<const Entity*>& added;
+    std::vector<const Entity*>& modified;
+    std::vector<std::string>& removed;
+    std::vector<std::string>& conflicts;
+};
+
+} // namespace
+
+bool ModelDiff::isEmpty() const {
+    return size() == 0;
+}
+
+size_t ModelDiff::size() const {
+    return addedConcepts.size() + modifiedConcepts.size() + removedConcepts.size() +
+           addedRelationships.size() + modifiedRelationships.size() + removedRelationships.size();
+}
+
+ModelDiff diff(const MentalModel& from, const MentalModel& to) {
+    ModelDiff result;
+    diffEntities(from, to, from.getConcepts(), to.getConcepts(),
+                 result.addedConcepts, result.modifiedConcepts, result.removedConcepts);
+    diffEntities(from, to, from.getRelationships(), to.getRelationships(),
+                 result.addedRelationships, result.modifiedRelationships, result.removedRelationships);
+    return result;
+}
+
+ModelMerge merge(const MentalModel& base, const MentalModel& ours, const MentalModel& theirs,
+                 ConflictResolution resolution) {
+    ModelMerge result;
+    ModelDiff& changes = result.changes;
+    EntityMerge<Concept>(resolution, changes.addedConcepts, changes.modifiedConcepts, changes.removedConcepts,
+                         result.conflictingConcepts)
+        .run(base, ours, theirs, base.getConcepts(), theirs.getConcepts());
+    EntityMerge<Relationship>(resolution, changes.addedRelationships, changes.modifiedRelationships,
+                              changes.removedRelationships, result.conflictingRelationships)
+        .run(base, ours, theirs, base.getRelationships(), theirs.getRelationships());
+
+    // Removing a concept takes its relationships along, so one that ours
+    // connected since base conflicts with theirs removing the concept
+    std::unordered_set<std::string> removedConcepts(changes.removedConcepts.begin(), changes.removedConcepts.end());
+    std::unordered_set<std::string> keptConcepts;
+    if (!removedConcepts.empty()) {
+        std::unordered_set<std::string> removedRelationships(changes.removedRelationships.begin(),
+                                                             changes.removedRelationships.end());
+        for (const auto& relationship : ours.getRelationships()) {
+            if (removedRelationships.count(relationship->getId()) ||
+                sameVersion(base.getRelationship(relationship->getId()),
+                            static_cast<const Relationship*>(relationship.get()))) {
+                continue;
+            }
+            for (const std::string* endpoint : {&relationship->getSourceConceptId(),
+                                                &relationship->getTargetConceptId()}) {
+                if (removedConcepts.count(*endpoint) && keptConcepts.insert(*endpoint).second) {
+                    result.conflictingConcepts.push_back(*endpoint);
+                }
+            }
+        }
+        if (resolution == ConflictResolution::KEEP_OURS && !keptConcepts.empty()) {
+            auto& removed = changes.removedConcepts;
+            removed.erase(std::remove_if(removed.begin(), removed.end(),
+                                         [&keptConcepts](const std::string& id) { return keptConcepts.count(id) > 0; }),
+                          removed.end());
+            for (const auto& id : keptConcepts) {
+                removedConcepts.erase(id);
+            }
+        }
+    }
+
+    // Relationships theirs brings in need both concepts in the merged model
+    std::unordered_set<std::string> addedConcepts;
+    for (const Concept* concept : changes.addedConcepts) {
+        addedConcepts.insert(concept->getId());
+    }
+    auto resolves = [&](const std::string& id) {
+        return addedConcepts.count(id) || (ours.getConcept(id) && !removedConcepts.count(id));
+    };
+    for (auto* list : {&changes.addedRelationships, &changes.modifiedRelationships}) {
+        auto dangling = std::remove_if(list->begin(), list->end(), [&](const Relationship* relationship) {
+            if (resolves(relationship->getSourceConceptId()) && resolves(relationship->getTargetConceptId())) {
+                return false;
+            }
+            result.conflictingRelationships.push_back(relationship->getId());
+            return true;
+        });
+        list->erase(dangling, list->end());
+    }
+    return result;
+}
+
+} // namespace qlink
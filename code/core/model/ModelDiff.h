@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace qlink {
+
+class MentalModel;
+class Concept;
+class Relationship;
+
+/**
+ * Entity-level difference between two models, matched by id. Entities are
+ * compared by content hash (see Concept::getContentHash), so those that
+ * did not change cost one lookup each.
+ *
+ * Added and modified entities point into the model the diff leads to and
+ * are valid while it is unchanged; ApplyDiffCommand copies them.
+ */
+struct ModelDiff {
+    std::vector<const Concept*> addedConcepts;
+    std::vector<const Concept*> modifiedConcepts;
+    std::vector<std::string> removedConcepts;
+    std::vector<const Relationship*> addedRelationships;
+    std::vector<const Relationship*> modifiedRelationships; // Possibly between other concepts
+    std::vector<std::string> removedRelationships;
+
+    bool isEmpty() const;
+    size_t size() const;
+};
+
+/**
+ * What takes from to to; model names and entity times are not compared.
+ * Linear in the size of both models.
+ */
+ModelDiff diff(const MentalModel& from, const MentalModel& to);
+
+/**
+ * Result of a three-way merge: the changes that bring theirs' edits into
+ * ours, and the entities both sides changed differently
+ */
+struct ModelMerge {
+    ModelDiff changes; // To apply to ours; entities point into theirs
+    std::vector<std::string> conflictingConcepts;
+    std::vector<std::string> conflictingRelationships; // Including those whose concepts the merge drops
+};
+
+/**
+ * How merge() settles an entity that both sides changed, or one changed
+ * and the other removed
+ */
+enum class ConflictResolution {
+    KEEP_OURS,
+    TAKE_THEIRS
+};
+
+/**
+ * Merge the edits theirs made since base into ours, both copies of base.
+ * An entity only one side changed takes that side's version; one both
+ * changed the same way is left alone; any other is a conflict, settled by
+ * resolution. A relationship whose concepts the merged model would lack is
+ * left out and reported as a conflict. Linear in the size of the models.
+ */
+ModelMerge merge(const MentalModel& base, const MentalModel& ours, const MentalModel& theirs,
+                 ConflictResolution resolution = ConflictResolution::KEEP_OURS);
+
+} // namespace qlink
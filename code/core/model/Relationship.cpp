@@ -1,4 +1,6 @@
 #include "Relationship.h"
+#include "../common/Hash.h"
+#include "../common/Json.h"
 #include <sstream>
 #include <random>
 #include <iomanip>
@@ -8,25 +10,62 @@ namespace qlink {
 Relationship::Relationship(const std::string& sourceId, const std::string& targetId,
                           const std::string& type, bool directed, double weight)
     : id(generateId()), sourceConceptId(sourceId), targetConceptId(targetId),
-      type(type), isDirected(directed), weight(weight) {
+      type(type), isDirected(directed), weight(weight), created(currentTimestamp()), modified(created) {
 }
 
 Relationship::Relationship(const std::string& id, const std::string& sourceId, const std::string& targetId,
                           const std::string& type, bool directed, double weight)
     : id(id), sourceConceptId(sourceId), targetConceptId(targetId),
-      type(type), isDirected(directed), weight(weight) {
+      type(type), isDirected(directed), weight(weight), created(currentTimestamp()), modified(created) {
 }
 
 void Relationship::setType(const std::string& type) {
+    if (this->type == type) return;
     this->type = type;
+    touch();
 }
 
 void Relationship::setWeight(double weight) {
+    if (this->weight == weight) return;
     this->weight = weight;
+    touch();
 }
 
 void Relationship::setDirected(bool directed) {
-    this->isDirected = directed;
+    if (isDirected == directed) return;
+    isDirected = directed;
+    touch();
+}
+
+void Relationship::assignContent(const Relationship& other) {
+    setType(other.type);
+    setDirected(other.isDirected);
+    setWeight(other.weight);
+    setTimestamps(other.created, other.modified);
+}
+
+uint64_t Relationship::getContentHash() const {
+    if (!contentHashValid) {
+        uint64_t hash = fnv1aField(sourceConceptId);
+        hash = fnv1aField(targetConceptId, hash);
+        hash = fnv1aField(type, hash);
+        uint8_t directed = isDirected ? 1 : 0;
+        hash = fnv1a(&directed, sizeof(directed), hash);
+        contentHash = fnv1a(&weight, sizeof(weight), hash);
+        contentHashValid = true;
+    }
+    return contentHash;
+}
+
+void Relationship::setTimestamps(Timestamp created, Timestamp modified) {
+    this->created = created;
+    this->modified = modified;
+}
+
+void Relationship::touch() {
+    modified = currentTimestamp();
+    dirty = true;
+    contentHashValid = false;
 }
 
 bool Relationship::connects(const std::string& concept1, const std::string& concept2) const {
@@ -71,22 +110,83 @@ std::string Relationship::toString() const {
 }
 
 std::string Relationship::toJson() const {
-    std::ostringstream oss;
-    oss << "{";
-    oss << "\"id\":\"" << id << "\",";
-    oss << "\"sourceConceptId\":\"" << sourceConceptId << "\",";
-    oss << "\"targetConceptId\":\"" << targetConceptId << "\",";
-    oss << "\"type\":\"" << type << "\",";
-    oss << "\"isDirected\":" << (isDirected ? "true" : "false") << ",";
-    oss << "\"weight\":" << weight;
-    oss << "}";
-    return oss.str();
+    std::string json;
+    JsonWriter writer(json);
+    writeJson(writer);
+    return json;
+}
+
+void Relationship::writeJson(JsonWriter& writer) const {
+    writer.beginObject();
+    writer.key("id");
+    writer.string(id);
+    writer.key("sourceConceptId");
+    writer.string(sourceConceptId);
+    writer.key("targetConceptId");
+    writer.string(targetConceptId);
+    writer.key("type");
+    writer.string(type);
+    writer.key("isDirected");
+    writer.boolean(isDirected);
+    writer.key("weight");
+    writer.number(weight);
+    writer.key("created");
+    writer.string(formatTimestamp(created));
+    writer.key("modified");
+    writer.string(formatTimestamp(modified));
+    writer.endObject();
+}
+
+std::unique_ptr<Relationship> Relationship::fromJson(JsonReader& reader) {
+    std::string id;
+    std::string sourceId;
+    std::string targetId;
+    std::string type;
+    bool directed = false;
+    double weight = 1.0;
+    Timestamp created = 0;
+    Timestamp modified = 0;
+    bool stamped = false;
+
+    reader.beginObject();
+    std::string_view key;
+    while (reader.nextMember(key)) {
+        if (key == "id") {
+            id = reader.readString();
+        } else if (key == "sourceConceptId") {
+            sourceId = reader.readString();
+        } else if (key == "targetConceptId") {
+            targetId = reader.readString();
+        } else if (key == "type") {
+            type = reader.readString();
+        } else if (key == "isDirected" || key == "directed") {
+            // ModelManager's files say "directed"
+            directed = reader.readBool();
+        } else if (key == "weight") {
+            weight = reader.readNumber();
+        } else if ((key == "created" || key == "modified") && reader.peek() == JsonReader::Type::String) {
+            // Unreadable times are left at the load time
+            stamped = parseTimestamp(reader.readString(), key == "created" ? created : modified) || stamped;
+        } else {
+            reader.skipValue();
+        }
+    }
+
+    if (sourceId.empty() || targetId.empty()) {
+        return nullptr;
+    }
+    auto relationship = id.empty() ? std::make_unique<Relationship>(sourceId, targetId, type, directed, weight)
+                                   : std::make_unique<Relationship>(id, sourceId, targetId, type, directed, weight);
+    if (stamped) {
+        relationship->setTimestamps(created ? created : modified, modified ? modified : created);
+    }
+    return relationship;
 }
 
 std::string Relationship::generateId() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, 15);
+    // One engine per thread, so entities can be created on load workers
+    thread_local std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<> dis(0, 15);
     
     std::ostringstream oss;
     oss << "rel_";
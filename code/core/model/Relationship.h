@@ -2,9 +2,13 @@
 
 #include <string>
 #include <memory>
+#include "../common/Timestamp.h"
 
 namespace qlink {
 
+class JsonReader;
+class JsonWriter;
+
 /**
  * Represents a relationship edge between two concepts
  */
@@ -16,6 +20,11 @@ private:
     std::string type;
     bool isDirected;
     double weight;
+    Timestamp created;
+    Timestamp modified;
+    bool dirty = true; // Changed since markClean(); new relationships start out dirty
+    mutable uint64_t contentHash = 0;
+    mutable bool contentHashValid = false;
 
 public:
     // Constructors
@@ -31,11 +40,36 @@ public:
     const std::string& getType() const { return type; }
     bool getIsDirected() const { return isDirected; }
     double getWeight() const { return weight; }
+    Timestamp getCreated() const { return created; }
+    Timestamp getModified() const { return modified; }
     
-    // Setters
+    // Setters; each one that changes something stamps the modification time
+    // and marks the relationship dirty
     void setType(const std::string& type);
     void setWeight(double weight);
     void setDirected(bool directed);
+
+    /**
+     * Take other's type, direction, weight and times, changing only what
+     * differs; the id and endpoints stay
+     */
+    void assignContent(const Relationship& other);
+    
+    /**
+     * Hash of the endpoints, type, direction and weight, but not the id or
+     * times. Computed once and kept until the relationship changes.
+     */
+    uint64_t getContentHash() const;
+    
+    // Change tracking
+
+    /**
+     * Restore timestamps read from a file; leaves the dirty flag alone
+     */
+    void setTimestamps(Timestamp created, Timestamp modified);
+    bool isDirty() const { return dirty; }
+    void markClean() { dirty = false; }
+    void markDirty() { dirty = true; }
     
     // Utility methods
     bool connects(const std::string& concept1, const std::string& concept2) const;
@@ -46,8 +80,16 @@ public:
     
     // JSON serialization
     std::string toJson() const;
+    void writeJson(JsonWriter& writer) const;
+
+    /**
+     * Read one relationship object; unknown keys are skipped
+     * @throws ParseException on malformed input
+     */
+    static std::unique_ptr<Relationship> fromJson(JsonReader& reader);
 
 private:
+    void touch();
     static std::string generateId();
 };
 
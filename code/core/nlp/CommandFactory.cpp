@@ -1,135 +1,351 @@
 #include "CommandFactory.h"
 #include "Commands.h"
 #include "../model/MentalModel.h"
-#include <regex>
-#include <algorithm>
+#include <array>
 #include <cctype>
+#include <string_view>
+#include <vector>
 
 namespace qlink {
 
-// Helper function to trim whitespace
-static std::string trim(const std::string& str) {
-    size_t first = str.find_first_not_of(" \t\n\r");
-    if (first == std::string::npos) return "";
-    size_t last = str.find_last_not_of(" \t\n\r");
-    return str.substr(first, last - first + 1);
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+    while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+bool equalsIgnoreCase(std::string_view first, std::string_view second) {
+    if (first.size() != second.size()) return false;
+    for (size_t i = 0; i < first.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(first[i])) != std::tolower(static_cast<unsigned char>(second[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool startsWithIgnoreCase(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && equalsIgnoreCase(text.substr(0, prefix.size()), prefix);
+}
+
+bool containsIgnoreCase(std::string_view text, std::string_view part) {
+    for (size_t i = 0; i + part.size() <= text.size(); ++i) {
+        if (equalsIgnoreCase(text.substr(i, part.size()), part)) return true;
+    }
+    return false;
 }
 
-// Helper function to convert to lowercase
-static std::string toLower(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
-    return result;
+// Split on whitespace in one pass; tokens point into text
+std::vector<std::string_view> tokenize(std::string_view text) {
+    std::vector<std::string_view> tokens;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && isSpace(text[i])) ++i;
+        size_t start = i;
+        while (i < text.size() && !isSpace(text[i])) ++i;
+        if (i > start) tokens.push_back(text.substr(start, i - start));
+    }
+    return tokens;
 }
 
-// Helper to find concept by name (case-insensitive)
-static std::string findConceptIdByName(MentalModel* model, const std::string& name) {
-    std::string lowerName = toLower(name);
+// What the words or text an element matched are kept as
+enum class Capture { NONE, NAME, OTHER_NAME, TYPE, DESCRIPTION, DIRECTION, COUNT };
+
+enum class Action { ADD_CONCEPT, REMOVE_CONCEPT, CONNECT, DISCONNECT, ADD_NAMED };
+
+/**
+ * One step of a rule: a choice of keywords, alternatives separated by '|'
+ * and matched whole-word ignoring case, or free text (words == nullptr)
+ * taking as few tokens as lets the rest of the rule match. Consecutive
+ * elements with the same non-zero group are optional together.
+ */
+struct GrammarElement {
+    const char* words;
+    Capture capture;
+    int optionalGroup;
+};
+
+struct GrammarRule {
+    Action action;
+    bool anchored; // Only at the start of the input, not anywhere in it
+    std::vector<GrammarElement> elements;
+};
+
+// Tried in order; a rule whose concepts do not resolve gives way to the next
+const GrammarRule GRAMMAR[] = {
+    // add concept <name> [with description <text>]
+    {Action::ADD_CONCEPT, false, {
+        {"add|create", Capture::NONE, 0},
+        {"concept", Capture::NONE, 0},
+        {nullptr, Capture::NAME, 0},
+        {"with|having", Capture::NONE, 1},
+        {"description|desc", Capture::NONE, 1},
+        {nullptr, Capture::DESCRIPTION, 1}}},
+    // remove concept <name>
+    {Action::REMOVE_CONCEPT, false, {
+        {"remove|delete", Capture::NONE, 0},
+        {"concept", Capture::NONE, 0},
+        {nullptr, Capture::NAME, 0}}},
+    // connect <name> to <name> [as <type>] [directed]
+    {Action::CONNECT, false, {
+        {"connect|link|relate", Capture::NONE, 0},
+        {nullptr, Capture::NAME, 0},
+        {"to|with|and", Capture::NONE, 0},
+        {nullptr, Capture::OTHER_NAME, 0},
+        {"as|type|with type", Capture::NONE, 1},
+        {nullptr, Capture::TYPE, 1},
+        {"directed|undirected", Capture::DIRECTION, 2}}},
+    // disconnect <name> from <name>, remove link between <name> and <name>
+    {Action::DISCONNECT, false, {
+        {"disconnect|unlink|remove link|remove relationship", Capture::NONE, 0},
+        {"between", Capture::NONE, 1},
+        {nullptr, Capture::NAME, 0},
+        {"from|and", Capture::NONE, 0},
+        {nullptr, Capture::OTHER_NAME, 0}}},
+    // add <name>
+    {Action::ADD_NAMED, true, {
+        {"add", Capture::NONE, 0},
+        {nullptr, Capture::NAME, 0}}},
+};
+
+using Captures = std::array<std::string_view, static_cast<size_t>(Capture::COUNT)>;
+
+/**
+ * GRAMMAR with its keywords split into tokens, built on first use. The
+ * matcher backtracks over tokens in regular expression order: optional
+ * parts present before absent, free text shortest first, alternatives
+ * left to right.
+ */
+class CompiledGrammar {
+public:
+    struct Element {
+        std::vector<std::vector<std::string_view>> alternatives; // Empty for free text
+        Capture capture = Capture::NONE;
+        size_t skipTo = 0; // On the first element of an optional group, the element after it
+    };
+
+    struct Rule {
+        Action action;
+        bool anchored;
+        std::vector<Element> elements;
+    };
+
+    static const CompiledGrammar& instance() {
+        static const CompiledGrammar grammar;
+        return grammar;
+    }
+
+    const std::vector<Rule>& getRules() const { return rules; }
+
+    /**
+     * Match rule against tokens from the leftmost start it can
+     */
+    static bool match(const Rule& rule, const std::vector<std::string_view>& tokens, Captures& captures) {
+        size_t lastStart = rule.anchored ? 0 : tokens.size();
+        for (size_t start = 0; start <= lastStart && start < tokens.size(); ++start) {
+            captures = Captures{};
+            if (Matcher{rule.elements, tokens, captures}.from(0, start, false)) return true;
+        }
+        return false;
+    }
+
+private:
+    CompiledGrammar() {
+        for (const GrammarRule& source : GRAMMAR) {
+            Rule rule{source.action, source.anchored, {}};
+            for (size_t i = 0; i < source.elements.size(); ++i) {
+                const GrammarElement& element = source.elements[i];
+                Element compiled;
+                compiled.capture = element.capture;
+                if (element.words) {
+                    for (std::string_view words : split(element.words, '|')) {
+                        compiled.alternatives.push_back(tokenize(words));
+                    }
+                }
+                bool opensGroup = element.optionalGroup != 0 &&
+                                  (i == 0 || source.elements[i - 1].optionalGroup != element.optionalGroup);
+                if (opensGroup) {
+                    size_t end = i + 1;
+                    while (end < source.elements.size() && source.elements[end].optionalGroup == element.optionalGroup) {
+                        ++end;
+                    }
+                    compiled.skipTo = end;
+                }
+                rule.elements.push_back(std::move(compiled));
+            }
+            rules.push_back(std::move(rule));
+        }
+    }
+
+    static std::vector<std::string_view> split(std::string_view text, char separator) {
+        std::vector<std::string_view> parts;
+        size_t start = 0;
+        for (size_t end; (end = text.find(separator, start)) != std::string_view::npos; start = end + 1) {
+            parts.push_back(text.substr(start, end - start));
+        }
+        parts.push_back(text.substr(start));
+        return parts;
+    }
+
+    // Free text may be quoted, and holds no quotes or line breaks
+    static std::string_view unquote(std::string_view text) {
+        if (!text.empty() && (text.front() == '"' || text.front() == '\'')) text.remove_prefix(1);
+        if (!text.empty() && (text.back() == '"' || text.back() == '\'')) text.remove_suffix(1);
+        if (text.find_first_of("\"'\n") != std::string_view::npos) return {};
+        return trim(text);
+    }
+
+    struct Matcher {
+        const std::vector<Element>& elements;
+        const std::vector<std::string_view>& tokens;
+        Captures& captures;
+
+        bool from(size_t index, size_t token, bool inGroup) {
+            if (index == elements.size()) return token == tokens.size();
+            const Element& element = elements[index];
+            if (element.skipTo && !inGroup) {
+                return from(index, token, true) || from(element.skipTo, token, false);
+            }
+            std::string_view& capture = captures[static_cast<size_t>(element.capture)];
+            if (element.alternatives.empty()) {
+                for (size_t end = token + 1; end <= tokens.size(); ++end) {
+                    std::string_view text = span(token, end);
+                    if (text.find_first_of("\"'\n", 1) < text.size() - 1) break; // Longer spans keep the quote inside
+                    capture = unquote(text);
+                    if (!capture.empty() && from(index + 1, end, false)) return true;
+                }
+            } else {
+                for (const auto& words : element.alternatives) {
+                    if (!matchesWords(words, token)) continue;
+                    capture = span(token, token + words.size());
+                    if (from(index + 1, token + words.size(), false)) return true;
+                }
+            }
+            capture = {};
+            return false;
+        }
+
+        bool matchesWords(const std::vector<std::string_view>& words, size_t token) const {
+            if (token + words.size() > tokens.size()) return false;
+            for (size_t i = 0; i < words.size(); ++i) {
+                if (!equalsIgnoreCase(tokens[token + i], words[i])) return false;
+            }
+            return true;
+        }
+
+        // The input from tokens[first] through tokens[end - 1], spacing included
+        std::string_view span(size_t first, size_t end) const {
+            const char* begin = tokens[first].data();
+            const char* last = tokens[end - 1].data() + tokens[end - 1].size();
+            return std::string_view(begin, static_cast<size_t>(last - begin));
+        }
+    };
+
+    std::vector<Rule> rules;
+};
+
+// Concepts are named case-insensitively
+std::string findConceptIdByName(MentalModel* model, std::string_view name) {
     for (const auto& concept : model->getConcepts()) {
-        if (toLower(concept->getName()) == lowerName) {
+        if (equalsIgnoreCase(concept->getName(), name)) {
             return concept->getId();
         }
     }
     return "";
 }
 
-std::unique_ptr<ICommand> CommandFactory::createCommand(const std::string& input, MentalModel* model) {
-    if (!model) return nullptr;
-    
-    std::string trimmedInput = trim(input);
-    if (trimmedInput.empty()) return nullptr;
-    
-    std::string lowerInput = toLower(trimmedInput);
-    
-    // Pattern 1: "add concept <name>" or "create concept <name>"
-    std::regex addConceptRegex(R"((add|create)\s+concept\s+[\"']?([^\"'\n]+?)[\"']?(?:\s+(?:with|having)\s+(?:description|desc)\s+[\"']?([^\"'\n]+?)[\"']?)?$)", std::regex::icase);
-    std::smatch match;
-    
-    if (std::regex_search(trimmedInput, match, addConceptRegex)) {
-        std::string conceptName = trim(match[2].str());
-        std::string description = match[3].matched ? trim(match[3].str()) : "";
-        return std::make_unique<AddConceptCommand>(model, conceptName, description);
-    }
-    
-    // Pattern 2: "remove concept <name>" or "delete concept <name>"
-    std::regex removeConceptRegex(R"((remove|delete)\s+concept\s+[\"']?([^\"'\n]+?)[\"']?$)", std::regex::icase);
-    if (std::regex_search(trimmedInput, match, removeConceptRegex)) {
-        std::string conceptName = trim(match[2].str());
-        std::string conceptId = findConceptIdByName(model, conceptName);
+std::unique_ptr<ICommand> buildCommand(Action action, const Captures& captures, MentalModel* model) {
+    auto captured = [&captures](Capture capture) { return captures[static_cast<size_t>(capture)]; };
+    std::string_view name = captured(Capture::NAME);
+    switch (action) {
+    case Action::ADD_CONCEPT:
+        return std::make_unique<AddConceptCommand>(model, std::string(name),
+                                                   std::string(captured(Capture::DESCRIPTION)));
+    case Action::REMOVE_CONCEPT: {
+        std::string conceptId = findConceptIdByName(model, name);
         if (!conceptId.empty()) {
             return std::make_unique<RemoveConceptCommand>(model, conceptId);
         }
+        return nullptr;
     }
-    
-    // Pattern 3: "connect <concept1> to <concept2>" or "link <concept1> to <concept2>"
-    std::regex connectRegex(R"((connect|link|relate)\s+[\"']?([^\"'\n]+?)[\"']?\s+(?:to|with|and)\s+[\"']?([^\"'\n]+?)[\"']?(?:\s+(?:as|type|with type)\s+[\"']?([^\"'\n]+?)[\"']?)?(?:\s+(directed|undirected))?$)", std::regex::icase);
-    if (std::regex_search(trimmedInput, match, connectRegex)) {
-        std::string concept1 = trim(match[2].str());
-        std::string concept2 = trim(match[3].str());
-        std::string type = match[4].matched ? trim(match[4].str()) : "relates_to";
-        bool directed = match[5].matched && toLower(match[5].str()) == "directed";
-        
-        std::string id1 = findConceptIdByName(model, concept1);
-        std::string id2 = findConceptIdByName(model, concept2);
-        
-        if (!id1.empty() && !id2.empty()) {
-            return std::make_unique<CreateRelationshipCommand>(model, id1, id2, type, directed);
-        }
+    case Action::CONNECT: {
+        std::string id1 = findConceptIdByName(model, name);
+        std::string id2 = findConceptIdByName(model, captured(Capture::OTHER_NAME));
+        if (id1.empty() || id2.empty()) return nullptr;
+        std::string_view type = captured(Capture::TYPE);
+        bool directed = equalsIgnoreCase(captured(Capture::DIRECTION), "directed");
+        return std::make_unique<CreateRelationshipCommand>(model, id1, id2,
+                                                           type.empty() ? "relates_to" : std::string(type), directed);
     }
-    
-    // Pattern 4: "disconnect <concept1> from <concept2>" or "remove link between <concept1> and <concept2>"
-    std::regex disconnectRegex(R"((disconnect|unlink|remove (?:link|relationship))\s+(?:between\s+)?[\"']?([^\"'\n]+?)[\"']?\s+(?:from|and)\s+[\"']?([^\"'\n]+?)[\"']?$)", std::regex::icase);
-    if (std::regex_search(trimmedInput, match, disconnectRegex)) {
-        std::string concept1 = trim(match[2].str());
-        std::string concept2 = trim(match[3].str());
-        
-        std::string id1 = findConceptIdByName(model, concept1);
-        std::string id2 = findConceptIdByName(model, concept2);
-        
-        if (!id1.empty() && !id2.empty()) {
-            // Find the relationship between these two concepts
-            for (const auto& rel : model->getRelationships()) {
-                if (rel->connects(id1, id2)) {
-                    return std::make_unique<DeleteRelationshipCommand>(model, rel->getId());
-                }
+    case Action::DISCONNECT: {
+        std::string id1 = findConceptIdByName(model, name);
+        std::string id2 = findConceptIdByName(model, captured(Capture::OTHER_NAME));
+        if (id1.empty() || id2.empty()) return nullptr;
+        // Find the relationship between these two concepts
+        for (const auto& rel : model->getRelationships()) {
+            if (rel->connects(id1, id2)) {
+                return std::make_unique<DeleteRelationshipCommand>(model, rel->getId());
             }
         }
+        return nullptr;
     }
-    
-    // Pattern 5: Simple "add <name>" without "concept" keyword
-    std::regex simpleAddRegex(R"(^add\s+[\"']?([^\"'\n]+?)[\"']?$)", std::regex::icase);
-    if (std::regex_search(trimmedInput, match, simpleAddRegex)) {
-        std::string conceptName = trim(match[1].str());
+    case Action::ADD_NAMED:
         // Avoid matching if it looks like it's trying to add something else
-        if (toLower(conceptName).find("relationship") == std::string::npos &&
-            toLower(conceptName).find("link") == std::string::npos) {
-            return std::make_unique<AddConceptCommand>(model, conceptName, "");
+        if (containsIgnoreCase(name, "relationship") || containsIgnoreCase(name, "link")) {
+            return nullptr;
+        }
+        return std::make_unique<AddConceptCommand>(model, std::string(name), "");
+    }
+    return nullptr;
+}
+
+// Words that start a command
+constexpr std::string_view COMMAND_KEYWORDS[] = {
+    "add", "create", "remove", "delete", "connect", "link",
+    "disconnect", "unlink", "relate"
+};
+
+} // namespace
+
+std::unique_ptr<ICommand> CommandFactory::createCommand(const std::string& input, MentalModel* model) {
+    if (!model) return nullptr;
+
+    std::vector<std::string_view> tokens = tokenize(input);
+    if (tokens.empty()) return nullptr;
+
+    Captures captures;
+    for (const auto& rule : CompiledGrammar::instance().getRules()) {
+        if (CompiledGrammar::match(rule, tokens, captures)) {
+            if (auto command = buildCommand(rule.action, captures, model)) {
+                return command;
+            }
         }
     }
-    
     return nullptr;
 }
 
 bool CommandFactory::isValidCommand(const std::string& input) {
-    std::string trimmedInput = trim(input);
+    std::string_view trimmedInput = trim(input);
     if (trimmedInput.empty()) return false;
-    
-    std::string lowerInput = toLower(trimmedInput);
-    
-    // Check for command keywords
-    std::vector<std::string> keywords = {
-        "add", "create", "remove", "delete", "connect", "link", 
-        "disconnect", "unlink", "relate"
-    };
-    
-    for (const auto& keyword : keywords) {
-        if (lowerInput.find(keyword) == 0 || 
-            lowerInput.find(" " + keyword + " ") != std::string::npos) {
-            return true;
+
+    // A keyword at the start, or anywhere between spaces
+    for (std::string_view keyword : COMMAND_KEYWORDS) {
+        if (startsWithIgnoreCase(trimmedInput, keyword)) return true;
+        for (size_t space = trimmedInput.find(' '); space != std::string_view::npos;
+             space = trimmedInput.find(' ', space + 1)) {
+            std::string_view rest = trimmedInput.substr(space + 1);
+            if (startsWithIgnoreCase(rest, keyword) && rest.size() > keyword.size() && rest[keyword.size()] == ' ') {
+                return true;
+            }
         }
     }
-    
+
     return false;
 }
 
@@ -157,4 +373,4 @@ std::string CommandFactory::getHelpText() {
            "  - remove concept AI\n";
 }
 
-} // namespace qlink
\ No newline at end of file
+} // namespace qlink
@@ -2,6 +2,7 @@
 #include "../model/MentalModel.h"
 #include "../model/Concept.h"
 #include "../model/Relationship.h"
+#include "../model/ModelDiff.h"
 #include <memory>
 
 namespace qlink {
@@ -115,4 +116,219 @@ std::string DeleteRelationshipCommand::getDescription() const {
     return "Delete relationship: " + relationshipId;
 }
 
+// RemoveEntitiesCommand
+RemoveEntitiesCommand::RemoveEntitiesCommand(MentalModel* model, const std::vector<std::string>& conceptIds,
+                                             const std::vector<std::string>& relationshipIds)
+    : model(model), conceptIds(conceptIds), relationshipIds(relationshipIds) {
+}
+
+void RemoveEntitiesCommand::execute() {
+    // Saved as copies, which do not depend on the model's payload cache
+    for (const auto& relationship : model->removeRelationshipsBulk(relationshipIds)) {
+        removedRelationships.push_back(std::make_unique<Relationship>(*relationship));
+    }
+    std::vector<std::unique_ptr<Relationship>> connected;
+    for (const auto& concept : model->removeConceptsBulk(conceptIds, &connected)) {
+        removedConcepts.push_back(std::make_unique<Concept>(*concept));
+    }
+    for (auto& relationship : connected) {
+        removedRelationships.push_back(std::make_unique<Relationship>(*relationship));
+    }
+}
+
+void RemoveEntitiesCommand::undo() {
+    model->addConceptsBulk(std::move(removedConcepts));
+    model->addRelationshipsBulk(std::move(removedRelationships));
+    removedConcepts.clear();
+    removedRelationships.clear();
+}
+
+std::string RemoveEntitiesCommand::getDescription() const {
+    return "Remove " + std::to_string(conceptIds.size()) + " concepts and " +
+           std::to_string(relationshipIds.size()) + " relationships";
+}
+
+// InsertEntitiesCommand
+InsertEntitiesCommand::InsertEntitiesCommand(MentalModel* model, const std::vector<const Concept*>& concepts,
+                                             const std::vector<const Relationship*>& relationships)
+    : model(model) {
+    for (const Concept* concept : concepts) {
+        this->concepts.push_back(std::make_unique<Concept>(*concept));
+    }
+    for (const Relationship* relationship : relationships) {
+        this->relationships.push_back(std::make_unique<Relationship>(*relationship));
+    }
+}
+
+void InsertEntitiesCommand::execute() {
+    std::vector<std::unique_ptr<Concept>> newConcepts;
+    newConcepts.reserve(concepts.size());
+    for (const auto& concept : concepts) {
+        addedConceptIds.push_back(concept->getId());
+        newConcepts.push_back(std::make_unique<Concept>(*concept));
+    }
+    model->addConceptsBulk(std::move(newConcepts));
+
+    std::vector<std::unique_ptr<Relationship>> newRelationships;
+    newRelationships.reserve(relationships.size());
+    for (const auto& relationship : relationships) {
+        // Those whose concepts are missing are not added, so not removed on undo
+        if (model->getConcept(relationship->getSourceConceptId()) &&
+            model->getConcept(relationship->getTargetConceptId())) {
+            addedRelationshipIds.push_back(relationship->getId());
+            newRelationships.push_back(std::make_unique<Relationship>(*relationship));
+        }
+    }
+    model->addRelationshipsBulk(std::move(newRelationships));
+}
+
+void InsertEntitiesCommand::undo() {
+    model->removeRelationshipsBulk(addedRelationshipIds);
+    model->removeConceptsBulk(addedConceptIds);
+    addedConceptIds.clear();
+    addedRelationshipIds.clear();
+}
+
+std::string InsertEntitiesCommand::getDescription() const {
+    return "Add " + std::to_string(concepts.size()) + " concepts and " + std::to_string(relationships.size()) +
+           " relationships";
+}
+
+// UpdateConceptCommand
+UpdateConceptCommand::UpdateConceptCommand(MentalModel* model, const Concept& target)
+    : model(model), target(std::make_unique<Concept>(target)) {
+}
+
+void UpdateConceptCommand::execute() {
+    Concept* concept = model->getConcept(target->getId());
+    if (concept) {
+        previous = std::make_unique<Concept>(*concept);
+        concept->assignContent(*target);
+        model->notifyConceptModified(concept->getId());
+    } else {
+        previous.reset();
+        model->addConcept(std::make_unique<Concept>(*target));
+    }
+    executed = true;
+}
+
+void UpdateConceptCommand::undo() {
+    if (!executed) {
+        return;
+    }
+    if (previous) {
+        if (Concept* concept = model->getConcept(target->getId())) {
+            concept->assignContent(*previous);
+            model->notifyConceptModified(concept->getId());
+        }
+        previous.reset();
+    } else {
+        model->removeConcept(target->getId());
+    }
+    executed = false;
+}
+
+std::string UpdateConceptCommand::getDescription() const {
+    return "Update concept: " + target->getName();
+}
+
+namespace {
+
+bool sameConcepts(const Relationship& first, const Relationship& second) {
+    return first.getSourceConceptId() == second.getSourceConceptId() &&
+           first.getTargetConceptId() == second.getTargetConceptId();
+}
+
+// Bring the model's relationship with wanted's id to wanted, replacing it if its concepts differ
+void putRelationship(MentalModel* model, const Relationship& wanted) {
+    Relationship* current = model->getRelationship(wanted.getId());
+    if (current && sameConcepts(*current, wanted)) {
+        current->assignContent(wanted);
+        model->notifyRelationshipModified(current->getId());
+        return;
+    }
+    if (current) {
+        model->removeRelationship(wanted.getId());
+    }
+    model->addRelationship(std::make_unique<Relationship>(wanted));
+}
+
+} // namespace
+
+// UpdateRelationshipCommand
+UpdateRelationshipCommand::UpdateRelationshipCommand(MentalModel* model, const Relationship& target)
+    : model(model), target(std::make_unique<Relationship>(target)) {
+}
+
+void UpdateRelationshipCommand::execute() {
+    const Relationship* current = model->getRelationship(target->getId());
+    previous = current ? std::make_unique<Relationship>(*current) : nullptr;
+    putRelationship(model, *target);
+    executed = true;
+}
+
+void UpdateRelationshipCommand::undo() {
+    if (!executed) {
+        return;
+    }
+    if (previous) {
+        putRelationship(model, *previous);
+        previous.reset();
+    } else {
+        model->removeRelationship(target->getId());
+    }
+    executed = false;
+}
+
+std::string UpdateRelationshipCommand::getDescription() const {
+    return "Update relationship: " + target->getSourceConceptId() + " -> " + target->getTargetConceptId();
+}
+
+// ApplyDiffCommand
+ApplyDiffCommand::ApplyDiffCommand(MentalModel* model, const ModelDiff& diff, const std::string& description)
+    : description(description) {
+    // Removals first, so an id removed and added again is free when it is added
+    std::vector<std::string> removedRelationships = diff.removedRelationships;
+    std::vector<const Relationship*> addedRelationships = diff.addedRelationships;
+    std::vector<const Relationship*> updatedRelationships;
+    for (const Relationship* relationship : diff.modifiedRelationships) {
+        const Relationship* current = model->getRelationship(relationship->getId());
+        if (current && (current->getSourceConceptId() != relationship->getSourceConceptId() ||
+                        current->getTargetConceptId() != relationship->getTargetConceptId())) {
+            removedRelationships.push_back(relationship->getId());
+            addedRelationships.push_back(relationship);
+        } else {
+            updatedRelationships.push_back(relationship);
+        }
+    }
+    if (!diff.removedConcepts.empty() || !removedRelationships.empty()) {
+        commands.push_back(std::make_unique<RemoveEntitiesCommand>(model, diff.removedConcepts, removedRelationships));
+    }
+    if (!diff.addedConcepts.empty() || !addedRelationships.empty()) {
+        commands.push_back(std::make_unique<InsertEntitiesCommand>(model, diff.addedConcepts, addedRelationships));
+    }
+    for (const Concept* concept : diff.modifiedConcepts) {
+        commands.push_back(std::make_unique<UpdateConceptCommand>(model, *concept));
+    }
+    for (const Relationship* relationship : updatedRelationships) {
+        commands.push_back(std::make_unique<UpdateRelationshipCommand>(model, *relationship));
+    }
+}
+
+void ApplyDiffCommand::execute() {
+    for (auto& command : commands) {
+        command->execute();
+    }
+}
+
+void ApplyDiffCommand::undo() {
+    for (auto it = commands.rbegin(); it != commands.rend(); ++it) {
+        (*it)->undo();
+    }
+}
+
+std::string ApplyDiffCommand::getDescription() const {
+    return description;
+}
+
 } // namespace qlink
\ No newline at end of file
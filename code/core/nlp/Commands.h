@@ -11,6 +11,7 @@ namespace qlink {
 class MentalModel;
 class Concept;
 class Relationship;
+struct ModelDiff;
 
 /**
  * Command to add a concept to the mental model
@@ -86,4 +87,110 @@ private:
     std::unique_ptr<Relationship> removedRelationship; // For undo
 };
 
+/**
+ * Command to remove many concepts and relationships in one pass over the
+ * model; the relationships involving the concepts go with them
+ */
+class RemoveEntitiesCommand : public ICommand {
+public:
+    RemoveEntitiesCommand(MentalModel* model, const std::vector<std::string>& conceptIds,
+                          const std::vector<std::string>& relationshipIds);
+
+    void execute() override;
+    void undo() override;
+    std::string getDescription() const override;
+
+private:
+    MentalModel* model;
+    std::vector<std::string> conceptIds;
+    std::vector<std::string> relationshipIds;
+    std::vector<std::unique_ptr<Concept>> removedConcepts; // For undo
+    std::vector<std::unique_ptr<Relationship>> removedRelationships; // For undo
+};
+
+/**
+ * Command to add copies of many concepts and relationships, keeping their
+ * ids; undone in one pass over the model
+ */
+class InsertEntitiesCommand : public ICommand {
+public:
+    InsertEntitiesCommand(MentalModel* model, const std::vector<const Concept*>& concepts,
+                          const std::vector<const Relationship*>& relationships);
+
+    void execute() override;
+    void undo() override;
+    std::string getDescription() const override;
+
+private:
+    MentalModel* model;
+    std::vector<std::unique_ptr<Concept>> concepts;
+    std::vector<std::unique_ptr<Relationship>> relationships;
+    std::vector<std::string> addedConceptIds; // For undo
+    std::vector<std::string> addedRelationshipIds; // For undo
+};
+
+/**
+ * Command to bring a concept to a given content, keeping its id; adds the
+ * concept if the model lacks it
+ */
+class UpdateConceptCommand : public ICommand {
+public:
+    UpdateConceptCommand(MentalModel* model, const Concept& target);
+
+    void execute() override;
+    void undo() override;
+    std::string getDescription() const override;
+
+private:
+    MentalModel* model;
+    std::unique_ptr<Concept> target;
+    std::unique_ptr<Concept> previous; // For undo; null if execute added the concept
+    bool executed = false;
+};
+
+/**
+ * Command to bring a relationship to a given content, keeping its id; adds
+ * the relationship if the model lacks it, and replaces it if its concepts
+ * changed
+ */
+class UpdateRelationshipCommand : public ICommand {
+public:
+    UpdateRelationshipCommand(MentalModel* model, const Relationship& target);
+
+    void execute() override;
+    void undo() override;
+    std::string getDescription() const override;
+
+private:
+    MentalModel* model;
+    std::unique_ptr<Relationship> target;
+    std::unique_ptr<Relationship> previous; // For undo; null if execute added the relationship
+    bool executed = false;
+};
+
+/**
+ * Command applying a ModelDiff (or the changes of a ModelMerge) as one
+ * undoable step. The diff's entities are copied, so the model they point
+ * into need not outlive the command.
+ */
+class ApplyDiffCommand : public ICommand {
+public:
+    ApplyDiffCommand(MentalModel* model, const ModelDiff& diff, const std::string& description = "Apply changes");
+
+    void execute() override;
+    void undo() override;
+    std::string getDescription() const override;
+
+    /**
+     * The steps, in the order execute() runs them: the removals, the
+     * additions, then one update per modified entity. A relationship moved
+     * to other concepts is removed and added again.
+     */
+    const std::vector<std::unique_ptr<ICommand>>& getCommands() const { return commands; }
+
+private:
+    std::vector<std::unique_ptr<ICommand>> commands;
+    std::string description;
+};
+
 } // namespace qlink
\ No newline at end of file
@@ -0,0 +1,808 @@
+#include "BinaryModelFormat.h"
+#include "FileSync.h"
+#include "../model/MentalModel.h"
+#include "../common/Hash.h"
+#include "../common/QLinkException.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <unordered_set>
+
+namespace qlink {
+
+using namespace binary_format;
+
+namespace {
+
+uint64_t align8(uint64_t offset) {
+    return (offset + 7) & ~uint64_t(7);
+}
+
+void pad(std::string& out) {
+    out.resize(align8(out.size()), '\0');
+}
+
+template <typename T>
+void append(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * Deduplicating string table
+ */
+class StringTable {
+public:
+    StringRef add(const std::string& text) {
+        auto it = refs.find(text);
+        if (it != refs.end()) return it->second;
+        StringRef ref{static_cast<uint32_t>(bytes.size()), static_cast<uint32_t>(text.size())};
+        bytes += text;
+        refs.emplace(text, ref);
+        return ref;
+    }
+
+    const std::string& getBytes() const { return bytes; }
+
+private:
+    std::string bytes;
+    std::unordered_map<std::string, StringRef> refs;
+};
+
+uint64_t adjacencyEntriesOffset(const FileHeader& header) {
+    return header.adjacencyOffset + align8((uint64_t(header.conceptCount) + 1) * sizeof(uint32_t));
+}
+
+size_t headerSize(uint32_t version) {
+    return version == 1 ? V1_HEADER_SIZE : sizeof(FileHeader);
+}
+
+// Redo file: "QLBP", uint32 version, uint64 hash before and after, uint32
+// edit count, then per edit uint64 offset, uint32 length and the bytes, and
+// last the FNV-1a hash of everything before it. The header's edit comes last.
+constexpr char REDO_MAGIC[4] = {'Q', 'L', 'B', 'P'};
+constexpr uint32_t REDO_VERSION = 1;
+
+struct Edit {
+    uint64_t offset;
+    std::string bytes;
+};
+
+std::string readAt(QFile& file, uint64_t offset, size_t length) {
+    std::string bytes(length, '\0');
+    if (length > 0 && (!file.seek(static_cast<qint64>(offset)) ||
+                       file.read(&bytes[0], static_cast<qint64>(length)) != static_cast<qint64>(length))) {
+        throw FileIOException("Cannot read binary model: " + file.fileName().toStdString());
+    }
+    return bytes;
+}
+
+template <typename T>
+T readRecordAt(QFile& file, uint64_t offset) {
+    T record;
+    std::memcpy(&record, readAt(file, offset, sizeof(T)).data(), sizeof(T));
+    return record;
+}
+
+template <typename T>
+std::string bytesOf(const T& value) {
+    return std::string(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * Edits to one file: records rewritten where they lie, and the strings
+ * they now need appended to the string table
+ */
+class PatchBuilder {
+public:
+    PatchBuilder(QFile& file, const FileHeader& header) : file(file), header(header) {}
+
+    /**
+     * Reference to text: old if it already holds text, else a new string
+     */
+    StringRef string(const std::string& text, const StringRef& old) {
+        if (old.length == text.size() && readString(old) == text) {
+            return old;
+        }
+        // The old string may be shared, so slack errs high
+        header.slackBytes += old.length;
+        auto found = added.find(text);
+        if (found != added.end()) return found->second;
+        StringRef ref{static_cast<uint32_t>(header.stringsSize + appended.size()), static_cast<uint32_t>(text.size())};
+        appended += text;
+        added.emplace(text, ref);
+        return ref;
+    }
+
+    std::string readString(const StringRef& ref) {
+        return readAt(file, header.stringsOffset + ref.offset, ref.length);
+    }
+
+    template <typename T>
+    void write(uint64_t offset, const T& record) {
+        edits[offset] = bytesOf(record);
+    }
+
+    QFile& file;
+    FileHeader header; // Updated as strings are added
+    std::map<uint64_t, std::string> edits; // By offset; never overlapping
+    std::string appended;
+
+private:
+    std::unordered_map<std::string, StringRef> added;
+};
+
+/**
+ * Position of each wanted entity in entities, whose order matches the
+ * file's records; one pass that stops once all are found
+ */
+template <typename T>
+bool findPositions(const std::vector<std::unique_ptr<T>>& entities, const std::vector<const T*>& wanted,
+                   std::unordered_map<const T*, uint32_t>& positions) {
+    if (wanted.empty()) return true;
+    std::unordered_set<const T*> remaining(wanted.begin(), wanted.end());
+    for (size_t i = 0; i < entities.size() && !remaining.empty(); ++i) {
+        if (remaining.erase(entities[i].get())) {
+            positions.emplace(entities[i].get(), static_cast<uint32_t>(i));
+        }
+    }
+    return remaining.empty();
+}
+
+void writeRedo(const std::string& redoPath, uint64_t baseHash, uint64_t newHash, const std::vector<Edit>& edits) {
+    std::string redo(REDO_MAGIC, sizeof(REDO_MAGIC));
+    redo += bytesOf(REDO_VERSION);
+    redo += bytesOf(baseHash);
+    redo += bytesOf(newHash);
+    redo += bytesOf(static_cast<uint32_t>(edits.size()));
+    for (const auto& edit : edits) {
+        redo += bytesOf(edit.offset);
+        redo += bytesOf(static_cast<uint32_t>(edit.bytes.size()));
+        redo += edit.bytes;
+    }
+    redo += bytesOf(fnv1a(redo.data(), redo.size()));
+
+    QString path = QString::fromStdString(redoPath);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(redo.data(), static_cast<qint64>(redo.size())) != static_cast<qint64>(redo.size()) ||
+        !syncFile(file) || !file.commit()) {
+        throw FileIOException("Cannot write binary model redo file: " + redoPath);
+    }
+    syncParentDirectory(path);
+}
+
+/**
+ * @return false if the redo file is damaged
+ */
+bool readRedo(const std::string& redo, uint64_t& baseHash, uint64_t& newHash, std::vector<Edit>& edits) {
+    if (redo.size() < sizeof(REDO_MAGIC) + sizeof(uint64_t) ||
+        redo.compare(0, sizeof(REDO_MAGIC), REDO_MAGIC, sizeof(REDO_MAGIC)) != 0) {
+        return false;
+    }
+    uint64_t hash;
+    size_t end = redo.size() - sizeof(hash);
+    std::memcpy(&hash, redo.data() + end, sizeof(hash));
+    if (fnv1a(redo.data(), end) != hash) return false;
+
+    size_t pos = sizeof(REDO_MAGIC);
+    auto get = [&](void* value, size_t length) {
+        if (length > end - pos) return false;
+        std::memcpy(value, redo.data() + pos, length);
+        pos += length;
+        return true;
+    };
+    uint32_t version;
+    uint32_t count;
+    if (!get(&version, sizeof(version)) || version != REDO_VERSION || !get(&baseHash, sizeof(baseHash)) ||
+        !get(&newHash, sizeof(newHash)) || !get(&count, sizeof(count))) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        Edit edit;
+        uint32_t length;
+        if (!get(&edit.offset, sizeof(edit.offset)) || !get(&length, sizeof(length)) || length > end - pos) {
+            return false;
+        }
+        edit.bytes.assign(redo.data() + pos, length);
+        pos += length;
+        edits.push_back(std::move(edit));
+    }
+    return !edits.empty();
+}
+
+/**
+ * Write the edits, the last one (the header) only once the rest is on disk
+ */
+void applyEdits(const std::string& filePath, const std::vector<Edit>& edits) {
+    QFile file(QString::fromStdString(filePath));
+    if (!file.open(QIODevice::ReadWrite)) {
+        throw FileIOException("Cannot open binary model for patching: " + filePath);
+    }
+    auto write = [&](const Edit& edit) {
+        return file.seek(static_cast<qint64>(edit.offset)) &&
+               file.write(edit.bytes.data(), static_cast<qint64>(edit.bytes.size())) ==
+                   static_cast<qint64>(edit.bytes.size());
+    };
+    bool written = true;
+    for (size_t i = 0; i + 1 < edits.size() && written; ++i) {
+        written = write(edits[i]);
+    }
+    if (!written || !syncFile(file) || !write(edits.back()) || !syncFile(file)) {
+        throw FileIOException("Cannot patch binary model: " + filePath);
+    }
+}
+
+} // namespace
+
+uint64_t binary_format::pageChecksum(const char* page, size_t length, uint64_t pageIndex) {
+    // Seeded by the index, so swapped pages change the sum
+    return fnv1a(page, length, fnv1a(&pageIndex, sizeof(pageIndex)));
+}
+
+uint64_t binary_format::checksum(const char* data, size_t size) {
+    uint64_t sum = 0;
+    for (uint64_t page = 0; page * CHECKSUM_PAGE_BYTES < size; ++page) {
+        size_t offset = page * CHECKSUM_PAGE_BYTES;
+        sum += pageChecksum(data + offset, std::min(CHECKSUM_PAGE_BYTES, size - offset), page);
+    }
+    return sum;
+}
+
+std::string BinaryModelWriter::encode(const MentalModel& model) {
+    StringTable strings;
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.modelName = strings.add(model.getModelName());
+
+    const auto& concepts = model.getConcepts();
+    std::unordered_map<std::string, uint32_t> conceptIndex;
+    conceptIndex.reserve(concepts.size());
+
+    std::vector<ConceptRecord> conceptRecords;
+    std::vector<StringRef> tags;
+    conceptRecords.reserve(concepts.size());
+    for (const auto& concept : concepts) {
+        conceptIndex.emplace(concept->getId(), static_cast<uint32_t>(conceptRecords.size()));
+
+        ConceptRecord record{};
+        record.id = strings.add(concept->getId());
+        record.name = strings.add(concept->getName());
+        record.description = strings.add(concept->getDescription());
+        record.firstTag = static_cast<uint32_t>(tags.size());
+        record.tagCount = static_cast<uint32_t>(concept->getTags().size());
+        record.x = concept->getPosition().x;
+        record.y = concept->getPosition().y;
+        record.created = concept->getCreated();
+        record.modified = concept->getModified();
+        for (const auto& tag : concept->getTags()) {
+            tags.push_back(strings.add(tag));
+        }
+        conceptRecords.push_back(record);
+    }
+
+    std::vector<RelationshipRecord> relationshipRecords;
+    relationshipRecords.reserve(model.getRelationships().size());
+    for (const auto& relationship : model.getRelationships()) {
+        auto source = conceptIndex.find(relationship->getSourceConceptId());
+        auto target = conceptIndex.find(relationship->getTargetConceptId());
+        if (source == conceptIndex.end() || target == conceptIndex.end()) continue;
+
+        RelationshipRecord record{};
+        record.id = strings.add(relationship->getId());
+        record.type = strings.add(relationship->getType());
+        record.source = source->second;
+        record.target = target->second;
+        record.weight = relationship->getWeight();
+        record.flags = relationship->getIsDirected() ? EDGE_DIRECTED : 0;
+        record.created = relationship->getCreated();
+        record.modified = relationship->getModified();
+        relationshipRecords.push_back(record);
+    }
+
+    // CSR adjacency: each edge is listed under both endpoints (once for a self-loop)
+    std::vector<uint32_t> offsets(conceptRecords.size() + 1, 0);
+    for (const auto& record : relationshipRecords) {
+        ++offsets[record.source + 1];
+        if (record.target != record.source) ++offsets[record.target + 1];
+    }
+    for (size_t i = 1; i < offsets.size(); ++i) {
+        offsets[i] += offsets[i - 1];
+    }
+    std::vector<AdjacencyEntry> adjacency(offsets.back());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (uint32_t i = 0; i < relationshipRecords.size(); ++i) {
+        const auto& record = relationshipRecords[i];
+        adjacency[fill[record.source]++] = AdjacencyEntry{record.target, i};
+        if (record.target != record.source) {
+            adjacency[fill[record.target]++] = AdjacencyEntry{record.source, i};
+        }
+    }
+
+    header.conceptCount = static_cast<uint32_t>(conceptRecords.size());
+    header.relationshipCount = static_cast<uint32_t>(relationshipRecords.size());
+    header.tagCount = static_cast<uint32_t>(tags.size());
+    header.adjacencyCount = static_cast<uint32_t>(adjacency.size());
+
+    std::string out(sizeof(FileHeader), '\0');
+    header.conceptsOffset = out.size();
+    out.append(reinterpret_cast<const char*>(conceptRecords.data()), conceptRecords.size() * sizeof(ConceptRecord));
+    header.tagsOffset = out.size();
+    out.append(reinterpret_cast<const char*>(tags.data()), tags.size() * sizeof(StringRef));
+    pad(out);
+
+    header.relationshipsOffset = out.size();
+    out.append(reinterpret_cast<const char*>(relationshipRecords.data()),
+               relationshipRecords.size() * sizeof(RelationshipRecord));
+
+    header.adjacencyOffset = out.size();
+    for (uint32_t offset : offsets) {
+        append(out, offset);
+    }
+    pad(out);
+    out.append(reinterpret_cast<const char*>(adjacency.data()), adjacency.size() * sizeof(AdjacencyEntry));
+
+    // Last, so in-place edits can add strings
+    header.stringsOffset = out.size();
+    header.stringsSize = strings.getBytes().size();
+    out += strings.getBytes();
+
+    header.fileSize = out.size();
+    header.checksum = checksum(out.data() + sizeof(FileHeader), out.size() - sizeof(FileHeader));
+    std::memcpy(&out[0], &header, sizeof(header));
+    return out;
+}
+
+void BinaryModelWriter::write(const MentalModel& model, const std::string& filePath) {
+    std::string encoded = encode(model);
+
+    QString path = QString::fromStdString(filePath);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        throw FileIOException("Cannot open file for writing: " + filePath);
+    }
+    if (file.write(encoded.data(), static_cast<qint64>(encoded.size())) != static_cast<qint64>(encoded.size()) ||
+        !syncFile(file) || !file.commit()) {
+        throw FileIOException("Cannot write binary model: " + filePath);
+    }
+    syncParentDirectory(path);
+}
+
+BinaryModelView::BinaryModelView(const char* data, size_t size, bool verifyChecksum) {
+    attach(data, size, verifyChecksum);
+}
+
+std::unique_ptr<BinaryModelView> BinaryModelView::open(const std::string& filePath, bool verifyChecksum) {
+    std::unique_ptr<BinaryModelView> view(new BinaryModelView());
+    view->file = std::make_unique<QFile>(QString::fromStdString(filePath));
+    if (!view->file->open(QIODevice::ReadOnly)) {
+        throw FileIOException("Cannot open file for reading: " + filePath);
+    }
+    qint64 fileSize = view->file->size();
+    if (fileSize < static_cast<qint64>(sizeof(FileHeader))) {
+        throw FileIOException("Not a binary model file: " + filePath);
+    }
+    view->mapped = view->file->map(0, fileSize);
+    if (!view->mapped) {
+        throw FileIOException("Cannot map binary model: " + filePath);
+    }
+    view->attach(reinterpret_cast<const char*>(view->mapped), static_cast<size_t>(fileSize), verifyChecksum);
+    view->filePath = QFileInfo(view->file->fileName()).absoluteFilePath().toStdString();
+    return view;
+}
+
+BinaryModelView::~BinaryModelView() {
+    if (file && mapped) {
+        file->unmap(mapped);
+    }
+}
+
+bool BinaryModelView::hasMagic(const char* data, size_t size) {
+    return size >= sizeof(MAGIC) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+uint64_t BinaryModelView::contentHash(const char* data, size_t size) {
+    uint32_t fileVersion = 0;
+    if (size >= sizeof(FileHeader) && hasMagic(data, size)) {
+        std::memcpy(&fileVersion, data + sizeof(MAGIC), sizeof(fileVersion));
+    }
+    return fileVersion == VERSION ? fnv1a(data, sizeof(FileHeader)) : fnv1a(data, size);
+}
+
+void BinaryModelView::attach(const char* data, size_t size, bool verifyChecksum) {
+    if (size < V1_HEADER_SIZE || !hasMagic(data, size)) {
+        throw FileIOException("Not a binary model file");
+    }
+    std::memcpy(&version, data + sizeof(MAGIC), sizeof(version));
+    if (version < OLDEST_READABLE_VERSION || version > VERSION) {
+        throw FileIOException("Unsupported binary model version " + std::to_string(version));
+    }
+    size_t headerBytes = headerSize(version);
+    if (size < headerBytes) {
+        throw FileIOException("Binary model is truncated");
+    }
+    header = FileHeader{};
+    std::memcpy(&header, data, headerBytes);
+    if (header.fileSize != size) {
+        throw FileIOException("Binary model is truncated");
+    }
+
+    // Every section must lie inside the file; records are bounds-checked again as they are read
+    size_t conceptBytes = version == 1 ? V1_CONCEPT_RECORD_SIZE : sizeof(ConceptRecord);
+    size_t relationshipBytes = version == 1 ? V1_RELATIONSHIP_RECORD_SIZE : sizeof(RelationshipRecord);
+    auto fits = [size](uint64_t offset, uint64_t length) {
+        return offset <= size && length <= size - offset;
+    };
+    if (!fits(header.stringsOffset, header.stringsSize) ||
+        !fits(header.conceptsOffset, uint64_t(header.conceptCount) * conceptBytes) ||
+        !fits(header.tagsOffset, uint64_t(header.tagCount) * sizeof(StringRef)) ||
+        !fits(header.relationshipsOffset, uint64_t(header.relationshipCount) * relationshipBytes) ||
+        !fits(header.adjacencyOffset, (uint64_t(header.conceptCount) + 1) * sizeof(uint32_t)) ||
+        !fits(adjacencyEntriesOffset(header), uint64_t(header.adjacencyCount) * sizeof(AdjacencyEntry))) {
+        throw FileIOException("Binary model has a section outside the file");
+    }
+
+    if (verifyChecksum) {
+        uint64_t actual = version == 1 ? fnv1a(data + headerBytes, size - headerBytes)
+                                       : checksum(data + headerBytes, size - headerBytes);
+        if (actual != header.checksum) {
+            throw FileIOException("Binary model checksum mismatch");
+        }
+    }
+
+    this->data = data;
+    this->size = size;
+}
+
+template <typename T>
+T BinaryModelView::recordAt(uint64_t sectionOffset, uint64_t index) const {
+    T record;
+    std::memcpy(&record, data + sectionOffset + index * sizeof(T), sizeof(T));
+    return record;
+}
+
+ConceptRecord BinaryModelView::conceptRecord(uint32_t index) const {
+    if (version == 1) {
+        // The same fields, narrower records
+        ConceptRecord record{};
+        std::memcpy(&record, data + header.conceptsOffset + uint64_t(index) * V1_CONCEPT_RECORD_SIZE,
+                    V1_CONCEPT_RECORD_SIZE);
+        return record;
+    }
+    return recordAt<ConceptRecord>(header.conceptsOffset, index);
+}
+
+RelationshipRecord BinaryModelView::relationshipRecord(uint32_t index) const {
+    if (version == 1) {
+        RelationshipRecord record{};
+        std::memcpy(&record, data + header.relationshipsOffset + uint64_t(index) * V1_RELATIONSHIP_RECORD_SIZE,
+                    V1_RELATIONSHIP_RECORD_SIZE);
+        return record;
+    }
+    return recordAt<RelationshipRecord>(header.relationshipsOffset, index);
+}
+
+std::string_view BinaryModelView::stringAt(const StringRef& ref) const {
+    if (ref.offset > header.stringsSize || ref.length > header.stringsSize - ref.offset) {
+        throw FileIOException("Binary model has a string outside the string table");
+    }
+    return std::string_view(data + header.stringsOffset + ref.offset, ref.length);
+}
+
+std::string_view BinaryModelView::getModelName() const {
+    return stringAt(header.modelName);
+}
+
+BinaryModelView::ConceptView BinaryModelView::getConcept(uint32_t index) const {
+    if (index >= header.conceptCount) {
+        throw ModelException("Concept index out of range: " + std::to_string(index));
+    }
+    auto record = conceptRecord(index);
+    return ConceptView{stringAt(record.id), stringAt(record.name), stringAt(record.description),
+                       Position(record.x, record.y), record.created, record.modified};
+}
+
+std::vector<std::string_view> BinaryModelView::getTags(uint32_t index) const {
+    if (index >= header.conceptCount) {
+        throw ModelException("Concept index out of range: " + std::to_string(index));
+    }
+    auto record = conceptRecord(index);
+    if (record.firstTag > header.tagCount || record.tagCount > header.tagCount - record.firstTag) {
+        throw FileIOException("Binary model has a tag range outside the tag table");
+    }
+    std::vector<std::string_view> tags;
+    tags.reserve(record.tagCount);
+    for (uint32_t i = 0; i < record.tagCount; ++i) {
+        tags.push_back(stringAt(recordAt<StringRef>(header.tagsOffset, record.firstTag + i)));
+    }
+    return tags;
+}
+
+BinaryModelView::RelationshipView BinaryModelView::getRelationship(uint32_t index) const {
+    if (index >= header.relationshipCount) {
+        throw ModelException("Relationship index out of range: " + std::to_string(index));
+    }
+    auto record = relationshipRecord(index);
+    if (record.source >= header.conceptCount || record.target >= header.conceptCount) {
+        throw FileIOException("Binary model has a relationship to a missing concept");
+    }
+    return RelationshipView{stringAt(record.id), stringAt(record.type), record.source, record.target,
+                            record.weight, (record.flags & EDGE_DIRECTED) != 0, record.created, record.modified};
+}
+
+std::vector<AdjacencyEntry> BinaryModelView::getNeighbors(uint32_t index) const {
+    if (index >= header.conceptCount) {
+        throw ModelException("Concept index out of range: " + std::to_string(index));
+    }
+    uint32_t begin = recordAt<uint32_t>(header.adjacencyOffset, index);
+    uint32_t end = recordAt<uint32_t>(header.adjacencyOffset, uint64_t(index) + 1);
+    if (begin > end || end > header.adjacencyCount) {
+        throw FileIOException("Binary model has a corrupt adjacency list");
+    }
+    std::vector<AdjacencyEntry> neighbors(end - begin);
+    std::memcpy(neighbors.data(), data + adjacencyEntriesOffset(header) + uint64_t(begin) * sizeof(AdjacencyEntry),
+                neighbors.size() * sizeof(AdjacencyEntry));
+    return neighbors;
+}
+
+int64_t BinaryModelView::findConcept(std::string_view id) const {
+    if (idIndex.empty() && header.conceptCount > 0) {
+        idIndex.reserve(header.conceptCount);
+        for (uint32_t i = 0; i < header.conceptCount; ++i) {
+            idIndex.emplace(stringAt(conceptRecord(i).id), i);
+        }
+    }
+    auto it = idIndex.find(id);
+    return it != idIndex.end() ? static_cast<int64_t>(it->second) : -1;
+}
+
+std::unique_ptr<Concept> BinaryModelView::materializeConcept(uint32_t index) const {
+    ConceptView view = getConcept(index);
+    auto concept = std::make_unique<Concept>(std::string(view.id), std::string(view.name),
+                                             std::string(view.description));
+    for (const auto& tag : getTags(index)) {
+        concept->addTag(std::string(tag));
+    }
+    concept->setPosition(view.position);
+    if (view.created != 0) {
+        concept->setTimestamps(view.created, view.modified);
+    }
+    return concept;
+}
+
+std::unique_ptr<Relationship> BinaryModelView::materializeRelationship(uint32_t index) const {
+    RelationshipView view = getRelationship(index);
+    auto relationship = std::make_unique<Relationship>(std::string(view.id),
+                                                       std::string(getConcept(view.source).id),
+                                                       std::string(getConcept(view.target).id),
+                                                       std::string(view.type), view.directed, view.weight);
+    if (view.created != 0) {
+        relationship->setTimestamps(view.created, view.modified);
+    }
+    return relationship;
+}
+
+std::unique_ptr<MentalModel> BinaryModelView::toModel() const {
+    auto model = std::make_unique<MentalModel>(std::string(getModelName()));
+    for (uint32_t i = 0; i < header.conceptCount; ++i) {
+        model->addConcept(materializeConcept(i));
+    }
+    for (uint32_t i = 0; i < header.relationshipCount; ++i) {
+        model->addRelationship(materializeRelationship(i));
+    }
+    return model;
+}
+
+ConceptPayload BinaryPayloadSource::load(uint32_t index) const {
+    ConceptPayload payload;
+    payload.description = std::string(view->getConcept(index).description);
+    for (const auto& tag : view->getTags(index)) {
+        payload.tags.emplace_back(tag);
+    }
+    return payload;
+}
+
+std::unique_ptr<MentalModel> BinaryModelView::toLazyModel(std::shared_ptr<const BinaryModelView> view,
+                                                          size_t cacheCapacity) {
+    auto model = std::make_unique<MentalModel>(std::string(view->getModelName()));
+    ConceptPayloadCache* cache = model->setPayloadSource(std::make_shared<BinaryPayloadSource>(view), cacheCapacity);
+
+    uint32_t conceptCount = view->getConceptCount();
+    std::vector<std::unique_ptr<Concept>> concepts;
+    concepts.reserve(conceptCount);
+    for (uint32_t i = 0; i < conceptCount; ++i) {
+        ConceptView record = view->getConcept(i);
+        auto concept = std::make_unique<Concept>(std::string(record.id), std::string(record.name), std::string());
+        concept->setPosition(record.position);
+        if (record.created != 0) {
+            concept->setTimestamps(record.created, record.modified);
+        }
+        concept->setLazyPayload(cache, i);
+        concepts.push_back(std::move(concept));
+    }
+    model->addConceptsBulk(std::move(concepts));
+
+    uint32_t relationshipCount = view->getRelationshipCount();
+    std::vector<std::unique_ptr<Relationship>> relationships;
+    relationships.reserve(relationshipCount);
+    for (uint32_t i = 0; i < relationshipCount; ++i) {
+        relationships.push_back(view->materializeRelationship(i));
+    }
+    model->addRelationshipsBulk(std::move(relationships));
+    return model;
+}
+
+std::string BinaryModelPatcher::redoPathFor(const std::string& filePath) {
+    return filePath + ".redo";
+}
+
+bool BinaryModelPatcher::patch(const std::string& filePath, uint64_t baseHash, const MentalModel& model,
+                               const ModelChanges& changes, uint64_t& contentHash) {
+    if (!changes.keepsStructure()) return false;
+
+    QFile file(QString::fromStdString(filePath));
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw FileIOException("Cannot open file for reading: " + filePath);
+    }
+    if (file.size() < static_cast<qint64>(sizeof(FileHeader))) return false;
+    std::string headerBytes = readAt(file, 0, sizeof(FileHeader));
+    FileHeader header;
+    std::memcpy(&header, headerBytes.data(), sizeof(header));
+
+    // Only the file the changes are relative to, in the current version,
+    // with its strings last and a record for every entity
+    if (!BinaryModelView::hasMagic(headerBytes.data(), headerBytes.size()) || header.version != VERSION ||
+        fnv1a(headerBytes.data(), headerBytes.size()) != baseHash ||
+        header.fileSize != static_cast<uint64_t>(file.size()) ||
+        header.stringsOffset + header.stringsSize != header.fileSize ||
+        header.conceptCount != model.getConceptCount() ||
+        header.relationshipCount != model.getRelationshipCount()) {
+        return false;
+    }
+
+    std::unordered_map<const Concept*, uint32_t> conceptPositions;
+    std::unordered_map<const Relationship*, uint32_t> relationshipPositions;
+    if (!findPositions(model.getConcepts(), changes.modifiedConcepts, conceptPositions) ||
+        !findPositions(model.getRelationships(), changes.modifiedRelationships, relationshipPositions)) {
+        return false;
+    }
+
+    PatchBuilder builder(file, header);
+    for (const Concept* concept : changes.modifiedConcepts) {
+        uint64_t offset = header.conceptsOffset + uint64_t(conceptPositions[concept]) * sizeof(ConceptRecord);
+        auto record = readRecordAt<ConceptRecord>(file, offset);
+        const auto& tags = concept->getTags();
+        if (builder.readString(record.id) != concept->getId() || tags.size() > record.tagCount) {
+            return false;
+        }
+        record.name = builder.string(concept->getName(), record.name);
+        record.description = builder.string(concept->getDescription(), record.description);
+        for (uint32_t i = 0; i < tags.size(); ++i) {
+            uint64_t tagOffset = header.tagsOffset + uint64_t(record.firstTag + i) * sizeof(StringRef);
+            auto old = readRecordAt<StringRef>(file, tagOffset);
+            StringRef ref = builder.string(tags[i], old);
+            if (ref.offset != old.offset || ref.length != old.length) {
+                builder.write(tagOffset, ref);
+            }
+        }
+        record.tagCount = static_cast<uint32_t>(tags.size()); // Dropped tags leave their slots unused
+        record.x = concept->getPosition().x;
+        record.y = concept->getPosition().y;
+        record.created = concept->getCreated();
+        record.modified = concept->getModified();
+        builder.write(offset, record);
+    }
+    for (const Relationship* relationship : changes.modifiedRelationships) {
+        uint64_t offset = header.relationshipsOffset +
+                          uint64_t(relationshipPositions[relationship]) * sizeof(RelationshipRecord);
+        auto record = readRecordAt<RelationshipRecord>(file, offset);
+        if (builder.readString(record.id) != relationship->getId()) {
+            return false;
+        }
+        record.type = builder.string(relationship->getType(), record.type);
+        record.weight = relationship->getWeight();
+        record.flags = relationship->getIsDirected() ? EDGE_DIRECTED : 0;
+        record.created = relationship->getCreated();
+        record.modified = relationship->getModified();
+        builder.write(offset, record);
+    }
+    if (changes.renamed) {
+        builder.header.modelName = builder.string(model.getModelName(), header.modelName);
+    }
+
+    FileHeader& patched = builder.header;
+    uint64_t stringsSize = header.stringsSize + builder.appended.size();
+    if (stringsSize > UINT32_MAX || patched.slackBytes * 2 > stringsSize) {
+        // String offsets would overflow, or the table is mostly dead strings that a rewrite drops
+        return false;
+    }
+    if (!builder.appended.empty()) {
+        builder.edits[header.fileSize] = builder.appended;
+    }
+    patched.stringsSize = stringsSize;
+    patched.fileSize = header.stringsOffset + stringsSize;
+
+    // Rehash only the pages the edits touch
+    const uint64_t dataStart = sizeof(FileHeader);
+    std::vector<uint64_t> pages;
+    for (const auto& edit : builder.edits) {
+        uint64_t first = (edit.first - dataStart) / CHECKSUM_PAGE_BYTES;
+        uint64_t last = (edit.first + edit.second.size() - 1 - dataStart) / CHECKSUM_PAGE_BYTES;
+        for (uint64_t page = first; page <= last; ++page) {
+            if (pages.empty() || pages.back() < page) pages.push_back(page);
+        }
+    }
+    for (uint64_t page : pages) {
+        uint64_t start = dataStart + page * CHECKSUM_PAGE_BYTES;
+        size_t oldLength = start < header.fileSize ? std::min<uint64_t>(CHECKSUM_PAGE_BYTES, header.fileSize - start) : 0;
+        size_t newLength = std::min<uint64_t>(CHECKSUM_PAGE_BYTES, patched.fileSize - start);
+        std::string bytes = readAt(file, start, oldLength);
+        if (oldLength > 0) {
+            patched.checksum -= pageChecksum(bytes.data(), oldLength, page);
+        }
+        bytes.resize(newLength, '\0');
+        auto edit = builder.edits.upper_bound(start);
+        if (edit != builder.edits.begin()) --edit;
+        for (; edit != builder.edits.end() && edit->first < start + newLength; ++edit) {
+            uint64_t from = std::max(start, edit->first);
+            uint64_t to = std::min<uint64_t>(start + newLength, edit->first + edit->second.size());
+            if (from < to) {
+                std::memcpy(&bytes[from - start], edit->second.data() + (from - edit->first), to - from);
+            }
+        }
+        patched.checksum += pageChecksum(bytes.data(), newLength, page);
+    }
+    file.close();
+
+    contentHash = fnv1a(&patched, sizeof(patched));
+    if (builder.edits.empty() && contentHash == baseHash) {
+        return true; // Nothing in the file changes
+    }
+    std::vector<Edit> edits;
+    edits.reserve(builder.edits.size() + 1);
+    for (auto& edit : builder.edits) {
+        edits.push_back(Edit{edit.first, std::move(edit.second)});
+    }
+    edits.push_back(Edit{0, bytesOf(patched)});
+
+    std::string redoPath = redoPathFor(filePath);
+    writeRedo(redoPath, baseHash, contentHash, edits);
+    applyEdits(filePath, edits);
+    QFile::remove(QString::fromStdString(redoPath));
+    return true;
+}
+
+void BinaryModelPatcher::recover(const std::string& filePath) {
+    QString redoPath = QString::fromStdString(redoPathFor(filePath));
+    QFile redoFile(redoPath);
+    if (!redoFile.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QByteArray bytes = redoFile.readAll();
+    redoFile.close();
+
+    uint64_t baseHash;
+    uint64_t newHash;
+    std::vector<Edit> edits;
+    if (readRedo(std::string(bytes.constData(), static_cast<size_t>(bytes.size())), baseHash, newHash, edits)) {
+        // The header goes in last, so until it has the file still names the old content
+        QFile file(QString::fromStdString(filePath));
+        std::string header;
+        if (file.open(QIODevice::ReadOnly) && file.size() >= static_cast<qint64>(sizeof(FileHeader))) {
+            header = readAt(file, 0, sizeof(FileHeader));
+        }
+        file.close();
+        if (!header.empty() && fnv1a(header.data(), header.size()) == baseHash) {
+            applyEdits(filePath, edits);
+        }
+    }
+    // Applied now, applied before, or meant for a file since replaced
+    QFile::remove(redoPath);
+}
+
+} // namespace qlink
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../common/DataStructures.h"
+#include "../common/Timestamp.h"
+#include "../model/ConceptPayloads.h"
+
+class QFile;
+
+namespace qlink {
+
+class MentalModel;
+class Concept;
+class Relationship;
+struct ModelChanges;
+
+/**
+ * Binary model file (.qlinkb), laid out so it can be used straight from a
+ * memory map and edited in place.
+ *
+ * Layout, all integers little-endian and every section 8-byte aligned:
+ *   header       magic "QLKB", version, sizes, section offsets, checksum
+ *   concepts     fixed-width records: id, name, description, tag range, position, times
+ *   tags         string references, each concept owning a contiguous range
+ *   edges        fixed-width records: id, type, endpoint indices, weight, flags, times
+ *   adjacency    CSR: conceptCount + 1 offsets, then (neighbor, edge) pairs
+ *   strings      every distinct string once, referenced by (offset, length)
+ *
+ * The string table comes last so BinaryModelPatcher can append the strings
+ * an edit needs. The checksum is the sum of FNV-1a hashes of the 4 KB pages
+ * after the header, so an edit updates it by rehashing only the pages it
+ * touches; the header's hash then identifies the content.
+ *
+ * Version 1 files (no times, strings first, whole-file checksum) are read too.
+ */
+namespace binary_format {
+
+constexpr char MAGIC[4] = {'Q', 'L', 'K', 'B'};
+constexpr uint32_t VERSION = 2;
+constexpr uint32_t OLDEST_READABLE_VERSION = 1;
+constexpr const char* FILE_EXTENSION = ".qlinkb";
+constexpr size_t CHECKSUM_PAGE_BYTES = 4096;
+
+struct StringRef {
+    uint32_t offset; // Into the string table
+    uint32_t length;
+};
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t fileSize;
+    uint64_t checksum;
+    uint32_t conceptCount;
+    uint32_t relationshipCount;
+    uint32_t tagCount;
+    uint32_t adjacencyCount;
+    StringRef modelName;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t conceptsOffset;
+    uint64_t tagsOffset;
+    uint64_t relationshipsOffset;
+    uint64_t adjacencyOffset; // Offsets array, followed by the entries
+    uint64_t slackBytes; // String table bytes that in-place edits left unreferenced
+};
+static_assert(sizeof(FileHeader) == 104, "FileHeader must have no padding");
+constexpr size_t V1_HEADER_SIZE = 96; // Without slackBytes
+
+struct ConceptRecord {
+    StringRef id;
+    StringRef name;
+    StringRef description;
+    uint32_t firstTag;
+    uint32_t tagCount;
+    double x;
+    double y;
+    int64_t created; // Milliseconds since the Unix epoch
+    int64_t modified;
+};
+static_assert(sizeof(ConceptRecord) == 64, "ConceptRecord must have no padding");
+
+constexpr uint32_t EDGE_DIRECTED = 1;
+
+struct RelationshipRecord {
+    StringRef id;
+    StringRef type;
+    uint32_t source; // Concept index
+    uint32_t target;
+    double weight;
+    uint32_t flags;
+    uint32_t reserved;
+    int64_t created;
+    int64_t modified;
+};
+static_assert(sizeof(RelationshipRecord) == 56, "RelationshipRecord must have no padding");
+
+// Version 1 records: the same fields without the times
+constexpr size_t V1_CONCEPT_RECORD_SIZE = 48;
+constexpr size_t V1_RELATIONSHIP_RECORD_SIZE = 40;
+
+/**
+ * The version 2 checksum over the bytes after the header
+ */
+uint64_t pageChecksum(const char* page, size_t length, uint64_t pageIndex);
+uint64_t checksum(const char* data, size_t size);
+
+struct AdjacencyEntry {
+    uint32_t neighbor;     // Concept index
+    uint32_t relationship; // Relationship index
+};
+
+} // namespace binary_format
+
+/**
+ * Encodes models into the binary format
+ */
+class BinaryModelWriter {
+public:
+    /**
+     * Relationships whose concepts are not in the model are left out
+     */
+    static std::string encode(const MentalModel& model);
+
+    /**
+     * Encode, then atomically replace filePath once the data is on disk
+     * @throws FileIOException if the file cannot be written
+     */
+    static void write(const MentalModel& model, const std::string& filePath);
+};
+
+/**
+ * Read-only view over an encoded model.
+ *
+ * Strings are returned as views into the underlying bytes and nothing is
+ * copied until a concept, relationship or the whole model is materialized,
+ * so opening a large file costs one map and a header check. Views are valid
+ * for the lifetime of the BinaryModelView.
+ */
+class BinaryModelView {
+public:
+    struct ConceptView {
+        std::string_view id;
+        std::string_view name;
+        std::string_view description;
+        Position position;
+        Timestamp created; // 0 in version 1 files
+        Timestamp modified;
+    };
+
+    struct RelationshipView {
+        std::string_view id;
+        std::string_view type;
+        uint32_t source; // Concept index
+        uint32_t target;
+        double weight;
+        bool directed;
+        Timestamp created;
+        Timestamp modified;
+    };
+
+    /**
+     * View an encoded buffer owned by the caller
+     * @throws FileIOException if the buffer is not a valid model
+     */
+    BinaryModelView(const char* data, size_t size, bool verifyChecksum = true);
+
+    /**
+     * Map a .qlinkb file
+     * @throws FileIOException if the file cannot be mapped or is not a valid model
+     */
+    static std::unique_ptr<BinaryModelView> open(const std::string& filePath, bool verifyChecksum = true);
+
+    ~BinaryModelView();
+
+    BinaryModelView(const BinaryModelView&) = delete;
+    BinaryModelView& operator=(const BinaryModelView&) = delete;
+
+    /**
+     * Whether data starts with the binary format's magic
+     */
+    static bool hasMagic(const char* data, size_t size);
+
+    /**
+     * Hash identifying an encoded model's content: of the header for the
+     * current version, whose checksum covers the rest, or of every byte
+     */
+    static uint64_t contentHash(const char* data, size_t size);
+
+    /**
+     * The encoded bytes
+     */
+    const char* getData() const { return data; }
+    size_t getSize() const { return size; }
+
+    /**
+     * Absolute path of the mapped file; empty for a caller's buffer
+     */
+    const std::string& getFilePath() const { return filePath; }
+
+    std::string_view getModelName() const;
+    uint32_t getConceptCount() const { return header.conceptCount; }
+    uint32_t getRelationshipCount() const { return header.relationshipCount; }
+
+    ConceptView getConcept(uint32_t index) const;
+    std::vector<std::string_view> getTags(uint32_t index) const;
+    RelationshipView getRelationship(uint32_t index) const;
+
+    /**
+     * Relationships touching a concept, in either direction
+     */
+    std::vector<binary_format::AdjacencyEntry> getNeighbors(uint32_t index) const;
+
+    /**
+     * @return the concept's index, or -1 if no concept has this id
+     */
+    int64_t findConcept(std::string_view id) const;
+
+    std::unique_ptr<Concept> materializeConcept(uint32_t index) const;
+    std::unique_ptr<Relationship> materializeRelationship(uint32_t index) const;
+    std::unique_ptr<MentalModel> toModel() const;
+
+    /**
+     * Model holding the topology, names and positions, whose descriptions
+     * and tags are read from view when used (see ConceptPayloadCache). The
+     * model and its clones keep view alive.
+     */
+    static std::unique_ptr<MentalModel> toLazyModel(std::shared_ptr<const BinaryModelView> view,
+                                                    size_t cacheCapacity = ConceptPayloadCache::DEFAULT_CAPACITY);
+
+private:
+    BinaryModelView() = default;
+    void attach(const char* data, size_t size, bool verifyChecksum);
+    std::string_view stringAt(const binary_format::StringRef& ref) const;
+    template <typename T> T recordAt(uint64_t sectionOffset, uint64_t index) const;
+    binary_format::ConceptRecord conceptRecord(uint32_t index) const;
+    binary_format::RelationshipRecord relationshipRecord(uint32_t index) const;
+
+    const char* data = nullptr;
+    size_t size = 0;
+    binary_format::FileHeader header{};
+    uint32_t version = binary_format::VERSION;
+
+    std::unique_ptr<QFile> file; // Set when the view owns a mapping
+    unsigned char* mapped = nullptr;
+    std::string filePath;
+
+    // Built on the first lookup by id
+    mutable std::unordered_map<std::string_view, uint32_t> idIndex;
+};
+
+/**
+ * Payloads read from a view's concept records, by index. The view, and
+ * with it the mapping, lives as long as a model or clone reads through it.
+ */
+class BinaryPayloadSource : public ConceptPayloadSource {
+public:
+    explicit BinaryPayloadSource(std::shared_ptr<const BinaryModelView> view) : view(std::move(view)) {}
+
+    ConceptPayload load(uint32_t index) const override;
+    const std::shared_ptr<const BinaryModelView>& getView() const { return view; }
+
+private:
+    std::shared_ptr<const BinaryModelView> view;
+};
+
+/**
+ * Writes edits into a .qlinkb file in place, so saving a few changed
+ * entities costs time in the size of the change rather than the model.
+ *
+ * Only entities that are in the file can be patched: records are rewritten
+ * where they lie, changed strings are appended to the string table and a
+ * concept may lose tags but not gain them. Anything else, or a string table
+ * that has become mostly slack, needs a full rewrite.
+ *
+ * The edits are first written to a redo file next to the model and synced;
+ * the header goes in last. A patch a crash interrupts is finished by
+ * recover(), which ModelManager calls before opening a binary model.
+ */
+class BinaryModelPatcher {
+public:
+    /**
+     * Redo file for a model file
+     */
+    static std::string redoPathFor(const std::string& filePath);
+
+    /**
+     * Bring filePath, last written from model as it was at markClean(), up
+     * to date with changes
+     * @param baseHash contentHash() of the file as last written; any other file is left alone
+     * @param contentHash receives the patched file's contentHash()
+     * @return false, leaving the file untouched, if the changes need a full rewrite
+     * @throws FileIOException if the file cannot be read or written
+     */
+    static bool patch(const std::string& filePath, uint64_t baseHash, const MentalModel& model,
+                      const ModelChanges& changes, uint64_t& contentHash);
+
+    /**
+     * Finish an interrupted patch of filePath, if its redo file says there is one
+     * @throws FileIOException if the file cannot be written
+     */
+    static void recover(const std::string& filePath);
+};
+
+} // namespace qlink
@@ -0,0 +1,39 @@
+#include "FileSync.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QString>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace qlink {
+
+bool syncFile(QFileDevice& file) {
+    if (!file.flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return ::_commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+void syncParentDirectory(const QString& filePath) {
+#ifndef Q_OS_WIN
+    QByteArray directory = QFile::encodeName(QFileInfo(filePath).absolutePath());
+    int fd = ::open(directory.constData(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#else
+    Q_UNUSED(filePath);
+#endif
+}
+
+} // namespace qlink
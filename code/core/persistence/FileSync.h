@@ -0,0 +1,21 @@
+#pragma once
+
+class QFileDevice;
+class QString;
+
+namespace qlink {
+
+/**
+ * Flush a file's written data through the OS cache to the storage device
+ * (fsync on POSIX, FlushFileBuffers on Windows)
+ * @return false if the device reported an error
+ */
+bool syncFile(QFileDevice& file);
+
+/**
+ * Sync the directory holding filePath, so a file renamed into it survives
+ * a power loss. Does nothing where directories cannot be synced.
+ */
+void syncParentDirectory(const QString& filePath);
+
+} // namespace qlink
@@ -0,0 +1,932 @@
+#include "GraphInterchange.h"
+#include "ParallelTasks.h"
+#include "../model/MentalModel.h"
+#include "../common/Json.h"
+#include "../common/QLinkException.h"
+#include <QIODevice>
+#include <QThreadPool>
+#include <QXmlStreamReader>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if !(defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L)
+#include <locale>
+#include <sstream>
+#endif
+
+namespace qlink {
+
+namespace {
+
+constexpr size_t CHUNK_BYTES = 1024 * 1024; // Rows parsed per task
+constexpr size_t WRITE_BUFFER_BYTES = 64 * 1024;
+constexpr char TAG_SEPARATOR = ';';
+const std::string DEFAULT_TYPE = "relates_to"; // What the command parser and link predictors use
+
+enum class EdgeField { SOURCE, TARGET, TYPE, WEIGHT, DIRECTED, ID, OTHER };
+enum class NodeField { ID, NAME, DESCRIPTION, TAGS, X, Y, OTHER };
+
+template <typename Field>
+struct FieldName {
+    std::string_view name;
+    Field field;
+};
+
+const FieldName<EdgeField> EDGE_FIELDS[] = {
+    {"source", EdgeField::SOURCE}, {"from", EdgeField::SOURCE},   {"target", EdgeField::TARGET},
+    {"to", EdgeField::TARGET},     {"type", EdgeField::TYPE},     {"label", EdgeField::TYPE},
+    {"weight", EdgeField::WEIGHT}, {"directed", EdgeField::DIRECTED}, {"id", EdgeField::ID},
+};
+
+const FieldName<NodeField> NODE_FIELDS[] = {
+    {"id", NodeField::ID},     {"name", NodeField::NAME}, {"label", NodeField::NAME},
+    {"description", NodeField::DESCRIPTION}, {"tags", NodeField::TAGS},
+    {"x", NodeField::X},       {"y", NodeField::Y},
+};
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+std::string_view trimSpaces(std::string_view text) {
+    while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+    while (!text.empty() && text.back() == ' ') text.remove_suffix(1);
+    return text;
+}
+
+bool parseNumber(std::string_view text, double& value) {
+    if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+    if (text.empty()) return false;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+#else
+    std::istringstream stream{std::string(text)};
+    stream.imbue(std::locale::classic());
+    stream >> value;
+    return !stream.fail() && stream.peek() == std::char_traits<char>::eof();
+#endif
+}
+
+bool parseFlag(std::string_view text, bool& value) {
+    for (std::string_view yes : {"true", "yes", "1"}) {
+        if (equalsIgnoreCase(text, yes)) {
+            value = true;
+            return true;
+        }
+    }
+    for (std::string_view no : {"false", "no", "0"}) {
+        if (equalsIgnoreCase(text, no)) {
+            value = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+[[noreturn]] void failAt(size_t offset, const std::string& message) {
+    throw ParseException("Delimited file parse error at byte " + std::to_string(offset) + ": " + message);
+}
+
+/**
+ * Reads the rows of delimited text between two offsets. Fields are views
+ * into the text, or into decoded for quoted fields containing "".
+ */
+class RowReader {
+public:
+    RowReader(const char* data, size_t begin, size_t end, char delimiter, std::deque<std::string>& decoded)
+        : data(data), position(begin), end(end), delimiter(delimiter), decoded(decoded) {}
+
+    /**
+     * Read the next row, skipping blank lines
+     * @return false at the end
+     */
+    bool next(std::vector<std::string_view>& fields) {
+        while (position < end) {
+            if (data[position] == '\n') {
+                ++position;
+                continue;
+            }
+            if (data[position] == '\r' && position + 1 < end && data[position + 1] == '\n') {
+                position += 2;
+                continue;
+            }
+
+            fields.clear();
+            while (true) {
+                fields.push_back(readField());
+                if (position >= end) return true;
+                if (data[position] == delimiter) {
+                    ++position;
+                    continue;
+                }
+                if (data[position] == '\r') ++position;
+                if (position < end && data[position] == '\n') ++position;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t getOffset() const { return position; }
+
+private:
+    bool atFieldEnd(size_t offset) const {
+        return offset >= end || data[offset] == delimiter || data[offset] == '\n' ||
+               (data[offset] == '\r' && (offset + 1 >= end || data[offset + 1] == '\n'));
+    }
+
+    std::string_view readField() {
+        size_t quote = position;
+        while (quote < end && data[quote] == ' ' && delimiter != ' ') ++quote;
+        if (quote < end && data[quote] == '"') {
+            return readQuoted(quote);
+        }
+
+        size_t stop = position;
+        while (stop < end && data[stop] != delimiter && data[stop] != '\n') ++stop;
+        std::string_view field(data + position, stop - position);
+        position = stop;
+        if (!field.empty() && field.back() == '\r') field.remove_suffix(1);
+        return trimSpaces(field);
+    }
+
+    std::string_view readQuoted(size_t quote) {
+        size_t contentStart = quote + 1;
+        bool escaped = false;
+        position = contentStart;
+        while (true) {
+            auto next = static_cast<const char*>(std::memchr(data + position, '"', end - position));
+            if (!next) failAt(quote, "unterminated quoted field");
+            position = static_cast<size_t>(next - data) + 1;
+            if (position < end && data[position] == '"') {
+                escaped = true;
+                ++position;
+                continue;
+            }
+            break;
+        }
+        std::string_view raw(data + contentStart, position - 1 - contentStart);
+        while (position < end && data[position] == ' ' && delimiter != ' ') ++position;
+        if (!atFieldEnd(position)) failAt(position, "text after a quoted field");
+        if (!escaped) return raw;
+
+        std::string& text = decoded.emplace_back();
+        text.reserve(raw.size());
+        for (size_t i = 0; i < raw.size(); ++i) {
+            text += raw[i];
+            if (raw[i] == '"') ++i; // Second quote of the pair
+        }
+        return text;
+    }
+
+    const char* data;
+    size_t position;
+    size_t end;
+    char delimiter;
+    std::deque<std::string>& decoded;
+};
+
+struct RowRange {
+    size_t begin;
+    size_t end;
+};
+
+/**
+ * Cut [begin, end) into pieces of about CHUNK_BYTES that each end after a
+ * line break outside quotes. Whether a position is inside quotes follows
+ * from the parity of the quotes before it, so only the bytes around each
+ * cut are looked at one by one.
+ */
+std::vector<RowRange> splitRows(const char* data, size_t begin, size_t end) {
+    std::vector<RowRange> ranges;
+    size_t start = begin;
+    while (start < end) {
+        size_t cut = std::min(end, start + CHUNK_BYTES);
+        bool inQuotes = std::count(data + start, data + cut, '"') % 2 != 0;
+        while (cut < end && (inQuotes || data[cut] != '\n')) {
+            if (data[cut] == '"') inQuotes = !inQuotes;
+            ++cut;
+        }
+        if (cut < end) ++cut; // Past the line break
+        ranges.push_back({start, cut});
+        start = cut;
+    }
+    return ranges;
+}
+
+/**
+ * Field of each column: named by the first row if any of its fields is a
+ * known column name, else in the default order
+ * @return offset of the first data row
+ */
+template <typename Field, size_t N>
+size_t readColumns(const char* data, size_t begin, size_t end, char delimiter, const FieldName<Field> (&names)[N],
+                   std::vector<Field>& columns) {
+    std::deque<std::string> decoded;
+    std::vector<std::string_view> fields;
+    RowReader reader(data, begin, end, delimiter, decoded);
+    bool header = false;
+    if (reader.next(fields)) {
+        for (std::string_view field : fields) {
+            Field column = Field::OTHER;
+            for (const auto& name : names) {
+                if (equalsIgnoreCase(field, name.name)) {
+                    column = name.field;
+                    header = true;
+                    break;
+                }
+            }
+            columns.push_back(column);
+        }
+    }
+    if (header) return reader.getOffset();
+
+    columns.clear();
+    for (int i = 0; i < static_cast<int>(Field::OTHER); ++i) {
+        columns.push_back(static_cast<Field>(i));
+    }
+    return begin;
+}
+
+template <typename Field>
+bool hasColumn(const std::vector<Field>& columns, Field field) {
+    return std::find(columns.begin(), columns.end(), field) != columns.end();
+}
+
+size_t skipByteOrderMark(const char* data, size_t size) {
+    return size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0 ? 3 : 0;
+}
+
+void splitTags(std::string_view text, Concept& concept) {
+    while (!text.empty()) {
+        size_t separator = text.find(TAG_SEPARATOR);
+        std::string_view tag = trimSpaces(text.substr(0, separator));
+        if (!tag.empty()) concept.addTag(std::string(tag));
+        if (separator == std::string_view::npos) break;
+        text.remove_prefix(separator + 1);
+    }
+}
+
+/**
+ * Maps edge endpoints to concept ids: an existing concept's id, then the
+ * first concept with that name, then a new concept named after the
+ * endpoint. Endpoints must outlive the resolver.
+ */
+class EndpointResolver {
+public:
+    explicit EndpointResolver(const MentalModel& model) : model(model) {}
+
+    /**
+     * @return index to look the concept id up with getId()
+     */
+    uint32_t resolve(std::string_view endpoint) {
+        auto found = resolved.find(endpoint);
+        if (found != resolved.end()) return found->second;
+
+        auto index = static_cast<uint32_t>(ids.size());
+        std::string key(endpoint);
+        if (const Concept* concept = model.getConcept(key)) {
+            ids.push_back(&concept->getId());
+        } else if (const std::string* named = findByName(endpoint)) {
+            ids.push_back(named);
+        } else {
+            newConcepts.push_back(std::make_unique<Concept>(key, key, ""));
+            ids.push_back(&newConcepts.back()->getId());
+        }
+        resolved.emplace(endpoint, index);
+        return index;
+    }
+
+    const std::string& getId(uint32_t index) const { return *ids[index]; }
+
+    std::vector<std::unique_ptr<Concept>> takeNewConcepts() { return std::move(newConcepts); }
+
+private:
+    const std::string* findByName(std::string_view name) {
+        if (!namesIndexed) {
+            // Only needed once an endpoint is not an id
+            names.reserve(model.getConceptCount());
+            for (const auto& concept : model.getConcepts()) {
+                names.emplace(concept->getName(), &concept->getId());
+            }
+            namesIndexed = true;
+        }
+        auto found = names.find(name);
+        return found != names.end() ? found->second : nullptr;
+    }
+
+    const MentalModel& model;
+    std::unordered_map<std::string_view, uint32_t> resolved;
+    std::unordered_map<std::string_view, const std::string*> names;
+    bool namesIndexed = false;
+    std::vector<const std::string*> ids;
+    std::vector<std::unique_ptr<Concept>> newConcepts;
+};
+
+/**
+ * Relationship with the given id, or with "edge_<ordinal>" if none is
+ * given. Whether the id is free is settled afterwards by RelationshipIds.
+ */
+std::unique_ptr<Relationship> makeRelationship(std::string_view givenId, size_t ordinal, const std::string& source,
+                                               const std::string& target, std::string_view type, double weight,
+                                               bool directed) {
+    std::string edgeType = type.empty() ? DEFAULT_TYPE : std::string(type);
+    std::string id = givenId.empty() ? "edge_" + std::to_string(ordinal) : std::string(givenId);
+    return std::make_unique<Relationship>(id, source, target, edgeType, directed, weight);
+}
+
+/**
+ * The ids of one import's relationships, settled in file order on the
+ * calling thread: a given id already in the model or earlier in the file
+ * rejects its relationship, a generated one that is taken is replaced by a
+ * random one
+ */
+class RelationshipIds {
+public:
+    explicit RelationshipIds(const MentalModel& model) : model(model) {}
+
+    /**
+     * @return relationship, possibly under a new id, or nullptr if its given id is taken
+     */
+    std::unique_ptr<Relationship> settle(std::unique_ptr<Relationship> relationship, bool generated) {
+        if (isTaken(relationship->getId())) {
+            if (!generated) return nullptr;
+            do {
+                relationship = std::make_unique<Relationship>(
+                    relationship->getSourceConceptId(), relationship->getTargetConceptId(), relationship->getType(),
+                    relationship->getIsDirected(), relationship->getWeight());
+            } while (isTaken(relationship->getId()));
+        }
+        // The caller holds the relationship for the rest of the import, so a view of its id stays valid
+        used.insert(relationship->getId());
+        return relationship;
+    }
+
+private:
+    bool isTaken(const std::string& id) const {
+        return model.getRelationship(id) || used.count(id);
+    }
+
+    const MentalModel& model;
+    std::unordered_set<std::string_view> used;
+};
+
+struct EdgeRow {
+    std::string_view source;
+    std::string_view target;
+    std::string_view type;
+    std::string_view id;
+    double weight = 1.0;
+    bool directed = true; // Source and target read as a direction unless told otherwise
+};
+
+struct EdgeChunk {
+    RowRange range;
+    std::deque<std::string> decoded;
+    std::vector<EdgeRow> rows;
+    std::vector<std::string_view> endpoints; // Distinct, in order of appearance
+    std::vector<uint32_t> rowEndpoints; // Source and target of each row, into endpoints
+    std::vector<uint32_t> resolved; // EndpointResolver index of each endpoint
+    std::vector<std::unique_ptr<Relationship>> relationships;
+    size_t skipped = 0;
+};
+
+void parseEdges(const char* data, char delimiter, const std::vector<EdgeField>& columns, EdgeChunk& chunk) {
+    RowReader reader(data, chunk.range.begin, chunk.range.end, delimiter, chunk.decoded);
+    std::unordered_map<std::string_view, uint32_t> seen;
+    std::vector<std::string_view> fields;
+    while (reader.next(fields)) {
+        EdgeRow row;
+        bool valid = true;
+        for (size_t i = 0; i < fields.size() && i < columns.size(); ++i) {
+            std::string_view field = fields[i];
+            switch (columns[i]) {
+                case EdgeField::SOURCE: row.source = field; break;
+                case EdgeField::TARGET: row.target = field; break;
+                case EdgeField::TYPE: row.type = field; break;
+                case EdgeField::ID: row.id = field; break;
+                case EdgeField::WEIGHT:
+                    if (!field.empty()) valid = valid && parseNumber(field, row.weight);
+                    break;
+                case EdgeField::DIRECTED:
+                    if (!field.empty()) valid = valid && parseFlag(field, row.directed);
+                    break;
+                case EdgeField::OTHER: break;
+            }
+        }
+        if (!valid || row.source.empty() || row.target.empty()) {
+            ++chunk.skipped;
+            continue;
+        }
+        for (std::string_view endpoint : {row.source, row.target}) {
+            auto inserted = seen.emplace(endpoint, static_cast<uint32_t>(chunk.endpoints.size()));
+            if (inserted.second) chunk.endpoints.push_back(endpoint);
+            chunk.rowEndpoints.push_back(inserted.first->second);
+        }
+        chunk.rows.push_back(row);
+    }
+}
+
+struct NodeChunk {
+    RowRange range;
+    std::vector<std::unique_ptr<Concept>> concepts;
+    size_t skipped = 0;
+};
+
+void parseNodes(const char* data, char delimiter, const std::vector<NodeField>& columns, NodeChunk& chunk) {
+    std::deque<std::string> decoded;
+    RowReader reader(data, chunk.range.begin, chunk.range.end, delimiter, decoded);
+    std::vector<std::string_view> fields;
+    while (reader.next(fields)) {
+        std::string_view id, name, description, tags;
+        Position position;
+        bool valid = true;
+        for (size_t i = 0; i < fields.size() && i < columns.size(); ++i) {
+            std::string_view field = fields[i];
+            switch (columns[i]) {
+                case NodeField::ID: id = field; break;
+                case NodeField::NAME: name = field; break;
+                case NodeField::DESCRIPTION: description = field; break;
+                case NodeField::TAGS: tags = field; break;
+                case NodeField::X:
+                    if (!field.empty()) valid = valid && parseNumber(field, position.x);
+                    break;
+                case NodeField::Y:
+                    if (!field.empty()) valid = valid && parseNumber(field, position.y);
+                    break;
+                case NodeField::OTHER: break;
+            }
+        }
+        if (!valid || (id.empty() && name.empty())) {
+            ++chunk.skipped;
+            continue;
+        }
+        auto concept = std::make_unique<Concept>(std::string(id.empty() ? name : id),
+                                                 std::string(name.empty() ? id : name), std::string(description));
+        splitTags(tags, *concept);
+        concept->setPosition(position);
+        chunk.concepts.push_back(std::move(concept));
+    }
+}
+
+/**
+ * Concepts whose ids are not in the model yet, first of each id
+ */
+std::vector<std::unique_ptr<Concept>> takeUnseen(const MentalModel& model,
+                                                 std::vector<std::unique_ptr<Concept>>& candidates,
+                                                 std::unordered_set<std::string_view>& seen, size_t& skipped) {
+    std::vector<std::unique_ptr<Concept>> accepted;
+    accepted.reserve(candidates.size());
+    for (auto& concept : candidates) {
+        if (model.getConcept(concept->getId()) || !seen.insert(concept->getId()).second) {
+            ++skipped;
+            continue;
+        }
+        accepted.push_back(std::move(concept));
+    }
+    return accepted;
+}
+
+/**
+ * Buffers output for the write function
+ */
+class OutputBuffer {
+public:
+    explicit OutputBuffer(const GraphExporter::WriteFunction& write) : write(write) {
+        text.reserve(WRITE_BUFFER_BYTES * 2);
+    }
+
+    void endRecord() {
+        if (text.size() >= WRITE_BUFFER_BYTES) flush();
+    }
+
+    void flush() {
+        if (!text.empty() && !write(text.data(), text.size())) {
+            throw FileIOException("Failed to write graph export");
+        }
+        text.clear();
+    }
+
+    std::string text;
+
+private:
+    const GraphExporter::WriteFunction& write;
+};
+
+void appendField(std::string& out, std::string_view field, char delimiter) {
+    bool quote = field.find_first_of(std::string{delimiter, '"', '\n', '\r'}) != std::string_view::npos ||
+                 (!field.empty() && (field.front() == ' ' || field.back() == ' '));
+    if (!quote) {
+        out += field;
+        return;
+    }
+    out += '"';
+    for (char c : field) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+/**
+ * XML 1.0 cannot hold other control characters at all, so they are dropped
+ */
+void appendXml(std::string& out, std::string_view text, bool attribute) {
+    for (char c : text) {
+        switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            case '\r': out += "&#13;"; break;
+            case '\n': out += attribute ? "&#10;" : "\n"; break;
+            case '\t': out += attribute ? "&#9;" : "\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) >= 0x20) out += c;
+        }
+    }
+}
+
+void appendXmlData(std::string& out, const char* key, std::string_view text) {
+    out += "<data key=\"";
+    out += key;
+    out += "\">";
+    appendXml(out, text, false);
+    out += "</data>";
+}
+
+std::string joinTags(const std::vector<std::string>& tags) {
+    std::string joined;
+    for (const auto& tag : tags) {
+        if (!joined.empty()) joined += TAG_SEPARATOR;
+        joined += tag;
+    }
+    return joined;
+}
+
+std::string lowerName(QStringView name) {
+    return name.toString().toLower().toStdString();
+}
+
+// GraphML data key → attribute name it stands for, per element kind
+struct GraphMLKeys {
+    std::unordered_map<std::string, std::string> node;
+    std::unordered_map<std::string, std::string> edge;
+
+    static std::string lookup(const std::unordered_map<std::string, std::string>& keys, const std::string& key) {
+        auto found = keys.find(key);
+        return found != keys.end() ? found->second : key; // Undeclared keys go by their id
+    }
+};
+
+struct GraphMLEdge {
+    std::string id;
+    std::string source;
+    std::string target;
+    std::string type;
+    double weight = 1.0;
+    bool directed = true;
+};
+
+} // namespace
+
+ImportResult GraphImporter::importEdgeList(MentalModel& model, const char* data, size_t size, char delimiter,
+                                           QThreadPool* pool) {
+    size_t begin = skipByteOrderMark(data, size);
+    std::vector<EdgeField> columns;
+    begin = readColumns(data, begin, size, delimiter, EDGE_FIELDS, columns);
+    if (!hasColumn(columns, EdgeField::SOURCE) || !hasColumn(columns, EdgeField::TARGET)) {
+        throw ParseException("Edge list header names no source or no target column");
+    }
+
+    std::vector<RowRange> ranges = splitRows(data, begin, size);
+    std::vector<EdgeChunk> chunks(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        chunks[i].range = ranges[i];
+    }
+    if (!pool) pool = QThreadPool::globalInstance();
+    runParallel(chunks.size(), [&](size_t index) { parseEdges(data, delimiter, columns, chunks[index]); }, pool);
+
+    // Each chunk's distinct endpoints, in file order, so new concepts are too
+    const MentalModel& existing = model;
+    EndpointResolver resolver(existing);
+    ImportResult result;
+    std::vector<size_t> firstOrdinal(chunks.size());
+    size_t ordinal = existing.getRelationshipCount();
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        EdgeChunk& chunk = chunks[i];
+        chunk.resolved.reserve(chunk.endpoints.size());
+        for (std::string_view endpoint : chunk.endpoints) {
+            chunk.resolved.push_back(resolver.resolve(endpoint));
+        }
+        firstOrdinal[i] = ordinal;
+        ordinal += chunk.rows.size();
+    }
+
+    runParallel(chunks.size(), [&](size_t index) {
+        EdgeChunk& chunk = chunks[index];
+        chunk.relationships.reserve(chunk.rows.size());
+        for (size_t i = 0; i < chunk.rows.size(); ++i) {
+            const EdgeRow& row = chunk.rows[i];
+            const std::string& source = resolver.getId(chunk.resolved[chunk.rowEndpoints[2 * i]]);
+            const std::string& target = resolver.getId(chunk.resolved[chunk.rowEndpoints[2 * i + 1]]);
+            chunk.relationships.push_back(makeRelationship(row.id, firstOrdinal[index] + i, source, target,
+                                                           row.type, row.weight, row.directed));
+        }
+    }, pool);
+
+    auto newConcepts = resolver.takeNewConcepts();
+    result.concepts = newConcepts.size();
+    model.addConceptsBulk(std::move(newConcepts));
+
+    std::vector<std::unique_ptr<Relationship>> relationships;
+    relationships.reserve(ordinal - existing.getRelationshipCount());
+    RelationshipIds ids(existing);
+    for (auto& chunk : chunks) {
+        result.skipped += chunk.skipped;
+        for (size_t i = 0; i < chunk.relationships.size(); ++i) {
+            auto relationship = ids.settle(std::move(chunk.relationships[i]), chunk.rows[i].id.empty());
+            if (relationship) {
+                relationships.push_back(std::move(relationship));
+            } else {
+                ++result.skipped;
+            }
+        }
+    }
+    size_t decoded = relationships.size();
+    result.relationships = model.addRelationshipsBulk(std::move(relationships));
+    result.skipped += decoded - result.relationships;
+    return result;
+}
+
+ImportResult GraphImporter::importNodes(MentalModel& model, const char* data, size_t size, char delimiter,
+                                        QThreadPool* pool) {
+    size_t begin = skipByteOrderMark(data, size);
+    std::vector<NodeField> columns;
+    begin = readColumns(data, begin, size, delimiter, NODE_FIELDS, columns);
+    if (!hasColumn(columns, NodeField::ID) && !hasColumn(columns, NodeField::NAME)) {
+        throw ParseException("Node table header names no id or name column");
+    }
+
+    std::vector<RowRange> ranges = splitRows(data, begin, size);
+    std::vector<NodeChunk> chunks(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        chunks[i].range = ranges[i];
+    }
+    runParallel(chunks.size(), [&](size_t index) { parseNodes(data, delimiter, columns, chunks[index]); },
+                pool ? pool : QThreadPool::globalInstance());
+
+    ImportResult result;
+    std::vector<std::unique_ptr<Concept>> concepts;
+    std::unordered_set<std::string_view> seen;
+    for (auto& chunk : chunks) {
+        result.skipped += chunk.skipped;
+        auto accepted = takeUnseen(model, chunk.concepts, seen, result.skipped);
+        std::move(accepted.begin(), accepted.end(), std::back_inserter(concepts));
+    }
+    result.concepts = concepts.size();
+    model.addConceptsBulk(std::move(concepts));
+    return result;
+}
+
+ImportResult GraphImporter::importGraphML(MentalModel& model, QIODevice& device) {
+    QXmlStreamReader xml(&device);
+    GraphMLKeys keys;
+    std::vector<std::unique_ptr<Concept>> nodes;
+    std::deque<GraphMLEdge> edges; // Endpoints are resolved by view, so they must not move
+    ImportResult result;
+    bool directedByDefault = true;
+    bool inGraph = false;
+
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isEndElement() && xml.name() == QLatin1String("graph")) {
+            break; // Only the first graph is read
+        }
+        if (!xml.isStartElement()) continue;
+
+        QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == QLatin1String("key")) {
+            std::string id = attributes.value(QLatin1String("id")).toString().toStdString();
+            std::string name = lowerName(attributes.value(QLatin1String("attr.name")));
+            QStringView domain = attributes.value(QLatin1String("for"));
+            if (name.empty()) name = id;
+            if (domain != QLatin1String("edge")) keys.node[id] = name;
+            if (domain != QLatin1String("node")) keys.edge[id] = name;
+            xml.skipCurrentElement();
+        } else if (xml.name() == QLatin1String("graph")) {
+            inGraph = true;
+            directedByDefault = attributes.value(QLatin1String("edgedefault")) != QLatin1String("undirected");
+        } else if (xml.name() == QLatin1String("node") && inGraph) {
+            std::string id = attributes.value(QLatin1String("id")).toString().toStdString();
+            std::string name, description, tags;
+            Position position;
+            bool valid = !id.empty();
+            while (xml.readNextStartElement()) {
+                if (xml.name() != QLatin1String("data")) {
+                    xml.skipCurrentElement(); // Ports, nested graphs
+                    continue;
+                }
+                std::string key = GraphMLKeys::lookup(
+                    keys.node, xml.attributes().value(QLatin1String("key")).toString().toStdString());
+                QString text = xml.readElementText(QXmlStreamReader::SkipChildElements);
+                bool ok = true;
+                if (key == "name" || key == "label") name = text.toStdString();
+                else if (key == "description") description = text.toStdString();
+                else if (key == "tags") tags = text.toStdString();
+                else if (key == "x") position.x = text.toDouble(&ok);
+                else if (key == "y") position.y = text.toDouble(&ok);
+                valid = valid && ok;
+            }
+            if (!valid) {
+                ++result.skipped;
+                continue;
+            }
+            auto concept = std::make_unique<Concept>(id, name.empty() ? id : name, description);
+            splitTags(tags, *concept);
+            concept->setPosition(position);
+            nodes.push_back(std::move(concept));
+        } else if (xml.name() == QLatin1String("edge") && inGraph) {
+            GraphMLEdge edge;
+            edge.id = attributes.value(QLatin1String("id")).toString().toStdString();
+            edge.source = attributes.value(QLatin1String("source")).toString().toStdString();
+            edge.target = attributes.value(QLatin1String("target")).toString().toStdString();
+            edge.directed = directedByDefault;
+            bool valid = !edge.source.empty() && !edge.target.empty();
+            if (attributes.hasAttribute(QLatin1String("directed"))) {
+                std::string directed = attributes.value(QLatin1String("directed")).toString().toStdString();
+                valid = valid && parseFlag(directed, edge.directed);
+            }
+            while (xml.readNextStartElement()) {
+                if (xml.name() != QLatin1String("data")) {
+                    xml.skipCurrentElement();
+                    continue;
+                }
+                std::string key = GraphMLKeys::lookup(
+                    keys.edge, xml.attributes().value(QLatin1String("key")).toString().toStdString());
+                QString text = xml.readElementText(QXmlStreamReader::SkipChildElements);
+                bool ok = true;
+                if (key == "type" || key == "label" || key == "relation") edge.type = text.toStdString();
+                else if (key == "weight") edge.weight = text.toDouble(&ok);
+                valid = valid && ok;
+            }
+            if (valid) {
+                edges.push_back(std::move(edge));
+            } else {
+                ++result.skipped;
+            }
+        }
+    }
+    if (xml.hasError()) {
+        throw ParseException("GraphML parse error at line " + std::to_string(xml.lineNumber()) + ": " +
+                             xml.errorString().toStdString());
+    }
+
+    // Nodes go in first so edges find them by id
+    std::unordered_set<std::string_view> seen;
+    auto accepted = takeUnseen(model, nodes, seen, result.skipped);
+    result.concepts = accepted.size();
+    model.addConceptsBulk(std::move(accepted));
+
+    const MentalModel& existing = model;
+    EndpointResolver resolver(existing);
+    std::vector<std::unique_ptr<Relationship>> relationships;
+    relationships.reserve(edges.size());
+    size_t ordinal = existing.getRelationshipCount();
+    RelationshipIds ids(existing);
+    for (const auto& edge : edges) {
+        const std::string& source = resolver.getId(resolver.resolve(edge.source));
+        const std::string& target = resolver.getId(resolver.resolve(edge.target));
+        auto relationship = ids.settle(makeRelationship(edge.id, ordinal++, source, target, edge.type, edge.weight,
+                                                        edge.directed),
+                                       edge.id.empty());
+        if (relationship) {
+            relationships.push_back(std::move(relationship));
+        } else {
+            ++result.skipped;
+        }
+    }
+
+    auto newConcepts = resolver.takeNewConcepts();
+    result.concepts += newConcepts.size();
+    model.addConceptsBulk(std::move(newConcepts));
+    size_t decoded = relationships.size();
+    result.relationships = model.addRelationshipsBulk(std::move(relationships));
+    result.skipped += decoded - result.relationships;
+    return result;
+}
+
+void GraphExporter::writeEdgeList(const MentalModel& model, const WriteFunction& write, char delimiter) {
+    OutputBuffer output(write);
+    std::string& out = output.text;
+    for (const char* name : {"source", "target", "type", "weight", "directed"}) {
+        out += name;
+        out += delimiter;
+    }
+    out += "id\n";
+    for (const auto& relationship : model.getRelationships()) {
+        appendField(out, relationship->getSourceConceptId(), delimiter);
+        out += delimiter;
+        appendField(out, relationship->getTargetConceptId(), delimiter);
+        out += delimiter;
+        appendField(out, relationship->getType(), delimiter);
+        out += delimiter;
+        appendNumber(out, relationship->getWeight());
+        out += delimiter;
+        out += relationship->getIsDirected() ? "true" : "false";
+        out += delimiter;
+        appendField(out, relationship->getId(), delimiter);
+        out += '\n';
+        output.endRecord();
+    }
+    output.flush();
+}
+
+void GraphExporter::writeNodes(const MentalModel& model, const WriteFunction& write, char delimiter) {
+    OutputBuffer output(write);
+    std::string& out = output.text;
+    for (const char* name : {"id", "name", "description", "tags", "x"}) {
+        out += name;
+        out += delimiter;
+    }
+    out += "y\n";
+    for (const auto& concept : model.getConcepts()) {
+        appendField(out, concept->getId(), delimiter);
+        out += delimiter;
+        appendField(out, concept->getName(), delimiter);
+        out += delimiter;
+        appendField(out, concept->getDescription(), delimiter);
+        out += delimiter;
+        appendField(out, joinTags(concept->getTags()), delimiter);
+        out += delimiter;
+        appendNumber(out, concept->getPosition().x);
+        out += delimiter;
+        appendNumber(out, concept->getPosition().y);
+        out += '\n';
+        output.endRecord();
+    }
+    output.flush();
+}
+
+void GraphExporter::writeGraphML(const MentalModel& model, const WriteFunction& write) {
+    OutputBuffer output(write);
+    std::string& out = output.text;
+    out += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+           "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+           "  <key id=\"name\" for=\"node\" attr.name=\"name\" attr.type=\"string\"/>\n"
+           "  <key id=\"description\" for=\"node\" attr.name=\"description\" attr.type=\"string\"/>\n"
+           "  <key id=\"tags\" for=\"node\" attr.name=\"tags\" attr.type=\"string\"/>\n"
+           "  <key id=\"x\" for=\"node\" attr.name=\"x\" attr.type=\"double\"/>\n"
+           "  <key id=\"y\" for=\"node\" attr.name=\"y\" attr.type=\"double\"/>\n"
+           "  <key id=\"type\" for=\"edge\" attr.name=\"type\" attr.type=\"string\"/>\n"
+           "  <key id=\"weight\" for=\"edge\" attr.name=\"weight\" attr.type=\"double\"/>\n"
+           "  <graph id=\"";
+    appendXml(out, model.getModelName(), true);
+    out += "\" edgedefault=\"directed\">\n";
+
+    for (const auto& concept : model.getConcepts()) {
+        out += "    <node id=\"";
+        appendXml(out, concept->getId(), true);
+        out += "\">";
+        appendXmlData(out, "name", concept->getName());
+        if (!concept->getDescription().empty()) appendXmlData(out, "description", concept->getDescription());
+        if (!concept->getTags().empty()) appendXmlData(out, "tags", joinTags(concept->getTags()));
+        out += "<data key=\"x\">";
+        appendNumber(out, concept->getPosition().x);
+        out += "</data><data key=\"y\">";
+        appendNumber(out, concept->getPosition().y);
+        out += "</data></node>\n";
+        output.endRecord();
+    }
+
+    for (const auto& relationship : model.getRelationships()) {
+        out += "    <edge id=\"";
+        appendXml(out, relationship->getId(), true);
+        out += "\" source=\"";
+        appendXml(out, relationship->getSourceConceptId(), true);
+        out += "\" target=\"";
+        appendXml(out, relationship->getTargetConceptId(), true);
+        out += relationship->getIsDirected() ? "\" directed=\"true\">" : "\" directed=\"false\">";
+        appendXmlData(out, "type", relationship->getType());
+        out += "<data key=\"weight\">";
+        appendNumber(out, relationship->getWeight());
+        out += "</data></edge>\n";
+        output.endRecord();
+    }
+
+    out += "  </graph>\n</graphml>\n";
+    output.flush();
+}
+
+} // namespace qlink
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+class QIODevice;
+class QThreadPool;
+
+namespace qlink {
+
+class MentalModel;
+
+/**
+ * What one import added and left out
+ */
+struct ImportResult {
+    size_t concepts = 0; // Including those created for edge endpoints
+    size_t relationships = 0;
+    size_t skipped = 0; // Rows or elements with missing or unreadable fields, or ids already taken
+};
+
+/**
+ * Readers for graph interchange formats: delimited edge lists, delimited
+ * node tables and GraphML.
+ *
+ * Delimited files follow RFC 4180 with a choice of delimiter: fields may be
+ * quoted, with "" standing for a quote, and quoted fields may span lines.
+ * The first row may name the columns; otherwise they are taken in the
+ * order GraphExporter writes them:
+ *   edges  source, target, type, weight, directed, id
+ *   nodes  id, name, description, tags, x, y   (tags separated by ';')
+ *
+ * Edge endpoints are matched against concept ids, then names; an endpoint
+ * matching neither becomes a new concept with that value as id and name.
+ * Delimited input is cut into chunks at row boundaries and parsed on the
+ * pool (the global one if null) and the calling thread; everything is then
+ * added to the model in bulk.
+ */
+class GraphImporter {
+public:
+    /**
+     * @throws ParseException if the file is malformed
+     */
+    static ImportResult importEdgeList(MentalModel& model, const char* data, size_t size, char delimiter,
+                                       QThreadPool* pool = nullptr);
+    static ImportResult importNodes(MentalModel& model, const char* data, size_t size, char delimiter,
+                                    QThreadPool* pool = nullptr);
+
+    /**
+     * Read nodes and edges of the first graph; data keys are matched by
+     * their attr.name, so files from other tools load too
+     * @throws ParseException if the document is not well-formed
+     */
+    static ImportResult importGraphML(MentalModel& model, QIODevice& device);
+};
+
+/**
+ * Writers for the formats GraphImporter reads, streaming through a
+ * fixed-size buffer to the write function
+ */
+class GraphExporter {
+public:
+    /**
+     * @return false if the bytes could not be written
+     */
+    using WriteFunction = std::function<bool(const char* data, size_t size)>;
+
+    /**
+     * @throws FileIOException if the write function fails
+     */
+    static void writeEdgeList(const MentalModel& model, const WriteFunction& write, char delimiter);
+    static void writeNodes(const MentalModel& model, const WriteFunction& write, char delimiter);
+    static void writeGraphML(const MentalModel& model, const WriteFunction& write);
+};
+
+} // namespace qlink
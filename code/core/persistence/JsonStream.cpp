@@ -0,0 +1,337 @@
+#include "JsonStream.h"
+#include "../common/Json.h"
+#include "../common/QLinkException.h"
+#include <algorithm>
+
+namespace qlink {
+
+namespace {
+
+constexpr size_t INDENT = 4;
+
+bool isWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+} // namespace
+
+JsonRecordWriter::JsonRecordWriter(WriteFunction write, size_t bufferSize)
+    : write(std::move(write)), bufferSize(bufferSize) {
+    buffer.reserve(bufferSize);
+}
+
+void JsonRecordWriter::beginObject() {
+    beginValue();
+    put("{", 1);
+    firstInScope.push_back(true);
+}
+
+void JsonRecordWriter::endObject() {
+    endScope('}');
+}
+
+void JsonRecordWriter::writeString(const std::string& key, const std::string& value) {
+    writeKey(key);
+    put("\"" + escape(value) + "\"");
+}
+
+void JsonRecordWriter::writeBool(const std::string& key, bool value) {
+    writeKey(key);
+    put(value ? "true" : "false");
+}
+
+void JsonRecordWriter::writeRaw(const std::string& key, const std::string& json) {
+    writeKey(key);
+    put(json);
+}
+
+void JsonRecordWriter::beginArray(const std::string& key) {
+    writeKey(key);
+    put("[", 1);
+    firstInScope.push_back(true);
+}
+
+void JsonRecordWriter::writeRecord(const std::string& json) {
+    beginValue();
+    put(json);
+}
+
+void JsonRecordWriter::endArray() {
+    endScope(']');
+}
+
+void JsonRecordWriter::finish() {
+    put("\n", 1);
+    flush();
+}
+
+std::string JsonRecordWriter::escape(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    JsonWriter::appendEscaped(escaped, text);
+    return escaped;
+}
+
+void JsonRecordWriter::beginValue() {
+    if (firstInScope.empty()) return;
+    if (!firstInScope.back()) put(",", 1);
+    firstInScope.back() = false;
+    newline();
+}
+
+void JsonRecordWriter::endScope(char closer) {
+    bool empty = firstInScope.back();
+    firstInScope.pop_back();
+    if (!empty) newline();
+    put(&closer, 1);
+}
+
+void JsonRecordWriter::writeKey(const std::string& key) {
+    beginValue();
+    put("\"" + escape(key) + "\": ");
+}
+
+void JsonRecordWriter::newline() {
+    put("\n", 1);
+    buffer.append(firstInScope.size() * INDENT, ' ');
+}
+
+void JsonRecordWriter::put(const char* data, size_t size) {
+    if (buffer.size() + size > bufferSize) flush();
+    buffer.append(data, size);
+}
+
+void JsonRecordWriter::flush() {
+    if (buffer.empty()) return;
+    if (!write(buffer.data(), buffer.size())) {
+        throw FileIOException("Failed to write JSON output");
+    }
+    buffer.clear();
+}
+
+JsonRecordReader::JsonRecordReader(ReadFunction read, size_t chunkSize)
+    : read(std::move(read)), chunk(chunkSize) {
+}
+
+void JsonRecordReader::parse(const Handler& handler) {
+    skipWhitespace();
+    if (atEnd() || peek() != '{') {
+        fail("root element is not an object");
+    }
+    parseModel(handler, true);
+    skipWhitespace();
+    if (!atEnd()) {
+        fail("garbage at the end of the document");
+    }
+}
+
+void JsonRecordReader::parseModel(const Handler& handler, bool isRoot) {
+    expect('{');
+    if (handler.onModelBegin) handler.onModelBegin();
+
+    bool wrapped = false; // The "model" wrapper replaced the root; skip the rest of it
+    skipWhitespace();
+    if (peek() == '}') {
+        next();
+        return;
+    }
+    while (true) {
+        skipWhitespace();
+        std::string key = parseString();
+        skipWhitespace();
+        expect(':');
+        skipWhitespace();
+
+        char first = peek();
+        if (wrapped) {
+            skipValue(nullptr);
+        } else if (isRoot && key == "model" && first == '{') {
+            parseModel(handler, false);
+            wrapped = true;
+        } else if (key == "name" && first == '"') {
+            std::string name = parseString();
+            if (handler.onModelName) handler.onModelName(name);
+        } else if (key == "concepts" && first == '[') {
+            parseRecords(handler.onConcept, handler.onConceptSpan);
+        } else if (key == "relationships" && first == '[') {
+            parseRecords(handler.onRelationship, handler.onRelationshipSpan);
+        } else {
+            skipValue(nullptr);
+        }
+
+        skipWhitespace();
+        char separator = next();
+        if (separator == '}') return;
+        if (separator != ',') fail("expected ',' or '}' in object");
+    }
+}
+
+void JsonRecordReader::parseRecords(const std::function<void(const std::string&)>& onRecord,
+                                    const std::function<void(uint64_t, size_t)>& onSpan) {
+    expect('[');
+    skipWhitespace();
+    if (peek() == ']') {
+        next();
+        return;
+    }
+
+    std::string record;
+    while (true) {
+        skipWhitespace();
+        if (peek() == '{' && (onRecord || !onSpan)) {
+            record.clear();
+            skipValue(&record);
+            largestRecord = std::max(largestRecord, record.size());
+            if (onRecord) onRecord(record);
+        } else if (peek() == '{') {
+            uint64_t start = consumed + position;
+            skipValue(nullptr);
+            size_t length = static_cast<size_t>(consumed + position - start);
+            largestRecord = std::max(largestRecord, length);
+            onSpan(start, length);
+        } else {
+            skipValue(nullptr); // Entries that are not objects were never loaded
+        }
+
+        skipWhitespace();
+        char separator = next();
+        if (separator == ']') return;
+        if (separator != ',') fail("expected ',' or ']' in array");
+    }
+}
+
+std::string JsonRecordReader::parseString() {
+    expect('"');
+    std::string text;
+    while (true) {
+        char c = next();
+        if (c == '"') return text;
+        if (c != '\\') {
+            text += c;
+            continue;
+        }
+
+        char escaped = next();
+        switch (escaped) {
+            case '"': text += '"'; break;
+            case '\\': text += '\\'; break;
+            case '/': text += '/'; break;
+            case 'b': text += '\b'; break;
+            case 'f': text += '\f'; break;
+            case 'n': text += '\n'; break;
+            case 'r': text += '\r'; break;
+            case 't': text += '\t'; break;
+            case 'u': {
+                auto hex4 = [this]() {
+                    uint32_t value = 0;
+                    for (int i = 0; i < 4; ++i) {
+                        char digit = next();
+                        value <<= 4;
+                        if (digit >= '0' && digit <= '9') value |= digit - '0';
+                        else if (digit >= 'a' && digit <= 'f') value |= digit - 'a' + 10;
+                        else if (digit >= 'A' && digit <= 'F') value |= digit - 'A' + 10;
+                        else fail("invalid \\u escape");
+                    }
+                    return value;
+                };
+                uint32_t codePoint = hex4();
+                if (codePoint >= 0xD800 && codePoint < 0xDC00) {
+                    // High surrogate; the low half must follow as another escape
+                    if (next() != '\\' || next() != 'u') fail("unpaired surrogate");
+                    uint32_t low = hex4();
+                    if (low < 0xDC00 || low >= 0xE000) fail("unpaired surrogate");
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                } else if (codePoint >= 0xDC00 && codePoint < 0xE000) {
+                    // Low surrogate with no high half before it
+                    fail("unpaired surrogate");
+                }
+                appendUtf8(text, codePoint);
+                break;
+            }
+            default:
+                fail("invalid escape sequence");
+        }
+    }
+}
+
+void JsonRecordReader::skipValue(std::string* capture) {
+    // Tracks nesting and string boundaries only; captured records are
+    // validated by whoever parses them
+    std::vector<char> closers;
+    do {
+        char c = next();
+        if (capture) *capture += c;
+
+        if (c == '"') {
+            while (true) {
+                char s = next();
+                if (capture) *capture += s;
+                if (s == '"') break;
+                if (s == '\\') {
+                    char escaped = next();
+                    if (capture) *capture += escaped;
+                }
+            }
+        } else if (c == '{') {
+            closers.push_back('}');
+        } else if (c == '[') {
+            closers.push_back(']');
+        } else if (c == '}' || c == ']') {
+            if (closers.empty() || closers.back() != c) fail("mismatched brackets");
+            closers.pop_back();
+        } else if (closers.empty()) {
+            // Number or literal: runs until the next delimiter
+            if (isWhitespace(c) || c == ',' || c == ':') fail("expected a value");
+            while (!atEnd()) {
+                char n = peek();
+                if (isWhitespace(n) || n == ',' || n == '}' || n == ']') break;
+                next();
+                if (capture) *capture += n;
+            }
+        }
+    } while (!closers.empty());
+}
+
+void JsonRecordReader::skipWhitespace() {
+    while (!atEnd() && isWhitespace(peek())) {
+        ++position;
+    }
+}
+
+void JsonRecordReader::expect(char expected) {
+    if (next() != expected) {
+        fail(std::string("expected '") + expected + "'");
+    }
+}
+
+bool JsonRecordReader::atEnd() {
+    if (position < available) return false;
+    if (exhausted) return true;
+
+    consumed += available;
+    position = 0;
+    int64_t count = read(chunk.data(), chunk.size());
+    if (count < 0) {
+        throw FileIOException("Failed to read JSON input");
+    }
+    available = static_cast<size_t>(count);
+    exhausted = count == 0;
+    return exhausted;
+}
+
+char JsonRecordReader::peek() {
+    if (atEnd()) fail("unexpected end of input");
+    return chunk[position];
+}
+
+char JsonRecordReader::next() {
+    char c = peek();
+    ++position;
+    return c;
+}
+
+void JsonRecordReader::fail(const std::string& message) const {
+    throw FileIOException("JSON parse error at byte " + std::to_string(consumed + position) + ": " + message);
+}
+
+} // namespace qlink
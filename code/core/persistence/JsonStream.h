@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace qlink {
+
+/**
+ * Incremental writer for model JSON files.
+ *
+ * Output goes through a fixed-size buffer to the write function, so a model
+ * is written one record at a time instead of being assembled as a document
+ * first. Records are passed in already encoded and are written one per line.
+ */
+class JsonRecordWriter {
+public:
+    /**
+     * @return false if the bytes could not be written
+     */
+    using WriteFunction = std::function<bool(const char* data, size_t size)>;
+
+    explicit JsonRecordWriter(WriteFunction write, size_t bufferSize = 64 * 1024);
+
+    void beginObject();
+    void endObject();
+
+    void writeString(const std::string& key, const std::string& value);
+    void writeBool(const std::string& key, bool value);
+
+    /**
+     * Write a value that is already encoded JSON
+     */
+    void writeRaw(const std::string& key, const std::string& json);
+
+    void beginArray(const std::string& key);
+    void writeRecord(const std::string& json);
+    void endArray();
+
+    /**
+     * Flush buffered output
+     * @throws FileIOException if the write function fails
+     */
+    void finish();
+
+    static std::string escape(const std::string& text);
+
+private:
+    void beginValue();
+    void endScope(char closer);
+    void writeKey(const std::string& key);
+    void put(const char* data, size_t size);
+    void put(const std::string& text) { put(text.data(), text.size()); }
+    void newline();
+    void flush();
+
+    WriteFunction write;
+    size_t bufferSize;
+    std::string buffer;
+    std::vector<bool> firstInScope; // One entry per open object or array
+};
+
+/**
+ * Streaming reader for model JSON files.
+ *
+ * Scans the document structure without building it: the model name is
+ * decoded, each concept and relationship object is handed over as its raw
+ * JSON text and everything else is skipped. Memory use is the read chunk
+ * plus the largest single record. Accepts the model at the root or inside
+ * a "model" wrapper object; when the wrapper is present it wins, as with
+ * the document-based loader.
+ */
+class JsonRecordReader {
+public:
+    /**
+     * @return bytes read into the buffer, 0 at the end of input or -1 on error
+     */
+    using ReadFunction = std::function<int64_t(char* buffer, size_t capacity)>;
+
+    struct Handler {
+        /**
+         * A model object starts; anything reported before belongs to a
+         * model that is being replaced by the wrapper
+         */
+        std::function<void()> onModelBegin;
+        std::function<void(const std::string& name)> onModelName;
+        std::function<void(const std::string& json)> onConcept;
+        std::function<void(const std::string& json)> onRelationship;
+
+        /**
+         * Used instead of onConcept / onRelationship when those are unset:
+         * report where each record lies in the input without copying it
+         */
+        std::function<void(uint64_t offset, size_t length)> onConceptSpan;
+        std::function<void(uint64_t offset, size_t length)> onRelationshipSpan;
+    };
+
+    explicit JsonRecordReader(ReadFunction read, size_t chunkSize = 64 * 1024);
+
+    /**
+     * Read the whole input, reporting records as they are completed
+     * @throws FileIOException if the input is not valid JSON or cannot be read
+     */
+    void parse(const Handler& handler);
+
+    /**
+     * Size of the largest record handed to the handler
+     */
+    size_t getLargestRecord() const { return largestRecord; }
+
+private:
+    void parseModel(const Handler& handler, bool isRoot);
+    void parseRecords(const std::function<void(const std::string&)>& onRecord,
+                      const std::function<void(uint64_t, size_t)>& onSpan);
+    std::string parseString();
+    void skipValue(std::string* capture);
+    void skipWhitespace();
+    void expect(char expected);
+    bool atEnd();
+    char peek();
+    char next();
+    [[noreturn]] void fail(const std::string& message) const;
+
+    ReadFunction read;
+    std::vector<char> chunk;
+    size_t position = 0; // Within chunk
+    size_t available = 0;
+    uint64_t consumed = 0; // Bytes before the current chunk
+    bool exhausted = false;
+    size_t largestRecord = 0;
+};
+
+} // namespace qlink
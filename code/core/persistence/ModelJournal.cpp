@@ -0,0 +1,553 @@
+#include "ModelJournal.h"
+#include "FileSync.h"
+#include "../model/MentalModel.h"
+#include "../common/Hash.h"
+#include "../common/QLinkException.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QDebug>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace qlink {
+
+namespace {
+
+// File: "QLJN", uint32 version, uint64 content hash of the base, then records.
+// Record: RecordHeader, then payload.
+constexpr char FILE_MAGIC[4] = {'Q', 'L', 'J', 'N'};
+constexpr uint32_t FILE_VERSION = 1;
+constexpr uint64_t FILE_HEADER_SIZE = 16;
+constexpr uint32_t RECORD_MARKER = 0x4A524543; // "JREC"
+
+enum RecordType : uint8_t {
+    CONCEPT = 1,               // Full concept state
+    CONCEPT_REMOVED = 2,
+    RELATIONSHIP = 3,          // Full relationship state
+    RELATIONSHIP_REMOVED = 4,
+    CLEARED = 5,
+    SAVE_POINT = 6,
+    ROLLBACK = 7,              // Drop records since the last save point
+    BASE_SWITCH = 8            // uint64 new base hash, uint64 snapshot offset
+};
+
+struct RecordHeader {
+    uint32_t marker;
+    uint32_t length;   // Payload bytes
+    uint32_t checksum; // Over type and payload
+    uint8_t type;
+    uint8_t reserved[3];
+};
+static_assert(sizeof(RecordHeader) == 16, "RecordHeader must have no padding");
+
+uint32_t recordChecksum(uint8_t type, const char* payload, size_t length) {
+    uint64_t hash = fnv1a(&type, sizeof(type));
+    hash = fnv1a(payload, length, hash);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+class Encoder {
+public:
+    template <typename T> void put(T value) { out.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void putString(const std::string& text) {
+        put(static_cast<uint32_t>(text.size()));
+        out += text;
+    }
+    std::string out;
+};
+
+class Decoder {
+public:
+    explicit Decoder(std::string_view in) : in(in) {}
+
+    template <typename T> T get() {
+        T value{};
+        if (sizeof(T) > in.size() - pos) {
+            throw FileIOException("Journal record is shorter than its contents");
+        }
+        std::memcpy(&value, in.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+    std::string getString() {
+        uint32_t length = get<uint32_t>();
+        if (length > in.size() - pos) {
+            throw FileIOException("Journal record is shorter than its contents");
+        }
+        std::string text(in.data() + pos, length);
+        pos += length;
+        return text;
+    }
+    bool atEnd() const { return pos == in.size(); }
+
+private:
+    std::string_view in;
+    size_t pos = 0;
+};
+
+std::string fileHeader(uint64_t baseHash) {
+    std::string header(FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.append(reinterpret_cast<const char*>(&FILE_VERSION), sizeof(FILE_VERSION));
+    header.append(reinterpret_cast<const char*>(&baseHash), sizeof(baseHash));
+    return header;
+}
+
+bool readHeader(const std::string& bytes, uint64_t& baseHash) {
+    if (bytes.size() < FILE_HEADER_SIZE || bytes.compare(0, 8, fileHeader(0), 0, 8) != 0) {
+        return false;
+    }
+    std::memcpy(&baseHash, bytes.data() + 8, sizeof(baseHash));
+    return true;
+}
+
+/**
+ * Visit the valid records from offset on
+ * @return the end of the last valid record
+ */
+uint64_t scanRecords(const std::string& bytes, uint64_t offset,
+                     const std::function<void(uint8_t, std::string_view, uint64_t)>& visit) {
+    while (offset + sizeof(RecordHeader) <= bytes.size()) {
+        RecordHeader header;
+        std::memcpy(&header, bytes.data() + offset, sizeof(header));
+        if (header.marker != RECORD_MARKER) break;
+        if (header.length > bytes.size() - offset - sizeof(header)) break;
+
+        const char* payload = bytes.data() + offset + sizeof(header);
+        if (recordChecksum(header.type, payload, header.length) != header.checksum) break;
+
+        visit(header.type, std::string_view(payload, header.length), offset);
+        offset += sizeof(header) + header.length;
+    }
+    return offset;
+}
+
+std::string readAll(const std::string& filePath) {
+    QFile file(QString::fromStdString(filePath));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    QByteArray data = file.readAll();
+    return std::string(data.constData(), static_cast<size_t>(data.size()));
+}
+
+/**
+ * Where replay for baseHash starts: after the header if the journal was
+ * written for it, or at the snapshot of an interrupted compaction that
+ * produced it. 0 if the journal belongs to another base.
+ */
+uint64_t replayStart(const std::string& bytes, uint64_t baseHash) {
+    uint64_t journalBase;
+    if (!readHeader(bytes, journalBase)) return 0;
+    if (journalBase == baseHash) return FILE_HEADER_SIZE;
+
+    uint64_t start = 0;
+    uint64_t end = scanRecords(bytes, FILE_HEADER_SIZE, [&](uint8_t type, std::string_view payload, uint64_t) {
+        if (type != BASE_SWITCH) return;
+        Decoder decoder(payload);
+        uint64_t newBase = decoder.get<uint64_t>();
+        uint64_t snapshotOffset = decoder.get<uint64_t>();
+        if (newBase == baseHash) start = snapshotOffset;
+    });
+    return start >= FILE_HEADER_SIZE && start <= end ? start : 0;
+}
+
+/**
+ * The records from offset on, without compaction markers
+ */
+std::string recordsFrom(const std::string& bytes, uint64_t offset) {
+    std::string records;
+    scanRecords(bytes, offset, [&](uint8_t type, std::string_view payload, uint64_t recordOffset) {
+        if (type != BASE_SWITCH) {
+            records.append(bytes, recordOffset, sizeof(RecordHeader) + payload.size());
+        }
+    });
+    return records;
+}
+
+void applyRecord(MentalModel& model, uint8_t type, std::string_view payload) {
+    Decoder decoder(payload);
+    switch (type) {
+        case CONCEPT: {
+            std::string id = decoder.getString();
+            std::string name = decoder.getString();
+            std::string description = decoder.getString();
+            double x = decoder.get<double>();
+            double y = decoder.get<double>();
+            uint32_t tagCount = decoder.get<uint32_t>();
+            std::vector<std::string> tags;
+            for (uint32_t i = 0; i < tagCount; ++i) {
+                tags.push_back(decoder.getString());
+            }
+            // Records written before times were journaled end here
+            bool timed = !decoder.atEnd();
+            Timestamp created = timed ? decoder.get<int64_t>() : 0;
+            Timestamp modified = timed ? decoder.get<int64_t>() : 0;
+
+            Concept* concept = model.getConcept(id);
+            bool existing = concept != nullptr;
+            if (!concept) {
+                auto added = std::make_unique<Concept>(id, name, description);
+                concept = added.get();
+                model.addConcept(std::move(added));
+            }
+            concept->setName(name);
+            concept->setDescription(description);
+            concept->setPosition(Position(x, y));
+            for (const auto& tag : std::vector<std::string>(concept->getTags())) {
+                concept->removeTag(tag);
+            }
+            for (const auto& tag : tags) {
+                concept->addTag(tag);
+            }
+            if (timed) {
+                concept->setTimestamps(created, modified);
+            }
+            if (existing) {
+                model.notifyConceptModified(id);
+            }
+            break;
+        }
+        case CONCEPT_REMOVED:
+            model.removeConcept(decoder.getString());
+            break;
+        case RELATIONSHIP: {
+            std::string id = decoder.getString();
+            std::string source = decoder.getString();
+            std::string target = decoder.getString();
+            std::string relationshipType = decoder.getString();
+            bool directed = decoder.get<uint8_t>() != 0;
+            double weight = decoder.get<double>();
+            bool timed = !decoder.atEnd();
+            Timestamp created = timed ? decoder.get<int64_t>() : 0;
+            Timestamp modified = timed ? decoder.get<int64_t>() : 0;
+
+            Relationship* relationship = model.getRelationship(id);
+            if (relationship && (relationship->getSourceConceptId() != source ||
+                                 relationship->getTargetConceptId() != target)) {
+                model.removeRelationship(id);
+                relationship = nullptr;
+            }
+            if (relationship) {
+                relationship->setType(relationshipType);
+                relationship->setDirected(directed);
+                relationship->setWeight(weight);
+                if (timed) {
+                    relationship->setTimestamps(created, modified);
+                }
+                model.notifyRelationshipModified(id);
+            } else {
+                auto added = std::make_unique<Relationship>(id, source, target, relationshipType, directed, weight);
+                if (timed) {
+                    added->setTimestamps(created, modified);
+                }
+                model.addRelationship(std::move(added));
+            }
+            break;
+        }
+        case RELATIONSHIP_REMOVED:
+            model.removeRelationship(decoder.getString());
+            break;
+        case CLEARED:
+            model.clear();
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace
+
+ModelJournal::ModelJournal(const std::string& filePath)
+    : filePath(filePath), syncedSize(FILE_HEADER_SIZE) {
+}
+
+ModelJournal::~ModelJournal() {
+    close();
+}
+
+std::string ModelJournal::pathFor(const std::string& modelPath) {
+    return modelPath + ".qlj";
+}
+
+ModelJournal::ReplayResult ModelJournal::replay(const std::string& filePath, uint64_t baseHash, MentalModel& model) {
+    ReplayResult result;
+    std::string bytes = readAll(filePath);
+    uint64_t start = replayStart(bytes, baseHash);
+    if (start == 0) {
+        return result;
+    }
+    result.matched = true;
+
+    // Records are applied when a save point confirms them; whatever follows
+    // the last one is recovered unless a rollback dropped it
+    std::vector<std::pair<uint8_t, std::string_view>> unsaved;
+    auto applyAll = [&]() {
+        for (const auto& record : unsaved) {
+            applyRecord(model, record.first, record.second);
+        }
+        result.applied += unsaved.size();
+    };
+    scanRecords(bytes, start, [&](uint8_t type, std::string_view payload, uint64_t) {
+        switch (type) {
+            case SAVE_POINT:
+                applyAll();
+                unsaved.clear();
+                break;
+            case ROLLBACK:
+                unsaved.clear();
+                break;
+            case BASE_SWITCH:
+                break;
+            default:
+                unsaved.emplace_back(type, payload);
+        }
+    });
+    applyAll();
+    result.recovered = unsaved.size();
+    return result;
+}
+
+void ModelJournal::open(uint64_t baseHash) {
+    std::lock_guard<std::mutex> lock(mutex);
+    close();
+
+    std::string bytes = readAll(filePath);
+    uint64_t journalBase;
+    if (readHeader(bytes, journalBase) && journalBase == baseHash) {
+        syncedSize = scanRecords(bytes, FILE_HEADER_SIZE, [](uint8_t, std::string_view, uint64_t) {});
+        based = true;
+        openForAppend();
+        if (syncedSize < bytes.size()) {
+            // A crash mid-append leaves a torn record; later appends go after the last good one
+            qWarning() << "Truncating damaged tail of model journal:" << (bytes.size() - syncedSize) << "bytes";
+            file->resize(static_cast<qint64>(syncedSize));
+        }
+        return;
+    }
+
+    uint64_t start = replayStart(bytes, baseHash);
+    rewrite(baseHash, start ? recordsFrom(bytes, start) : std::string());
+}
+
+void ModelJournal::reset(uint64_t baseHash, bool keepBuffered) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!keepBuffered) {
+        buffered.clear();
+        dropStaged();
+    }
+    rewrite(baseHash, std::string());
+}
+
+bool ModelJournal::hasBase() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return based;
+}
+
+void ModelJournal::recordConcept(const Concept& concept) {
+    Encoder encoder;
+    encoder.putString(concept.getId());
+    encoder.putString(concept.getName());
+    encoder.putString(concept.getDescription());
+    encoder.put(concept.getPosition().x);
+    encoder.put(concept.getPosition().y);
+    encoder.put(static_cast<uint32_t>(concept.getTags().size()));
+    for (const auto& tag : concept.getTags()) {
+        encoder.putString(tag);
+    }
+    encoder.put(concept.getCreated());
+    encoder.put(concept.getModified());
+    std::lock_guard<std::mutex> lock(mutex);
+    stage(CONCEPT, true, concept.getId(), std::move(encoder.out));
+}
+
+void ModelJournal::recordConceptRemoved(const std::string& conceptId) {
+    Encoder encoder;
+    encoder.putString(conceptId);
+    std::lock_guard<std::mutex> lock(mutex);
+    stage(CONCEPT_REMOVED, true, conceptId, std::move(encoder.out));
+}
+
+void ModelJournal::recordRelationship(const Relationship& relationship) {
+    Encoder encoder;
+    encoder.putString(relationship.getId());
+    encoder.putString(relationship.getSourceConceptId());
+    encoder.putString(relationship.getTargetConceptId());
+    encoder.putString(relationship.getType());
+    encoder.put(static_cast<uint8_t>(relationship.getIsDirected() ? 1 : 0));
+    encoder.put(relationship.getWeight());
+    encoder.put(relationship.getCreated());
+    encoder.put(relationship.getModified());
+    std::lock_guard<std::mutex> lock(mutex);
+    stage(RELATIONSHIP, false, relationship.getId(), std::move(encoder.out));
+}
+
+void ModelJournal::recordRelationshipRemoved(const std::string& relationshipId) {
+    Encoder encoder;
+    encoder.putString(relationshipId);
+    std::lock_guard<std::mutex> lock(mutex);
+    stage(RELATIONSHIP_REMOVED, false, relationshipId, std::move(encoder.out));
+}
+
+void ModelJournal::recordCleared() {
+    std::lock_guard<std::mutex> lock(mutex);
+    dropStaged(); // Cleared anyway
+    append(CLEARED, std::string());
+}
+
+void ModelJournal::recordSavePoint() {
+    std::lock_guard<std::mutex> lock(mutex);
+    mergeStaged();
+    append(SAVE_POINT, std::string());
+}
+
+void ModelJournal::recordRollback() {
+    std::lock_guard<std::mutex> lock(mutex);
+    dropStaged(); // All after the last save point, which the rollback drops
+    append(ROLLBACK, std::string());
+}
+
+void ModelJournal::sync() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!based) return;
+    mergeStaged();
+    writeBuffered();
+    if (!syncFile(*file)) {
+        throw FileIOException("Cannot sync model journal: " + filePath);
+    }
+}
+
+uint64_t ModelJournal::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return syncedSize + buffered.size() + stagedBytes;
+}
+
+uint64_t ModelJournal::getBufferedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return buffered.size() + stagedBytes;
+}
+
+void ModelJournal::beginRebase(uint64_t newBaseHash, uint64_t snapshotOffset) {
+    Encoder encoder;
+    encoder.put(newBaseHash);
+    encoder.put(snapshotOffset);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!based) return;
+    mergeStaged();
+    append(BASE_SWITCH, encoder.out);
+    writeBuffered();
+    if (!syncFile(*file)) {
+        throw FileIOException("Cannot sync model journal: " + filePath);
+    }
+}
+
+void ModelJournal::finishRebase(uint64_t newBaseHash, uint64_t snapshotOffset) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!based) return;
+    mergeStaged();
+    writeBuffered();
+    std::string bytes = readAll(filePath);
+    rewrite(newBaseHash, recordsFrom(bytes, std::min<uint64_t>(snapshotOffset, bytes.size())));
+}
+
+void ModelJournal::append(uint8_t type, const std::string& payload) {
+    RecordHeader header{};
+    header.marker = RECORD_MARKER;
+    header.length = static_cast<uint32_t>(payload.size());
+    header.checksum = recordChecksum(type, payload.data(), payload.size());
+    header.type = type;
+    buffered.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    buffered += payload;
+}
+
+void ModelJournal::stage(uint8_t type, bool concept, const std::string& id, std::string payload) {
+    auto recordBytes = [](const StagedRecord& record) {
+        return sizeof(RecordHeader) + record.payload.size() +
+               (record.removal.empty() ? 0 : sizeof(RecordHeader) + record.removal.size());
+    };
+    auto& index = concept ? stagedConcepts : stagedRelationships;
+    auto found = index.emplace(id, staged.size());
+    if (found.second) {
+        staged.push_back(StagedRecord{type, std::move(payload), std::string()});
+    } else {
+        StagedRecord& record = staged[found.first->second];
+        stagedBytes -= recordBytes(record);
+        std::string removal;
+        if (type == CONCEPT) {
+            removal = record.type == CONCEPT_REMOVED ? std::move(record.payload) : std::move(record.removal);
+        }
+        record = StagedRecord{type, std::move(payload), std::move(removal)};
+    }
+    stagedBytes += recordBytes(staged[found.first->second]);
+}
+
+// Removals first and relationships after the concepts they join, so replay
+// reaches the state the entities ended in whatever order they changed in
+void ModelJournal::mergeStaged() {
+    for (uint8_t type : {RELATIONSHIP_REMOVED, CONCEPT_REMOVED, CONCEPT, RELATIONSHIP}) {
+        for (const auto& record : staged) {
+            if (record.type == type) {
+                append(record.type, record.payload);
+            } else if (type == CONCEPT_REMOVED && !record.removal.empty()) {
+                append(CONCEPT_REMOVED, record.removal);
+            }
+        }
+    }
+    dropStaged();
+}
+
+void ModelJournal::dropStaged() {
+    staged.clear();
+    stagedConcepts.clear();
+    stagedRelationships.clear();
+    stagedBytes = 0;
+}
+
+void ModelJournal::writeBuffered() {
+    if (buffered.empty()) return;
+    file->seek(static_cast<qint64>(syncedSize));
+    if (file->write(buffered.data(), static_cast<qint64>(buffered.size())) != static_cast<qint64>(buffered.size())) {
+        throw FileIOException("Cannot write model journal: " + filePath);
+    }
+    syncedSize += buffered.size();
+    buffered.clear();
+}
+
+void ModelJournal::rewrite(uint64_t baseHash, const std::string& records) {
+    close();
+
+    QString path = QString::fromStdString(filePath);
+    QSaveFile saveFile(path);
+    std::string contents = fileHeader(baseHash) + records;
+    if (!saveFile.open(QIODevice::WriteOnly) ||
+        saveFile.write(contents.data(), static_cast<qint64>(contents.size())) != static_cast<qint64>(contents.size()) ||
+        !syncFile(saveFile) || !saveFile.commit()) {
+        throw FileIOException("Cannot write model journal: " + filePath);
+    }
+    syncParentDirectory(path);
+
+    syncedSize = contents.size();
+    based = true;
+    openForAppend();
+}
+
+void ModelJournal::openForAppend() {
+    file = std::make_unique<QFile>(QString::fromStdString(filePath));
+    if (!file->open(QIODevice::ReadWrite)) {
+        file.reset();
+        based = false;
+        throw FileIOException("Cannot open model journal: " + filePath);
+    }
+}
+
+void ModelJournal::close() {
+    if (file) {
+        file->close();
+        file.reset();
+    }
+    based = false;
+}
+
+} // namespace qlink
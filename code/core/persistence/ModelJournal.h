@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class QFile;
+
+namespace qlink {
+
+class MentalModel;
+class Concept;
+class Relationship;
+
+/**
+ * Append-only change journal kept next to a model file (its base).
+ *
+ * Each change is a small checksummed binary record holding the full new
+ * state of one concept or relationship, or a removal, so replaying a record
+ * twice gives the same result. Records are buffered and written with one
+ * fsync per sync() call; until the next save point or sync, a record for an
+ * entity replaces the one before it, so an entity dragged or retyped many
+ * times between syncs costs one record. Save points mark which records the user saved;
+ * records after the last one are unsaved changes a crash left behind, and
+ * a rollback record drops them.
+ *
+ * The header names the base by a hash of its content; a journal written for
+ * another version of the base is ignored. Compaction writes a new base from
+ * a snapshot taken at a save point, then keeps only the records after it.
+ * A marker appended before the new base replaces the old one lets replay
+ * find the right starting point if a crash hits between the two renames.
+ *
+ * All members may be called from any thread.
+ */
+class ModelJournal {
+public:
+    struct ReplayResult {
+        bool matched = false;  // The journal belongs to this base
+        size_t applied = 0;    // Records applied to the model
+        size_t recovered = 0;  // Of those, records after the last save point
+    };
+
+    explicit ModelJournal(const std::string& filePath);
+    ~ModelJournal();
+
+    ModelJournal(const ModelJournal&) = delete;
+    ModelJournal& operator=(const ModelJournal&) = delete;
+
+    /**
+     * Journal file for a model file
+     */
+    static std::string pathFor(const std::string& modelPath);
+
+    /**
+     * Apply the journal at filePath to model, freshly loaded from a base
+     * with content hash baseHash. A torn tail is ignored.
+     */
+    static ReplayResult replay(const std::string& filePath, uint64_t baseHash, MentalModel& model);
+
+    /**
+     * Continue the existing journal for this base, finishing an interrupted
+     * compaction if needed, or start a new one if there is none or it
+     * belongs to another base
+     * @throws FileIOException if the journal cannot be written
+     */
+    void open(uint64_t baseHash);
+
+    /**
+     * Start a new, empty journal for a base that was just written
+     * @param keepBuffered Keep unsynced records; they were made after the base's snapshot
+     * @throws FileIOException if the journal cannot be written
+     */
+    void reset(uint64_t baseHash, bool keepBuffered);
+
+    /**
+     * Whether the journal has a base; records are only buffered until it does
+     */
+    bool hasBase() const;
+
+    void recordConcept(const Concept& concept);
+    void recordConceptRemoved(const std::string& conceptId);
+    void recordRelationship(const Relationship& relationship);
+    void recordRelationshipRemoved(const std::string& relationshipId);
+    void recordCleared();
+    void recordSavePoint();
+    void recordRollback();
+
+    /**
+     * Write buffered records and fsync
+     * @throws FileIOException if the journal cannot be written
+     */
+    void sync();
+
+    /**
+     * Size the journal will have once synced; record offsets are relative to it
+     */
+    uint64_t getSize() const;
+    uint64_t getBufferedBytes() const;
+
+    /**
+     * Called once a compacted base is on disk but before it replaces the
+     * old one: marks where its snapshot was taken
+     * @throws FileIOException if the journal cannot be written
+     */
+    void beginRebase(uint64_t newBaseHash, uint64_t snapshotOffset);
+
+    /**
+     * Called after the new base is in place: keeps only the records written
+     * after snapshotOffset
+     * @throws FileIOException if the journal cannot be written
+     */
+    void finishRebase(uint64_t newBaseHash, uint64_t snapshotOffset);
+
+private:
+    void append(uint8_t type, const std::string& payload);
+    void stage(uint8_t type, bool concept, const std::string& id, std::string payload);
+    void mergeStaged();
+    void dropStaged();
+    void writeBuffered();
+    void rewrite(uint64_t baseHash, const std::string& records);
+    void openForAppend();
+    void close();
+
+    std::string filePath;
+    std::unique_ptr<QFile> file;
+    bool based = false;
+    uint64_t syncedSize; // Header plus records on disk
+    std::string buffered;
+
+    // The latest record for each entity changed since the last merge
+    struct StagedRecord {
+        uint8_t type;
+        std::string payload;
+        // A concept removed and added again keeps its removal, which on
+        // replay also drops the relationships the old concept had
+        std::string removal;
+    };
+    std::vector<StagedRecord> staged;
+    std::unordered_map<std::string, size_t> stagedConcepts; // Id to index in staged
+    std::unordered_map<std::string, size_t> stagedRelationships;
+    uint64_t stagedBytes = 0; // As records
+
+    mutable std::mutex mutex;
+};
+
+} // namespace qlink
@@ -1,53 +1,154 @@
 #include "ModelManager.h"
+#include "BinaryModelFormat.h"
+#include "JsonStream.h"
+#include "FileSync.h"
+#include "SaveJob.h"
+#include "ModelJournal.h"
+#include "ModelOverlay.h"
+#include "ParallelTasks.h"
+#include "../common/Hash.h"
+#include "../common/Json.h"
 #include "../common/QLinkException.h"
+#include "../common/Timestamp.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QFile>
+#include <QSaveFile>
 #include <QFileInfo>
 #include <QDir>
 #include <QStandardPaths>
+#include <QTimer>
+#include <QPointer>
 #include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 
 namespace qlink {
 
+namespace {
+
+struct RecordSpan {
+    uint64_t offset;
+    size_t length;
+};
+
+// Consecutive records decoded by one task
+struct ParseChunk {
+    bool relationships;
+    size_t first;
+    size_t last;
+};
+
+QJsonObject parseRecordAt(const char* data, const RecordSpan& span) {
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(
+        QByteArray::fromRawData(data + span.offset, static_cast<int>(span.length)), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        throw FileIOException("JSON parse error at byte " + std::to_string(span.offset + parseError.offset) +
+                              ": " + parseError.errorString().toStdString());
+    }
+    return doc.object();
+}
+
+/**
+ * Payloads read from the concept records of a mapped JSON document, by
+ * record; the document stays mapped while a model or clone reads from it
+ */
+class JsonPayloadSource : public ConceptPayloadSource {
+public:
+    JsonPayloadSource(std::shared_ptr<const char> data, std::vector<RecordSpan> spans)
+        : data(std::move(data)), spans(std::move(spans)) {}
+
+    // Decoded as deserializeConcept does, without building a QJsonObject
+    ConceptPayload load(uint32_t index) const override {
+        const RecordSpan& span = spans[index];
+        JsonReader reader(std::string_view(data.get() + span.offset, span.length));
+        ConceptPayload payload;
+        reader.beginObject();
+        std::string_view key;
+        while (reader.nextMember(key)) {
+            if (key == "description" && reader.peek() == JsonReader::Type::String) {
+                payload.description = reader.readString();
+            } else if (key == "tags" && reader.peek() == JsonReader::Type::Array) {
+                reader.beginArray();
+                while (reader.nextElement()) {
+                    std::string tag; // Other values read as empty, as with QJsonValue::toString
+                    if (reader.peek() == JsonReader::Type::String) {
+                        tag = reader.readString();
+                    } else {
+                        reader.skipValue();
+                    }
+                    if (std::find(payload.tags.begin(), payload.tags.end(), tag) == payload.tags.end()) {
+                        payload.tags.push_back(std::move(tag));
+                    }
+                }
+            } else {
+                reader.skipValue();
+            }
+        }
+        return payload;
+    }
+
+private:
+    std::shared_ptr<const char> data;
+    std::vector<RecordSpan> spans;
+};
+
+// Files written before times were kept hold the save time, or nothing
+template <typename T>
+void readTimestamps(const QJsonObject& object, T& entity) {
+    Timestamp created = 0;
+    Timestamp modified = 0;
+    parseTimestamp(object["created"].toString().toStdString(), created);
+    parseTimestamp(object["modified"].toString().toStdString(), modified);
+    if (created != 0 || modified != 0) {
+        entity.setTimestamps(created ? created : modified, modified ? modified : created);
+    }
+}
+
+} // namespace
+
 ModelManager::ModelManager(QObject *parent)
-    : QObject(parent) {
+    : QObject(parent), journalSyncTimer(new QTimer(this)) {
     // Initialize default save directory
     QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     defaultSaveDirectory = QDir(appDataPath).absoluteFilePath("models");
     
     // Ensure directory exists
     QDir().mkpath(defaultSaveDirectory);
+    
+    savePool.setMaxThreadCount(1);
+
+    journalSyncTimer->setSingleShot(true);
+    journalSyncTimer->setInterval(JOURNAL_SYNC_DELAY_MS);
+    connect(journalSyncTimer, &QTimer::timeout, this, &ModelManager::syncJournal);
 }
 
-ModelManager::~ModelManager() = default;
+// Buffered journal records are synced first; savePool then waits for a
+// running save, so quitting never cuts one short
+ModelManager::~ModelManager() {
+    stopJournal();
+}
 
-bool ModelManager::saveModel(const MentalModel& model, const QString& filePath) {
+bool ModelManager::saveModel(MentalModel& model, const QString& filePath) {
     try {
-        // Ensure file has .json extension
-        QString actualFilePath = filePath;
-        if (!actualFilePath.endsWith(".json", Qt::CaseInsensitive)) {
-            actualFilePath += ".json";
-        }
-        
-        QJsonObject jsonModel = serializeModel(model);
-        QJsonDocument doc(jsonModel);
-        QByteArray data = doc.toJson(QJsonDocument::Indented); // Use indented format for readability
-        
-        QFile file(actualFilePath);
-        if (!file.open(QIODevice::WriteOnly)) {
-            emit errorOccurred(QString("Failed to open file for writing: %1").arg(actualFilePath));
-            return false;
-        }
-        
-        qint64 bytesWritten = file.write(data);
-        if (bytesWritten == -1) {
-            emit errorOccurred(QString("Failed to write data to file: %1").arg(actualFilePath));
-            return false;
+        QString actualFilePath = resolveSavePath(filePath);
+        uint64_t contentHash = writeModelFile(model, actualFilePath);
+        baseHashes[actualFilePath] = contentHash;
+        markSaved(model, actualFilePath);
+        if (isJournaling(model, actualFilePath)) {
+            // Everything journaled so far is in the new base
+            try {
+                journal->reset(contentHash, false);
+            } catch (const std::exception& e) {
+                stopJournal();
+                qWarning() << "Cannot restart model journal:" << e.what();
+            }
+        } else {
+            QFile::remove(QString::fromStdString(ModelJournal::pathFor(actualFilePath.toStdString())));
         }
-        
-        file.close();
         addToRecentFiles(actualFilePath); // Automatically add to recent files
         emit modelSaved(actualFilePath);
         return true;
@@ -57,51 +158,172 @@ bool ModelManager::saveModel(const MentalModel& model, const QString& filePath)
     }
 }
 
-std::unique_ptr<MentalModel> ModelManager::loadModel(const QString& filePath) {
-    try {
-        // Validate file extension
-        if (!filePath.endsWith(".json", Qt::CaseInsensitive)) {
-            emit errorOccurred(QString("Only JSON files (.json) are supported for loading: %1").arg(filePath));
-            return nullptr;
+SaveJob* ModelManager::saveModelInBackground(MentalModel& model, const QString& filePath) {
+    // The copy is the only model the worker sees; changes from here on are relative to it
+    std::shared_ptr<const MentalModel> snapshot = model.clone();
+    model.markClean();
+    if (cleanModel == &model) {
+        cleanModel = nullptr;
+    }
+    QString actualFilePath = resolveSavePath(filePath);
+    auto* job = new SaveJob(std::move(snapshot), actualFilePath, this);
+
+    // Changes made from here on are not in the snapshot. The new journal
+    // buffers them until the file it belongs to exists.
+    attachJournal(model, actualFilePath,
+                  std::make_shared<ModelJournal>(ModelJournal::pathFor(actualFilePath.toStdString())));
+    std::weak_ptr<ModelJournal> pendingJournal = journal;
+    QPointer<MentalModel> savedModel(&model);
+
+    connect(job, &SaveJob::finished, this, [this, job, pendingJournal](const QString& savedPath) {
+        --activeSaves;
+        baseHashes[savedPath] = job->getContentHash();
+        auto current = pendingJournal.lock();
+        if (current && current == journal) {
+            cleanModel = journalModel;
+            cleanPath = savedPath;
+            try {
+                current->reset(job->getContentHash(), true);
+            } catch (const std::exception& e) {
+                stopJournal();
+                emit errorOccurred(QString("Error writing model journal: %1").arg(e.what()));
+            }
         }
-        
-        QFile file(filePath);
-        if (!file.open(QIODevice::ReadOnly)) {
-            emit errorOccurred(QString("Failed to open file for reading: %1").arg(filePath));
-            return nullptr;
+        addToRecentFiles(savedPath);
+        emit modelSaved(savedPath);
+        job->deleteLater();
+    });
+    connect(job, &SaveJob::failed, this, [this, job, pendingJournal, savedModel](const QString& error) {
+        --activeSaves;
+        if (pendingJournal.lock() == journal) {
+            stopJournal();
         }
-        
-        QByteArray data = file.readAll();
-        file.close();
-        
-        QJsonParseError parseError;
-        QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
-        if (parseError.error != QJsonParseError::NoError) {
-            emit errorOccurred(QString("JSON parse error: %1").arg(parseError.errorString()));
-            return nullptr;
+        // The snapshot never reached the disk, so what it took as saved is not
+        if (savedModel) {
+            savedModel->markUnsaved();
+            if (cleanModel == savedModel) {
+                cleanModel = nullptr;
+            }
+        }
+        emit errorOccurred(QString("Error saving model: %1").arg(error));
+        job->deleteLater();
+    });
+
+    ++activeSaves;
+    job->start(&savePool);
+    return job;
+}
+
+QString ModelManager::resolveSavePath(const QString& filePath) {
+    // A model opened from a binary file is saved back in the same format
+    if (isBinaryPath(filePath) || isOverlayPath(filePath) || filePath.endsWith(".json", Qt::CaseInsensitive)) {
+        return filePath;
+    }
+    return filePath + ".json";
+}
+
+uint64_t ModelManager::writeModelFile(const MentalModel& model, const QString& filePath,
+                                      const ProgressCallback& progress, const CommitHook& beforeCommit) {
+    // QSaveFile writes a temporary file and renames it over the target on commit
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        throw FileIOException("Failed to open file for writing: " + filePath.toStdString());
+    }
+
+    uint64_t contentHash = FNV1A_SEED;
+    if (isOverlayPath(filePath)) {
+        // Only what the model changed; the base is named relative to the overlay where possible
+        auto base = ModelOverlay::baseOf(model);
+        if (!base) {
+            throw FileIOException("Only a model loaded on a base can be saved as an overlay: " +
+                                  filePath.toStdString());
+        }
+        QString basePath = QFileInfo(filePath).absoluteDir().relativeFilePath(
+            QString::fromStdString(base->getFilePath()));
+        std::string encoded = ModelOverlay::encode(model, *base, basePath.toStdString());
+        contentHash = fnv1a(encoded.data(), encoded.size());
+        if (file.write(encoded.data(), static_cast<qint64>(encoded.size())) != static_cast<qint64>(encoded.size())) {
+            throw FileIOException("Failed to write data to file: " + filePath.toStdString());
+        }
+        if (progress) {
+            size_t total = model.getConceptCount() + model.getRelationshipCount();
+            progress(total, total);
+        }
+    } else if (isBinaryPath(filePath)) {
+        std::string encoded = BinaryModelWriter::encode(model);
+        contentHash = BinaryModelView::contentHash(encoded.data(), encoded.size());
+        if (file.write(encoded.data(), static_cast<qint64>(encoded.size())) != static_cast<qint64>(encoded.size())) {
+            throw FileIOException("Failed to write data to file: " + filePath.toStdString());
         }
-        
-        if (!doc.isObject()) {
-            emit errorOccurred("Invalid JSON format: root element is not an object");
-            return nullptr;
+        if (progress) {
+            size_t total = model.getConceptCount() + model.getRelationshipCount();
+            progress(total, total);
         }
-        
-        QJsonObject rootObject = doc.object();
-        
-        // Check if there's a "model" wrapper object
-        QJsonObject modelObject;
-        if (rootObject.contains("model") && rootObject["model"].isObject()) {
-            modelObject = rootObject["model"].toObject();
+    } else {
+        // Written record by record; the model is never held as a JSON document
+        writeModel(model, file, false, progress, &contentHash);
+    }
+
+    if (!syncFile(file)) {
+        throw FileIOException("Failed to write data to file: " + filePath.toStdString());
+    }
+    if (beforeCommit) {
+        beforeCommit(contentHash);
+    }
+    if (!file.commit()) {
+        throw FileIOException("Failed to write data to file: " + filePath.toStdString());
+    }
+    syncParentDirectory(filePath);
+    if (isBinaryPath(filePath)) {
+        // Left by a patch of the file just replaced
+        QFile::remove(QString::fromStdString(BinaryModelPatcher::redoPathFor(filePath.toStdString())));
+    }
+    return contentHash;
+}
+
+std::unique_ptr<MentalModel> ModelManager::loadModel(const QString& filePath) {
+    recoveredChanges = 0;
+    try {
+        std::unique_ptr<MentalModel> model;
+        uint64_t contentHash = FNV1A_SEED;
+        if (isBinaryPath(filePath)) {
+            // Mapped, checked, then materialized; the mapping is released on return
+            // unless the model reads its payloads from it
+            BinaryModelPatcher::recover(filePath.toStdString());
+            std::shared_ptr<const BinaryModelView> view = BinaryModelView::open(filePath.toStdString());
+            model = lazyLoading ? BinaryModelView::toLazyModel(view, payloadCacheCapacity) : view->toModel();
+            contentHash = BinaryModelView::contentHash(view->getData(), view->getSize());
+        } else if (isOverlayPath(filePath)) {
+            model = loadOverlay(filePath, contentHash);
         } else {
-            // Assume the root object is the model itself
-            modelObject = rootObject;
+            model = loadJsonModel(filePath, contentHash);
+            if (!model) {
+                return nullptr;
+            }
         }
-        
-        auto model = deserializeModel(modelObject);
-        if (model) {
-            addToRecentFiles(filePath); // Automatically add to recent files
-            emit modelLoaded(filePath);
+        baseHashes[filePath] = contentHash;
+        markSaved(*model, filePath);
+
+        // The file is the base; changes saved or left behind since are in its journal
+        std::string journalFile = ModelJournal::pathFor(filePath.toStdString());
+        if (QFile::exists(QString::fromStdString(journalFile))) {
+            auto replayed = ModelJournal::replay(journalFile, contentHash, *model);
+            recoveredChanges = replayed.recovered;
         }
+
+        addToRecentFiles(filePath); // Automatically add to recent files
+        emit modelLoaded(filePath);
+        return model;
+    } catch (const std::exception& e) {
+        emit errorOccurred(QString("Error loading model: %1").arg(e.what()));
+        return nullptr;
+    }
+}
+
+std::unique_ptr<MentalModel> ModelManager::loadLayered(const QString& basePath) {
+    try {
+        auto model = BinaryModelView::toLazyModel(openBase(basePath), payloadCacheCapacity);
+        emit modelLoaded(basePath);
         return model;
     } catch (const std::exception& e) {
         emit errorOccurred(QString("Error loading model: %1").arg(e.what()));
@@ -109,20 +331,213 @@ std::unique_ptr<MentalModel> ModelManager::loadModel(const QString& filePath) {
     }
 }
 
+std::shared_ptr<const BinaryModelView> ModelManager::openBase(const QString& basePath, uint64_t expectedHash) {
+    QString key = QFileInfo(basePath).absoluteFilePath();
+    std::shared_ptr<const BinaryModelView> view = baseViews.value(key).lock();
+    if (!view || (expectedHash != 0 &&
+                  BinaryModelView::contentHash(view->getData(), view->getSize()) != expectedHash)) {
+        // Not open, or replaced on disk since
+        view = BinaryModelView::open(key.toStdString());
+        baseViews.insert(key, view);
+    }
+    return view;
+}
+
+std::unique_ptr<MentalModel> ModelManager::loadOverlay(const QString& filePath, uint64_t& contentHash) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw FileIOException("Failed to open file for reading: " + filePath.toStdString());
+    }
+    QByteArray bytes = file.readAll();
+    std::string_view json(bytes.constData(), static_cast<size_t>(bytes.size()));
+    contentHash = fnv1a(json.data(), json.size());
+
+    ModelOverlay::BaseReference reference = ModelOverlay::readBase(json);
+    QString basePath = QFileInfo(filePath).absoluteDir().absoluteFilePath(QString::fromStdString(reference.path));
+    auto base = openBase(basePath, reference.contentHash);
+    if (BinaryModelView::contentHash(base->getData(), base->getSize()) != reference.contentHash) {
+        throw FileIOException("The base of this overlay has changed since it was saved: " + basePath.toStdString());
+    }
+    auto model = BinaryModelView::toLazyModel(base, payloadCacheCapacity);
+    ModelOverlay::apply(json, *model);
+    return model;
+}
+
+std::unique_ptr<MentalModel> ModelManager::loadJsonModel(const QString& filePath, uint64_t& contentHash) {
+
+    // Validate file extension
+    if (!filePath.endsWith(".json", Qt::CaseInsensitive)) {
+        emit errorOccurred(QString("Only JSON (.json) and binary (.qlinkb) model files are supported for loading: %1").arg(filePath));
+        return nullptr;
+    }
+    
+    auto file = std::make_shared<QFile>(filePath);
+    if (!file->open(QIODevice::ReadOnly)) {
+        emit errorOccurred(QString("Failed to open file for reading: %1").arg(filePath));
+        return nullptr;
+    }
+    
+    if (file->size() >= PARALLEL_LOAD_MIN_BYTES) {
+        // Large files are mapped and decoded in parallel; the mapping goes with the
+        // file, which a lazily loaded model keeps
+        if (uchar* mapped = file->map(0, file->size())) {
+            const char* data = reinterpret_cast<const char*>(mapped);
+            std::shared_ptr<const char> retainedData;
+            if (lazyLoading) {
+                retainedData = std::shared_ptr<const char>(file, data);
+            }
+            return parseModel(data, static_cast<size_t>(file->size()), nullptr, &contentHash,
+                              std::move(retainedData), payloadCacheCapacity);
+        }
+    }
+    
+    // Streamed in chunks; only one record at a time is parsed into a QJsonObject
+    auto model = readModel(*file, &contentHash);
+    file->close();
+    return model;
+}
+
+void ModelManager::setLazyLoading(bool enabled, size_t cacheCapacity) {
+    lazyLoading = enabled;
+    payloadCacheCapacity = cacheCapacity;
+}
+
 bool ModelManager::exportModel(const MentalModel& model, const QString& filePath, ExportFormat format) {
     try {
-        // Only JSON export is supported
-        if (format != ExportFormat::JSON) {
-            emit errorOccurred("Only JSON export format is supported");
-            return false;
+        switch (format) {
+            case ExportFormat::JSON:
+                return exportToJSON(model, filePath);
+            case ExportFormat::BINARY:
+                return exportToBinary(model, filePath);
+            case ExportFormat::EDGE_LIST_CSV:
+            case ExportFormat::EDGE_LIST_TSV:
+            case ExportFormat::NODE_CSV:
+            case ExportFormat::GRAPHML:
+                return exportToInterchange(model, filePath, format);
         }
-        return exportToJSON(model, filePath);
+        emit errorOccurred("Unsupported export format");
+        return false;
     } catch (const std::exception& e) {
         emit errorOccurred(QString("Error exporting model: %1").arg(e.what()));
         return false;
     }
 }
 
+std::unique_ptr<MentalModel> ModelManager::importModel(const QString& filePath, ImportFormat format) {
+    auto model = std::make_unique<MentalModel>(QFileInfo(filePath).completeBaseName().toStdString());
+    if (!importInto(*model, filePath, format)) {
+        return nullptr;
+    }
+    return model;
+}
+
+bool ModelManager::importInto(MentalModel& model, const QString& filePath, ImportFormat format) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        emit errorOccurred(QString("Failed to open file for import: %1").arg(filePath));
+        return false;
+    }
+
+    // Files are parsed completely before the model is touched, so a bad one leaves it as it was
+    try {
+        if (format == ImportFormat::GRAPHML) {
+            lastImport = GraphImporter::importGraphML(model, file);
+        } else {
+            // Delimited files are parsed in place from a mapping where possible
+            QByteArray contents;
+            const char* data = nullptr;
+            size_t size = static_cast<size_t>(file.size());
+            if (size > 0) {
+                if (uchar* mapped = file.map(0, file.size())) {
+                    data = reinterpret_cast<const char*>(mapped);
+                } else {
+                    contents = file.readAll();
+                    data = contents.constData();
+                    size = static_cast<size_t>(contents.size());
+                }
+            }
+            char delimiter = format == ImportFormat::EDGE_LIST_TSV ? '\t' : ',';
+            lastImport = format == ImportFormat::NODE_CSV
+                ? GraphImporter::importNodes(model, data, size, delimiter)
+                : GraphImporter::importEdgeList(model, data, size, delimiter);
+        }
+    } catch (const std::exception& e) {
+        emit errorOccurred(QString("Error importing model: %1").arg(e.what()));
+        return false;
+    }
+
+    emit modelImported(filePath, format);
+    return true;
+}
+
+bool ModelManager::startJournal(MentalModel& model, const QString& filePath) {
+    auto hash = baseHashes.find(filePath);
+    if (hash == baseHashes.end()) {
+        return false;
+    }
+    auto newJournal = std::make_shared<ModelJournal>(ModelJournal::pathFor(filePath.toStdString()));
+    try {
+        newJournal->open(hash.value());
+    } catch (const std::exception& e) {
+        emit errorOccurred(QString("Error opening model journal: %1").arg(e.what()));
+        return false;
+    }
+    attachJournal(model, filePath, std::move(newJournal));
+    return true;
+}
+
+void ModelManager::stopJournal() {
+    if (!journal) return;
+    disconnect(journalChanges);
+    disconnect(journalModelDestroyed);
+    journalSyncTimer->stop();
+    syncJournal();
+    journal.reset();
+    journalModel = nullptr;
+    journalPath.clear();
+}
+
+bool ModelManager::isJournaling(const MentalModel& model, const QString& filePath) const {
+    return journal && journal->hasBase() && journalModel == &model && journalPath == filePath;
+}
+
+bool ModelManager::saveIncrementally(MentalModel& model, const QString& filePath) {
+    QString actualFilePath = resolveSavePath(filePath);
+    if (!isJournaling(model, actualFilePath)) {
+        return false;
+    }
+    bool patched;
+    try {
+        journal->recordSavePoint();
+        journal->sync();
+        journalSyncTimer->stop();
+        patched = patchBase(model, actualFilePath);
+    } catch (const std::exception& e) {
+        // The caller falls back to a full save, which starts a new journal
+        qWarning() << "Model journal failed, saving the whole model:" << e.what();
+        stopJournal();
+        return false;
+    }
+    if (!patched) {
+        compactJournal();
+    }
+    addToRecentFiles(actualFilePath);
+    emit modelSaved(actualFilePath);
+    return true;
+}
+
+void ModelManager::discardUnsaved() {
+    if (!journal) return;
+    journal->recordRollback();
+    journalSyncTimer->stop();
+    syncJournal();
+}
+
+void ModelManager::setJournalCompaction(double ratio, qint64 minBytes) {
+    compactionRatio = ratio;
+    compactionMinBytes = minBytes;
+}
+
 QStringList ModelManager::getRecentFiles() const {
     return recentFiles;
 }
@@ -146,26 +561,52 @@ void ModelManager::setDefaultSaveDirectory(const QString& directory) {
     QDir().mkpath(directory); // Ensure it exists
 }
 
-QJsonObject ModelManager::serializeModel(const MentalModel& model) {
-    QJsonObject jsonModel;
+void ModelManager::writeModel(const MentalModel& model, QIODevice& device, bool exportMetadata,
+                              const ProgressCallback& progress, uint64_t* contentHash) {
+    JsonRecordWriter writer([&device, contentHash](const char* data, size_t size) {
+        if (contentHash) {
+            *contentHash = fnv1a(data, size, *contentHash);
+        }
+        return device.write(data, static_cast<qint64>(size)) == static_cast<qint64>(size);
+    });
+    auto encode = [](const QJsonObject& object) {
+        return QJsonDocument(object).toJson(QJsonDocument::Compact).toStdString();
+    };
+
+    writer.beginObject();
     // Basic model information
-    jsonModel["name"] = QString::fromStdString(model.getModelName());
-    jsonModel["version"] = "1.0";
-    jsonModel["created"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    writer.writeString("name", model.getModelName());
+    writer.writeString("version", "1.0");
+    // No save time: saving an unchanged model writes the same bytes
+    if (exportMetadata) {
+        writer.writeString("exportFormat", "JSON");
+        writer.writeString("exportedAt", QDateTime::currentDateTime().toString(Qt::ISODate).toStdString());
+    }
     
+    size_t written = 0;
+    size_t total = model.getConceptCount() + model.getRelationshipCount();
+    auto report = [&]() {
+        // Every 256 records keeps the callback off the hot path
+        if (progress && (++written % 256 == 0 || written == total)) {
+            progress(written, total);
+        }
+    };
+
     // Serialize concepts
-    QJsonArray conceptsArray;
+    writer.beginArray("concepts");
     for (const auto& concept : model.getConcepts()) {
-        conceptsArray.append(serializeConcept(*concept));
+        writer.writeRecord(encode(serializeConcept(*concept)));
+        report();
     }
-    jsonModel["concepts"] = conceptsArray;
+    writer.endArray();
     
     // Serialize relationships
-    QJsonArray relationshipsArray;
+    writer.beginArray("relationships");
     for (const auto& relationship : model.getRelationships()) {
-        relationshipsArray.append(serializeRelationship(*relationship));
+        writer.writeRecord(encode(serializeRelationship(*relationship)));
+        report();
     }
-    jsonModel["relationships"] = relationshipsArray;
+    writer.endArray();
     
     // Add statistics for verification
     auto stats = model.getStatistics();
@@ -176,44 +617,186 @@ QJsonObject ModelManager::serializeModel(const MentalModel& model) {
     statsObject["averageConnections"] = stats.averageConnections;
     statsObject["maxConnections"] = static_cast<int>(stats.maxConnections);
     statsObject["minConnections"] = static_cast<int>(stats.minConnections);
-    jsonModel["statistics"] = statsObject;
+    writer.writeRaw("statistics", encode(statsObject));
     
-    return jsonModel;
+    writer.endObject();
+    writer.finish();
 }
 
-std::unique_ptr<MentalModel> ModelManager::deserializeModel(const QJsonObject& jsonModel) {
-    // Extract model name
-    QString modelName = jsonModel["name"].toString("Untitled Model");
-    auto model = std::make_unique<MentalModel>(modelName.toStdString());
+std::unique_ptr<MentalModel> ModelManager::readModel(QIODevice& device, uint64_t* contentHash) {
+    std::unique_ptr<MentalModel> model;
+    // Relationships listed before their concepts are held until the end
+    std::vector<std::unique_ptr<Relationship>> pending;
+
+    auto parseRecord = [](const std::string& json) {
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(
+            QByteArray::fromRawData(json.data(), static_cast<int>(json.size())), &parseError);
+        if (parseError.error != QJsonParseError::NoError) {
+            throw FileIOException("JSON parse error: " + parseError.errorString().toStdString());
+        }
+        return doc.object();
+    };
+    auto hasEndpoints = [&model](const Relationship& relationship) {
+        return model->getConcept(relationship.getSourceConceptId()) &&
+               model->getConcept(relationship.getTargetConceptId());
+    };
+
+    JsonRecordReader::Handler handler;
+    handler.onModelBegin = [&]() {
+        // A "model" wrapper replaces whatever the root held
+        model = std::make_unique<MentalModel>("Untitled Model");
+        pending.clear();
+    };
+    handler.onModelName = [&](const std::string& name) {
+        model->setModelName(name);
+    };
+    handler.onConcept = [&](const std::string& json) {
+        auto concept = deserializeConcept(parseRecord(json));
+        if (concept) {
+            model->addConcept(std::move(concept));
+        }
+    };
+    handler.onRelationship = [&](const std::string& json) {
+        auto relationship = deserializeRelationship(parseRecord(json));
+        if (!relationship) return;
+        if (hasEndpoints(*relationship)) {
+            model->addRelationship(std::move(relationship));
+        } else {
+            pending.push_back(std::move(relationship));
+        }
+    };
+
+    JsonRecordReader reader([&device, contentHash](char* buffer, size_t capacity) {
+        qint64 count = device.read(buffer, static_cast<qint64>(capacity));
+        if (contentHash && count > 0) {
+            *contentHash = fnv1a(buffer, static_cast<size_t>(count), *contentHash);
+        }
+        return static_cast<int64_t>(count);
+    });
+    reader.parse(handler);
+
+    for (auto& relationship : pending) {
+        // Verify that the concepts exist
+        if (hasEndpoints(*relationship)) {
+            model->addRelationship(std::move(relationship));
+        } else {
+            qWarning() << "Skipping relationship with invalid concept IDs";
+        }
+    }
     
-    // Deserialize concepts first
-    QJsonArray conceptsArray = jsonModel["concepts"].toArray();
-    for (const auto& conceptValue : conceptsArray) {
-        if (conceptValue.isObject()) {
-            auto concept = deserializeConcept(conceptValue.toObject());
-            if (concept) {
-                model->addConcept(std::move(concept));
+    return model;
+}
+
+std::unique_ptr<MentalModel> ModelManager::parseModel(const char* data, size_t size, QThreadPool* pool,
+                                                      uint64_t* contentHash, std::shared_ptr<const char> retainedData,
+                                                      size_t cacheCapacity) {
+    // Locate the records without decoding them
+    std::string modelName;
+    std::vector<RecordSpan> conceptSpans;
+    std::vector<RecordSpan> relationshipSpans;
+
+    JsonRecordReader::Handler handler;
+    handler.onModelBegin = [&]() {
+        // A "model" wrapper replaces whatever the root held
+        modelName = "Untitled Model";
+        conceptSpans.clear();
+        relationshipSpans.clear();
+    };
+    handler.onModelName = [&](const std::string& name) {
+        modelName = name;
+    };
+    handler.onConceptSpan = [&](uint64_t offset, size_t length) {
+        conceptSpans.push_back({offset, length});
+    };
+    handler.onRelationshipSpan = [&](uint64_t offset, size_t length) {
+        relationshipSpans.push_back({offset, length});
+    };
+
+    size_t readOffset = 0;
+    JsonRecordReader reader([&](char* buffer, size_t capacity) {
+        size_t count = std::min(capacity, size - readOffset);
+        std::memcpy(buffer, data + readOffset, count);
+        readOffset += count;
+        return static_cast<int64_t>(count);
+    });
+    reader.parse(handler);
+
+    std::vector<ParseChunk> chunks;
+    auto split = [&chunks](const std::vector<RecordSpan>& spans, bool relationships) {
+        size_t first = 0;
+        size_t bytes = 0;
+        for (size_t i = 0; i < spans.size(); ++i) {
+            bytes += spans[i].length;
+            if (bytes >= PARSE_CHUNK_BYTES || i + 1 == spans.size()) {
+                chunks.push_back({relationships, first, i + 1});
+                first = i + 1;
+                bytes = 0;
             }
         }
+    };
+    split(conceptSpans, false);
+    split(relationshipSpans, true);
+
+    // Concepts stay lazy behind their spans; setting up a concept touches nothing the tasks share
+    auto model = std::make_unique<MentalModel>(modelName);
+    ConceptPayloadCache* payloadCache = nullptr;
+    if (retainedData) {
+        payloadCache = model->setPayloadSource(std::make_shared<JsonPayloadSource>(retainedData, conceptSpans),
+                                               cacheCapacity);
     }
-    
-    // Then deserialize relationships
-    QJsonArray relationshipsArray = jsonModel["relationships"].toArray();
-    for (const auto& relationshipValue : relationshipsArray) {
-        if (relationshipValue.isObject()) {
-            auto relationship = deserializeRelationship(relationshipValue.toObject());
-            if (relationship) {
-                // Verify that the concepts exist
-                if (model->getConcept(relationship->getSourceConceptId()) &&
-                    model->getConcept(relationship->getTargetConceptId())) {
-                    model->addRelationship(std::move(relationship));
-                } else {
-                    qWarning() << "Skipping relationship with invalid concept IDs";
+
+    // Each chunk decodes into its own buffer, so tasks share nothing but the input.
+    // The hash, if wanted, is one more task.
+    std::vector<std::vector<std::unique_ptr<Concept>>> conceptChunks(chunks.size());
+    std::vector<std::vector<std::unique_ptr<Relationship>>> relationshipChunks(chunks.size());
+    size_t taskCount = chunks.size() + (contentHash ? 1 : 0);
+
+    runParallel(taskCount, [&](size_t index) {
+        if (index == chunks.size()) {
+            *contentHash = fnv1a(data, size);
+            return;
+        }
+        const ParseChunk& chunk = chunks[index];
+        if (chunk.relationships) {
+            auto& decoded = relationshipChunks[index];
+            decoded.reserve(chunk.last - chunk.first);
+            for (size_t i = chunk.first; i < chunk.last; ++i) {
+                auto relationship = deserializeRelationship(parseRecordAt(data, relationshipSpans[i]));
+                if (relationship) decoded.push_back(std::move(relationship));
+            }
+        } else {
+            auto& decoded = conceptChunks[index];
+            decoded.reserve(chunk.last - chunk.first);
+            for (size_t i = chunk.first; i < chunk.last; ++i) {
+                auto concept = deserializeConcept(parseRecordAt(data, conceptSpans[i]));
+                if (!concept) continue;
+                if (payloadCache) {
+                    concept->setLazyPayload(payloadCache, static_cast<uint32_t>(i));
                 }
+                decoded.push_back(std::move(concept));
             }
         }
+    }, pool ? pool : QThreadPool::globalInstance());
+
+    // Concepts go in first so every relationship resolves its endpoints through the index
+    std::vector<std::unique_ptr<Concept>> concepts;
+    concepts.reserve(conceptSpans.size());
+    for (auto& decoded : conceptChunks) {
+        std::move(decoded.begin(), decoded.end(), std::back_inserter(concepts));
+    }
+    model->addConceptsBulk(std::move(concepts));
+
+    std::vector<std::unique_ptr<Relationship>> relationships;
+    relationships.reserve(relationshipSpans.size());
+    for (auto& decoded : relationshipChunks) {
+        std::move(decoded.begin(), decoded.end(), std::back_inserter(relationships));
+    }
+    size_t decodedRelationships = relationships.size();
+    size_t added = model->addRelationshipsBulk(std::move(relationships));
+    if (added < decodedRelationships) {
+        qWarning() << "Skipping" << (decodedRelationships - added) << "relationships with invalid concept IDs";
     }
-    
     return model;
 }
 
@@ -238,8 +821,8 @@ QJsonObject ModelManager::serializeConcept(const Concept& concept) {
     jsonConcept["position"] = positionObject;
     
     // Add timestamps
-    jsonConcept["created"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-    jsonConcept["modified"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    jsonConcept["created"] = QString::fromStdString(formatTimestamp(concept.getCreated()));
+    jsonConcept["modified"] = QString::fromStdString(formatTimestamp(concept.getModified()));
     
     return jsonConcept;
 }
@@ -268,6 +851,7 @@ std::unique_ptr<Concept> ModelManager::deserializeConcept(const QJsonObject& jso
     position.x = positionObject["x"].toDouble();
     position.y = positionObject["y"].toDouble();
     concept->setPosition(position);
+    readTimestamps(jsonConcept, *concept);
     
     return concept;
 }
@@ -282,8 +866,8 @@ QJsonObject ModelManager::serializeRelationship(const Relationship& relationship
     jsonRelationship["weight"] = relationship.getWeight();
     
     // Add timestamps
-    jsonRelationship["created"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-    jsonRelationship["modified"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    jsonRelationship["created"] = QString::fromStdString(formatTimestamp(relationship.getCreated()));
+    jsonRelationship["modified"] = QString::fromStdString(formatTimestamp(relationship.getModified()));
     
     return jsonRelationship;
 }
@@ -300,13 +884,28 @@ std::unique_ptr<Relationship> ModelManager::deserializeRelationship(const QJsonO
         return nullptr;
     }
     
-    auto relationship = std::make_unique<Relationship>(
-        sourceId.toStdString(),
-        targetId.toStdString(),
-        type.toStdString(),
-        directed,
-        weight
-    );
+    // Keep the saved id so references to the relationship survive a reload
+    QString id = jsonRelationship["id"].toString();
+    std::unique_ptr<Relationship> relationship;
+    if (!id.isEmpty()) {
+        relationship = std::make_unique<Relationship>(
+            id.toStdString(),
+            sourceId.toStdString(),
+            targetId.toStdString(),
+            type.toStdString(),
+            directed,
+            weight
+        );
+    } else {
+        relationship = std::make_unique<Relationship>(
+            sourceId.toStdString(),
+            targetId.toStdString(),
+            type.toStdString(),
+            directed,
+            weight
+        );
+    }
+    readTimestamps(jsonRelationship, *relationship);
     
     return relationship;
 }
@@ -318,25 +917,209 @@ bool ModelManager::exportToJSON(const MentalModel& model, const QString& filePat
         actualFilePath += ".json";
     }
     
-    QJsonObject jsonModel = serializeModel(model);
-    // Add export metadata
-    jsonModel["exportFormat"] = "JSON";
-    jsonModel["exportedAt"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-    
-    QJsonDocument doc(jsonModel);
-    QByteArray data = doc.toJson(QJsonDocument::Indented);
-    
     QFile file(actualFilePath);
     if (!file.open(QIODevice::WriteOnly)) {
         emit errorOccurred(QString("Failed to open file for JSON export: %1").arg(actualFilePath));
         return false;
     }
     
-    file.write(data);
+    // Add export metadata
+    writeModel(model, file, true);
     file.close();
     
     emit modelExported(actualFilePath, ExportFormat::JSON);
     return true;
 }
 
-} // namespace qlink
\ No newline at end of file
+bool ModelManager::exportToBinary(const MentalModel& model, const QString& filePath) {
+    // Ensure file has .qlinkb extension
+    QString actualFilePath = filePath;
+    if (!isBinaryPath(actualFilePath)) {
+        actualFilePath += binary_format::FILE_EXTENSION;
+    }
+
+    BinaryModelWriter::write(model, actualFilePath.toStdString());
+
+    emit modelExported(actualFilePath, ExportFormat::BINARY);
+    return true;
+}
+
+bool ModelManager::exportToInterchange(const MentalModel& model, const QString& filePath, ExportFormat format) {
+    QString extension = format == ExportFormat::GRAPHML ? ".graphml"
+                      : format == ExportFormat::EDGE_LIST_TSV ? ".tsv" : ".csv";
+    QString actualFilePath = filePath;
+    if (!actualFilePath.endsWith(extension, Qt::CaseInsensitive)) {
+        actualFilePath += extension;
+    }
+
+    QSaveFile file(actualFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        emit errorOccurred(QString("Failed to open file for export: %1").arg(actualFilePath));
+        return false;
+    }
+    GraphExporter::WriteFunction write = [&file](const char* data, size_t size) {
+        return file.write(data, static_cast<qint64>(size)) == static_cast<qint64>(size);
+    };
+    switch (format) {
+        case ExportFormat::EDGE_LIST_TSV:
+            GraphExporter::writeEdgeList(model, write, '\t');
+            break;
+        case ExportFormat::NODE_CSV:
+            GraphExporter::writeNodes(model, write, ',');
+            break;
+        case ExportFormat::GRAPHML:
+            GraphExporter::writeGraphML(model, write);
+            break;
+        default:
+            GraphExporter::writeEdgeList(model, write, ',');
+    }
+    if (!file.commit()) {
+        emit errorOccurred(QString("Failed to write export: %1").arg(actualFilePath));
+        return false;
+    }
+
+    emit modelExported(actualFilePath, format);
+    return true;
+}
+
+bool ModelManager::isBinaryPath(const QString& filePath) {
+    return filePath.endsWith(binary_format::FILE_EXTENSION, Qt::CaseInsensitive);
+}
+
+bool ModelManager::isOverlayPath(const QString& filePath) {
+    return filePath.endsWith(ModelOverlay::FILE_EXTENSION, Qt::CaseInsensitive);
+}
+
+void ModelManager::attachJournal(MentalModel& model, const QString& filePath,
+                                 std::shared_ptr<ModelJournal> newJournal) {
+    stopJournal();
+    journal = std::move(newJournal);
+    journalModel = &model;
+    journalPath = filePath;
+    journalChanges = connect(&model, &MentalModel::modelChanged, this, &ModelManager::recordChange);
+    journalModelDestroyed = connect(&model, &QObject::destroyed, this, [this]() {
+        if (cleanModel == journalModel) {
+            cleanModel = nullptr;
+        }
+        stopJournal();
+    });
+}
+
+void ModelManager::recordChange(const ModelChangeEvent& event) {
+    const std::string& id = event.entityId;
+    switch (event.type) {
+        case ChangeType::CONCEPT_ADDED:
+        case ChangeType::CONCEPT_MODIFIED:
+            if (const Concept* concept = journalModel->getConcept(id)) {
+                journal->recordConcept(*concept);
+            }
+            break;
+        case ChangeType::CONCEPT_REMOVED:
+            // Replay removes its relationships the same way
+            journal->recordConceptRemoved(id);
+            break;
+        case ChangeType::RELATIONSHIP_ADDED:
+        case ChangeType::RELATIONSHIP_MODIFIED:
+            if (const Relationship* relationship = journalModel->getRelationship(id)) {
+                journal->recordRelationship(*relationship);
+            }
+            break;
+        case ChangeType::RELATIONSHIP_REMOVED:
+            journal->recordRelationshipRemoved(id);
+            break;
+        case ChangeType::MODEL_CLEARED:
+            journal->recordCleared();
+            break;
+    }
+    if (!journalSyncTimer->isActive()) {
+        journalSyncTimer->start();
+    }
+}
+
+void ModelManager::syncJournal() {
+    if (!journal) return;
+    try {
+        journal->sync();
+    } catch (const std::exception& e) {
+        emit errorOccurred(QString("Error writing model journal: %1").arg(e.what()));
+    }
+}
+
+// Write the changes made since a binary base was written into it and start
+// the journal over; false if the changes need a full rewrite instead
+bool ModelManager::patchBase(MentalModel& model, const QString& filePath) {
+    if (!isBinaryPath(filePath) || compacting || cleanModel != &model || cleanPath != filePath) {
+        return false;
+    }
+    ModelChanges changes = model.getChanges();
+    if (changes.isEmpty()) {
+        return false;
+    }
+    uint64_t contentHash;
+    if (!BinaryModelPatcher::patch(filePath.toStdString(), baseHashes.value(filePath), model, changes,
+                                   contentHash)) {
+        return false;
+    }
+    baseHashes[filePath] = contentHash;
+    model.markClean();
+    journal->reset(contentHash, false);
+    return true;
+}
+
+void ModelManager::markSaved(MentalModel& model, const QString& filePath) {
+    model.markClean();
+    cleanModel = &model;
+    cleanPath = filePath;
+}
+
+void ModelManager::compactJournal() {
+    if (compacting || !journal) return;
+
+    uint64_t journalSize = journal->getSize();
+    qint64 baseSize = QFileInfo(journalPath).size();
+    if (static_cast<qint64>(journalSize) < compactionMinBytes ||
+        static_cast<double>(journalSize) < compactionRatio * static_cast<double>(baseSize)) {
+        return;
+    }
+
+    // Called right after a save point, so the snapshot holds exactly the
+    // records before this offset
+    uint64_t snapshotOffset = journalSize;
+    std::shared_ptr<ModelJournal> compacted = journal;
+    auto* job = new SaveJob(journalModel->clone(), journalPath, this,
+        [compacted, snapshotOffset](uint64_t contentHash) {
+            compacted->beginRebase(contentHash, snapshotOffset);
+        });
+    // Until the new base is in place, changes are relative to neither file
+    journalModel->markClean();
+    if (cleanModel == journalModel) {
+        cleanModel = nullptr;
+    }
+
+    connect(job, &SaveJob::finished, this, [this, job, compacted, snapshotOffset](const QString& savedPath) {
+        compacting = false;
+        baseHashes[savedPath] = job->getContentHash();
+        if (compacted == journal) {
+            cleanModel = journalModel;
+            cleanPath = savedPath;
+        }
+        try {
+            compacted->finishRebase(job->getContentHash(), snapshotOffset);
+        } catch (const std::exception& e) {
+            // Replay still finds the new base through the marker
+            emit errorOccurred(QString("Error compacting model journal: %1").arg(e.what()));
+        }
+        job->deleteLater();
+    });
+    connect(job, &SaveJob::failed, this, [this, job](const QString& error) {
+        // The old base and the journal are untouched
+        compacting = false;
+        emit errorOccurred(QString("Error compacting model journal: %1").arg(error));
+        job->deleteLater();
+    });
+
+    compacting = true;
+    job->start(&savePool);
+}
+
+} // namespace qlink
@@ -5,16 +5,43 @@
 #include <QStringList>
 #include <QJsonObject>
 #include <QDateTime>
+#include <QThreadPool>
+#include <QHash>
+#include <functional>
 #include <memory>
 #include "../model/MentalModel.h"
+#include "GraphInterchange.h"
+
+class QIODevice;
+class QTimer;
 
 namespace qlink {
 
+class SaveJob;
+class ModelJournal;
+class BinaryModelView;
+
 /**
- * Export format, JSON only currently may add more in future or next deliverable
+ * Export format: indented JSON, the memory-mappable binary format (.qlinkb),
+ * or one of the interchange formats GraphExporter writes
  */
 enum class ExportFormat {
-    JSON
+    JSON,
+    BINARY,
+    EDGE_LIST_CSV,
+    EDGE_LIST_TSV,
+    NODE_CSV,
+    GRAPHML
+};
+
+/**
+ * Interchange formats GraphImporter reads
+ */
+enum class ImportFormat {
+    EDGE_LIST_CSV,
+    EDGE_LIST_TSV,
+    NODE_CSV,
+    GRAPHML
 };
 
 /**
@@ -27,39 +54,221 @@ public:
     explicit ModelManager(QObject *parent = nullptr);
     ~ModelManager();
 
-    // Core persistence operations
-    bool saveModel(const MentalModel& model, const QString& filePath);
+    // Core persistence operations; saving marks the model clean (see MentalModel::markClean)
+    bool saveModel(MentalModel& model, const QString& filePath);
+
+    /**
+     * Save a snapshot of the model on a worker thread. The model may be
+     * edited as soon as this returns; the job reports progress and
+     * modelSaved() is emitted once the file is on disk. Saves run one at a
+     * time, in the order they were requested.
+     *
+     * From then on the model's changes are journaled next to the new file,
+     * including those made while the snapshot is being written.
+     * @return the job, owned by the manager and deleted after it finishes
+     */
+    SaveJob* saveModelInBackground(MentalModel& model, const QString& filePath);
+    bool isSaving() const { return activeSaves > 0; }
     std::unique_ptr<MentalModel> loadModel(const QString& filePath);
+
+    /**
+     * Model on a read-only binary base, e.g. a shared reference ontology.
+     * The base is mapped once per manager and shared by every model layered
+     * on it (and by other processes, through the page cache); each model
+     * holds only the topology and what it changes. Saved to an overlay path
+     * (.qlinko), it writes only its differences from the base (see
+     * ModelOverlay); loadModel() of that path layers them on the base again.
+     * @return nullptr if the base cannot be opened
+     */
+    std::unique_ptr<MentalModel> loadLayered(const QString& basePath);
+
+    /**
+     * Have loadModel() leave concept descriptions and tags in the file and
+     * read them when used, holding at most cacheCapacity at a time (see
+     * ConceptPayloadCache), so a large model opens in the time it takes to
+     * read its topology. Applies to binary files and to JSON files large
+     * enough to be mapped; the model keeps the file mapped.
+     */
+    void setLazyLoading(bool enabled, size_t cacheCapacity = ConceptPayloadCache::DEFAULT_CAPACITY);
+    bool isLazyLoading() const { return lazyLoading; }
+
     bool exportModel(const MentalModel& model, const QString& filePath, ExportFormat format);
 
+    /**
+     * Read a graph from an interchange file into a new model named after
+     * the file
+     * @return nullptr if the file cannot be read
+     */
+    std::unique_ptr<MentalModel> importModel(const QString& filePath, ImportFormat format);
+
+    /**
+     * Add a graph from an interchange file to model, e.g. a node table and
+     * then an edge list that names its concepts
+     */
+    bool importInto(MentalModel& model, const QString& filePath, ImportFormat format);
+
+    /**
+     * What the last successful import added and skipped
+     */
+    const ImportResult& getLastImport() const { return lastImport; }
+
+    // Change journal (see ModelJournal)
+
+    /**
+     * Journal every change to model next to filePath, which this manager
+     * must have loaded or saved last
+     * @return false if the file's content is unknown or the journal cannot be written
+     */
+    bool startJournal(MentalModel& model, const QString& filePath);
+    void stopJournal();
+    bool isJournaling(const MentalModel& model, const QString& filePath) const;
+
+    /**
+     * Save by marking the journaled changes as saved, which costs one small
+     * append and fsync. A binary base is then patched in place with the
+     * entities changed since it was written, and the journal starts over;
+     * otherwise, once the journal outgrows its base, a new base is written
+     * in the background.
+     * @return false if model is not journaled at filePath; save it fully instead
+     */
+    bool saveIncrementally(MentalModel& model, const QString& filePath);
+
+    /**
+     * Mark the changes since the last save as abandoned, so they are not
+     * recovered when the file is opened again
+     */
+    void discardUnsaved();
+
+    /**
+     * Compact once the journal is larger than ratio times its base and at
+     * least minBytes
+     */
+    void setJournalCompaction(double ratio, qint64 minBytes);
+    bool isCompacting() const { return compacting; }
+
+    /**
+     * Unsaved changes the last loadModel() recovered from a journal
+     */
+    size_t getRecoveredChanges() const { return recoveredChanges; }
+
     // File management
     QStringList getRecentFiles() const;
     void addToRecentFiles(const QString& filePath);
     QString getDefaultSaveDirectory() const;
     void setDefaultSaveDirectory(const QString& directory);
 
+    /**
+     * Path a save to filePath writes: .qlinkb files stay binary and .qlinko
+     * files overlays, anything else gets a .json extension
+     */
+    static QString resolveSavePath(const QString& filePath);
+
+    using ProgressCallback = std::function<void(size_t writtenRecords, size_t totalRecords)>;
+
+    /**
+     * Called with the content hash once the new file is synced, just before
+     * it replaces the old one; throwing keeps the old file
+     */
+    using CommitHook = std::function<void(uint64_t contentHash)>;
+
+    /**
+     * Write model to filePath in the format its extension names, replacing
+     * the file atomically once the data is synced to disk. Touches no
+     * manager state, so it may run on any thread.
+     * @return FNV-1a hash of the written file
+     * @throws FileIOException if the file cannot be written
+     */
+    static uint64_t writeModelFile(const MentalModel& model, const QString& filePath,
+                                   const ProgressCallback& progress = {},
+                                   const CommitHook& beforeCommit = {});
+
+    /**
+     * Parse a model JSON document held in memory. One sequential scan finds
+     * where each record lies; the records are then decoded in chunks on the
+     * pool (the global one if null) and on the calling thread, and added to
+     * the model in bulk. loadModel() uses this for large files.
+     * @param contentHash If set, receives the FNV-1a hash of the document, computed alongside
+     * @param retainedData If set, keeps data valid; concept descriptions and tags are then left
+     *        in it and read when used, through a cache of cacheCapacity payloads
+     * @throws FileIOException if the document is not valid
+     */
+    static std::unique_ptr<MentalModel> parseModel(const char* data, size_t size, QThreadPool* pool = nullptr,
+                                                   uint64_t* contentHash = nullptr,
+                                                   std::shared_ptr<const char> retainedData = nullptr,
+                                                   size_t cacheCapacity = ConceptPayloadCache::DEFAULT_CAPACITY);
+
 signals:
     void modelSaved(const QString& filePath);
     void modelLoaded(const QString& filePath);
     void modelExported(const QString& filePath, ExportFormat format);
+    void modelImported(const QString& filePath, ImportFormat format);
     void errorOccurred(const QString& error);
     void recentFilesChanged(const QStringList& recentFiles);
 
 private:
-    // Serialization methods
-    QJsonObject serializeModel(const MentalModel& model);
-    std::unique_ptr<MentalModel> deserializeModel(const QJsonObject& jsonModel);
-    QJsonObject serializeConcept(const Concept& concept);
-    std::unique_ptr<Concept> deserializeConcept(const QJsonObject& jsonConcept);
-    QJsonObject serializeRelationship(const Relationship& relationship);
-    std::unique_ptr<Relationship> deserializeRelationship(const QJsonObject& jsonRelationship);
+    // Serialization methods; models are streamed, records go through QJsonObject
+    static void writeModel(const MentalModel& model, QIODevice& device, bool exportMetadata,
+                           const ProgressCallback& progress = {}, uint64_t* contentHash = nullptr);
+    std::unique_ptr<MentalModel> readModel(QIODevice& device, uint64_t* contentHash = nullptr);
+    std::unique_ptr<MentalModel> loadJsonModel(const QString& filePath, uint64_t& contentHash);
+    std::unique_ptr<MentalModel> loadOverlay(const QString& filePath, uint64_t& contentHash);
+    std::shared_ptr<const BinaryModelView> openBase(const QString& basePath, uint64_t expectedHash = 0);
+    static QJsonObject serializeConcept(const Concept& concept);
+    static std::unique_ptr<Concept> deserializeConcept(const QJsonObject& jsonConcept);
+    static QJsonObject serializeRelationship(const Relationship& relationship);
+    static std::unique_ptr<Relationship> deserializeRelationship(const QJsonObject& jsonRelationship);
 
     // Export format implementation
     bool exportToJSON(const MentalModel& model, const QString& filePath);
+    bool exportToBinary(const MentalModel& model, const QString& filePath);
+    bool exportToInterchange(const MentalModel& model, const QString& filePath, ExportFormat format);
+
+    static bool isBinaryPath(const QString& filePath);
+    static bool isOverlayPath(const QString& filePath);
+
+    void attachJournal(MentalModel& model, const QString& filePath,
+                       std::shared_ptr<ModelJournal> newJournal);
+    void recordChange(const ModelChangeEvent& event);
+    void syncJournal();
+    void compactJournal();
+    bool patchBase(MentalModel& model, const QString& filePath);
+    void markSaved(MentalModel& model, const QString& filePath);
 
     // Member variables
     QStringList recentFiles;
     QString defaultSaveDirectory;
+    QThreadPool savePool; // One thread, so saves never race on the same file
+    int activeSaves = 0;
+
+    // Content hash of each file as last loaded or saved; journals name their base by it
+    QHash<QString, uint64_t> baseHashes;
+
+    // Bases of layered models, by absolute path; open while a model reads from one
+    QHash<QString, std::weak_ptr<const BinaryModelView>> baseViews;
+
+    std::shared_ptr<ModelJournal> journal; // Shared with a compaction in progress
+    MentalModel* journalModel = nullptr;
+    QString journalPath;
+    QMetaObject::Connection journalChanges;
+    QMetaObject::Connection journalModelDestroyed;
+    QTimer* journalSyncTimer;
+
+    // The model whose changes since markClean() are relative to cleanPath
+    // as it is on disk, so a save may patch the file with them
+    const MentalModel* cleanModel = nullptr;
+    QString cleanPath;
+
+    double compactionRatio = 1.0;
+    qint64 compactionMinBytes = 64 * 1024;
+    bool compacting = false;
+    size_t recoveredChanges = 0;
+    ImportResult lastImport;
+    bool lazyLoading = false;
+    size_t payloadCacheCapacity = ConceptPayloadCache::DEFAULT_CAPACITY;
+
+    static constexpr int JOURNAL_SYNC_DELAY_MS = 1000; // Changes within this window share one fsync
+    static constexpr qint64 PARALLEL_LOAD_MIN_BYTES = 8 * 1024 * 1024; // Smaller files are streamed
+    static constexpr size_t PARSE_CHUNK_BYTES = 1024 * 1024; // Records decoded per task
 };
 
 } // namespace qlink
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "ModelOverlay.h"
+#include "BinaryModelFormat.h"
+#include "../model/MentalModel.h"
+#include "../common/Json.h"
+#include "../common/QLinkException.h"
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+namespace qlink {
+
+namespace {
+
+std::string formatHash(uint64_t hash) {
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return std::string(buffer, 16);
+}
+
+uint64_t parseHash(std::string_view text) {
+    std::string digits(text);
+    char* end = nullptr;
+    uint64_t hash = std::strtoull(digits.c_str(), &end, 16);
+    if (digits.size() != 16 || end != digits.c_str() + digits.size()) {
+        throw ParseException("Bad overlay base hash: " + digits);
+    }
+    return hash;
+}
+
+// Version 1 bases have no times, so a loaded model's are its own
+bool sameTimes(Timestamp created, Timestamp modified, Timestamp baseCreated, Timestamp baseModified) {
+    return baseCreated == 0 || (created == baseCreated && modified == baseModified);
+}
+
+bool sameConcept(const Concept& concept, const BinaryModelView& base, uint32_t index) {
+    BinaryModelView::ConceptView record = base.getConcept(index);
+    if (concept.getName() != record.name || !(concept.getPosition() == record.position) ||
+        !sameTimes(concept.getCreated(), concept.getModified(), record.created, record.modified)) {
+        return false;
+    }
+    if (concept.hasLazyPayload()) {
+        // Still read from the base, so unchanged
+        return true;
+    }
+    if (concept.getDescription() != record.description) return false;
+    std::vector<std::string_view> tags = base.getTags(index);
+    const auto& current = concept.getTags();
+    if (current.size() != tags.size()) return false;
+    for (size_t i = 0; i < tags.size(); ++i) {
+        if (current[i] != tags[i]) return false;
+    }
+    return true;
+}
+
+bool sameRelationship(const Relationship& relationship, const BinaryModelView& base, uint32_t index) {
+    BinaryModelView::RelationshipView record = base.getRelationship(index);
+    return relationship.getSourceConceptId() == base.getConcept(record.source).id &&
+           relationship.getTargetConceptId() == base.getConcept(record.target).id &&
+           relationship.getType() == record.type && relationship.getIsDirected() == record.directed &&
+           relationship.getWeight() == record.weight &&
+           sameTimes(relationship.getCreated(), relationship.getModified(), record.created, record.modified);
+}
+
+std::vector<std::string> readIds(JsonReader& reader) {
+    std::vector<std::string> ids;
+    reader.beginArray();
+    while (reader.nextElement()) {
+        ids.emplace_back(reader.readString());
+    }
+    return ids;
+}
+
+} // namespace
+
+std::shared_ptr<const BinaryModelView> ModelOverlay::baseOf(const MentalModel& model) {
+    const ConceptPayloadCache* cache = model.getPayloadCache();
+    if (!cache) return nullptr;
+    auto source = dynamic_cast<const BinaryPayloadSource*>(cache->getSource().get());
+    return source ? source->getView() : nullptr;
+}
+
+std::string ModelOverlay::encode(const MentalModel& model, const BinaryModelView& base, const std::string& basePath) {
+    // Base entities by id; with duplicate ids the first wins, as in the model's index
+    std::unordered_map<std::string_view, uint32_t> baseConcepts;
+    baseConcepts.reserve(base.getConceptCount());
+    for (uint32_t i = 0; i < base.getConceptCount(); ++i) {
+        baseConcepts.emplace(base.getConcept(i).id, i);
+    }
+    std::unordered_map<std::string_view, uint32_t> baseRelationships;
+    baseRelationships.reserve(base.getRelationshipCount());
+    for (uint32_t i = 0; i < base.getRelationshipCount(); ++i) {
+        baseRelationships.emplace(base.getRelationship(i).id, i);
+    }
+
+    std::string json;
+    JsonWriter writer(json);
+    writer.beginObject();
+    writer.key("overlay");
+    writer.number(VERSION);
+    writer.key("base");
+    writer.string(basePath);
+    writer.key("baseHash");
+    writer.string(formatHash(BinaryModelView::contentHash(base.getData(), base.getSize())));
+    writer.key("name");
+    writer.string(model.getModelName());
+
+    writer.key("concepts");
+    writer.beginArray();
+    for (const auto& concept : model.getConcepts()) {
+        auto found = baseConcepts.find(concept->getId());
+        if (found == baseConcepts.end() || !sameConcept(*concept, base, found->second)) {
+            concept->writeJson(writer);
+        }
+    }
+    writer.endArray();
+
+    writer.key("relationships");
+    writer.beginArray();
+    for (const auto& relationship : model.getRelationships()) {
+        auto found = baseRelationships.find(relationship->getId());
+        if (found == baseRelationships.end() || !sameRelationship(*relationship, base, found->second)) {
+            relationship->writeJson(writer);
+        }
+    }
+    writer.endArray();
+
+    // In base order, so an unchanged model encodes the same every time
+    writer.key("removedConcepts");
+    writer.beginArray();
+    for (uint32_t i = 0; i < base.getConceptCount(); ++i) {
+        std::string_view id = base.getConcept(i).id;
+        if (baseConcepts[id] == i && !model.getConcept(std::string(id))) {
+            writer.string(id);
+        }
+    }
+    writer.endArray();
+
+    writer.key("removedRelationships");
+    writer.beginArray();
+    for (uint32_t i = 0; i < base.getRelationshipCount(); ++i) {
+        std::string_view id = base.getRelationship(i).id;
+        if (baseRelationships[id] == i && !model.getRelationship(std::string(id))) {
+            writer.string(id);
+        }
+    }
+    writer.endArray();
+    writer.endObject();
+    return json;
+}
+
+ModelOverlay::BaseReference ModelOverlay::readBase(std::string_view json) {
+    BaseReference reference;
+    bool overlay = false;
+    bool hashed = false;
+    JsonReader reader(json);
+    reader.beginObject();
+    std::string_view key;
+    while (reader.nextMember(key)) {
+        if (key == "overlay") {
+            overlay = reader.readNumber() == VERSION;
+        } else if (key == "base") {
+            reference.path = reader.readString();
+        } else if (key == "baseHash") {
+            reference.contentHash = parseHash(reader.readString());
+            hashed = true;
+        } else {
+            reader.skipValue();
+        }
+    }
+    if (!overlay || reference.path.empty() || !hashed) {
+        throw ParseException("Not a model overlay");
+    }
+    return reference;
+}
+
+void ModelOverlay::apply(std::string_view json, MentalModel& model) {
+    readBase(json);
+
+    std::string name;
+    bool named = false;
+    std::vector<std::unique_ptr<Concept>> concepts;
+    std::vector<std::unique_ptr<Relationship>> relationships;
+    std::vector<std::string> removedConcepts;
+    std::vector<std::string> removedRelationships;
+
+    JsonReader reader(json);
+    reader.beginObject();
+    std::string_view key;
+    while (reader.nextMember(key)) {
+        if (key == "name") {
+            name = reader.readString();
+            named = true;
+        } else if (key == "concepts") {
+            reader.beginArray();
+            while (reader.nextElement()) {
+                if (auto concept = Concept::fromJson(reader)) concepts.push_back(std::move(concept));
+            }
+        } else if (key == "relationships") {
+            reader.beginArray();
+            while (reader.nextElement()) {
+                if (auto relationship = Relationship::fromJson(reader)) {
+                    relationships.push_back(std::move(relationship));
+                }
+            }
+        } else if (key == "removedConcepts") {
+            removedConcepts = readIds(reader);
+        } else if (key == "removedRelationships") {
+            removedRelationships = readIds(reader);
+        } else {
+            reader.skipValue();
+        }
+    }
+    reader.finish();
+
+    for (const auto& id : removedRelationships) {
+        model.removeRelationship(id);
+    }
+    for (const auto& id : removedConcepts) {
+        model.removeConcept(id);
+    }
+    if (named) {
+        model.setModelName(name);
+    }
+
+    for (auto& saved : concepts) {
+        if (Concept* concept = model.getConcept(saved->getId())) {
+            concept->assignContent(*saved);
+            model.notifyConceptModified(concept->getId());
+        } else {
+            model.addConcept(std::move(saved));
+        }
+    }
+    for (auto& saved : relationships) {
+        Relationship* relationship = model.getRelationship(saved->getId());
+        if (relationship && (relationship->getSourceConceptId() != saved->getSourceConceptId() ||
+                             relationship->getTargetConceptId() != saved->getTargetConceptId())) {
+            model.removeRelationship(saved->getId());
+            relationship = nullptr;
+        }
+        if (relationship) {
+            relationship->assignContent(*saved);
+            model.notifyRelationshipModified(relationship->getId());
+        } else {
+            model.addRelationship(std::move(saved));
+        }
+    }
+}
+
+} // namespace qlink
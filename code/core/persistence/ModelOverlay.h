@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace qlink {
+
+class MentalModel;
+class BinaryModelView;
+
+/**
+ * A model stored as what it adds to, changes in and removes from a
+ * read-only binary base, e.g. an analyst's work on a shared reference
+ * ontology.
+ *
+ * The base (.qlinkb) is mapped and never written, so every session layered
+ * on it shares its pages; see ModelManager::loadLayered. The overlay file
+ * (.qlinko) is JSON holding the base's path and content hash, the added and
+ * changed entities in full and the ids of removed ones:
+ *
+ *   {"overlay": 1, "base": "ontology.qlinkb", "baseHash": "<16 hex digits>",
+ *    "name": "...", "concepts": [...], "relationships": [...],
+ *    "removedConcepts": ["id", ...], "removedRelationships": ["id", ...]}
+ *
+ * A model is layered when its lazy payloads come from a base view (see
+ * BinaryModelView::toLazyModel). Its clones are too, so a background save
+ * writes an overlay like any other.
+ */
+class ModelOverlay {
+public:
+    static constexpr const char* FILE_EXTENSION = ".qlinko";
+    static constexpr uint32_t VERSION = 1;
+
+    struct BaseReference {
+        std::string path; // Relative to the overlay's directory, unless absolute
+        uint64_t contentHash = 0; // BinaryModelView::contentHash() of the base
+    };
+
+    /**
+     * The base a layered model reads its payloads from; null for any other model
+     */
+    static std::shared_ptr<const BinaryModelView> baseOf(const MentalModel& model);
+
+    /**
+     * The overlay that takes base to model, which must be layered on base.
+     * Finding what changed takes time in the size of the base; concepts
+     * whose payload was never edited are compared without reading it.
+     * @param basePath Written as the base's path
+     */
+    static std::string encode(const MentalModel& model, const BinaryModelView& base, const std::string& basePath);
+
+    /**
+     * @throws ParseException if json is not an overlay
+     */
+    static BaseReference readBase(std::string_view json);
+
+    /**
+     * Bring a model loaded from the overlay's base up to the overlay:
+     * removals first, then the entities it holds, added or updated by id
+     * @throws ParseException if json is not an overlay
+     */
+    static void apply(std::string_view json, MentalModel& model);
+};
+
+} // namespace qlink
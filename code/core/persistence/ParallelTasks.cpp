@@ -0,0 +1,54 @@
+#include "ParallelTasks.h"
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace qlink {
+
+void runParallel(size_t count, const std::function<void(size_t)>& task, QThreadPool* pool) {
+    struct State {
+        std::atomic<size_t> next{0};
+        std::atomic<bool> failed{false};
+        std::mutex mutex;
+        std::condition_variable allDone;
+        size_t finished = 0;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+
+    // Helpers that start late find nothing left to claim and never touch task
+    auto work = [state, count, &task]() {
+        size_t index;
+        while ((index = state->next.fetch_add(1)) < count) {
+            if (!state->failed) {
+                try {
+                    task(index);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!state->error) state->error = std::current_exception();
+                    state->failed = true;
+                }
+            }
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (++state->finished == count) state->allDone.notify_all();
+        }
+    };
+
+    int helpers = static_cast<int>(std::min<size_t>(count, static_cast<size_t>(pool->maxThreadCount()))) - 1;
+    for (int i = 0; i < helpers; ++i) {
+        pool->start(work);
+    }
+    work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->allDone.wait(lock, [&]() { return state->finished == count; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+} // namespace qlink
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+class QThreadPool;
+
+namespace qlink {
+
+/**
+ * Run task(0) .. task(count - 1) on the pool and the calling thread and
+ * return once all have finished; the first exception is rethrown.
+ * The caller takes part, so this finishes even when the pool is busy.
+ */
+void runParallel(size_t count, const std::function<void(size_t)>& task, QThreadPool* pool);
+
+} // namespace qlink
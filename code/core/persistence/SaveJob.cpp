@@ -0,0 +1,113 @@
+#include "SaveJob.h"
+#include "ModelManager.h"
+#include "../model/MentalModel.h"
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <mutex>
+
+namespace qlink {
+
+struct SaveJob::SharedState {
+    std::shared_ptr<const MentalModel> snapshot;
+    QString filePath;
+    std::function<void(uint64_t)> beforeCommit;
+    std::atomic<int> writtenRecords{0};
+    std::atomic<int> totalRecords{0};
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> contentHash{0};
+
+    std::mutex errorMutex;
+    QString error; // Empty on success
+
+    SharedState(std::shared_ptr<const MentalModel> snapshot, const QString& filePath,
+                std::function<void(uint64_t)> beforeCommit)
+        : snapshot(std::move(snapshot)), filePath(filePath), beforeCommit(std::move(beforeCommit)) {
+        totalRecords = static_cast<int>(this->snapshot->getConceptCount() + this->snapshot->getRelationshipCount());
+    }
+
+    void run() {
+        try {
+            contentHash = ModelManager::writeModelFile(*snapshot, filePath, [this](size_t written, size_t) {
+                writtenRecords.store(static_cast<int>(written), std::memory_order_relaxed);
+            }, beforeCommit);
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            error = QString::fromUtf8(e.what());
+        }
+        done = true;
+    }
+};
+
+SaveJob::SaveJob(std::shared_ptr<const MentalModel> snapshot, const QString& filePath, QObject* parent,
+                 std::function<void(uint64_t contentHash)> beforeCommit)
+    : QObject(parent),
+      state(std::make_shared<SharedState>(std::move(snapshot), filePath, std::move(beforeCommit))),
+      filePath(filePath),
+      pollTimer(new QTimer(this)),
+      started(false),
+      lastReportedProgress(-1) {
+    pollTimer->setInterval(POLL_INTERVAL_MS);
+    connect(pollTimer, &QTimer::timeout, this, &SaveJob::poll);
+}
+
+// The worker shares the state and finishes the write even if we are gone
+SaveJob::~SaveJob() = default;
+
+void SaveJob::start(QThreadPool* pool) {
+    if (started) return;
+    started = true;
+
+    if (!pool) {
+        pool = QThreadPool::globalInstance();
+    }
+    auto shared = state;
+    pool->start([shared]() { shared->run(); });
+    pollTimer->start();
+}
+
+bool SaveJob::isRunning() const {
+    return started && !state->done.load();
+}
+
+uint64_t SaveJob::getModelVersion() const {
+    return state->snapshot->getVersion();
+}
+
+int SaveJob::getWrittenRecords() const {
+    return state->writtenRecords.load();
+}
+
+int SaveJob::getTotalRecords() const {
+    return state->totalRecords.load();
+}
+
+uint64_t SaveJob::getContentHash() const {
+    return state->contentHash.load();
+}
+
+void SaveJob::poll() {
+    bool done = state->done.load();
+
+    int written = state->writtenRecords.load();
+    if (written != lastReportedProgress) {
+        lastReportedProgress = written;
+        emit progressChanged(written, state->totalRecords.load());
+    }
+
+    if (!done) return;
+    pollTimer->stop();
+
+    QString error;
+    {
+        std::lock_guard<std::mutex> lock(state->errorMutex);
+        error = state->error;
+    }
+    if (error.isEmpty()) {
+        emit finished(filePath);
+    } else {
+        emit failed(error);
+    }
+}
+
+} // namespace qlink
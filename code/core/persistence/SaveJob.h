@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+class QThreadPool;
+class QTimer;
+
+namespace qlink {
+
+class MentalModel;
+
+/**
+ * Writes a model snapshot to disk on a worker thread.
+ *
+ * The snapshot is an immutable copy taken when the save was requested, so
+ * the live model can keep changing while it is written. The file is
+ * replaced atomically and synced to disk before finished() is emitted;
+ * a crash mid-save leaves the previous file intact.
+ *
+ * Like SuggestionJob, the worker never emits signals; the job polls its
+ * progress from the thread it lives in.
+ */
+class SaveJob : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @param filePath Final path; the format follows its extension
+     * @param beforeCommit Run on the worker once the file is synced, before it replaces the old one
+     */
+    SaveJob(std::shared_ptr<const MentalModel> snapshot, const QString& filePath, QObject* parent = nullptr,
+            std::function<void(uint64_t contentHash)> beforeCommit = {});
+    ~SaveJob();
+
+    /**
+     * Start writing on the given pool (the global pool if null)
+     */
+    void start(QThreadPool* pool = nullptr);
+
+    bool isRunning() const;
+    const QString& getFilePath() const { return filePath; }
+
+    /**
+     * MentalModel::getVersion() of the model when the snapshot was taken
+     */
+    uint64_t getModelVersion() const;
+
+    int getWrittenRecords() const;
+    int getTotalRecords() const;
+
+    /**
+     * FNV-1a hash of the written file, once finished() was emitted
+     */
+    uint64_t getContentHash() const;
+
+signals:
+    void progressChanged(int writtenRecords, int totalRecords);
+    void finished(const QString& filePath);
+    void failed(const QString& error);
+
+private slots:
+    void poll();
+
+private:
+    struct SharedState;
+
+    std::shared_ptr<SharedState> state;
+    QString filePath;
+    QTimer* pollTimer;
+    bool started;
+    int lastReportedProgress;
+
+    static constexpr int POLL_INTERVAL_MS = 33;
+};
+
+} // namespace qlink
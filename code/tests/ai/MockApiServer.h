@@ -0,0 +1,167 @@
+#pragma once
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QList>
+#include <QStringList>
+#include <QHash>
+#include <functional>
+#include <algorithm>
+
+namespace qlink {
+
+/**
+ * Canned reply from MockApiServer
+ */
+struct MockResponse {
+    int status = 200;
+    QByteArray body;
+    int delayMs = 0;
+    QList<QByteArray> chunks; // Streamed after body, one every intervalMs
+    int intervalMs = 0;
+
+    static MockResponse text(const QString& text, int delayMs = 0) {
+        QJsonObject object;
+        object["text"] = text;
+        return MockResponse{200, QJsonDocument(object).toJson(QJsonDocument::Compact), delayMs};
+    }
+
+    /**
+     * Cohere v1 style stream: one JSON event per line, each token its own chunk
+     */
+    static MockResponse stream(const QStringList& tokens, int firstDelayMs, int intervalMs) {
+        MockResponse response;
+        response.delayMs = firstDelayMs;
+        response.intervalMs = intervalMs;
+        for (const QString& token : tokens) {
+            response.chunks.append(event({{"event_type", "text-generation"}, {"text", token}}));
+        }
+        response.chunks.append(event({{"event_type", "stream-end"}, {"finish_reason", "COMPLETE"}}));
+        return response;
+    }
+
+private:
+    static QByteArray event(const QJsonObject& object) {
+        return QJsonDocument(object).toJson(QJsonDocument::Compact) + "\n";
+    }
+};
+
+/**
+ * Minimal local HTTP server standing in for the Cohere API in tests.
+ * Point an AIAssistant at url() through setApiEndpoint.
+ */
+class MockApiServer {
+public:
+    using Handler = std::function<MockResponse(const QJsonObject& request)>;
+
+    MockApiServer() {
+        handler = [](const QJsonObject&) { return MockResponse::text("Mock reply"); };
+        QObject::connect(&server, &QTcpServer::newConnection, [this]() {
+            while (QTcpSocket* socket = server.nextPendingConnection()) {
+                QObject::connect(socket, &QTcpSocket::readyRead, [this, socket]() { onReadyRead(socket); });
+                QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+        server.listen(QHostAddress::LocalHost, 0);
+    }
+
+    QString url() const {
+        return QString("http://127.0.0.1:%1/v1/chat").arg(server.serverPort());
+    }
+
+    void setHandler(Handler newHandler) { handler = std::move(newHandler); }
+
+    int requestCount() const { return requests.size(); }
+    int activeRequests() const { return active; }
+    int peakConcurrentRequests() const { return peak; }
+
+    QList<QJsonObject> requests;
+
+private:
+    void onReadyRead(QTcpSocket* socket) {
+        QByteArray& buffer = buffers[socket];
+        buffer += socket->readAll();
+
+        int headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0) return;
+
+        int contentLength = 0;
+        for (const QByteArray& line : buffer.left(headerEnd).split('\n')) {
+            if (line.toLower().startsWith("content-length:")) {
+                contentLength = line.mid(15).trimmed().toInt();
+            }
+        }
+        if (buffer.size() < headerEnd + 4 + contentLength) return;
+
+        QJsonObject request = QJsonDocument::fromJson(buffer.mid(headerEnd + 4, contentLength)).object();
+        buffers.remove(socket);
+        requests.append(request);
+        peak = std::max(peak, ++active);
+
+        MockResponse response = handler(request);
+        if (!response.chunks.isEmpty()) {
+            sendStream(socket, response);
+            return;
+        }
+        QTimer::singleShot(response.delayMs, socket, [this, socket, response]() {
+            --active;
+            QByteArray reply = "HTTP/1.1 " + QByteArray::number(response.status) + " Mock\r\n"
+                               "Content-Type: application/json\r\n"
+                               "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n"
+                               "Connection: close\r\n\r\n" + response.body;
+            socket->write(reply);
+            socket->disconnectFromHost();
+        });
+    }
+
+    /**
+     * Headers right away, then the chunks with no Content-Length; closing
+     * the connection ends the body
+     */
+    void sendStream(QTcpSocket* socket, const MockResponse& response) {
+        socket->write("HTTP/1.1 " + QByteArray::number(response.status) + " Mock\r\n"
+                      "Content-Type: application/stream+json\r\n"
+                      "Connection: close\r\n\r\n");
+        for (int i = 0; i <= response.chunks.size(); ++i) {
+            int delay = response.delayMs + i * response.intervalMs;
+            QTimer::singleShot(delay, socket, [this, socket, response, i]() {
+                if (i < response.chunks.size()) {
+                    socket->write(response.chunks[i]);
+                    socket->flush();
+                } else {
+                    --active;
+                    socket->disconnectFromHost();
+                }
+            });
+        }
+    }
+
+    QTcpServer server;
+    Handler handler;
+    QHash<QTcpSocket*, QByteArray> buffers;
+    int active = 0;
+    int peak = 0;
+};
+
+/**
+ * Run the event loop until condition holds or the timeout expires
+ */
+inline bool waitUntil(const std::function<bool()>& condition, int timeoutMs = 5000) {
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while (!condition()) {
+        if (elapsed.elapsed() > timeoutMs) return false;
+        QEventLoop loop;
+        QTimer::singleShot(5, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+    return true;
+}
+
+} // namespace qlink
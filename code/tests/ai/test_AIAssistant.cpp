@@ -0,0 +1,648 @@
+#include <gtest/gtest.h>
+#include "MockApiServer.h"
+#include "../../core/ai/AIAssistant.h"
+#include "../../core/ai/ExplanationPrefetcher.h"
+#include "../../core/model/Concept.h"
+#include "../../core/model/MentalModel.h"
+#include "../../core/model/Relationship.h"
+#include <QString>
+#include <QTemporaryDir>
+#include <QRegularExpression>
+#include <QJsonArray>
+#include <set>
+
+using namespace qlink;
+
+namespace {
+
+/**
+ * Answer a batch prompt with "Answer: <item>" for every numbered item not in skip
+ */
+MockResponse answerBatch(const QJsonObject& request, const std::set<int>& skip = {}) {
+    QString message = request["message"].toString();
+    QJsonArray answers;
+    QRegularExpression item("^(\\d+)\\. (.+)$", QRegularExpression::MultilineOption);
+    for (auto match = item.globalMatch(message); match.hasNext();) {
+        auto next = match.next();
+        int id = next.captured(1).toInt();
+        if (skip.count(id)) continue;
+        answers.append(QJsonObject{{"id", id}, {"text", "Answer: " + next.captured(2)}});
+    }
+    return MockResponse::text(QString::fromUtf8(QJsonDocument(answers).toJson(QJsonDocument::Compact)));
+}
+
+bool isBatch(const QJsonObject& request) {
+    return request["message"].toString().contains("JSON array");
+}
+
+} // namespace
+
+class AIAssistantTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        assistant = std::make_unique<AIAssistant>();
+        assistant->setApiKey("test-key");
+        assistant->setApiEndpoint(server.url());
+        // Keep responses from other runs out of the request counts
+        assistant->setResponseStorePath(QString());
+        // Tests that want retries turn them on
+        assistant->setRetryPolicy(0, 0, 0);
+    }
+
+    MockApiServer server;
+    std::unique_ptr<AIAssistant> assistant;
+};
+
+TEST_F(AIAssistantTest, AsyncCallReturnsBeforeReply) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Async description", 50); });
+
+    std::string result;
+    assistant->generateConceptDescriptionAsync("Entropy", [&](const std::string& text) { result = text; });
+
+    // Nothing has been delivered yet; the event loop does that
+    EXPECT_TRUE(result.empty());
+    EXPECT_EQ(assistant->getPendingRequestCount(), 1u);
+
+    ASSERT_TRUE(waitUntil([&]() { return !result.empty(); }));
+    EXPECT_EQ(result, "Async description");
+    EXPECT_EQ(assistant->getPendingRequestCount(), 0u);
+}
+
+TEST_F(AIAssistantTest, RequestsRunConcurrentlyUpToLimit) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("ok", 100); });
+    assistant->setMaxConcurrentRequests(2);
+
+    int completed = 0;
+    for (int i = 0; i < 5; ++i) {
+        assistant->generateConceptDescriptionAsync("Concept " + std::to_string(i),
+                                                   [&](const std::string&) { ++completed; });
+    }
+    EXPECT_EQ(assistant->getPendingRequestCount(), 5u);
+
+    ASSERT_TRUE(waitUntil([&]() { return completed == 5; }));
+    EXPECT_EQ(server.requestCount(), 5);
+    EXPECT_EQ(server.peakConcurrentRequests(), 2);
+}
+
+TEST_F(AIAssistantTest, CachedAnswerIsDeliveredImmediately) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Cached"); });
+    assistant->generateConceptDescription("Entropy");
+
+    std::string result;
+    assistant->generateConceptDescriptionAsync("Entropy", [&](const std::string& text) { result = text; });
+
+    EXPECT_EQ(result, "Cached");
+    EXPECT_EQ(server.requestCount(), 1);
+}
+
+TEST_F(AIAssistantTest, BlockingCallStillWorks) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("1. Thermodynamics\n- Information"); });
+
+    Concept concept("Entropy");
+    auto suggestions = assistant->suggestRelatedConcepts(concept);
+
+    ASSERT_EQ(suggestions.size(), 2u);
+    EXPECT_EQ(suggestions[0], "Thermodynamics");
+    EXPECT_EQ(suggestions[1], "Information");
+}
+
+TEST_F(AIAssistantTest, ServerErrorFallsBack) {
+    server.setHandler([](const QJsonObject&) { return MockResponse{500, "{}", 0}; });
+
+    Concept first("Entropy");
+    Concept second("Information");
+    std::string result;
+    assistant->explainConnectionAsync(first, second, [&](const std::string& text) { result = text; });
+
+    ASSERT_TRUE(waitUntil([&]() { return !result.empty(); }));
+    EXPECT_NE(result.find("Unable to generate explanation"), std::string::npos);
+}
+
+TEST_F(AIAssistantTest, PromptIsSentToEndpoint) {
+    assistant->generateConceptDescription("Entropy");
+
+    ASSERT_EQ(server.requestCount(), 1);
+    EXPECT_TRUE(server.requests[0]["message"].toString().contains("Entropy"));
+}
+
+TEST_F(AIAssistantTest, PendingCallbacksAreDroppedOnDestruction) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("late", 50); });
+
+    bool called = false;
+    assistant->generateConceptDescriptionAsync("Entropy", [&](const std::string&) { called = true; });
+    assistant.reset();
+
+    waitUntil([&]() { return server.activeRequests() == 0; });
+    EXPECT_FALSE(called);
+}
+
+TEST_F(AIAssistantTest, StoredResponseSurvivesRestart) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QString storePath = dir.filePath("responses.qlrs");
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Persisted"); });
+
+    assistant->setResponseStorePath(storePath);
+    EXPECT_EQ(assistant->generateConceptDescription("Entropy"), "Persisted");
+    assistant.reset();
+
+    AIAssistant restarted;
+    restarted.setApiKey("test-key");
+    restarted.setApiEndpoint(server.url());
+    restarted.setResponseStorePath(storePath);
+
+    std::string result;
+    restarted.generateConceptDescriptionAsync("Entropy", [&](const std::string& text) { result = text; });
+
+    EXPECT_EQ(result, "Persisted");
+    EXPECT_EQ(server.requestCount(), 1);
+}
+
+TEST_F(AIAssistantTest, FailedResponsesAreNotStored) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    assistant->setResponseStorePath(dir.filePath("responses.qlrs"));
+    server.setHandler([](const QJsonObject&) { return MockResponse{500, "{}", 0}; });
+    assistant->generateConceptDescription("Entropy");
+    assistant.reset();
+
+    AIAssistant restarted;
+    restarted.setApiKey("test-key");
+    restarted.setApiEndpoint(server.url());
+    restarted.setResponseStorePath(dir.filePath("responses.qlrs"));
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Recovered"); });
+
+    EXPECT_EQ(restarted.generateConceptDescription("Entropy"), "Recovered");
+    EXPECT_EQ(server.requestCount(), 2);
+}
+
+TEST_F(AIAssistantTest, ConnectionCacheIgnoresOrder) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Linked"); });
+
+    Concept first("Entropy");
+    Concept second("Information");
+    assistant->explainConnection(first, second);
+    EXPECT_EQ(assistant->explainConnection(second, first), "Linked");
+    EXPECT_EQ(server.requestCount(), 1);
+}
+
+TEST_F(AIAssistantTest, FailedRequestIsRetriedAfterNegativeTtl) {
+    assistant->setCacheLimits(1024 * 1024, 3600, 0);
+    server.setHandler([](const QJsonObject&) { return MockResponse{500, "{}", 0}; });
+    assistant->generateConceptDescription("Entropy");
+
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Recovered"); });
+    EXPECT_EQ(assistant->generateConceptDescription("Entropy"), "Recovered");
+    EXPECT_EQ(server.requestCount(), 2);
+    EXPECT_EQ(assistant->getCacheStats().hits, 0u);
+}
+
+TEST_F(AIAssistantTest, IdenticalConcurrentRequestsShareOneCall) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Shared", 50); });
+
+    std::vector<std::string> results;
+    for (int i = 0; i < 3; ++i) {
+        assistant->generateConceptDescriptionAsync("Entropy", [&](const std::string& text) { results.push_back(text); });
+    }
+    EXPECT_EQ(assistant->getPendingRequestCount(), 1u);
+
+    ASSERT_TRUE(waitUntil([&]() { return results.size() == 3; }));
+    EXPECT_EQ(server.requestCount(), 1);
+    for (const auto& result : results) {
+        EXPECT_EQ(result, "Shared");
+    }
+}
+
+TEST_F(AIAssistantTest, ReversedConnectionJoinsPendingCall) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Linked", 50); });
+
+    Concept first("Entropy");
+    Concept second("Information");
+    int completed = 0;
+    assistant->explainConnectionAsync(first, second, [&](const std::string&) { ++completed; });
+    assistant->explainConnectionAsync(second, first, [&](const std::string&) { ++completed; });
+
+    ASSERT_TRUE(waitUntil([&]() { return completed == 2; }));
+    EXPECT_EQ(server.requestCount(), 1);
+}
+
+TEST_F(AIAssistantTest, CancellingOneWaiterKeepsTheCall) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Kept", 50); });
+
+    bool cancelledRan = false;
+    std::string result;
+    auto cancelled = assistant->generateConceptDescriptionAsync("Entropy", [&](const std::string&) { cancelledRan = true; });
+    assistant->generateConceptDescriptionAsync("Entropy", [&](const std::string& text) { result = text; });
+    EXPECT_TRUE(assistant->cancelRequest(cancelled));
+    EXPECT_FALSE(assistant->cancelRequest(cancelled));
+
+    ASSERT_TRUE(waitUntil([&]() { return !result.empty(); }));
+    EXPECT_EQ(result, "Kept");
+    EXPECT_FALSE(cancelledRan);
+    EXPECT_EQ(server.requestCount(), 1);
+}
+
+TEST_F(AIAssistantTest, CancellingLastWaiterAbortsRequest) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Too late", 500); });
+
+    bool ran = false;
+    auto id = assistant->generateConceptDescriptionAsync("Entropy", [&](const std::string&) { ran = true; });
+    ASSERT_TRUE(waitUntil([&]() { return server.requestCount() == 1; }));
+
+    EXPECT_TRUE(assistant->cancelRequest(id));
+    ASSERT_TRUE(waitUntil([&]() { return assistant->getPendingRequestCount() == 0; }));
+    EXPECT_FALSE(ran);
+
+    // Nothing was cached for the aborted call
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Fresh"); });
+    EXPECT_EQ(assistant->generateConceptDescription("Entropy"), "Fresh");
+}
+
+TEST_F(AIAssistantTest, CancelledQueuedRequestIsNeverSent) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("ok", 50); });
+    assistant->setMaxConcurrentRequests(1);
+
+    int completed = 0;
+    assistant->generateConceptDescriptionAsync("First", [&](const std::string&) { ++completed; });
+    auto queued = assistant->generateConceptDescriptionAsync("Second", [&](const std::string&) { ++completed; });
+    EXPECT_TRUE(assistant->cancelRequest(queued));
+
+    ASSERT_TRUE(waitUntil([&]() { return completed == 1 && assistant->getPendingRequestCount() == 0; }));
+    EXPECT_EQ(server.requestCount(), 1);
+}
+
+TEST_F(AIAssistantTest, CachedAnswerHasNoRequestId) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Cached"); });
+    assistant->generateConceptDescription("Entropy");
+
+    EXPECT_EQ(assistant->generateConceptDescriptionAsync("Entropy", [](const std::string&) {}), 0u);
+}
+
+TEST_F(AIAssistantTest, BatchDescriptionsUseOneRequest) {
+    server.setHandler([](const QJsonObject& request) { return answerBatch(request); });
+
+    auto results = assistant->generateConceptDescriptions({"Entropy", "Information", "Entropy", "Energy"});
+
+    ASSERT_EQ(results.size(), 4u);
+    EXPECT_EQ(results[0], "Answer: Entropy");
+    EXPECT_EQ(results[1], "Answer: Information");
+    EXPECT_EQ(results[2], "Answer: Entropy");
+    EXPECT_EQ(results[3], "Answer: Energy");
+    EXPECT_EQ(server.requestCount(), 1);
+
+    // Each item was cached on its own
+    EXPECT_EQ(assistant->generateConceptDescription("Information"), "Answer: Information");
+    EXPECT_EQ(server.requestCount(), 1);
+}
+
+TEST_F(AIAssistantTest, UnparsedBatchItemsFallBackToSingleRequests) {
+    server.setHandler([](const QJsonObject& request) {
+        return isBatch(request) ? answerBatch(request, {2}) : MockResponse::text("Single answer");
+    });
+
+    auto results = assistant->generateConceptDescriptions({"Entropy", "Information", "Energy"});
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0], "Answer: Entropy");
+    EXPECT_EQ(results[1], "Single answer");
+    EXPECT_EQ(results[2], "Answer: Energy");
+    EXPECT_EQ(server.requestCount(), 2);
+}
+
+TEST_F(AIAssistantTest, BatchSkipsCachedItems) {
+    server.setHandler([](const QJsonObject& request) {
+        return isBatch(request) ? answerBatch(request) : MockResponse::text("Single answer");
+    });
+    assistant->generateConceptDescription("Entropy");
+
+    auto results = assistant->generateConceptDescriptions({"Entropy", "Information", "Energy"});
+
+    EXPECT_EQ(results[0], "Single answer");
+    EXPECT_EQ(server.requestCount(), 2);
+    EXPECT_FALSE(server.requests.last()["message"].toString().contains("1. Entropy"));
+}
+
+TEST_F(AIAssistantTest, BatchExplanationsShareCacheWithSingleCalls) {
+    server.setHandler([](const QJsonObject& request) { return answerBatch(request); });
+
+    Concept entropy("Entropy");
+    Concept information("Information");
+    Concept energy("Energy");
+    auto results = assistant->explainConnections({{&entropy, &information}, {&energy, &entropy}});
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0], "Answer: Entropy and Information");
+    EXPECT_EQ(server.requestCount(), 1);
+    EXPECT_EQ(server.requests.first()["max_tokens"].toInt(), 240);
+
+    EXPECT_EQ(assistant->explainConnection(entropy, energy), results[1]);
+    EXPECT_EQ(server.requestCount(), 1);
+}
+
+TEST_F(AIAssistantTest, EmptyBatchCompletesImmediately) {
+    bool called = false;
+    assistant->generateConceptDescriptionsAsync({}, [&](const std::vector<std::string>& results) {
+        called = results.empty();
+    });
+    EXPECT_TRUE(called);
+}
+
+TEST_F(AIAssistantTest, ServerErrorsAreRetried) {
+    assistant->setRetryPolicy(3, 10, 40);
+    int attempts = 0;
+    server.setHandler([&attempts](const QJsonObject&) {
+        return ++attempts <= 2 ? MockResponse{503, "{}", 0} : MockResponse::text("Third time lucky");
+    });
+
+    EXPECT_EQ(assistant->generateConceptDescription("Entropy"), "Third time lucky");
+    EXPECT_EQ(server.requestCount(), 3);
+}
+
+TEST_F(AIAssistantTest, RateLimitedRequestsAreRetried) {
+    assistant->setRetryPolicy(1, 10, 10);
+    int attempts = 0;
+    server.setHandler([&attempts](const QJsonObject&) {
+        return ++attempts == 1 ? MockResponse{429, "{}", 0} : MockResponse::text("Allowed");
+    });
+
+    EXPECT_EQ(assistant->generateConceptDescription("Entropy"), "Allowed");
+    EXPECT_FALSE(assistant->isCircuitOpen());
+}
+
+TEST_F(AIAssistantTest, RetriesStopAtTheLimit) {
+    assistant->setRetryPolicy(2, 10, 10);
+    server.setHandler([](const QJsonObject&) { return MockResponse{500, "{}", 0}; });
+
+    assistant->generateConceptDescription("Entropy");
+    EXPECT_EQ(server.requestCount(), 3);
+}
+
+TEST_F(AIAssistantTest, OpenCircuitFailsFast) {
+    assistant->setCircuitBreaker(2, 60000);
+    server.setHandler([](const QJsonObject&) { return MockResponse{500, "{}", 0}; });
+    assistant->generateConceptDescription("Entropy");
+    assistant->generateConceptDescription("Information");
+    ASSERT_TRUE(assistant->isCircuitOpen());
+
+    std::string result;
+    assistant->generateConceptDescriptionAsync("Energy", [&](const std::string& text) { result = text; });
+
+    // The fallback arrives without another request
+    EXPECT_EQ(result, "A concept representing Energy in your knowledge model.");
+    EXPECT_EQ(server.requestCount(), 2);
+}
+
+TEST_F(AIAssistantTest, CircuitClosesAfterSuccessfulProbe) {
+    assistant->setCircuitBreaker(1, 50);
+    server.setHandler([](const QJsonObject&) { return MockResponse{500, "{}", 0}; });
+    assistant->generateConceptDescription("Entropy");
+    ASSERT_TRUE(assistant->isCircuitOpen());
+
+    ASSERT_TRUE(waitUntil([&]() { return !assistant->isCircuitOpen(); }));
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Back again"); });
+
+    EXPECT_EQ(assistant->generateConceptDescription("Information"), "Back again");
+    EXPECT_FALSE(assistant->isCircuitOpen());
+}
+
+TEST_F(AIAssistantTest, RateLimitSpacesRequests) {
+    assistant->setRateLimit(20.0, 1);
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("ok"); });
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    int completed = 0;
+    for (int i = 0; i < 3; ++i) {
+        assistant->generateConceptDescriptionAsync("Concept " + std::to_string(i), [&](const std::string&) { ++completed; });
+    }
+    ASSERT_TRUE(waitUntil([&]() { return completed == 3; }));
+
+    // One token up front, then one every 50 ms
+    EXPECT_GE(elapsed.elapsed(), 90);
+}
+
+TEST_F(AIAssistantTest, LatencyIsRecorded) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("ok", 30); });
+    assistant->generateConceptDescription("Entropy");
+
+    auto latency = assistant->getLatencyStats();
+    EXPECT_EQ(latency.samples, 1u);
+    EXPECT_GE(latency.p50, 25.0);
+}
+
+TEST_F(AIAssistantTest, StreamedTokensArriveBeforeCompletion) {
+    server.setHandler([](const QJsonObject& request) {
+        EXPECT_TRUE(request["stream"].toBool());
+        return MockResponse::stream({"Both ", "describe ", "disorder."}, 10, 20);
+    });
+    Concept entropy("Entropy");
+    Concept chaos("Chaos");
+
+    std::vector<std::string> tokens;
+    std::string complete;
+    size_t tokensAtCompletion = 0;
+    assistant->explainConnectionStreaming(entropy, chaos,
+        [&](const std::string& token) { tokens.push_back(token); },
+        [&](const std::string& text) { complete = text; tokensAtCompletion = tokens.size(); });
+    ASSERT_TRUE(waitUntil([&]() { return !complete.empty(); }));
+
+    EXPECT_EQ(tokens, (std::vector<std::string>{"Both ", "describe ", "disorder."}));
+    EXPECT_EQ(tokensAtCompletion, 3u);
+    EXPECT_EQ(complete, "Both describe disorder.");
+}
+
+TEST_F(AIAssistantTest, StreamedAnswerIsCached) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::stream({"Streamed ", "answer"}, 0, 5); });
+    Concept entropy("Entropy");
+    Concept chaos("Chaos");
+
+    std::string complete;
+    assistant->explainConnectionStreaming(entropy, chaos, [](const std::string&) {},
+                                          [&](const std::string& text) { complete = text; });
+    ASSERT_TRUE(waitUntil([&]() { return !complete.empty(); }));
+
+    // The unstreamed call and a repeated stream are both answered from the cache
+    EXPECT_EQ(assistant->explainConnection(chaos, entropy), "Streamed answer");
+    std::vector<std::string> tokens;
+    EXPECT_EQ(assistant->explainConnectionStreaming(entropy, chaos,
+        [&](const std::string& token) { tokens.push_back(token); }, [](const std::string&) {}), 0u);
+    EXPECT_EQ(tokens, std::vector<std::string>{"Streamed answer"});
+    EXPECT_EQ(server.requestCount(), 1);
+}
+
+TEST_F(AIAssistantTest, StreamingReportsTimeToFirstToken) {
+    // A slow generation: the first token after 30 ms, the rest over the next 400 ms
+    QStringList words;
+    for (int i = 0; i < 8; ++i) {
+        words << QString("word%1 ").arg(i);
+    }
+    server.setHandler([&](const QJsonObject&) { return MockResponse::stream(words, 30, 50); });
+    Concept entropy("Entropy");
+    Concept chaos("Chaos");
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    qint64 firstToken = -1;
+    qint64 total = -1;
+    assistant->explainConnectionStreaming(entropy, chaos,
+        [&](const std::string&) { if (firstToken < 0) firstToken = elapsed.elapsed(); },
+        [&](const std::string&) { total = elapsed.elapsed(); });
+    ASSERT_TRUE(waitUntil([&]() { return total >= 0; }));
+
+    auto stats = assistant->getFirstTokenLatencyStats();
+    ASSERT_EQ(stats.samples, 1u);
+    ASSERT_GE(firstToken, 0);
+    EXPECT_LT(firstToken, total / 2);
+    EXPECT_LE(stats.p50, static_cast<double>(firstToken));
+    RecordProperty("time_to_first_token_ms", static_cast<int>(firstToken));
+    RecordProperty("total_time_ms", static_cast<int>(total));
+}
+
+TEST_F(AIAssistantTest, FailedStreamFallsBack) {
+    server.setHandler([](const QJsonObject&) { return MockResponse{500, "{}", 0}; });
+    Concept entropy("Entropy");
+    Concept chaos("Chaos");
+
+    std::vector<std::string> tokens;
+    std::string complete;
+    assistant->explainConnectionStreaming(entropy, chaos,
+        [&](const std::string& token) { tokens.push_back(token); },
+        [&](const std::string& text) { complete = text; });
+    ASSERT_TRUE(waitUntil([&]() { return !complete.empty(); }));
+
+    // The fallback text arrives as the only token
+    ASSERT_EQ(tokens.size(), 1u);
+    EXPECT_EQ(tokens[0], complete);
+}
+
+TEST_F(AIAssistantTest, PrefetchedExplanationIsInstant) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Prefetched"); });
+    Concept entropy("Entropy");
+    Concept chaos("Chaos");
+
+    EXPECT_NE(assistant->prefetchExplanation(entropy, chaos), 0u);
+    ASSERT_TRUE(waitUntil([&]() { return assistant->getPendingRequestCount() == 0; }));
+
+    std::string result;
+    assistant->explainConnectionAsync(chaos, entropy, [&](const std::string& text) { result = text; });
+    EXPECT_EQ(result, "Prefetched");
+    EXPECT_EQ(server.requestCount(), 1);
+
+    // Nothing left to fetch
+    EXPECT_EQ(assistant->prefetchExplanation(entropy, chaos), 0u);
+}
+
+TEST_F(AIAssistantTest, PrefetchesUseHalfTheSlots) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("ok", 50); });
+    std::vector<Concept> concepts;
+    for (int i = 0; i < 5; ++i) {
+        concepts.emplace_back("Concept " + std::to_string(i));
+    }
+    for (int i = 1; i < 5; ++i) {
+        assistant->prefetchExplanation(concepts[0], concepts[i]);
+    }
+    ASSERT_TRUE(waitUntil([&]() { return assistant->getPendingRequestCount() == 0; }));
+
+    EXPECT_EQ(server.requestCount(), 4);
+    EXPECT_EQ(server.peakConcurrentRequests(), 2);
+}
+
+TEST_F(AIAssistantTest, PrefetchesWaitBehindOtherRequests) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("ok", 20); });
+    assistant->setMaxConcurrentRequests(1);
+    Concept entropy("Entropy");
+    Concept chaos("Chaos");
+
+    assistant->prefetchExplanation(entropy, chaos);
+    // The prefetch took the only slot; both descriptions still go before the next prefetch
+    Concept order("Order");
+    assistant->prefetchExplanation(entropy, order);
+    int completed = 0;
+    assistant->generateConceptDescriptionAsync("Entropy", [&](const std::string&) { ++completed; });
+    assistant->generateConceptDescriptionAsync("Chaos", [&](const std::string&) { ++completed; });
+    ASSERT_TRUE(waitUntil([&]() { return assistant->getPendingRequestCount() == 0; }));
+
+    ASSERT_EQ(server.requests.size(), 4);
+    EXPECT_TRUE(server.requests[1]["message"].toString().contains("Entropy"));
+    EXPECT_FALSE(server.requests[1]["message"].toString().contains("Chaos"));
+    EXPECT_TRUE(server.requests[3]["message"].toString().contains("Order"));
+    EXPECT_EQ(completed, 2);
+}
+
+TEST_F(AIAssistantTest, RequestJoinsQueuedPrefetch) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("Shared", 20); });
+    assistant->setMaxConcurrentRequests(2);
+    Concept entropy("Entropy");
+    Concept chaos("Chaos");
+    Concept order("Order");
+
+    // The first prefetch fills the background share, the second stays queued
+    assistant->prefetchExplanation(entropy, order);
+    assistant->prefetchExplanation(entropy, chaos);
+
+    std::string result;
+    assistant->explainConnectionAsync(entropy, chaos, [&](const std::string& text) { result = text; });
+    // Promoted into the free foreground slot at once
+    EXPECT_EQ(assistant->getPendingRequestCount(), 2u);
+    ASSERT_TRUE(waitUntil([&]() { return !result.empty(); }));
+
+    EXPECT_EQ(result, "Shared");
+    ASSERT_TRUE(waitUntil([&]() { return assistant->getPendingRequestCount() == 0; }));
+    EXPECT_EQ(server.requestCount(), 2);
+}
+
+TEST_F(AIAssistantTest, PrefetcherCancelsWhenTheListChanges) {
+    server.setHandler([](const QJsonObject&) { return MockResponse::text("ok", 30); });
+    assistant->setMaxConcurrentRequests(2);
+    std::vector<Concept> concepts;
+    for (int i = 0; i < 6; ++i) {
+        concepts.emplace_back("Concept " + std::to_string(i));
+    }
+
+    ExplanationPrefetcher prefetcher(assistant.get());
+    prefetcher.prefetch({{&concepts[0], &concepts[1]}, {&concepts[0], &concepts[2]}, {&concepts[0], &concepts[3]}});
+    // The first is already in flight and still wanted; the other two were queued and are dropped
+    prefetcher.prefetch({{&concepts[0], &concepts[1]}, {&concepts[0], &concepts[4]}});
+    ASSERT_TRUE(waitUntil([&]() { return assistant->getPendingRequestCount() == 0; }));
+
+    EXPECT_EQ(server.requestCount(), 2);
+    for (const QJsonObject& request : server.requests) {
+        EXPECT_FALSE(request["message"].toString().contains("Concept 2"));
+        EXPECT_FALSE(request["message"].toString().contains("Concept 3"));
+    }
+}
+
+TEST_F(AIAssistantTest, OfflineExplanationComesFromTheGraph) {
+    MentalModel model("Test Model");
+    auto entropy = std::make_unique<Concept>("Entropy");
+    auto disorder = std::make_unique<Concept>("Disorder");
+    const Concept* first = entropy.get();
+    const Concept* second = disorder.get();
+    model.addConcept(std::move(entropy));
+    model.addConcept(std::move(disorder));
+    model.addRelationship(std::make_unique<Relationship>(first->getId(), second->getId(), "measures", true));
+
+    assistant->setModel(&model);
+    assistant->setApiKey(QString());
+    EXPECT_EQ(assistant->explainConnection(*second, *first), "In your model, Entropy measures Disorder.");
+    EXPECT_EQ(server.requestCount(), 0);
+}
+
+TEST_F(AIAssistantTest, FailedRequestFallsBackToTheGraph) {
+    server.setHandler([](const QJsonObject&) { return MockResponse{500, "{}", 0}; });
+    MentalModel model("Test Model");
+    auto entropy = std::make_unique<Concept>("Entropy");
+    auto information = std::make_unique<Concept>("Information");
+    entropy->addTag("information theory");
+    information->addTag("information theory");
+    const Concept* first = entropy.get();
+    const Concept* second = information.get();
+    model.addConcept(std::move(entropy));
+    model.addConcept(std::move(information));
+
+    assistant->setModel(&model);
+    std::string local = assistant->explainConnectionLocally(*first, *second);
+    EXPECT_NE(local.find("Both are tagged information theory."), std::string::npos);
+    EXPECT_EQ(assistant->explainConnection(*first, *second), local);
+    EXPECT_EQ(server.requestCount(), 1);
+}
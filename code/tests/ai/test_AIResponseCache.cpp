@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "../../core/ai/AIResponseCache.h"
+
+using namespace qlink;
+
+class AIResponseCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        cache.setClock([this]() { return now; });
+    }
+
+    void advance(std::chrono::milliseconds elapsed) { now += elapsed; }
+
+    AIResponseCache::Clock::time_point now{};
+    AIResponseCache cache{1024 * 1024, std::chrono::seconds(60), std::chrono::seconds(5)};
+};
+
+TEST_F(AIResponseCacheTest, StoresAndFinds) {
+    cache.store("key", "value");
+
+    std::string value;
+    EXPECT_TRUE(cache.find("key", value));
+    EXPECT_EQ(value, "value");
+    EXPECT_FALSE(cache.find("missing", value));
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.entries, 1u);
+}
+
+TEST_F(AIResponseCacheTest, TracksBytes) {
+    cache.store("key", std::string(100, 'x'));
+    size_t withOne = cache.getByteSize();
+    EXPECT_GE(withOne, 100u);
+
+    cache.store("key", std::string(10, 'x'));
+    EXPECT_EQ(cache.getByteSize(), withOne - 90);
+
+    cache.clear();
+    EXPECT_EQ(cache.getByteSize(), 0u);
+}
+
+TEST_F(AIResponseCacheTest, EvictsLeastRecentlyUsedOverBudget) {
+    cache.store("a", std::string(100, 'a'));
+    size_t entryBytes = cache.getByteSize();
+    cache.setMaxBytes(entryBytes * 2);
+    cache.store("b", std::string(100, 'b'));
+
+    // Touch "a" so "b" is the oldest
+    std::string value;
+    cache.find("a", value);
+    cache.store("c", std::string(100, 'c'));
+
+    EXPECT_TRUE(cache.find("a", value));
+    EXPECT_FALSE(cache.find("b", value));
+    EXPECT_TRUE(cache.find("c", value));
+    EXPECT_EQ(cache.getStats().evictions, 1u);
+    EXPECT_LE(cache.getByteSize(), cache.getMaxBytes());
+}
+
+TEST_F(AIResponseCacheTest, EntriesExpire) {
+    cache.store("key", "value");
+    advance(std::chrono::seconds(59));
+
+    std::string value;
+    EXPECT_TRUE(cache.find("key", value));
+
+    advance(std::chrono::seconds(1));
+    EXPECT_FALSE(cache.find("key", value));
+    EXPECT_EQ(cache.getStats().expirations, 1u);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(AIResponseCacheTest, NegativeEntriesExpireSooner) {
+    cache.store("good", "answer");
+    cache.store("failed", "fallback", true);
+    advance(std::chrono::seconds(5));
+
+    std::string value;
+    EXPECT_FALSE(cache.find("failed", value));
+    EXPECT_TRUE(cache.find("good", value));
+}
+
+TEST_F(AIResponseCacheTest, ZeroNegativeTtlSkipsFailures) {
+    cache.setNegativeTtl(std::chrono::milliseconds(0));
+    cache.store("failed", "fallback", true);
+
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(AIResponseCacheTest, ConnectionKeyIsOrderIndependent) {
+    EXPECT_EQ(AIResponseCache::connectionKey("A", "B"), AIResponseCache::connectionKey("B", "A"));
+    EXPECT_NE(AIResponseCache::connectionKey("A", "B"), AIResponseCache::connectionKey("A", "C"));
+    // Names may hold the separator
+    EXPECT_NE(AIResponseCache::connectionKey("A|B", "C"), AIResponseCache::connectionKey("A", "B|C"));
+    EXPECT_NE(AIResponseCache::connectionKey("1:A", "B"), AIResponseCache::connectionKey("1", "A|B"));
+}
+
+TEST_F(AIResponseCacheTest, ContainsDoesNotCountAsUse) {
+    cache.store("key", "value");
+
+    EXPECT_TRUE(cache.contains("key"));
+    EXPECT_FALSE(cache.contains("missing"));
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 0u);
+    EXPECT_EQ(stats.misses, 0u);
+
+    advance(std::chrono::seconds(61));
+    EXPECT_FALSE(cache.contains("key"));
+}
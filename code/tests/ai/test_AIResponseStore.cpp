@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include "../../core/ai/AIResponseStore.h"
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+
+using namespace qlink;
+
+class AIResponseStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(dir.isValid());
+        path = dir.filePath("responses.qlrs").toStdString();
+    }
+
+    qint64 fileSize() const { return QFileInfo(QString::fromStdString(path)).size(); }
+
+    QTemporaryDir dir;
+    std::string path;
+};
+
+TEST_F(AIResponseStoreTest, FindReturnsStoredResponse) {
+    AIResponseStore store(path);
+    store.put("key", "response");
+
+    std::string response;
+    EXPECT_TRUE(store.find("key", response));
+    EXPECT_EQ(response, "response");
+    EXPECT_FALSE(store.find("other", response));
+}
+
+TEST_F(AIResponseStoreTest, FileIsCreatedLazily) {
+    AIResponseStore store(path);
+    EXPECT_FALSE(QFile::exists(QString::fromStdString(path)));
+
+    std::string response;
+    store.find("key", response);
+    EXPECT_TRUE(QFile::exists(QString::fromStdString(path)));
+}
+
+TEST_F(AIResponseStoreTest, ResponsesSurviveReopen) {
+    {
+        AIResponseStore store(path);
+        store.put("first", "one");
+        store.put("second", "two");
+    }
+
+    AIResponseStore reopened(path);
+    std::string response;
+    ASSERT_TRUE(reopened.find("second", response));
+    EXPECT_EQ(response, "two");
+    ASSERT_TRUE(reopened.find("first", response));
+    EXPECT_EQ(response, "one");
+    EXPECT_EQ(reopened.size(), 2u);
+}
+
+TEST_F(AIResponseStoreTest, LaterPutReplacesEarlier) {
+    {
+        AIResponseStore store(path);
+        store.put("key", "old");
+        store.put("key", "new");
+        EXPECT_EQ(store.size(), 1u);
+        EXPECT_GT(store.getDeadBytes(), 0u);
+    }
+
+    AIResponseStore reopened(path);
+    std::string response;
+    ASSERT_TRUE(reopened.find("key", response));
+    EXPECT_EQ(response, "new");
+}
+
+TEST_F(AIResponseStoreTest, KeyIncludesModelAndNormalizesWhitespace) {
+    EXPECT_EQ(AIResponseStore::makeKey("model-a", "  Explain\n\n  entropy  "),
+              AIResponseStore::makeKey("model-a", "Explain entropy"));
+    EXPECT_NE(AIResponseStore::makeKey("model-a", "Explain entropy"),
+              AIResponseStore::makeKey("model-b", "Explain entropy"));
+}
+
+TEST_F(AIResponseStoreTest, TornTailIsTruncated) {
+    {
+        AIResponseStore store(path);
+        store.put("kept", "intact");
+        store.put("torn", "this record loses its last bytes");
+    }
+
+    // Simulate a crash halfway through the last append
+    QFile file(QString::fromStdString(path));
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.resize(file.size() - 10));
+    file.close();
+
+    AIResponseStore reopened(path);
+    std::string response;
+    ASSERT_TRUE(reopened.find("kept", response));
+    EXPECT_EQ(response, "intact");
+    EXPECT_FALSE(reopened.find("torn", response));
+
+    // New records go right after the last good one
+    reopened.put("after", "crash");
+    ASSERT_TRUE(reopened.find("after", response));
+    EXPECT_EQ(response, "crash");
+}
+
+TEST_F(AIResponseStoreTest, CorruptRecordEndsTheLog) {
+    {
+        AIResponseStore store(path);
+        store.put("kept", "intact");
+        store.put("corrupt", "flipped");
+    }
+
+    QFile file(QString::fromStdString(path));
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    file.seek(file.size() - 1);
+    file.write("X");
+    file.close();
+
+    AIResponseStore reopened(path);
+    std::string response;
+    EXPECT_TRUE(reopened.find("kept", response));
+    EXPECT_FALSE(reopened.find("corrupt", response));
+}
+
+TEST_F(AIResponseStoreTest, CompactDropsDeadRecords) {
+    AIResponseStore store(path);
+    for (int i = 0; i < 20; ++i) {
+        store.put("key", "version " + std::to_string(i));
+    }
+    store.put("other", "value");
+    qint64 before = fileSize();
+
+    store.compact();
+
+    EXPECT_LT(fileSize(), before);
+    EXPECT_EQ(store.getDeadBytes(), 0u);
+    std::string response;
+    ASSERT_TRUE(store.find("key", response));
+    EXPECT_EQ(response, "version 19");
+    ASSERT_TRUE(store.find("other", response));
+    EXPECT_EQ(response, "value");
+}
+
+TEST_F(AIResponseStoreTest, PutCompactsPastThreshold) {
+    AIResponseStore store(path);
+    store.setCompactionThreshold(0.5, 0);
+    for (int i = 0; i < 10; ++i) {
+        store.put("key", "version " + std::to_string(i));
+    }
+
+    EXPECT_EQ(store.size(), 1u);
+    EXPECT_LE(store.getDeadBytes(), static_cast<uint64_t>(fileSize()) / 2);
+}
+
+TEST_F(AIResponseStoreTest, SecondOwnerKeepsNothing) {
+    AIResponseStore owner(path);
+    owner.put("key", "response");
+
+    // The log is locked for as long as its owner has it open
+    {
+        AIResponseStore other(path);
+        std::string response;
+        EXPECT_FALSE(other.find("key", response));
+        EXPECT_NO_THROW(other.put("other", "response"));
+        EXPECT_FALSE(other.find("other", response));
+    }
+    std::string response;
+    EXPECT_TRUE(owner.find("key", response));
+
+    // Replacing the log while compacting does not give the lock up
+    owner.put("key", "newer");
+    owner.compact();
+    EXPECT_EQ(owner.getDeadBytes(), 0u);
+    AIResponseStore locked(path);
+    EXPECT_EQ(locked.size(), 0u);
+}
+
+TEST_F(AIResponseStoreTest, LockIsReleasedWithTheStore) {
+    {
+        AIResponseStore store(path);
+        store.put("key", "response");
+    }
+    AIResponseStore next(path);
+    std::string response;
+    EXPECT_TRUE(next.find("key", response));
+    EXPECT_NO_THROW(next.put("other", "response"));
+}
+
+TEST_F(AIResponseStoreTest, ClearRemovesFile) {
+    AIResponseStore store(path);
+    store.put("key", "response");
+    store.clear();
+
+    EXPECT_FALSE(QFile::exists(QString::fromStdString(path)));
+    std::string response;
+    EXPECT_FALSE(store.find("key", response));
+}
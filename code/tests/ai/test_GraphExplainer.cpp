@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "../../core/ai/GraphExplainer.h"
+#include "../../core/model/MentalModel.h"
+#include "../../core/model/Concept.h"
+#include "../../core/model/Relationship.h"
+#include <chrono>
+
+using namespace qlink;
+
+class GraphExplainerTest : public ::testing::Test {
+protected:
+    std::string add(const std::string& name, const std::vector<std::string>& tags = {}) {
+        auto concept = std::make_unique<Concept>(name);
+        for (const auto& tag : tags) {
+            concept->addTag(tag);
+        }
+        std::string id = concept->getId();
+        model.addConcept(std::move(concept));
+        return id;
+    }
+
+    void link(const std::string& source, const std::string& target, const std::string& type, double weight = 1.0) {
+        model.addRelationship(std::make_unique<Relationship>(source, target, type, true, weight));
+    }
+
+    MentalModel model{"Test Model"};
+};
+
+TEST_F(GraphExplainerTest, DirectRelationship) {
+    std::string entropy = add("Entropy");
+    std::string disorder = add("Disorder");
+    link(entropy, disorder, "measures");
+
+    EXPECT_EQ(GraphExplainer::explain(model, disorder, entropy), "In your model, Entropy measures Disorder.");
+}
+
+TEST_F(GraphExplainerTest, PathListsRelationshipTypes) {
+    std::string entropy = add("Entropy");
+    std::string disorder = add("Disorder");
+    std::string chaos = add("Chaos");
+    std::string order = add("Order");
+    link(entropy, disorder, "measures");
+    link(chaos, disorder, "part_of");
+    link(order, chaos, "");
+
+    GraphExplainer::Evidence evidence;
+    ASSERT_TRUE(GraphExplainer::gather(model, entropy, order, evidence));
+    EXPECT_EQ(evidence.path, (std::vector<std::string>{"Entropy", "Disorder", "Chaos", "Order"}));
+    ASSERT_EQ(evidence.steps.size(), 3u);
+    EXPECT_EQ(evidence.steps[1].source, "Chaos");
+    EXPECT_EQ(evidence.steps[1].type, "part_of");
+
+    EXPECT_EQ(GraphExplainer::describe("Entropy", "Order", evidence),
+              "In your model, Entropy and Order are linked through Disorder and Chaos: "
+              "Entropy measures Disorder, Chaos part of Disorder, and Order is related to Chaos.");
+}
+
+TEST_F(GraphExplainerTest, SharedNeighborsAndTags) {
+    std::string entropy = add("Entropy", {"physics", "information"});
+    std::string information = add("Information", {"information", "computing"});
+    std::string bits = add("Bits");
+    std::string probability = add("Probability");
+    link(entropy, bits, "measured_in");
+    link(information, bits, "measured_in");
+    link(entropy, probability, "uses");
+    link(information, probability, "uses");
+
+    GraphExplainer::Evidence evidence;
+    ASSERT_TRUE(GraphExplainer::gather(model, entropy, information, evidence));
+    EXPECT_EQ(evidence.sharedNeighbors, (std::vector<std::string>{"Bits", "Probability"}));
+    EXPECT_EQ(evidence.sharedTags, std::vector<std::string>{"information"});
+
+    std::string text = GraphExplainer::describe("Entropy", "Information", evidence);
+    EXPECT_NE(text.find("Both are connected to Bits and Probability."), std::string::npos);
+    EXPECT_NE(text.find("Both are tagged information."), std::string::npos);
+}
+
+TEST_F(GraphExplainerTest, LongListsAreCut) {
+    std::string hub1 = add("Hub 1");
+    std::string hub2 = add("Hub 2");
+    for (int i = 0; i < 5; ++i) {
+        std::string spoke = add("Spoke " + std::to_string(i));
+        link(hub1, spoke, "");
+        link(hub2, spoke, "");
+    }
+
+    std::string text = GraphExplainer::explain(model, hub1, hub2);
+    EXPECT_NE(text.find("Spoke 0, Spoke 1, Spoke 2 and 2 more"), std::string::npos);
+}
+
+TEST_F(GraphExplainerTest, UnconnectedConcepts) {
+    std::string entropy = add("Entropy");
+    std::string poetry = add("Poetry");
+
+    std::string text = GraphExplainer::explain(model, entropy, poetry);
+    EXPECT_EQ(text.rfind("Entropy and Poetry are not connected in your model yet.", 0), 0u);
+}
+
+TEST_F(GraphExplainerTest, MissingConceptGivesNothing) {
+    std::string entropy = add("Entropy");
+    EXPECT_TRUE(GraphExplainer::explain(model, entropy, "missing").empty());
+}
+
+TEST_F(GraphExplainerTest, IsFastOnALargerGraph) {
+    // A 2000-concept chain with cross links; the explanation must still be effectively instant
+    std::vector<std::string> ids;
+    for (int i = 0; i < 2000; ++i) {
+        ids.push_back(add("Concept " + std::to_string(i)));
+        if (i > 0) link(ids[i - 1], ids[i], "next");
+        if (i >= 10) link(ids[i - 10], ids[i], "skip");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::string text = GraphExplainer::explain(model, ids.front(), ids[55]);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    EXPECT_NE(text.find("linked through"), std::string::npos);
+    RecordProperty("explain_us", static_cast<int>(elapsed.count()));
+    EXPECT_LT(elapsed.count(), 50000);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "../../core/model/MentalModel.h"
+#include "../../core/model/Concept.h"
+#include "../../core/model/Relationship.h"
+#include "../../core/ai/GraphSnapshot.h"
+
+using namespace qlink;
+
+class GraphSnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        model = std::make_unique<MentalModel>("Test Model");
+        aId = addConcept("A");
+        bId = addConcept("B");
+        cId = addConcept("C");
+        dId = addConcept("D");
+    }
+
+    std::string addConcept(const std::string& name) {
+        auto concept = std::make_unique<Concept>(name);
+        std::string id = concept->getId();
+        model->addConcept(std::move(concept));
+        return id;
+    }
+
+    void connect(const std::string& sourceId, const std::string& targetId,
+                 const std::string& type = "", bool directed = false, double weight = 1.0) {
+        model->addRelationship(std::make_unique<Relationship>(sourceId, targetId, type, directed, weight));
+    }
+
+    std::unique_ptr<MentalModel> model;
+    std::string aId, bId, cId, dId;
+};
+
+TEST_F(GraphSnapshotTest, VerticesFollowModelOrder) {
+    auto snapshot = GraphSnapshot::fromModel(*model);
+    ASSERT_EQ(snapshot->vertexCount(), 4);
+    EXPECT_EQ(snapshot->conceptId(0), aId);
+    EXPECT_EQ(snapshot->conceptId(3), dId);
+    EXPECT_EQ(snapshot->getModelVersion(), model->getVersion());
+}
+
+TEST_F(GraphSnapshotTest, EdgesAreUndirectedAndSorted) {
+    connect(aId, cId);
+    connect(bId, aId);
+
+    auto snapshot = GraphSnapshot::fromModel(*model);
+    ASSERT_EQ(snapshot->degree(0), 2);
+    EXPECT_EQ(snapshot->neighborsBegin(0)[0], 1);
+    EXPECT_EQ(snapshot->neighborsBegin(0)[1], 2);
+    EXPECT_TRUE(snapshot->areAdjacent(1, 0));
+    EXPECT_TRUE(snapshot->areAdjacent(2, 0));
+    EXPECT_FALSE(snapshot->areAdjacent(1, 2));
+    EXPECT_EQ(snapshot->degree(3), 0);
+}
+
+TEST_F(GraphSnapshotTest, ParallelEdgesAreCollapsed) {
+    connect(aId, bId);
+    connect(bId, aId);
+
+    auto snapshot = GraphSnapshot::fromModel(*model);
+    EXPECT_EQ(snapshot->degree(0), 1);
+    EXPECT_EQ(snapshot->degree(1), 1);
+}
+
+TEST_F(GraphSnapshotTest, SnapshotIsUnaffectedByLaterChanges) {
+    auto snapshot = GraphSnapshot::fromModel(*model);
+    connect(aId, bId);
+    addConcept("E");
+
+    EXPECT_EQ(snapshot->vertexCount(), 4);
+    EXPECT_EQ(snapshot->degree(0), 0);
+    EXPECT_NE(snapshot->getModelVersion(), model->getVersion());
+}
+
+TEST_F(GraphSnapshotTest, WeightsAreStoredAlongsideNeighbors) {
+    connect(aId, bId, "", false, 0.25);
+    connect(aId, cId, "", false, 2.0);
+
+    auto snapshot = GraphSnapshot::fromModel(*model);
+    EXPECT_DOUBLE_EQ(snapshot->weightsBegin(0)[0], 0.25);
+    EXPECT_DOUBLE_EQ(snapshot->weightsBegin(0)[1], 2.0);
+    EXPECT_DOUBLE_EQ(snapshot->strength(0), 2.25);
+    EXPECT_DOUBLE_EQ(snapshot->strength(1), 0.25);
+}
+
+TEST_F(GraphSnapshotTest, ParallelEdgeWeightsAreAdded) {
+    connect(aId, bId, "", false, 0.5);
+    connect(bId, aId, "", false, 0.25);
+
+    auto snapshot = GraphSnapshot::fromModel(*model);
+    ASSERT_EQ(snapshot->degree(0), 1);
+    EXPECT_DOUBLE_EQ(snapshot->weightsBegin(0)[0], 0.75);
+}
+
+TEST_F(GraphSnapshotTest, DirectedRelationshipsOnlyGoForward) {
+    connect(aId, bId, "requires", true);
+    connect(bId, cId);
+
+    auto snapshot = GraphSnapshot::fromModel(*model);
+    EXPECT_EQ(snapshot->outDegree(0), 1);
+    EXPECT_EQ(snapshot->inDegree(0), 0);
+    EXPECT_EQ(snapshot->inDegree(1), 2);  // From A, and from C (undirected)
+    EXPECT_EQ(snapshot->outDegree(1), 1); // Only to C
+    EXPECT_EQ(snapshot->outNeighborsBegin(1)[0], 2);
+
+    // The undirected view still sees both
+    EXPECT_EQ(snapshot->degree(1), 2);
+}
+
+TEST_F(GraphSnapshotTest, RelationshipTypeFilter) {
+    connect(aId, bId, "requires");
+    connect(aId, cId, "contradicts");
+
+    auto snapshot = GraphSnapshot::fromModel(*model, {"requires"});
+    EXPECT_TRUE(snapshot->areAdjacent(0, 1));
+    EXPECT_FALSE(snapshot->areAdjacent(0, 2));
+}
+
+TEST(TopKPairsTest, KeepsBestPairs) {
+    TopKPairs top(2);
+    EXPECT_TRUE(top.offer(1.0, 0, 1));
+    EXPECT_TRUE(top.offer(3.0, 0, 2));
+    EXPECT_TRUE(top.offer(2.0, 1, 2));
+    EXPECT_FALSE(top.offer(0.5, 1, 3));
+
+    auto pairs = top.sorted();
+    ASSERT_EQ(pairs.size(), 2u);
+    EXPECT_DOUBLE_EQ(pairs[0].score, 3.0);
+    EXPECT_DOUBLE_EQ(pairs[1].score, 2.0);
+    EXPECT_DOUBLE_EQ(top.threshold(), 2.0);
+}
+
+TEST(TopKPairsTest, TiesAreBrokenByVertexOrder) {
+    // Merging in either order must give the same answer
+    TopKPairs first(1), second(1);
+    first.offer(1.0, 2, 3);
+    second.offer(1.0, 0, 1);
+
+    TopKPairs forward(1), backward(1);
+    forward.merge(first);
+    forward.merge(second);
+    backward.merge(second);
+    backward.merge(first);
+
+    EXPECT_EQ(forward.sorted()[0].source, 0);
+    EXPECT_EQ(backward.sorted()[0].source, 0);
+}
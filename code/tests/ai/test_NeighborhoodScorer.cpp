@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "../../core/model/MentalModel.h"
+#include "../../core/model/Concept.h"
+#include "../../core/model/Relationship.h"
+#include "../../core/ai/NeighborhoodScorer.h"
+#include "../../core/ai/NeighborhoodPredictor.h"
+
+using namespace qlink;
+
+class NeighborhoodScorerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        model = std::make_unique<MentalModel>("Test Model");
+
+        // A and B share C and D; B also links to E
+        // Degrees: A=2, B=3, C=2, D=2, E=1
+        for (const char* name : {"A", "B", "C", "D", "E"}) {
+            auto concept = std::make_unique<Concept>(name);
+            ids.push_back(concept->getId());
+            model->addConcept(std::move(concept));
+        }
+        connect(A, C);
+        connect(A, D);
+        connect(B, C);
+        connect(B, D);
+        connect(B, E);
+        snapshot = GraphSnapshot::fromModel(*model);
+    }
+
+    void connect(int source, int target) {
+        model->addRelationship(std::make_unique<Relationship>(ids[source], ids[target]));
+    }
+
+    template <typename Metric>
+    double score(int source, int target) {
+        NeighborhoodScorer<Metric> scorer(*snapshot);
+        TopKPairs top(100);
+        scorer.scoreAll(top);
+        for (const auto& pair : top.sorted()) {
+            if (pair.source == std::min(source, target) && pair.target == std::max(source, target)) {
+                return pair.score;
+            }
+        }
+        return 0.0;
+    }
+
+    enum { A, B, C, D, E };
+    std::unique_ptr<MentalModel> model;
+    std::vector<std::string> ids;
+    std::shared_ptr<const GraphSnapshot> snapshot;
+};
+
+TEST_F(NeighborhoodScorerTest, CommonNeighborsCountsSharedNeighbors) {
+    EXPECT_DOUBLE_EQ(score<metrics::CommonNeighbors>(A, B), 2.0);
+    EXPECT_DOUBLE_EQ(score<metrics::CommonNeighbors>(C, D), 2.0);
+    EXPECT_DOUBLE_EQ(score<metrics::CommonNeighbors>(C, E), 1.0);
+}
+
+TEST_F(NeighborhoodScorerTest, PairsWithoutCommonNeighborAreNotScored) {
+    EXPECT_DOUBLE_EQ(score<metrics::CommonNeighbors>(A, E), 0.0);
+}
+
+TEST_F(NeighborhoodScorerTest, ConnectedPairsAreNotScored) {
+    EXPECT_DOUBLE_EQ(score<metrics::CommonNeighbors>(A, C), 0.0);
+    EXPECT_DOUBLE_EQ(score<metrics::CommonNeighbors>(B, E), 0.0);
+}
+
+TEST_F(NeighborhoodScorerTest, Jaccard) {
+    EXPECT_DOUBLE_EQ(score<metrics::Jaccard>(A, B), 2.0 / 3.0);
+}
+
+TEST_F(NeighborhoodScorerTest, AdamicAdar) {
+    EXPECT_DOUBLE_EQ(score<metrics::AdamicAdar>(A, B), 2.0 / std::log(2.0));
+    EXPECT_DOUBLE_EQ(score<metrics::AdamicAdar>(C, D), 1.0 / std::log(2.0) + 1.0 / std::log(3.0));
+}
+
+TEST_F(NeighborhoodScorerTest, ResourceAllocation) {
+    EXPECT_DOUBLE_EQ(score<metrics::ResourceAllocation>(A, B), 1.0);
+    EXPECT_DOUBLE_EQ(score<metrics::ResourceAllocation>(C, E), 1.0 / 3.0);
+}
+
+TEST_F(NeighborhoodScorerTest, Salton) {
+    EXPECT_DOUBLE_EQ(score<metrics::Salton>(A, B), 2.0 / std::sqrt(6.0));
+}
+
+TEST_F(NeighborhoodScorerTest, Sorensen) {
+    EXPECT_DOUBLE_EQ(score<metrics::Sorensen>(A, B), 4.0 / 5.0);
+}
+
+TEST_F(NeighborhoodScorerTest, HubPromoted) {
+    EXPECT_DOUBLE_EQ(score<metrics::HubPromoted>(A, B), 1.0);
+    EXPECT_DOUBLE_EQ(score<metrics::HubPromoted>(C, E), 1.0);
+}
+
+TEST_F(NeighborhoodScorerTest, PredictorAdapterUsesMetricName) {
+    NeighborhoodPredictor<metrics::AdamicAdar> predictor;
+    auto suggestions = predictor.predictLinks(*model, 10);
+
+    ASSERT_FALSE(suggestions.empty());
+    EXPECT_EQ(predictor.getAlgorithmName(), "Adamic-Adar");
+    EXPECT_EQ(suggestions[0].algorithmName, "Adamic-Adar");
+    EXPECT_DOUBLE_EQ(suggestions[0].confidence, 1.0);
+}
+
+TEST_F(NeighborhoodScorerTest, FactoryCreatesEveryAlgorithm) {
+    for (auto type : LinkPredictorFactory::getAvailableAlgorithms()) {
+        auto predictor = LinkPredictorFactory::createPredictor(type);
+        ASSERT_NE(predictor, nullptr);
+        EXPECT_EQ(predictor->getAlgorithmName(), LinkPredictorFactory::getAlgorithmName(type));
+        EXPECT_EQ(predictor->isNeighborhoodLocal(), LinkPredictorFactory::isNeighborhoodLocal(type));
+    }
+}
+
+TEST(NeighborhoodScorerFlavorTest, WeightedCommonNeighborsUsesWeights) {
+    MentalModel model("Weighted");
+    std::vector<std::string> ids;
+    for (const char* name : {"A", "B", "Strong", "Weak"}) {
+        auto concept = std::make_unique<Concept>(name);
+        ids.push_back(concept->getId());
+        model.addConcept(std::move(concept));
+    }
+    // A and B share a strong and a weak neighbour
+    model.addRelationship(std::make_unique<Relationship>(ids[0], ids[2], "requires", false, 1.0));
+    model.addRelationship(std::make_unique<Relationship>(ids[1], ids[2], "requires", false, 0.5));
+    model.addRelationship(std::make_unique<Relationship>(ids[0], ids[3], "contradicts", false, 0.1));
+    model.addRelationship(std::make_unique<Relationship>(ids[1], ids[3], "contradicts", false, 0.1));
+    auto snapshot = GraphSnapshot::fromModel(model);
+
+    auto scoreOfAB = [](const TopKPairs& top) {
+        for (const auto& pair : top.sorted()) {
+            if (pair.source == 0 && pair.target == 1) return pair.score;
+        }
+        return 0.0;
+    };
+
+    TopKPairs unweighted(10), weighted(10);
+    NeighborhoodScorer<metrics::CommonNeighbors>(*snapshot).scoreAll(unweighted);
+    NeighborhoodScorer<metrics::CommonNeighbors, true>(*snapshot).scoreAll(weighted);
+    EXPECT_DOUBLE_EQ(scoreOfAB(unweighted), 2.0);
+    EXPECT_DOUBLE_EQ(scoreOfAB(weighted), 0.75 + 0.1);
+
+    // Weighted Jaccard: shared weight over the combined strength
+    TopKPairs jaccard(10);
+    NeighborhoodScorer<metrics::Jaccard, true>(*snapshot).scoreAll(jaccard);
+    EXPECT_DOUBLE_EQ(scoreOfAB(jaccard), (0.75 + 0.1) / (1.1 + 0.6 - (0.75 + 0.1)));
+}
+
+TEST(NeighborhoodScorerFlavorTest, DirectedScoresFollowPaths) {
+    MentalModel model("Directed");
+    std::vector<std::string> ids;
+    for (const char* name : {"A", "B", "C"}) {
+        auto concept = std::make_unique<Concept>(name);
+        ids.push_back(concept->getId());
+        model.addConcept(std::move(concept));
+    }
+    // A -> B -> C, so only A -> C is suggested
+    model.addRelationship(std::make_unique<Relationship>(ids[0], ids[1], "leads_to", true));
+    model.addRelationship(std::make_unique<Relationship>(ids[1], ids[2], "leads_to", true));
+    auto snapshot = GraphSnapshot::fromModel(model);
+
+    TopKPairs top(10);
+    NeighborhoodScorer<metrics::CommonNeighbors, false, true>(*snapshot).scoreAll(top);
+
+    auto pairs = top.sorted();
+    ASSERT_EQ(pairs.size(), 1u);
+    EXPECT_EQ(pairs[0].source, 0);
+    EXPECT_EQ(pairs[0].target, 2);
+}
+
+TEST(NeighborhoodScorerFlavorTest, PredictorHonoursTypeFilter) {
+    MentalModel model("Filtered");
+    std::vector<std::string> ids;
+    for (const char* name : {"A", "B", "C"}) {
+        auto concept = std::make_unique<Concept>(name);
+        ids.push_back(concept->getId());
+        model.addConcept(std::move(concept));
+    }
+    model.addRelationship(std::make_unique<Relationship>(ids[0], ids[1], "requires", false, 1.0));
+    model.addRelationship(std::make_unique<Relationship>(ids[1], ids[2], "contradicts", false, 1.0));
+
+    NeighborhoodPredictor<metrics::CommonNeighbors> predictor;
+    EXPECT_EQ(predictor.predictLinks(model, 10).size(), 1u);
+
+    LinkPredictionOptions options;
+    options.relationshipTypes = {"requires"};
+    predictor.setOptions(options);
+    EXPECT_TRUE(predictor.predictLinks(model, 10).empty());
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "../../core/ai/PromptBatcher.h"
+
+using namespace qlink;
+
+TEST(PromptBatcherTest, EstimatesAboutFourCharactersPerToken) {
+    EXPECT_EQ(PromptBatcher::estimateTokens(""), 0);
+    EXPECT_EQ(PromptBatcher::estimateTokens("abcd"), 1);
+    EXPECT_EQ(PromptBatcher::estimateTokens("abcde"), 2);
+}
+
+TEST(PromptBatcherTest, PacksEverythingIntoOneBatchWhenItFits) {
+    PromptBatcher batcher;
+    auto batches = batcher.pack({"Entropy", "Information", "Energy"}, 100, 120);
+
+    ASSERT_EQ(batches.size(), 1u);
+    EXPECT_EQ(batches[0], (std::vector<size_t>{0, 1, 2}));
+}
+
+TEST(PromptBatcherTest, RespectsItemLimit) {
+    PromptBatcher::Limits limits;
+    limits.maxItems = 2;
+    PromptBatcher batcher(limits);
+
+    auto batches = batcher.pack({"a", "b", "c", "d", "e"}, 0, 1);
+
+    ASSERT_EQ(batches.size(), 3u);
+    EXPECT_EQ(batches[2], (std::vector<size_t>{4}));
+}
+
+TEST(PromptBatcherTest, RespectsOutputBudget) {
+    PromptBatcher::Limits limits;
+    limits.maxOutputTokens = 300;
+    PromptBatcher batcher(limits);
+
+    auto batches = batcher.pack({"a", "b", "c", "d", "e"}, 0, 100);
+
+    ASSERT_EQ(batches.size(), 2u);
+    EXPECT_EQ(batches[0].size(), 3u);
+    EXPECT_EQ(batches[1].size(), 2u);
+}
+
+TEST(PromptBatcherTest, RespectsPromptBudget) {
+    PromptBatcher::Limits limits;
+    limits.maxPromptTokens = 100;
+    PromptBatcher batcher(limits);
+    std::string item(160, 'x'); // 40 tokens plus numbering
+
+    auto batches = batcher.pack({item, item, item}, 10, 1);
+
+    ASSERT_EQ(batches.size(), 2u);
+    EXPECT_EQ(batches[0].size(), 2u);
+}
+
+TEST(PromptBatcherTest, OversizedItemGetsItsOwnBatch) {
+    PromptBatcher::Limits limits;
+    limits.maxPromptTokens = 50;
+    PromptBatcher batcher(limits);
+
+    auto batches = batcher.pack({"small", std::string(400, 'x'), "small"}, 0, 1);
+
+    ASSERT_EQ(batches.size(), 3u);
+    EXPECT_EQ(batches[1], (std::vector<size_t>{1}));
+}
+
+TEST(PromptBatcherTest, FormatsNumberedItems) {
+    std::string text = PromptBatcher::formatItems({"Entropy", "Information"});
+
+    EXPECT_NE(text.find("1. Entropy\n2. Information\n"), std::string::npos);
+    EXPECT_NE(text.find("JSON array"), std::string::npos);
+}
+
+TEST(PromptBatcherTest, ParsesJsonAnswers) {
+    auto answers = PromptBatcher::parseResponse(
+        "Here you go:\n```json\n[{\"id\": 1, \"text\": \"First\"}, {\"id\": \"2\", \"text\": \" Second \"}]\n```");
+
+    ASSERT_EQ(answers.size(), 2u);
+    EXPECT_EQ(answers[1], "First");
+    EXPECT_EQ(answers[2], "Second");
+}
+
+TEST(PromptBatcherTest, SkipsUnusableAnswers) {
+    auto answers = PromptBatcher::parseResponse("[{\"id\": 1, \"text\": \"\"}, {\"text\": \"no id\"}, {\"id\": 3, \"text\": \"ok\"}]");
+
+    ASSERT_EQ(answers.size(), 1u);
+    EXPECT_EQ(answers[3], "ok");
+    EXPECT_TRUE(PromptBatcher::parseResponse("not json at all").empty());
+    EXPECT_TRUE(PromptBatcher::parseResponse("[broken").empty());
+}
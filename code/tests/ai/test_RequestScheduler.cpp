@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "../../core/ai/RequestScheduler.h"
+
+using namespace qlink;
+using std::chrono::milliseconds;
+
+class RequestSchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config.requestsPerSecond = 10.0;
+        config.burst = 2;
+        config.maxRetries = 2;
+        config.baseBackoff = milliseconds(100);
+        config.maxBackoff = milliseconds(1000);
+        config.failureThreshold = 3;
+        config.openDuration = milliseconds(5000);
+        scheduler.setConfig(config);
+        scheduler.seed(42);
+    }
+
+    RequestScheduler::Admission admit() { return scheduler.admit(now, wait); }
+
+    bool finish(RequestScheduler::Outcome outcome, int attempt = 0) {
+        return scheduler.onFinished(now, outcome, milliseconds(10), attempt, milliseconds(0), retryDelay);
+    }
+
+    RequestScheduler::Config config;
+    RequestScheduler scheduler;
+    SchedulerClock::time_point now = SchedulerClock::time_point() + std::chrono::hours(1);
+    milliseconds wait{0};
+    milliseconds retryDelay{0};
+};
+
+TEST_F(RequestSchedulerTest, BurstThenWaitForRefill) {
+    EXPECT_EQ(admit(), RequestScheduler::Admission::SEND);
+    EXPECT_EQ(admit(), RequestScheduler::Admission::SEND);
+    EXPECT_EQ(admit(), RequestScheduler::Admission::WAIT);
+    EXPECT_EQ(wait, milliseconds(100));
+
+    now += milliseconds(100);
+    EXPECT_EQ(admit(), RequestScheduler::Admission::SEND);
+}
+
+TEST_F(RequestSchedulerTest, BucketNeverExceedsBurst) {
+    admit();
+    admit();
+    now += std::chrono::seconds(60);
+
+    EXPECT_EQ(admit(), RequestScheduler::Admission::SEND);
+    EXPECT_EQ(admit(), RequestScheduler::Admission::SEND);
+    EXPECT_EQ(admit(), RequestScheduler::Admission::WAIT);
+}
+
+TEST_F(RequestSchedulerTest, RetriesServerErrorsAndRateLimits) {
+    EXPECT_TRUE(finish(RequestScheduler::Outcome::SERVER_ERROR));
+    EXPECT_TRUE(finish(RequestScheduler::Outcome::RATE_LIMITED));
+    EXPECT_FALSE(finish(RequestScheduler::Outcome::CLIENT_ERROR));
+    EXPECT_FALSE(finish(RequestScheduler::Outcome::NETWORK_ERROR));
+    EXPECT_FALSE(finish(RequestScheduler::Outcome::SUCCESS));
+}
+
+TEST_F(RequestSchedulerTest, StopsRetryingAtTheLimit) {
+    EXPECT_TRUE(finish(RequestScheduler::Outcome::RATE_LIMITED, 1));
+    EXPECT_FALSE(finish(RequestScheduler::Outcome::RATE_LIMITED, 2));
+}
+
+TEST_F(RequestSchedulerTest, BackoffGrowsWithinJitterBounds) {
+    for (int attempt = 0; attempt < 8; ++attempt) {
+        int64_t ceiling = std::min<int64_t>(100LL << attempt, 1000);
+        for (int i = 0; i < 50; ++i) {
+            milliseconds delay = scheduler.backoffDelay(attempt);
+            EXPECT_GE(delay.count(), 0);
+            EXPECT_LE(delay.count(), ceiling);
+        }
+    }
+}
+
+TEST_F(RequestSchedulerTest, RetryAfterIsAFloor) {
+    ASSERT_TRUE(scheduler.onFinished(now, RequestScheduler::Outcome::RATE_LIMITED, milliseconds(10), 0,
+                                     milliseconds(3000), retryDelay));
+    EXPECT_EQ(retryDelay, milliseconds(3000));
+}
+
+TEST_F(RequestSchedulerTest, CircuitOpensAfterConsecutiveFailures) {
+    finish(RequestScheduler::Outcome::NETWORK_ERROR);
+    finish(RequestScheduler::Outcome::SUCCESS);
+    finish(RequestScheduler::Outcome::NETWORK_ERROR);
+    finish(RequestScheduler::Outcome::NETWORK_ERROR);
+    EXPECT_EQ(scheduler.getCircuitState(now), CircuitBreaker::State::CLOSED);
+
+    // The failure that opens the circuit is not retried
+    EXPECT_FALSE(finish(RequestScheduler::Outcome::SERVER_ERROR));
+    EXPECT_EQ(scheduler.getCircuitState(now), CircuitBreaker::State::OPEN);
+    EXPECT_EQ(admit(), RequestScheduler::Admission::FAIL_FAST);
+}
+
+TEST_F(RequestSchedulerTest, HalfOpenLetsOneProbeThrough) {
+    for (int i = 0; i < 3; ++i) finish(RequestScheduler::Outcome::NETWORK_ERROR);
+    now += milliseconds(5000);
+    EXPECT_EQ(scheduler.getCircuitState(now), CircuitBreaker::State::HALF_OPEN);
+
+    EXPECT_EQ(admit(), RequestScheduler::Admission::SEND);
+    EXPECT_EQ(admit(), RequestScheduler::Admission::HOLD);
+
+    finish(RequestScheduler::Outcome::SUCCESS);
+    EXPECT_EQ(scheduler.getCircuitState(now), CircuitBreaker::State::CLOSED);
+    EXPECT_EQ(admit(), RequestScheduler::Admission::SEND);
+}
+
+TEST_F(RequestSchedulerTest, FailedProbeReopens) {
+    for (int i = 0; i < 3; ++i) finish(RequestScheduler::Outcome::NETWORK_ERROR);
+    now += milliseconds(5000);
+    ASSERT_EQ(admit(), RequestScheduler::Admission::SEND);
+
+    finish(RequestScheduler::Outcome::NETWORK_ERROR);
+    EXPECT_EQ(scheduler.getCircuitState(now), CircuitBreaker::State::OPEN);
+    now += milliseconds(4999);
+    EXPECT_EQ(admit(), RequestScheduler::Admission::FAIL_FAST);
+}
+
+TEST_F(RequestSchedulerTest, AbandonedProbeFreesTheSlot) {
+    for (int i = 0; i < 3; ++i) finish(RequestScheduler::Outcome::NETWORK_ERROR);
+    now += milliseconds(5000);
+    ASSERT_EQ(admit(), RequestScheduler::Admission::SEND);
+
+    scheduler.onAbandoned();
+    now += milliseconds(100);
+    EXPECT_EQ(admit(), RequestScheduler::Admission::SEND);
+}
+
+TEST(LatencyTrackerTest, ReportsNearestRankPercentiles) {
+    LatencyTracker tracker;
+    for (int i = 1; i <= 100; ++i) {
+        tracker.record(milliseconds(i));
+    }
+
+    auto percentiles = tracker.getPercentiles();
+    EXPECT_EQ(percentiles.samples, 100u);
+    EXPECT_DOUBLE_EQ(percentiles.p50, 50.0);
+    EXPECT_DOUBLE_EQ(percentiles.p90, 90.0);
+    EXPECT_DOUBLE_EQ(percentiles.p99, 99.0);
+    EXPECT_DOUBLE_EQ(percentiles.max, 100.0);
+}
+
+TEST(LatencyTrackerTest, KeepsOnlyTheWindow) {
+    LatencyTracker tracker(4);
+    for (int i = 1; i <= 10; ++i) {
+        tracker.record(milliseconds(i * 10));
+    }
+
+    auto percentiles = tracker.getPercentiles();
+    EXPECT_EQ(percentiles.samples, 4u);
+    EXPECT_DOUBLE_EQ(percentiles.max, 100.0);
+    EXPECT_DOUBLE_EQ(percentiles.p50, 80.0);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "../../core/ai/StreamParser.h"
+#include <string>
+#include <vector>
+
+using namespace qlink;
+
+class StreamParserTest : public ::testing::Test {
+protected:
+    StreamParser parser{[this](const std::string& token) { tokens.push_back(token); }};
+    std::vector<std::string> tokens;
+};
+
+TEST_F(StreamParserTest, ParsesCohereEvents) {
+    parser.feed("{\"event_type\":\"stream-start\"}\n"
+                "{\"event_type\":\"text-generation\",\"text\":\"Hello\"}\n"
+                "{\"event_type\":\"text-generation\",\"text\":\" world\"}\n"
+                "{\"event_type\":\"stream-end\",\"finish_reason\":\"COMPLETE\"}\n");
+
+    EXPECT_EQ(tokens, (std::vector<std::string>{"Hello", " world"}));
+    EXPECT_EQ(parser.getText(), "Hello world");
+    EXPECT_TRUE(parser.isComplete());
+}
+
+TEST_F(StreamParserTest, LinesSplitAcrossChunksAreJoined) {
+    std::string body = "{\"event_type\":\"text-generation\",\"text\":\"Split\"}\n"
+                       "{\"event_type\":\"text-generation\",\"text\":\" token\"}\n";
+    // Feed one byte at a time, the worst case the network can produce
+    for (char c : body) {
+        parser.feed(&c, 1);
+    }
+
+    EXPECT_EQ(tokens, (std::vector<std::string>{"Split", " token"}));
+    EXPECT_FALSE(parser.isComplete());
+}
+
+TEST_F(StreamParserTest, TokenIsDeliveredWhenItsLineCompletes) {
+    parser.feed("{\"event_type\":\"text-generation\",\"text\":\"First\"}");
+    EXPECT_TRUE(tokens.empty());
+
+    parser.feed("\n{\"event_type\":\"text-gen");
+    EXPECT_EQ(tokens.size(), 1u);
+}
+
+TEST_F(StreamParserTest, ParsesServerSentEvents) {
+    parser.feed("event: content-delta\r\n"
+                "data: {\"type\":\"content-delta\",\"delta\":{\"message\":{\"content\":{\"text\":\"SSE\"}}}}\r\n"
+                "\r\n"
+                ": keep-alive comment\r\n"
+                "data: {\"type\":\"content-delta\",\"delta\":{\"message\":{\"content\":{\"text\":\" text\"}}}}\r\n"
+                "\r\n"
+                "data: {\"type\":\"message-end\"}\r\n\r\n");
+
+    EXPECT_EQ(tokens, (std::vector<std::string>{"SSE", " text"}));
+    EXPECT_TRUE(parser.isComplete());
+}
+
+TEST_F(StreamParserTest, DoneMarkerCompletesStream) {
+    parser.feed("data: [DONE]\n");
+    EXPECT_TRUE(parser.isComplete());
+    EXPECT_TRUE(tokens.empty());
+}
+
+TEST_F(StreamParserTest, FinishParsesUnterminatedLine) {
+    parser.feed("{\"event_type\":\"text-generation\",\"text\":\"Tail\"}");
+    parser.finish();
+
+    EXPECT_EQ(parser.getText(), "Tail");
+    EXPECT_EQ(parser.getTokenCount(), 1u);
+}
+
+TEST_F(StreamParserTest, MalformedLinesAreSkipped) {
+    parser.feed("{not json\n"
+                "data: {\"type\":\"content-delta\"\n"
+                "{\"event_type\":\"text-generation\",\"text\":\"ok\"}\n");
+
+    EXPECT_EQ(tokens, std::vector<std::string>{"ok"});
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include "../../core/model/MentalModel.h"
+#include "../../core/model/Concept.h"
+#include "../../core/model/Relationship.h"
+#include "../../core/ai/SuggestionCache.h"
+#include "../../core/ai/CommonNeighborPredictor.h"
+
+using namespace qlink;
+
+// Wraps a real predictor and counts how often it actually runs
+class CountingPredictor : public ILinkPredictor {
+public:
+    explicit CountingPredictor(bool neighborhoodLocal = true) : local(neighborhoodLocal) {}
+
+    std::vector<LinkSuggestion> predictLinks(const MentalModel& model, int maxSuggestions = 10) override {
+        ++calls;
+        return inner.predictLinks(model, maxSuggestions);
+    }
+    std::string getAlgorithmName() const override { return local ? "Counting" : "Counting Global"; }
+    std::string getDescription() const override { return "Counts predictLinks calls"; }
+    bool isNeighborhoodLocal() const override { return local; }
+
+    int calls = 0;
+
+private:
+    CommonNeighborPredictor inner;
+    bool local;
+};
+
+class SuggestionCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        model = std::make_unique<MentalModel>("Test Model");
+        QObject::connect(model.get(), &MentalModel::modelChanged, [this](const ModelChangeEvent& event) {
+            cache.onModelChanged(event, *model);
+        });
+
+        // Path A-B-C, so A-C is suggested
+        aId = addConcept("A");
+        bId = addConcept("B");
+        cId = addConcept("C");
+        connect(aId, bId);
+        connect(bId, cId);
+    }
+
+    std::string addConcept(const std::string& name) {
+        auto concept = std::make_unique<Concept>(name);
+        std::string id = concept->getId();
+        model->addConcept(std::move(concept));
+        return id;
+    }
+
+    std::string connect(const std::string& sourceId, const std::string& targetId) {
+        auto relationship = std::make_unique<Relationship>(sourceId, targetId);
+        std::string id = relationship->getId();
+        model->addRelationship(std::move(relationship));
+        return id;
+    }
+
+    std::unique_ptr<MentalModel> model;
+    SuggestionCache cache;
+    std::string aId, bId, cId;
+};
+
+TEST_F(SuggestionCacheTest, RepeatedRequestIsServedFromCache) {
+    CountingPredictor predictor;
+    auto first = cache.getOrCompute(predictor, *model, 10, 0.0);
+    auto second = cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    EXPECT_EQ(predictor.calls, 1);
+    ASSERT_EQ(first.size(), second.size());
+    EXPECT_EQ(first[0].sourceConceptId, second[0].sourceConceptId);
+    EXPECT_EQ(cache.getHitCount(), 1u);
+}
+
+TEST_F(SuggestionCacheTest, DifferentParametersAreSeparateEntries) {
+    CountingPredictor predictor;
+    cache.getOrCompute(predictor, *model, 10, 0.0);
+    cache.getOrCompute(predictor, *model, 5, 0.0);
+    cache.getOrCompute(predictor, *model, 10, 0.5);
+
+    EXPECT_EQ(predictor.calls, 3);
+    EXPECT_EQ(cache.size(), 3u);
+}
+
+TEST_F(SuggestionCacheTest, ThresholdFiltersCachedResult) {
+    CountingPredictor predictor;
+    auto suggestions = cache.getOrCompute(predictor, *model, 10, 1.1);
+    EXPECT_TRUE(suggestions.empty());
+}
+
+TEST_F(SuggestionCacheTest, AddingIsolatedConceptKeepsNeighborhoodLocalEntry) {
+    CountingPredictor predictor;
+    cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    addConcept("Isolated");
+    cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    EXPECT_EQ(predictor.calls, 1);
+}
+
+TEST_F(SuggestionCacheTest, AddingIsolatedConceptDropsGlobalEntry) {
+    CountingPredictor predictor(false);
+    cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    addConcept("Isolated");
+    cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    EXPECT_EQ(predictor.calls, 2);
+}
+
+TEST_F(SuggestionCacheTest, LinkingTwoIsolatedConceptsKeepsEntry) {
+    std::string dId = addConcept("D");
+    std::string eId = addConcept("E");
+
+    CountingPredictor predictor;
+    auto before = cache.getOrCompute(predictor, *model, 10, 0.0);
+    connect(dId, eId);
+    auto after = cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    EXPECT_EQ(predictor.calls, 1);
+    EXPECT_EQ(before.size(), after.size());
+
+    // The cached answer must match a fresh computation
+    CommonNeighborPredictor fresh;
+    EXPECT_EQ(fresh.predictLinks(*model, 10).size(), after.size());
+}
+
+TEST_F(SuggestionCacheTest, ExtendedSupportInvalidatesOnNextLink) {
+    std::string dId = addConcept("D");
+    std::string eId = addConcept("E");
+    std::string fId = addConcept("F");
+
+    CountingPredictor predictor;
+    cache.getOrCompute(predictor, *model, 10, 0.0);
+    connect(dId, eId);
+    // D and F now share neighbour E, so D-F becomes a candidate
+    connect(eId, fId);
+    auto suggestions = cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    EXPECT_EQ(predictor.calls, 2);
+    bool foundDF = false;
+    for (const auto& suggestion : suggestions) {
+        if ((suggestion.sourceConceptId == dId && suggestion.targetConceptId == fId) ||
+            (suggestion.sourceConceptId == fId && suggestion.targetConceptId == dId)) {
+            foundDF = true;
+        }
+    }
+    EXPECT_TRUE(foundDF);
+}
+
+TEST_F(SuggestionCacheTest, RelationshipTouchingSupportInvalidates) {
+    CountingPredictor predictor;
+    cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    std::string dId = addConcept("D");
+    connect(cId, dId);
+    cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    EXPECT_EQ(predictor.calls, 2);
+}
+
+TEST_F(SuggestionCacheTest, RemovingRelationshipInvalidates) {
+    CountingPredictor predictor;
+    std::string dId = addConcept("D");
+    std::string relationshipId = connect(cId, dId);
+    cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    model->removeRelationship(relationshipId);
+    cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    EXPECT_EQ(predictor.calls, 2);
+}
+
+TEST_F(SuggestionCacheTest, RemovingConnectedConceptInvalidates) {
+    CountingPredictor predictor;
+    cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    model->removeConcept(bId);
+    auto suggestions = cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    EXPECT_EQ(predictor.calls, 2);
+    EXPECT_TRUE(suggestions.empty());
+}
+
+TEST_F(SuggestionCacheTest, StaleVersionIsNotServed) {
+    CountingPredictor predictor;
+    cache.getOrCompute(predictor, *model, 10, 0.0);
+
+    // Changes the cache never heard about must not be served from it
+    SuggestionCache disconnectedCache;
+    disconnectedCache.getOrCompute(predictor, *model, 10, 0.0);
+    addConcept("Isolated");
+    disconnectedCache.getOrCompute(predictor, *model, 10, 0.0);
+
+    EXPECT_EQ(predictor.calls, 3);
+}
+
+TEST_F(SuggestionCacheTest, LeastRecentlyUsedEntryIsEvicted) {
+    SuggestionCache small(2);
+    CountingPredictor predictor;
+    small.getOrCompute(predictor, *model, 1, 0.0);
+    small.getOrCompute(predictor, *model, 2, 0.0);
+    small.getOrCompute(predictor, *model, 1, 0.0); // Touch the first entry
+    small.getOrCompute(predictor, *model, 3, 0.0); // Evicts maxSuggestions = 2
+
+    EXPECT_EQ(small.size(), 2u);
+    EXPECT_EQ(predictor.calls, 3);
+
+    small.getOrCompute(predictor, *model, 1, 0.0);
+    EXPECT_EQ(predictor.calls, 3);
+    small.getOrCompute(predictor, *model, 2, 0.0);
+    EXPECT_EQ(predictor.calls, 4);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "../../core/ai/SuggestionJob.h"
+#include "../../core/ai/GraphSnapshot.h"
+#include "../../core/model/MentalModel.h"
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+#include <QThreadPool>
+#include <functional>
+
+using namespace qlink;
+
+namespace {
+
+bool waitUntil(const std::function<bool()>& condition, int timeoutMs = 5000) {
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while (!condition()) {
+        if (elapsed.elapsed() > timeoutMs) return false;
+        QEventLoop loop;
+        QTimer::singleShot(5, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+    return true;
+}
+
+// A ring with a chord every tenth concept, so neighbourhoods overlap
+std::shared_ptr<const GraphSnapshot> makeSnapshot(int conceptCount) {
+    MentalModel model("Jobs");
+    for (int i = 0; i < conceptCount; ++i) {
+        model.addConcept(std::make_unique<Concept>("c" + std::to_string(i), "Concept " + std::to_string(i), ""));
+    }
+    for (int i = 0; i < conceptCount; ++i) {
+        std::string source = "c" + std::to_string(i);
+        model.addRelationship(std::make_unique<Relationship>(
+            source, "c" + std::to_string((i + 1) % conceptCount), "next", false, 1.0));
+        if (i % 10 == 0) {
+            model.addRelationship(std::make_unique<Relationship>(
+                source, "c" + std::to_string((i + 7) % conceptCount), "chord", false, 1.0));
+        }
+    }
+    return GraphSnapshot::fromModel(model);
+}
+
+} // namespace
+
+TEST(SuggestionJobTest, ReportsProgressAndFinishes) {
+    SuggestionJob job(makeSnapshot(500), LinkPredictorFactory::AlgorithmType::COMMON_NEIGHBORS, 10);
+    int lastProcessed = -1;
+    int lastTotal = -1;
+    bool finished = false;
+    std::vector<LinkSuggestion> results;
+    QObject::connect(&job, &SuggestionJob::progressChanged, [&](int processed, int total) {
+        EXPECT_GE(processed, lastProcessed);
+        lastProcessed = processed;
+        lastTotal = total;
+    });
+    QObject::connect(&job, &SuggestionJob::finished, [&](const std::vector<LinkSuggestion>& suggestions) {
+        finished = true;
+        results = suggestions;
+    });
+
+    job.start();
+    ASSERT_TRUE(waitUntil([&]() { return finished; }));
+    EXPECT_FALSE(job.isRunning());
+    EXPECT_FALSE(job.isCancelled());
+    EXPECT_EQ(lastProcessed, 500);
+    EXPECT_EQ(lastTotal, 500);
+    ASSERT_FALSE(results.empty());
+    EXPECT_LE(results.size(), 10u);
+    for (size_t i = 1; i < results.size(); ++i) {
+        EXPECT_GE(results[i - 1].confidence, results[i].confidence);
+    }
+}
+
+TEST(SuggestionJobTest, CancelMidRunKeepsPartialResults) {
+    // Preferential attachment scores every unconnected pair, so this runs for long enough
+    QThreadPool pool;
+    pool.setMaxThreadCount(1);
+    SuggestionJob job(makeSnapshot(20000), LinkPredictorFactory::AlgorithmType::PREFERENTIAL_ATTACHMENT, 10);
+    std::vector<LinkSuggestion> partial;
+    bool finished = false;
+    bool cancelled = false;
+    QObject::connect(&job, &SuggestionJob::partialResults,
+                     [&](const std::vector<LinkSuggestion>& suggestions) { partial = suggestions; });
+    QObject::connect(&job, &SuggestionJob::finished, [&]() { finished = true; });
+    QObject::connect(&job, &SuggestionJob::cancelled, [&]() { cancelled = true; });
+
+    job.start(&pool);
+    ASSERT_TRUE(waitUntil([&]() { return !partial.empty(); }));
+    EXPECT_TRUE(job.isRunning());
+    EXPECT_LE(partial.size(), 10u);
+
+    job.cancel();
+    EXPECT_TRUE(job.isCancelled());
+    ASSERT_TRUE(waitUntil([&]() { return cancelled; }));
+    EXPECT_FALSE(finished);
+    EXPECT_FALSE(job.isRunning());
+    EXPECT_LT(job.getProcessedVertices(), job.getTotalVertices());
+
+    // What was found before the cancel is still there
+    std::vector<LinkSuggestion> kept = job.currentResults();
+    EXPECT_GE(kept.size(), partial.size());
+    EXPECT_LE(kept.size(), 10u);
+}
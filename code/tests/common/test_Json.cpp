@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "../../core/common/Json.h"
+#include "../../core/common/QLinkException.h"
+#include <cmath>
+
+using namespace qlink;
+
+TEST(JsonWriterTest, WritesNestedValuesCompactly) {
+    std::string out;
+    JsonWriter writer(out);
+    writer.beginObject();
+    writer.key("name");
+    writer.string("Physics");
+    writer.key("tags");
+    writer.beginArray();
+    writer.string("a");
+    writer.beginObject();
+    writer.endObject();
+    writer.beginArray();
+    writer.endArray();
+    writer.endArray();
+    writer.key("flag");
+    writer.boolean(false);
+    writer.key("none");
+    writer.null();
+    writer.key("weight");
+    writer.number(0.5);
+    writer.endObject();
+    EXPECT_EQ(out, R"({"name":"Physics","tags":["a",{},[]],"flag":false,"none":null,"weight":0.5})");
+}
+
+TEST(JsonWriterTest, EscapesStrings) {
+    std::string out;
+    JsonWriter::appendEscaped(out, "say \"hi\"\\\n\t\x01 caf\xC3\xA9");
+    EXPECT_EQ(out, "say \\\"hi\\\"\\\\\\n\\t\\u0001 caf\xC3\xA9");
+}
+
+TEST(JsonWriterTest, NumbersReadBackExactly) {
+    const double values[] = {0.0, -1.0, 0.1, 1.0 / 3.0, 1e300, -2.5e-300, 123456789.125};
+    for (double value : values) {
+        std::string out;
+        JsonWriter(out).number(value);
+        JsonReader reader(out);
+        EXPECT_EQ(reader.readNumber(), value) << out;
+        reader.finish();
+    }
+
+    std::string out;
+    JsonWriter(out).number(std::nan(""));
+    EXPECT_EQ(out, "null");
+}
+
+TEST(JsonWriterTest, RejectsDeepNesting) {
+    std::string out;
+    JsonWriter writer(out);
+    for (int i = 0; i < 64; ++i) writer.beginArray();
+    EXPECT_THROW(writer.beginArray(), QLinkException);
+}
+
+TEST(JsonReaderTest, ReadsObjectsAndSkipsUnknownMembers) {
+    JsonReader reader(R"( {"skip": {"a": [1, true, null, "x"]}, "name" : "Energy", "n": -1.5e2, "ok": true } )");
+    std::string name;
+    double number = 0.0;
+    bool ok = false;
+    reader.beginObject();
+    std::string_view key;
+    while (reader.nextMember(key)) {
+        if (key == "name") name = reader.readString();
+        else if (key == "n") number = reader.readNumber();
+        else if (key == "ok") ok = reader.readBool();
+        else reader.skipValue();
+    }
+    reader.finish();
+    EXPECT_EQ(name, "Energy");
+    EXPECT_DOUBLE_EQ(number, -150.0);
+    EXPECT_TRUE(ok);
+}
+
+TEST(JsonReaderTest, PlainStringsAreViewsIntoTheInput) {
+    std::string input = R"(["plain", "esc\"aped"])";
+    JsonReader reader(input);
+    reader.beginArray();
+    ASSERT_TRUE(reader.nextElement());
+    std::string_view plain = reader.readString();
+    EXPECT_EQ(plain, "plain");
+    EXPECT_GE(plain.data(), input.data());
+    EXPECT_LT(plain.data(), input.data() + input.size());
+    ASSERT_TRUE(reader.nextElement());
+    EXPECT_EQ(reader.readString(), "esc\"aped");
+    EXPECT_FALSE(reader.nextElement());
+}
+
+TEST(JsonReaderTest, DecodesEscapes) {
+    JsonReader reader(R"("\"\\\/\b\f\n\r\t \u00e9 \u20AC \ud83d\ude00")");
+    EXPECT_EQ(reader.readString(), "\"\\/\b\f\n\r\t \xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80");
+}
+
+TEST(JsonReaderTest, KeysSurviveReadingTheirValue) {
+    JsonReader reader(R"({"key": "value"})");
+    reader.beginObject();
+    std::string_view key;
+    ASSERT_TRUE(reader.nextMember(key));
+    EXPECT_EQ(reader.readString(), "value");
+    EXPECT_EQ(key, "key");
+}
+
+TEST(JsonReaderTest, ReportsTheOffsetOfMalformedInput) {
+    const char* invalid[] = {
+        R"({"a" 1})", R"([1,])", R"([1 2])", R"({"a":1,})", R"("unterminated)", "\"tab\there\"",
+        R"("\x")", R"("\ud83d")", R"("\ude00")", R"("\ude00\ud83d")", "01", "1.", "-", "1e", R"({"a":1} x)", "[",
+    };
+    for (const char* text : invalid) {
+        JsonReader reader(text);
+        EXPECT_THROW({
+            reader.skipValue();
+            reader.finish();
+        }, ParseException) << text;
+    }
+
+    JsonReader reader(R"({"a": tru})");
+    reader.beginObject();
+    std::string_view key;
+    reader.nextMember(key);
+    try {
+        reader.readBool();
+        FAIL() << "expected a ParseException";
+    } catch (const ParseException& e) {
+        EXPECT_NE(std::string(e.what()).find("at byte 6"), std::string::npos) << e.what();
+    }
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "../../core/common/Timestamp.h"
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+using namespace qlink;
+
+TEST(TimestampTest, FormatsUtcWithMilliseconds) {
+    EXPECT_EQ(formatTimestamp(0), "1970-01-01T00:00:00.000Z");
+    EXPECT_EQ(formatTimestamp(1714555800250), "2024-05-01T09:30:00.250Z");
+    EXPECT_EQ(formatTimestamp(-1), "1969-12-31T23:59:59.999Z");
+}
+
+TEST(TimestampTest, ParsesWhatItFormats) {
+    for (Timestamp timestamp : {Timestamp(0), Timestamp(951782400000), Timestamp(1714555800250)}) {
+        Timestamp parsed = -1;
+        ASSERT_TRUE(parseTimestamp(formatTimestamp(timestamp), parsed));
+        EXPECT_EQ(parsed, timestamp);
+    }
+}
+
+TEST(TimestampTest, ParsesOffsetsAndQtIsoDates) {
+    Timestamp timestamp;
+    ASSERT_TRUE(parseTimestamp("2024-05-01T11:30:00+02:00", timestamp));
+    EXPECT_EQ(timestamp, 1714555800000);
+    ASSERT_TRUE(parseTimestamp("2024-05-01T09:30:00.25Z", timestamp));
+    EXPECT_EQ(timestamp, 1714555800250);
+}
+
+TEST(TimestampTest, ReadsTimesWithoutOffsetAsLocal) {
+    // Earlier files hold QDateTime::currentDateTime().toString(Qt::ISODate):
+    // local time without an offset. Read them in a zone away from UTC.
+    const char* previous = std::getenv("TZ");
+    std::string saved = previous ? previous : "";
+    setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+    tzset();
+
+    for (Timestamp written : {Timestamp(1714555800000), Timestamp(1704103200000)}) {
+        std::time_t seconds = static_cast<std::time_t>(written / 1000);
+        char text[32];
+        std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", std::localtime(&seconds));
+        Timestamp timestamp = -1;
+        ASSERT_TRUE(parseTimestamp(text, timestamp)) << text;
+        EXPECT_EQ(timestamp, written) << text;
+    }
+    Timestamp summer;
+    ASSERT_TRUE(parseTimestamp("2024-05-01T11:30:00", summer));
+    EXPECT_EQ(summer, 1714555800000);
+
+    if (previous) {
+        setenv("TZ", saved.c_str(), 1);
+    } else {
+        unsetenv("TZ");
+    }
+    tzset();
+}
+
+TEST(TimestampTest, RejectsOtherText) {
+    Timestamp timestamp = 7;
+    EXPECT_FALSE(parseTimestamp("", timestamp));
+    EXPECT_FALSE(parseTimestamp("2024-05-01", timestamp));
+    EXPECT_FALSE(parseTimestamp("2024-13-01T00:00:00Z", timestamp));
+    EXPECT_FALSE(parseTimestamp("2024-05-01T09:30:00.Z", timestamp));
+    EXPECT_FALSE(parseTimestamp("2024-05-01T09:30:00Z trailing", timestamp));
+    EXPECT_EQ(timestamp, 7);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "../../core/model/Concept.h"
+#include "../../core/common/Json.h"
 
 using namespace qlink;
 
@@ -164,3 +165,33 @@ TEST_F(ConceptTest, NegativePositionValuesWork) {
     EXPECT_EQ(concept.getPosition().x, -100.5);
     EXPECT_EQ(concept.getPosition().y, -200.7);
 }
+
+// Change tracking tests
+TEST_F(ConceptTest, EditsUpdateModifiedTimeAndDirtyFlag) {
+    Concept concept("c1", "Energy", "");
+    EXPECT_TRUE(concept.isDirty());
+    EXPECT_EQ(concept.getCreated(), concept.getModified());
+
+    concept.setTimestamps(1000, 1000);
+    concept.markClean();
+    concept.setName("Energy"); // Unchanged
+    concept.removeTag("missing");
+    EXPECT_FALSE(concept.isDirty());
+    EXPECT_EQ(concept.getModified(), 1000);
+
+    concept.addTag("physics");
+    EXPECT_TRUE(concept.isDirty());
+    EXPECT_EQ(concept.getCreated(), 1000);
+    EXPECT_GT(concept.getModified(), 1000);
+}
+
+TEST_F(ConceptTest, JsonKeepsTimestamps) {
+    Concept concept("c1", "Energy", "");
+    concept.setTimestamps(1714555800000, 1714555800250);
+    std::string json = concept.toJson();
+    JsonReader reader(json);
+    auto restored = Concept::fromJson(reader);
+    ASSERT_NE(restored, nullptr);
+    EXPECT_EQ(restored->getCreated(), 1714555800000);
+    EXPECT_EQ(restored->getModified(), 1714555800250);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "../../core/model/ConceptPayloads.h"
+#include "../../core/model/Concept.h"
+#include "../../core/model/MentalModel.h"
+
+using namespace qlink;
+
+namespace {
+
+// Payload i is "description i" with tags "tag i" and "shared"
+class CountingSource : public ConceptPayloadSource {
+public:
+    ConceptPayload load(uint32_t index) const override {
+        ++loads;
+        return ConceptPayload{"description " + std::to_string(index), {"tag " + std::to_string(index), "shared"}};
+    }
+
+    mutable int loads = 0;
+};
+
+std::unique_ptr<MentalModel> lazyModel(std::shared_ptr<CountingSource> source, size_t concepts, size_t capacity) {
+    auto model = std::make_unique<MentalModel>("Lazy");
+    ConceptPayloadCache* cache = model->setPayloadSource(source, capacity);
+    for (size_t i = 0; i < concepts; ++i) {
+        auto concept = std::make_unique<Concept>("c" + std::to_string(i), "Concept " + std::to_string(i), "");
+        concept->setLazyPayload(cache, static_cast<uint32_t>(i));
+        model->addConcept(std::move(concept));
+    }
+    model->markClean();
+    return model;
+}
+
+} // namespace
+
+TEST(ConceptPayloadsTest, PayloadLoadsOnFirstUse) {
+    auto source = std::make_shared<CountingSource>();
+    auto model = lazyModel(source, 3, 8);
+    const Concept* concept = model->getConcept("c1");
+
+    EXPECT_FALSE(concept->isPayloadLoaded());
+    EXPECT_EQ(source->loads, 0);
+    EXPECT_EQ(concept->getDescription(), "description 1");
+    EXPECT_TRUE(concept->hasTag("tag 1"));
+    EXPECT_EQ(concept->getTags().size(), 2u);
+    EXPECT_TRUE(concept->isPayloadLoaded());
+    EXPECT_EQ(source->loads, 1);
+    EXPECT_EQ(model->getPayloadCache()->getLoadedCount(), 1u);
+}
+
+TEST(ConceptPayloadsTest, LeastRecentlyUsedPayloadIsDropped) {
+    auto source = std::make_shared<CountingSource>();
+    auto model = lazyModel(source, 4, 2);
+    const Concept* first = model->getConcept("c0");
+    const Concept* second = model->getConcept("c1");
+    const Concept* third = model->getConcept("c2");
+
+    first->getDescription();
+    second->getDescription();
+    first->getDescription(); // Now the second is the least recently used
+    third->getDescription();
+
+    EXPECT_TRUE(first->isPayloadLoaded());
+    EXPECT_FALSE(second->isPayloadLoaded());
+    EXPECT_TRUE(third->isPayloadLoaded());
+    EXPECT_EQ(model->getPayloadCache()->getLoadedCount(), 2u);
+
+    EXPECT_EQ(second->getDescription(), "description 1");
+    EXPECT_EQ(source->loads, 4);
+}
+
+TEST(ConceptPayloadsTest, EditedPayloadIsOwnedAndTracked) {
+    auto source = std::make_shared<CountingSource>();
+    auto model = lazyModel(source, 4, 2);
+    Concept* edited = model->getConcept("c0");
+
+    edited->setDescription("changed");
+    edited->addTag("new");
+    model->notifyConceptModified("c0");
+    EXPECT_FALSE(edited->hasLazyPayload());
+
+    // Reading every other concept cannot drop the edit
+    for (const auto& concept : model->getConcepts()) {
+        concept->getDescription();
+    }
+    EXPECT_EQ(edited->getDescription(), "changed");
+    EXPECT_EQ(edited->getTags(), (std::vector<std::string>{"tag 0", "shared", "new"}));
+    EXPECT_TRUE(edited->isDirty());
+    ASSERT_EQ(model->getChanges().modifiedConcepts.size(), 1u);
+}
+
+TEST(ConceptPayloadsTest, UnchangedSetterKeepsPayloadLazy) {
+    auto source = std::make_shared<CountingSource>();
+    auto model = lazyModel(source, 1, 2);
+    Concept* concept = model->getConcept("c0");
+
+    concept->setDescription("description 0");
+    concept->removeTag("missing");
+    EXPECT_TRUE(concept->hasLazyPayload());
+    EXPECT_FALSE(concept->isDirty());
+}
+
+TEST(ConceptPayloadsTest, CopyOwnsItsPayload) {
+    auto source = std::make_shared<CountingSource>();
+    auto model = lazyModel(source, 1, 2);
+    auto copy = std::make_unique<Concept>(*model->getConcept("c0"));
+    model.reset();
+
+    EXPECT_FALSE(copy->hasLazyPayload());
+    EXPECT_EQ(copy->getDescription(), "description 0");
+}
+
+TEST(ConceptPayloadsTest, CloneKeepsConceptsLazy) {
+    auto source = std::make_shared<CountingSource>();
+    auto model = lazyModel(source, 3, 2);
+    model->getConcept("c0")->setDescription("edited");
+    model->getConcept("c1")->getDescription();
+
+    auto copy = model->clone();
+    ASSERT_NE(copy->getPayloadCache(), nullptr);
+    EXPECT_NE(copy->getPayloadCache(), model->getPayloadCache());
+    EXPECT_EQ(copy->getPayloadCache()->getLoadedCount(), 0u);
+    EXPECT_EQ(copy->getConcept("c0")->getDescription(), "edited");
+    EXPECT_FALSE(copy->getConcept("c1")->isPayloadLoaded());
+    EXPECT_EQ(copy->getConcept("c2")->getDescription(), "description 2");
+
+    model.reset();
+    EXPECT_EQ(copy->getConcept("c1")->getDescription(), "description 1");
+}
+
+TEST(ConceptPayloadsTest, ShrinkingCapacityDropsPayloads) {
+    auto source = std::make_shared<CountingSource>();
+    auto model = lazyModel(source, 6, 8);
+    for (const auto& concept : model->getConcepts()) {
+        concept->getTags();
+    }
+    EXPECT_EQ(model->getPayloadCache()->getLoadedCount(), 6u);
+
+    model->getPayloadCache()->setCapacity(0);
+    EXPECT_EQ(model->getPayloadCache()->getCapacity(), ConceptPayloadCache::MIN_CAPACITY);
+    EXPECT_EQ(model->getPayloadCache()->getLoadedCount(), ConceptPayloadCache::MIN_CAPACITY);
+    EXPECT_TRUE(model->getConcept("c5")->isPayloadLoaded());
+
+    model->removeConcept("c5");
+    EXPECT_EQ(model->getPayloadCache()->getLoadedCount(), 1u);
+}
@@ -248,6 +248,96 @@ TEST_F(MentalModelTest, ClearRemovesAllContent) {
     EXPECT_EQ(model->getRelationshipCount(), 0);
 }
 
+TEST_F(MentalModelTest, CloneIsIndependentCopy) {
+    model->addConcept(std::make_unique<Concept>("c1", "C1", "First"));
+    model->addConcept(std::make_unique<Concept>("c2", "C2", ""));
+    model->addRelationship(std::make_unique<Relationship>("r1", "c1", "c2", "uses", false, 1.0));
+    
+    auto copy = model->clone();
+    EXPECT_EQ(copy->getModelName(), "Test Model");
+    EXPECT_EQ(copy->getVersion(), model->getVersion());
+    EXPECT_EQ(copy->getConceptCount(), 2);
+    ASSERT_NE(copy->getRelationship("r1"), nullptr);
+    
+    model->getConcept("c1")->setName("Renamed");
+    model->removeConcept("c2");
+    EXPECT_EQ(copy->getConcept("c1")->getName(), "C1");
+    EXPECT_EQ(copy->getConceptCount(), 2);
+    EXPECT_EQ(copy->getRelationshipCount(), 1);
+}
+
+TEST_F(MentalModelTest, BulkAddSkipsRelationshipsWithoutEndpoints) {
+    std::vector<std::unique_ptr<Concept>> concepts;
+    concepts.push_back(std::make_unique<Concept>("c1", "C1", ""));
+    concepts.push_back(std::make_unique<Concept>("c2", "C2", ""));
+    model->addConceptsBulk(std::move(concepts));
+    
+    std::vector<std::unique_ptr<Relationship>> relationships;
+    relationships.push_back(std::make_unique<Relationship>("r1", "c1", "c2", "uses", false, 1.0));
+    relationships.push_back(std::make_unique<Relationship>("r2", "c1", "missing", "uses", false, 1.0));
+    EXPECT_EQ(model->addRelationshipsBulk(std::move(relationships)), 1u);
+    
+    EXPECT_EQ(model->getConceptCount(), 2);
+    ASSERT_NE(model->getConcept("c2"), nullptr);
+    EXPECT_NE(model->getRelationship("r1"), nullptr);
+    EXPECT_EQ(model->getRelationship("r2"), nullptr);
+}
+
+TEST_F(MentalModelTest, BulkRemoveTakesConnectedRelationshipsAlong) {
+    for (int i = 0; i < 5; ++i) {
+        model->addConcept(std::make_unique<Concept>("c" + std::to_string(i), "C" + std::to_string(i), ""));
+    }
+    for (int i = 1; i < 5; ++i) {
+        model->addRelationship(std::make_unique<Relationship>("r" + std::to_string(i), "c" + std::to_string(i - 1),
+                                                              "c" + std::to_string(i), "uses", false, 1.0));
+    }
+    model->markClean();
+    model->addConcept(std::make_unique<Concept>("c1", "Duplicate", ""));
+    
+    std::vector<std::unique_ptr<Relationship>> connected;
+    auto removed = model->removeConceptsBulk({"c1", "c3", "missing"}, &connected);
+    ASSERT_EQ(removed.size(), 2u);
+    EXPECT_EQ(removed[0]->getName(), "C1");
+    EXPECT_EQ(connected.size(), 4u);
+    EXPECT_EQ(model->getRelationshipCount(), 0);
+    EXPECT_EQ(model->getConcept("c1")->getName(), "Duplicate");
+    EXPECT_EQ(model->getConcept("c4")->getName(), "C4");
+    
+    ModelChanges changes = model->getChanges();
+    EXPECT_EQ(changes.removedConcepts, (std::vector<std::string>{"c1", "c3"}));
+    EXPECT_EQ(changes.removedRelationships.size(), 4u);
+    ASSERT_EQ(changes.addedConcepts.size(), 1u);
+    EXPECT_EQ(changes.addedConcepts[0]->getName(), "Duplicate");
+    
+    model->addRelationship(std::make_unique<Relationship>("r5", "c0", "c4", "uses", false, 1.0));
+    EXPECT_EQ(model->removeRelationshipsBulk({"r5", "r1"}).size(), 1u);
+    EXPECT_EQ(model->getRelationship("r5"), nullptr);
+}
+
+TEST_F(MentalModelTest, DuplicateIdsResolveToTheFirstRemaining) {
+    model->addConcept(std::make_unique<Concept>("c1", "First", ""));
+    model->addConcept(std::make_unique<Concept>("c1", "Second", ""));
+    EXPECT_EQ(model->getConcept("c1")->getName(), "First");
+    
+    model->removeConcept("c1");
+    ASSERT_NE(model->getConcept("c1"), nullptr);
+    EXPECT_EQ(model->getConcept("c1")->getName(), "Second");
+    
+    model->removeConcept("c1");
+    EXPECT_EQ(model->getConcept("c1"), nullptr);
+}
+
+TEST_F(MentalModelTest, NotifyModifiedBumpsVersionForExistingEntities) {
+    model->addConcept(std::make_unique<Concept>("c1", "C1", ""));
+    uint64_t version = model->getVersion();
+    
+    model->notifyConceptModified("c1");
+    EXPECT_EQ(model->getVersion(), version + 1);
+    model->notifyConceptModified("missing");
+    model->notifyRelationshipModified("missing");
+    EXPECT_EQ(model->getVersion(), version + 1);
+}
+
 // Statistics tests
 TEST_F(MentalModelTest, GetStatisticsReturnsCorrectCounts) {
     model->addConcept(std::make_unique<Concept>("C1"));
@@ -289,3 +379,109 @@ TEST_F(MentalModelTest, GetConceptImportanceReturnsValueForExistingConcept) {
     double importance = model->getConceptImportance(c1Id);
     EXPECT_GE(importance, 0.0);
 }
+
+// JSON serialization tests
+TEST_F(MentalModelTest, JsonRoundTripKeepsAwkwardText) {
+    MentalModel original("Quotes \"and\" \\slashes\\");
+    auto energy = std::make_unique<Concept>("c1", "Energy \"E\"", "Line one\nLine two\ttab \x01 caf\xC3\xA9");
+    energy->addTag("a\\b");
+    energy->addTag("\xE2\x82\xAC");
+    energy->setPosition(Position(0.1, -2.5e-7));
+    original.addConcept(std::move(energy));
+    original.addConcept(std::make_unique<Concept>("c2", "Work", ""));
+    original.addRelationship(std::make_unique<Relationship>("r1", "c1", "c2", "\"enables\"", true, 1.0 / 3.0));
+
+    auto loaded = MentalModel::fromJson(original.toJson());
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getModelName(), original.getModelName());
+    ASSERT_EQ(loaded->getConceptCount(), 2);
+
+    const Concept* concept = loaded->getConcept("c1");
+    ASSERT_NE(concept, nullptr);
+    EXPECT_EQ(concept->getName(), "Energy \"E\"");
+    EXPECT_EQ(concept->getDescription(), "Line one\nLine two\ttab \x01 caf\xC3\xA9");
+    EXPECT_EQ(concept->getTags(), (std::vector<std::string>{"a\\b", "\xE2\x82\xAC"}));
+    EXPECT_EQ(concept->getPosition().x, 0.1);
+    EXPECT_EQ(concept->getPosition().y, -2.5e-7);
+
+    const Relationship* relationship = loaded->getRelationship("r1");
+    ASSERT_NE(relationship, nullptr);
+    EXPECT_EQ(relationship->getType(), "\"enables\"");
+    EXPECT_TRUE(relationship->getIsDirected());
+    EXPECT_EQ(relationship->getWeight(), 1.0 / 3.0);
+    EXPECT_EQ(loaded->toJson(), original.toJson());
+}
+
+TEST_F(MentalModelTest, FromJsonReadsModelManagerFiles) {
+    auto loaded = MentalModel::fromJson(R"({
+        "name": "Saved", "version": "1.0",
+        "relationships": [
+            {"id": "r1", "sourceConceptId": "c1", "targetConceptId": "c2", "type": "causes",
+             "directed": true, "weight": 2, "created": "2024-01-01T00:00:00"},
+            {"id": "r2", "sourceConceptId": "c1", "targetConceptId": "missing", "type": "causes"}
+        ],
+        "concepts": [
+            {"id": "c1", "name": "Rain", "tags": [], "position": {"x": 1, "y": 2}},
+            {"id": "c2", "name": "Flood"},
+            {"name": "No id"}
+        ]
+    })");
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getModelName(), "Saved");
+    EXPECT_EQ(loaded->getConceptCount(), 2);
+    EXPECT_EQ(loaded->getRelationshipCount(), 1);
+    ASSERT_NE(loaded->getRelationship("r1"), nullptr);
+    EXPECT_TRUE(loaded->getRelationship("r1")->getIsDirected());
+    EXPECT_DOUBLE_EQ(loaded->getRelationship("r1")->getWeight(), 2.0);
+}
+
+TEST_F(MentalModelTest, FromJsonRejectsMalformedText) {
+    EXPECT_EQ(MentalModel::fromJson(""), nullptr);
+    EXPECT_EQ(MentalModel::fromJson(R"({"concepts": [{"id": "c1", "name": "A"})"), nullptr);
+    EXPECT_EQ(MentalModel::fromJson(R"({"modelName": "A"} trailing)"), nullptr);
+}
+
+// Change tracking tests
+TEST_F(MentalModelTest, ChangesSinceMarkClean) {
+    model->addConcept(std::make_unique<Concept>("c1", "Energy", ""));
+    model->addConcept(std::make_unique<Concept>("c2", "Work", ""));
+    model->addConcept(std::make_unique<Concept>("c3", "Power", ""));
+    model->addRelationship(std::make_unique<Relationship>("r1", "c1", "c2", "enables", true, 1.0));
+    model->markClean();
+    EXPECT_FALSE(model->hasChanges());
+    EXPECT_FALSE(model->getConcept("c1")->isDirty());
+
+    model->getConcept("c1")->setName("Kinetic energy");
+    model->notifyConceptModified("c1");
+    ModelChanges changes = model->getChanges();
+    ASSERT_EQ(changes.modifiedConcepts.size(), 1u);
+    EXPECT_EQ(changes.modifiedConcepts[0]->getId(), "c1");
+    EXPECT_TRUE(changes.keepsStructure());
+
+    model->addConcept(std::make_unique<Concept>("c4", "Heat", ""));
+    model->notifyConceptModified("c4"); // Still counted as added
+    model->removeConcept("c2");
+    changes = model->getChanges();
+    ASSERT_EQ(changes.addedConcepts.size(), 1u);
+    EXPECT_EQ(changes.addedConcepts[0]->getId(), "c4");
+    EXPECT_EQ(changes.modifiedConcepts.size(), 1u);
+    EXPECT_EQ(changes.removedConcepts, std::vector<std::string>{"c2"});
+    EXPECT_EQ(changes.removedRelationships, std::vector<std::string>{"r1"}); // With its concept
+    EXPECT_FALSE(changes.keepsStructure());
+
+    model->markClean();
+    EXPECT_TRUE(model->getChanges().isEmpty());
+    EXPECT_FALSE(model->getConcept("c4")->isDirty());
+}
+
+TEST_F(MentalModelTest, RemovingAnAddedConceptLeavesNoChange) {
+    model->markClean();
+    model->addConcept(std::make_unique<Concept>("c1", "Energy", ""));
+    model->removeConcept("c1");
+    EXPECT_FALSE(model->hasChanges());
+
+    model->setModelName("Test Model"); // Unchanged
+    EXPECT_FALSE(model->hasChanges());
+    model->clear();
+    EXPECT_TRUE(model->getChanges().cleared);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include "../../core/model/ModelDiff.h"
+#include "../../core/model/MentalModel.h"
+#include <algorithm>
+
+using namespace qlink;
+
+class ModelDiffTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        base = std::make_unique<MentalModel>("Base");
+        for (int i = 0; i < 10; ++i) {
+            base->addConcept(std::make_unique<Concept>("c" + std::to_string(i), "Concept " + std::to_string(i),
+                                                       "About " + std::to_string(i)));
+        }
+        for (int i = 1; i < 10; ++i) {
+            base->addRelationship(std::make_unique<Relationship>("r" + std::to_string(i), "c" + std::to_string(i - 1),
+                                                                 "c" + std::to_string(i), "precedes", true, 1.0));
+        }
+    }
+
+    static bool contains(const std::vector<std::string>& ids, const std::string& id) {
+        return std::find(ids.begin(), ids.end(), id) != ids.end();
+    }
+
+    std::unique_ptr<MentalModel> base;
+};
+
+TEST_F(ModelDiffTest, IdenticalModelsHaveNoDifferences) {
+    auto copy = base->clone();
+    EXPECT_TRUE(diff(*base, *copy).isEmpty());
+
+    // Touching without changing content is no difference either
+    copy->getConcept("c1")->setDescription("About 1");
+    EXPECT_TRUE(diff(*base, *copy).isEmpty());
+}
+
+TEST_F(ModelDiffTest, FindsAddedModifiedAndRemovedEntities) {
+    auto edited = base->clone();
+    edited->getConcept("c2")->addTag("edited");
+    edited->getConcept("c3")->setPosition(Position(4.0, 2.0));
+    edited->removeConcept("c9"); // And with it r9
+    edited->getRelationship("r4")->setWeight(0.5);
+    edited->addConcept(std::make_unique<Concept>("new", "New", ""));
+    edited->addRelationship(std::make_unique<Relationship>("r-new", "new", "c0", "extends", true, 1.0));
+
+    ModelDiff changes = diff(*base, *edited);
+    ASSERT_EQ(changes.addedConcepts.size(), 1u);
+    EXPECT_EQ(changes.addedConcepts[0], edited->getConcept("new"));
+    ASSERT_EQ(changes.modifiedConcepts.size(), 2u);
+    EXPECT_EQ(changes.modifiedConcepts[0]->getId(), "c2");
+    EXPECT_EQ(changes.modifiedConcepts[1]->getId(), "c3");
+    EXPECT_EQ(changes.removedConcepts, std::vector<std::string>{"c9"});
+    ASSERT_EQ(changes.addedRelationships.size(), 1u);
+    EXPECT_EQ(changes.addedRelationships[0]->getId(), "r-new");
+    ASSERT_EQ(changes.modifiedRelationships.size(), 1u);
+    EXPECT_EQ(changes.modifiedRelationships[0]->getId(), "r4");
+    EXPECT_EQ(changes.removedRelationships, std::vector<std::string>{"r9"});
+    EXPECT_EQ(changes.size(), 7u);
+}
+
+TEST_F(ModelDiffTest, ContentHashFollowsEdits) {
+    Concept* concept = base->getConcept("c1");
+    uint64_t hash = concept->getContentHash();
+    EXPECT_EQ(concept->getContentHash(), hash);
+
+    concept->setDescription("Changed");
+    EXPECT_NE(concept->getContentHash(), hash);
+    concept->setDescription("About 1");
+    EXPECT_EQ(concept->getContentHash(), hash);
+
+    // Fields are delimited, so moving text between them changes the hash
+    Concept first("a", "ab", "c");
+    Concept second("b", "a", "bc");
+    EXPECT_NE(first.getContentHash(), second.getContentHash());
+
+    Relationship* relationship = base->getRelationship("r1");
+    uint64_t relationshipHash = relationship->getContentHash();
+    relationship->setDirected(false);
+    EXPECT_NE(relationship->getContentHash(), relationshipHash);
+}
+
+TEST_F(ModelDiffTest, MergeTakesChangesFromEitherSide) {
+    auto ours = base->clone();
+    auto theirs = base->clone();
+    ours->getConcept("c1")->setDescription("Ours");
+    theirs->getConcept("c2")->setDescription("Theirs");
+    theirs->getConcept("c5")->setDescription("Both");
+    ours->getConcept("c5")->setDescription("Both");
+    theirs->removeRelationship("r7");
+    theirs->addConcept(std::make_unique<Concept>("t", "Theirs", ""));
+
+    ModelMerge result = merge(*base, *ours, *theirs);
+    EXPECT_TRUE(result.conflictingConcepts.empty());
+    EXPECT_TRUE(result.conflictingRelationships.empty());
+    ASSERT_EQ(result.changes.modifiedConcepts.size(), 1u);
+    EXPECT_EQ(result.changes.modifiedConcepts[0], theirs->getConcept("c2"));
+    ASSERT_EQ(result.changes.addedConcepts.size(), 1u);
+    EXPECT_EQ(result.changes.addedConcepts[0]->getId(), "t");
+    EXPECT_EQ(result.changes.removedRelationships, std::vector<std::string>{"r7"});
+    EXPECT_EQ(result.changes.size(), 3u);
+}
+
+TEST_F(ModelDiffTest, MergeSettlesConflictsByResolution) {
+    auto ours = base->clone();
+    auto theirs = base->clone();
+    ours->getConcept("c1")->setDescription("Ours");
+    theirs->getConcept("c1")->setDescription("Theirs");
+    ours->getRelationship("r3")->setWeight(0.25);
+    theirs->removeRelationship("r3");
+
+    ModelMerge kept = merge(*base, *ours, *theirs, ConflictResolution::KEEP_OURS);
+    EXPECT_EQ(kept.conflictingConcepts, std::vector<std::string>{"c1"});
+    EXPECT_EQ(kept.conflictingRelationships, std::vector<std::string>{"r3"});
+    EXPECT_TRUE(kept.changes.isEmpty());
+
+    ModelMerge taken = merge(*base, *ours, *theirs, ConflictResolution::TAKE_THEIRS);
+    EXPECT_EQ(taken.conflictingConcepts, std::vector<std::string>{"c1"});
+    ASSERT_EQ(taken.changes.modifiedConcepts.size(), 1u);
+    EXPECT_EQ(taken.changes.modifiedConcepts[0]->getDescription(), "Theirs");
+    EXPECT_EQ(taken.changes.removedRelationships, std::vector<std::string>{"r3"});
+}
+
+TEST_F(ModelDiffTest, MergeKeepsRelationshipsConsistent) {
+    auto ours = base->clone();
+    auto theirs = base->clone();
+    // Ours connects to a concept theirs removes
+    ours->addRelationship(std::make_unique<Relationship>("r-ours", "c0", "c4", "mentions", false, 1.0));
+    theirs->removeConcept("c4");
+    // Theirs connects to a concept ours removed
+    ours->removeConcept("c8");
+    theirs->addRelationship(std::make_unique<Relationship>("r-theirs", "c8", "c1", "mentions", false, 1.0));
+
+    ModelMerge kept = merge(*base, *ours, *theirs, ConflictResolution::KEEP_OURS);
+    EXPECT_TRUE(contains(kept.conflictingConcepts, "c4"));
+    EXPECT_TRUE(kept.changes.removedConcepts.empty());
+    EXPECT_TRUE(contains(kept.conflictingRelationships, "r-theirs"));
+    EXPECT_TRUE(kept.changes.addedRelationships.empty());
+
+    ModelMerge taken = merge(*base, *ours, *theirs, ConflictResolution::TAKE_THEIRS);
+    EXPECT_TRUE(contains(taken.conflictingConcepts, "c4"));
+    EXPECT_EQ(taken.changes.removedConcepts, std::vector<std::string>{"c4"});
+}
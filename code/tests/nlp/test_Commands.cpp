@@ -3,6 +3,7 @@
 #include "../../core/model/MentalModel.h"
 #include "../../core/model/Concept.h"
 #include "../../core/model/Relationship.h"
+#include "../../core/model/ModelDiff.h"
 #include <memory>
 
 using namespace qlink;
@@ -412,3 +413,65 @@ TEST_F(CommandsTest, MultipleUndoCallsAreSafe) {
     EXPECT_NO_THROW(cmd.undo());
     EXPECT_EQ(model->getConcepts().size(), sizeAfterFirstUndo);
 }
+
+// ApplyDiffCommand Tests
+TEST_F(CommandsTest, ApplyDiffBringsModelToTargetAndUndoRestoresIt) {
+    model->addConcept(std::make_unique<Concept>("a", "A", "First"));
+    model->addConcept(std::make_unique<Concept>("b", "B", "Second"));
+    model->addConcept(std::make_unique<Concept>("c", "C", "Third"));
+    model->addRelationship(std::make_unique<Relationship>("ab", "a", "b", "extends", true, 1.0));
+    model->addRelationship(std::make_unique<Relationship>("bc", "b", "c", "extends", true, 1.0));
+    auto original = model->clone();
+
+    auto target = model->clone();
+    target->getConcept("a")->setDescription("Edited");
+    target->removeConcept("c");
+    target->addConcept(std::make_unique<Concept>("d", "D", "Fourth"));
+    target->removeRelationship("ab");
+    target->addRelationship(std::make_unique<Relationship>("ab", "a", "d", "extends", true, 0.5));
+
+    ApplyDiffCommand cmd(model.get(), diff(*model, *target), "Merge");
+    target.reset(); // The command holds its own copies
+    EXPECT_EQ(cmd.getDescription(), "Merge");
+
+    cmd.execute();
+    EXPECT_EQ(model->getConcept("a")->getDescription(), "Edited");
+    EXPECT_EQ(model->getConcept("c"), nullptr);
+    EXPECT_EQ(model->getConcept("d")->getName(), "D");
+    EXPECT_EQ(model->getRelationship("bc"), nullptr);
+    ASSERT_NE(model->getRelationship("ab"), nullptr);
+    EXPECT_EQ(model->getRelationship("ab")->getTargetConceptId(), "d");
+
+    cmd.undo();
+    EXPECT_TRUE(diff(*original, *model).isEmpty());
+    EXPECT_EQ(model->getRelationship("ab")->getTargetConceptId(), "b");
+    EXPECT_EQ(model->getConcept("a")->getDescription(), "First");
+    EXPECT_NE(model->getRelationship("bc"), nullptr);
+
+    cmd.execute();
+    EXPECT_EQ(model->getConcept("c"), nullptr);
+    EXPECT_EQ(model->getConcept("a")->getDescription(), "Edited");
+}
+
+TEST_F(CommandsTest, ApplyDiffOfAMergeIsOneUndoableStep) {
+    model->addConcept(std::make_unique<Concept>("a", "A", "First"));
+    model->addConcept(std::make_unique<Concept>("b", "B", "Second"));
+    auto base = model->clone();
+    auto theirs = model->clone();
+    model->getConcept("a")->setDescription("Ours");
+    theirs->getConcept("b")->setDescription("Theirs");
+    theirs->addRelationship(std::make_unique<Relationship>("ab", "a", "b", "extends", true, 1.0));
+
+    ModelMerge result = merge(*base, *model, *theirs);
+    ApplyDiffCommand cmd(model.get(), result.changes);
+    EXPECT_EQ(cmd.getCommands().size(), 2u);
+
+    cmd.execute();
+    EXPECT_EQ(model->getConcept("a")->getDescription(), "Ours");
+    EXPECT_EQ(model->getConcept("b")->getDescription(), "Theirs");
+    EXPECT_NE(model->getRelationship("ab"), nullptr);
+
+    cmd.undo();
+    EXPECT_EQ(model->getConcept("b")->getDescription(), "Second");
+    EXPECT_EQ(model->getRelationship("ab"), nullptr);
+}
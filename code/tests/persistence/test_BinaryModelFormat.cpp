@@ -0,0 +1,298 @@
+#include <gtest/gtest.h>
+#include "../../core/persistence/BinaryModelFormat.h"
+#include "../../core/persistence/ModelManager.h"
+#include "../../core/model/MentalModel.h"
+#include "../../core/common/QLinkException.h"
+#include <QTemporaryDir>
+#include <cstring>
+
+using namespace qlink;
+
+class BinaryModelFormatTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        model = std::make_unique<MentalModel>("Physics");
+
+        auto energy = std::make_unique<Concept>("c1", "Energy", "Capacity to do work");
+        energy->addTag("physics");
+        energy->addTag("core");
+        energy->setPosition(Position(10.5, -3.0));
+        model->addConcept(std::move(energy));
+
+        auto work = std::make_unique<Concept>("c2", "Work", "");
+        work->addTag("physics");
+        model->addConcept(std::move(work));
+
+        model->addConcept(std::make_unique<Concept>("c3", "Power", "Rate of work"));
+
+        model->addRelationship(std::make_unique<Relationship>("r1", "c1", "c2", "enables", true, 0.8));
+        model->addRelationship(std::make_unique<Relationship>("r2", "c3", "c2", "measures", false, 1.0));
+    }
+
+    std::unique_ptr<MentalModel> model;
+};
+
+TEST_F(BinaryModelFormatTest, ViewReadsStringsWithoutCopying) {
+    std::string encoded = BinaryModelWriter::encode(*model);
+    BinaryModelView view(encoded.data(), encoded.size());
+
+    EXPECT_EQ(view.getModelName(), "Physics");
+    ASSERT_EQ(view.getConceptCount(), 3u);
+    ASSERT_EQ(view.getRelationshipCount(), 2u);
+
+    auto energy = view.getConcept(0);
+    EXPECT_EQ(energy.id, "c1");
+    EXPECT_EQ(energy.name, "Energy");
+    EXPECT_EQ(energy.description, "Capacity to do work");
+    EXPECT_EQ(energy.position, Position(10.5, -3.0));
+    EXPECT_GE(energy.name.data(), encoded.data());
+    EXPECT_LT(energy.name.data(), encoded.data() + encoded.size());
+
+    auto tags = view.getTags(0);
+    ASSERT_EQ(tags.size(), 2u);
+    EXPECT_EQ(tags[0], "physics");
+    EXPECT_EQ(tags[1], "core");
+
+    auto enables = view.getRelationship(0);
+    EXPECT_EQ(enables.id, "r1");
+    EXPECT_EQ(enables.type, "enables");
+    EXPECT_EQ(enables.source, 0u);
+    EXPECT_EQ(enables.target, 1u);
+    EXPECT_DOUBLE_EQ(enables.weight, 0.8);
+    EXPECT_TRUE(enables.directed);
+}
+
+TEST_F(BinaryModelFormatTest, RepeatedStringsAreStoredOnce) {
+    std::string encoded = BinaryModelWriter::encode(*model);
+    BinaryModelView view(encoded.data(), encoded.size());
+
+    EXPECT_EQ(view.getTags(0)[0].data(), view.getTags(1)[0].data());
+}
+
+TEST_F(BinaryModelFormatTest, AdjacencyListsBothEndpoints) {
+    std::string encoded = BinaryModelWriter::encode(*model);
+    BinaryModelView view(encoded.data(), encoded.size());
+
+    auto work = view.getNeighbors(1);
+    ASSERT_EQ(work.size(), 2u);
+    EXPECT_EQ(work[0].neighbor, 0u);
+    EXPECT_EQ(work[0].relationship, 0u);
+    EXPECT_EQ(work[1].neighbor, 2u);
+    EXPECT_EQ(work[1].relationship, 1u);
+
+    EXPECT_EQ(view.getNeighbors(0).size(), 1u);
+    EXPECT_EQ(view.getNeighbors(2).size(), 1u);
+}
+
+TEST_F(BinaryModelFormatTest, FindConceptById) {
+    std::string encoded = BinaryModelWriter::encode(*model);
+    BinaryModelView view(encoded.data(), encoded.size());
+
+    EXPECT_EQ(view.findConcept("c3"), 2);
+    EXPECT_EQ(view.findConcept("missing"), -1);
+}
+
+TEST_F(BinaryModelFormatTest, MaterializedModelMatchesOriginal) {
+    std::string encoded = BinaryModelWriter::encode(*model);
+    auto loaded = BinaryModelView(encoded.data(), encoded.size()).toModel();
+
+    EXPECT_EQ(loaded->getModelName(), "Physics");
+    ASSERT_EQ(loaded->getConceptCount(), 3u);
+    ASSERT_EQ(loaded->getRelationshipCount(), 2u);
+
+    const Concept* energy = loaded->getConcept("c1");
+    ASSERT_NE(energy, nullptr);
+    EXPECT_EQ(energy->getDescription(), "Capacity to do work");
+    EXPECT_EQ(energy->getTags(), (std::vector<std::string>{"physics", "core"}));
+    EXPECT_EQ(energy->getPosition(), Position(10.5, -3.0));
+
+    const Relationship* measures = loaded->getRelationship("r2");
+    ASSERT_NE(measures, nullptr);
+    EXPECT_EQ(measures->getSourceConceptId(), "c3");
+    EXPECT_EQ(measures->getTargetConceptId(), "c2");
+    EXPECT_EQ(measures->getType(), "measures");
+    EXPECT_FALSE(measures->getIsDirected());
+}
+
+TEST_F(BinaryModelFormatTest, LazyModelReadsPayloadsFromTheView) {
+    std::string encoded = BinaryModelWriter::encode(*model);
+    auto view = std::make_shared<const BinaryModelView>(encoded.data(), encoded.size());
+    auto loaded = BinaryModelView::toLazyModel(view, 2);
+    view.reset();
+
+    ASSERT_EQ(loaded->getConceptCount(), 3u);
+    EXPECT_EQ(loaded->getRelationshipCount(), 2u);
+    const Concept* energy = loaded->getConcept("c1");
+    ASSERT_NE(energy, nullptr);
+    EXPECT_EQ(energy->getName(), "Energy");
+    EXPECT_EQ(energy->getPosition(), Position(10.5, -3.0));
+    EXPECT_FALSE(energy->isPayloadLoaded());
+
+    EXPECT_EQ(energy->getDescription(), "Capacity to do work");
+    EXPECT_EQ(energy->getTags(), (std::vector<std::string>{"physics", "core"}));
+    EXPECT_EQ(loaded->getConcept("c2")->getTags(), std::vector<std::string>{"physics"});
+    EXPECT_EQ(loaded->getConcept("c3")->getDescription(), "Rate of work");
+    EXPECT_FALSE(energy->isPayloadLoaded());
+    EXPECT_EQ(loaded->getPayloadCache()->getLoadedCount(), 2u);
+
+    // Lazy or not, the model encodes the same
+    EXPECT_EQ(BinaryModelWriter::encode(*loaded), encoded);
+}
+
+TEST_F(BinaryModelFormatTest, EmptyModelRoundTrips) {
+    MentalModel empty("Empty");
+    std::string encoded = BinaryModelWriter::encode(empty);
+    BinaryModelView view(encoded.data(), encoded.size());
+
+    EXPECT_EQ(view.getConceptCount(), 0u);
+    EXPECT_EQ(view.findConcept("c1"), -1);
+    EXPECT_TRUE(view.toModel()->isEmpty());
+}
+
+TEST_F(BinaryModelFormatTest, CorruptionIsDetected) {
+    std::string encoded = BinaryModelWriter::encode(*model);
+
+    std::string flipped = encoded;
+    flipped[flipped.size() - 1] ^= 0x01;
+    EXPECT_THROW(BinaryModelView(flipped.data(), flipped.size()), FileIOException);
+    EXPECT_NO_THROW(BinaryModelView(flipped.data(), flipped.size(), false));
+
+    std::string truncated = encoded.substr(0, encoded.size() - 8);
+    EXPECT_THROW(BinaryModelView(truncated.data(), truncated.size()), FileIOException);
+
+    std::string wrongMagic = encoded;
+    wrongMagic[0] = 'X';
+    EXPECT_THROW(BinaryModelView(wrongMagic.data(), wrongMagic.size()), FileIOException);
+
+    std::string newerVersion = encoded;
+    uint32_t version = binary_format::VERSION + 1;
+    std::memcpy(&newerVersion[4], &version, sizeof(version));
+    EXPECT_THROW(BinaryModelView(newerVersion.data(), newerVersion.size()), FileIOException);
+}
+
+TEST_F(BinaryModelFormatTest, ModelManagerLoadsMappedFile) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QString path = dir.filePath("model.qlinkb");
+
+    ModelManager manager;
+    ASSERT_TRUE(manager.saveModel(*model, path));
+
+    auto view = BinaryModelView::open(path.toStdString());
+    EXPECT_EQ(view->getConcept(2).name, "Power");
+
+    auto loaded = manager.loadModel(path);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getConceptCount(), 3u);
+    EXPECT_NE(loaded->getRelationship("r1"), nullptr);
+}
+
+TEST_F(BinaryModelFormatTest, ExportAddsExtension) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    ModelManager manager;
+    ASSERT_TRUE(manager.exportModel(*model, dir.filePath("export"), ExportFormat::BINARY));
+
+    auto loaded = manager.loadModel(dir.filePath("export.qlinkb"));
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getModelName(), "Physics");
+}
+
+namespace {
+
+uint64_t fileContentHash(const QString& path) {
+    auto view = BinaryModelView::open(path.toStdString());
+    return BinaryModelView::contentHash(view->getData(), view->getSize());
+}
+
+} // namespace
+
+TEST_F(BinaryModelFormatTest, TimesRoundTrip) {
+    model->getConcept("c1")->setTimestamps(1000, 2000);
+    std::string encoded = BinaryModelWriter::encode(*model);
+    BinaryModelView view(encoded.data(), encoded.size());
+
+    EXPECT_EQ(view.getConcept(0).created, 1000);
+    EXPECT_EQ(view.getConcept(0).modified, 2000);
+    EXPECT_EQ(view.materializeConcept(0)->getModified(), 2000);
+}
+
+TEST_F(BinaryModelFormatTest, PatchRewritesChangedRecordsInPlace) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QString path = dir.filePath("model.qlinkb");
+    BinaryModelWriter::write(*model, path.toStdString());
+    uint64_t baseHash = fileContentHash(path);
+    model->markClean();
+
+    Concept* energy = model->getConcept("c1");
+    energy->setName("Kinetic energy");
+    energy->removeTag("physics");
+    energy->setPosition(Position(1.0, 2.0));
+    model->notifyConceptModified("c1");
+    model->getRelationship("r1")->setWeight(0.25);
+    model->notifyRelationshipModified("r1");
+    model->setModelName("Mechanics");
+
+    uint64_t patchedHash = 0;
+    ASSERT_TRUE(BinaryModelPatcher::patch(path.toStdString(), baseHash, *model, model->getChanges(), patchedHash));
+    EXPECT_NE(patchedHash, baseHash);
+    EXPECT_EQ(fileContentHash(path), patchedHash);
+    EXPECT_FALSE(QFile::exists(QString::fromStdString(BinaryModelPatcher::redoPathFor(path.toStdString()))));
+
+    // Opening verifies the checksum
+    auto loaded = BinaryModelView::open(path.toStdString())->toModel();
+    EXPECT_EQ(loaded->getModelName(), "Mechanics");
+    const Concept* patched = loaded->getConcept("c1");
+    ASSERT_NE(patched, nullptr);
+    EXPECT_EQ(patched->getName(), "Kinetic energy");
+    EXPECT_EQ(patched->getTags(), std::vector<std::string>{"core"});
+    EXPECT_EQ(patched->getPosition(), Position(1.0, 2.0));
+    EXPECT_EQ(patched->getModified(), energy->getModified());
+    EXPECT_DOUBLE_EQ(loaded->getRelationship("r1")->getWeight(), 0.25);
+    EXPECT_EQ(loaded->getConcept("c2")->getTags(), std::vector<std::string>{"physics"});
+}
+
+TEST_F(BinaryModelFormatTest, PatchDeclinesWhatNeedsARewrite) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QString path = dir.filePath("model.qlinkb");
+    BinaryModelWriter::write(*model, path.toStdString());
+    uint64_t baseHash = fileContentHash(path);
+    uint64_t patchedHash = 0;
+
+    // Tags beyond the concept's range
+    model->markClean();
+    model->getConcept("c2")->addTag("mechanics");
+    model->notifyConceptModified("c2");
+    EXPECT_FALSE(BinaryModelPatcher::patch(path.toStdString(), baseHash, *model, model->getChanges(), patchedHash));
+
+    // A file other than the one the changes are relative to
+    model->getConcept("c2")->removeTag("mechanics");
+    EXPECT_FALSE(BinaryModelPatcher::patch(path.toStdString(), baseHash + 1, *model, model->getChanges(), patchedHash));
+
+    // Added entities
+    model->addConcept(std::make_unique<Concept>("c4", "Force", ""));
+    EXPECT_FALSE(BinaryModelPatcher::patch(path.toStdString(), baseHash, *model, model->getChanges(), patchedHash));
+
+    EXPECT_EQ(fileContentHash(path), baseHash);
+}
+
+TEST_F(BinaryModelFormatTest, RecoverDropsStaleRedoFile) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QString path = dir.filePath("model.qlinkb");
+    BinaryModelWriter::write(*model, path.toStdString());
+    uint64_t baseHash = fileContentHash(path);
+
+    QString redoPath = QString::fromStdString(BinaryModelPatcher::redoPathFor(path.toStdString()));
+    QFile redo(redoPath);
+    ASSERT_TRUE(redo.open(QIODevice::WriteOnly));
+    redo.write("QLBP not a redo file", 20);
+    redo.close();
+
+    BinaryModelPatcher::recover(path.toStdString());
+    EXPECT_FALSE(QFile::exists(redoPath));
+    EXPECT_EQ(fileContentHash(path), baseHash);
+}
@@ -0,0 +1,268 @@
+#include <gtest/gtest.h>
+#include "../../core/persistence/GraphInterchange.h"
+#include "../../core/model/MentalModel.h"
+#include "../../core/common/QLinkException.h"
+#include <QBuffer>
+#include <QThreadPool>
+
+using namespace qlink;
+
+class GraphInterchangeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        model = std::make_unique<MentalModel>("Physics");
+        pool.setMaxThreadCount(4);
+    }
+
+    ImportResult importEdges(const std::string& text, char delimiter = ',') {
+        return GraphImporter::importEdgeList(*model, text.data(), text.size(), delimiter, &pool);
+    }
+
+    ImportResult importNodes(const std::string& text, char delimiter = ',') {
+        return GraphImporter::importNodes(*model, text.data(), text.size(), delimiter, &pool);
+    }
+
+    static GraphExporter::WriteFunction appendTo(std::string& out) {
+        return [&out](const char* data, size_t size) {
+            out.append(data, size);
+            return true;
+        };
+    }
+
+    std::unique_ptr<MentalModel> model;
+    QThreadPool pool;
+};
+
+TEST_F(GraphInterchangeTest, EdgeEndpointsResolveByIdThenNameThenAsNewConcepts) {
+    model->addConcept(std::make_unique<Concept>("c1", "Energy", ""));
+    auto result = importEdges(
+        "source,target,type,weight\n"
+        "c1,Work,enables,0.5\n"
+        "Energy,Heat,\"becomes, partly\",2\n"
+        "Work,Heat,,\n");
+
+    EXPECT_EQ(result.concepts, 2u);
+    EXPECT_EQ(result.relationships, 3u);
+    EXPECT_EQ(result.skipped, 0u);
+    ASSERT_EQ(model->getConceptCount(), 3u);
+    ASSERT_NE(model->getConcept("Work"), nullptr);
+    EXPECT_EQ(model->getConcept("Work")->getName(), "Work");
+
+    const Relationship* first = model->getRelationship("edge_0");
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first->getSourceConceptId(), "c1");
+    EXPECT_EQ(first->getTargetConceptId(), "Work");
+    EXPECT_DOUBLE_EQ(first->getWeight(), 0.5);
+    EXPECT_TRUE(first->getIsDirected());
+
+    const Relationship* second = model->getRelationship("edge_1");
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(second->getSourceConceptId(), "c1");
+    EXPECT_EQ(second->getType(), "becomes, partly");
+
+    const Relationship* third = model->getRelationship("edge_2");
+    ASSERT_NE(third, nullptr);
+    EXPECT_EQ(third->getType(), "relates_to");
+    EXPECT_DOUBLE_EQ(third->getWeight(), 1.0);
+}
+
+TEST_F(GraphInterchangeTest, HeaderlessRowsFollowTheExportColumnOrder) {
+    auto result = importEdges("a\tb\tcauses\t3\tfalse\tr1\r\n\r\n b \t c \r\n", '\t');
+    EXPECT_EQ(result.relationships, 2u);
+    const Relationship* named = model->getRelationship("r1");
+    ASSERT_NE(named, nullptr);
+    EXPECT_EQ(named->getType(), "causes");
+    EXPECT_FALSE(named->getIsDirected());
+    EXPECT_DOUBLE_EQ(named->getWeight(), 3.0);
+    EXPECT_NE(model->getConcept("c"), nullptr); // Unquoted fields are trimmed, \r dropped
+}
+
+TEST_F(GraphInterchangeTest, SkipsRowsWithMissingOrUnreadableFields) {
+    auto result = importEdges(
+        "target,source,weight,directed\n"
+        "b,a,1,yes\n"
+        ",a,1,yes\n"
+        "b,a,heavy,yes\n"
+        "b,a,1,maybe\n");
+    EXPECT_EQ(result.relationships, 1u);
+    EXPECT_EQ(result.skipped, 3u);
+    ASSERT_EQ(model->getRelationshipCount(), 1u);
+    EXPECT_EQ(model->getRelationships()[0]->getSourceConceptId(), "a");
+}
+
+TEST_F(GraphInterchangeTest, EdgeIdsAreUniqueAcrossModelAndFile) {
+    model->addConcept(std::make_unique<Concept>("x", "X", ""));
+    model->addRelationship(std::make_unique<Relationship>("r0", "x", "x", "loops", true, 1.0));
+    auto result = importEdges(
+        "source,target,id\n"
+        "a,b,edge_2\n"
+        "b,c,\n"   // Would be edge_2
+        "c,d,r1\n"
+        "d,e,r1\n" // Given twice
+        "e,f,r0\n"); // Already in the model
+
+    EXPECT_EQ(result.relationships, 3u);
+    EXPECT_EQ(result.skipped, 2u);
+    ASSERT_EQ(model->getRelationshipCount(), 4u);
+    EXPECT_EQ(model->getRelationship("edge_2")->getSourceConceptId(), "a");
+    EXPECT_EQ(model->getRelationship("r1")->getSourceConceptId(), "c");
+    EXPECT_EQ(model->getRelationship("r0")->getType(), "loops");
+    const Relationship* generated = model->getRelationships()[2].get();
+    EXPECT_EQ(generated->getSourceConceptId(), "b");
+    EXPECT_EQ(generated->getId().rfind("rel_", 0), 0u);
+}
+
+TEST_F(GraphInterchangeTest, QuotedLineBreaksSurviveChunking) {
+    // Several chunks' worth, with quoted line breaks throughout
+    std::string text = "source,target,type\n";
+    const int rows = 60000;
+    for (int i = 0; i < rows; ++i) {
+        text += "n" + std::to_string(i % 1000) + ",n" + std::to_string((i + 1) % 1000) + ",\"line one\nline \"\"two\"\"\"\n";
+    }
+    auto result = importEdges(text);
+    EXPECT_EQ(result.relationships, static_cast<size_t>(rows));
+    EXPECT_EQ(result.concepts, 1000u);
+    EXPECT_EQ(result.skipped, 0u);
+
+    const Relationship* last = model->getRelationship("edge_" + std::to_string(rows - 1));
+    ASSERT_NE(last, nullptr);
+    EXPECT_EQ(last->getType(), "line one\nline \"two\"");
+    EXPECT_EQ(last->getSourceConceptId(), "n" + std::to_string((rows - 1) % 1000));
+}
+
+TEST_F(GraphInterchangeTest, MalformedFileLeavesTheModelUntouched) {
+    model->addConcept(std::make_unique<Concept>("c1", "Energy", ""));
+    EXPECT_THROW(importEdges("source,target\nc1,Work\nc1,\"Heat\n"), ParseException);
+    EXPECT_THROW(importEdges("source,target\nc1,\"Heat\" x\n"), ParseException);
+    EXPECT_THROW(importEdges("source,to_id\nc1,Work\n"), ParseException); // Header without a target
+    EXPECT_EQ(model->getConceptCount(), 1u);
+    EXPECT_EQ(model->getRelationshipCount(), 0u);
+}
+
+TEST_F(GraphInterchangeTest, ImportsNodeTables) {
+    model->addConcept(std::make_unique<Concept>("c1", "Energy", ""));
+    auto result = importNodes(
+        "name,id,tags,x,y,extra\n"
+        "Work,c2,\"physics; mechanics\",1.5,-2,ignored\n"
+        "Energy again,c1,,,\n"
+        "Heat,,,,\n"
+        "Power,c2,,,\n"
+        "Bad,c3,,left,\n");
+
+    EXPECT_EQ(result.concepts, 2u);
+    EXPECT_EQ(result.skipped, 3u); // c1 exists, c2 repeats, c3 has a bad x
+    const Concept* work = model->getConcept("c2");
+    ASSERT_NE(work, nullptr);
+    EXPECT_EQ(work->getName(), "Work");
+    EXPECT_EQ(work->getTags(), (std::vector<std::string>{"physics", "mechanics"}));
+    EXPECT_DOUBLE_EQ(work->getPosition().x, 1.5);
+    EXPECT_DOUBLE_EQ(work->getPosition().y, -2.0);
+    EXPECT_EQ(model->getConcept("c1")->getName(), "Energy");
+    EXPECT_NE(model->getConcept("Heat"), nullptr); // Named only, so the name is its id
+}
+
+TEST_F(GraphInterchangeTest, ExportedTablesReadBack) {
+    auto energy = std::make_unique<Concept>("c1", "Energy, \"kinetic\"", "Line one\nLine two");
+    energy->addTag("physics");
+    energy->addTag("core");
+    energy->setPosition(Position(0.1, 2.0 / 3.0));
+    model->addConcept(std::move(energy));
+    model->addConcept(std::make_unique<Concept>("c2", " Work ", ""));
+    model->addRelationship(std::make_unique<Relationship>("r1", "c1", "c2", "enables", true, 0.25));
+    model->addRelationship(std::make_unique<Relationship>("r2", "c2", "c1", "needs", false, 1.0 / 3.0));
+
+    for (char delimiter : {',', '\t'}) {
+        std::string nodes, edges;
+        GraphExporter::writeNodes(*model, appendTo(nodes), delimiter);
+        GraphExporter::writeEdgeList(*model, appendTo(edges), delimiter);
+
+        MentalModel loaded("Loaded");
+        GraphImporter::importNodes(loaded, nodes.data(), nodes.size(), delimiter, &pool);
+        auto result = GraphImporter::importEdgeList(loaded, edges.data(), edges.size(), delimiter, &pool);
+        EXPECT_EQ(result.concepts, 0u);
+        ASSERT_EQ(loaded.getConceptCount(), 2u);
+        ASSERT_EQ(loaded.getRelationshipCount(), 2u);
+
+        const Concept* concept = loaded.getConcept("c1");
+        ASSERT_NE(concept, nullptr);
+        EXPECT_EQ(concept->getName(), "Energy, \"kinetic\"");
+        EXPECT_EQ(concept->getDescription(), "Line one\nLine two");
+        EXPECT_EQ(concept->getTags(), (std::vector<std::string>{"physics", "core"}));
+        EXPECT_EQ(concept->getPosition().y, 2.0 / 3.0);
+        EXPECT_EQ(loaded.getConcept("c2")->getName(), " Work ");
+
+        const Relationship* needs = loaded.getRelationship("r2");
+        ASSERT_NE(needs, nullptr);
+        EXPECT_FALSE(needs->getIsDirected());
+        EXPECT_EQ(needs->getWeight(), 1.0 / 3.0);
+    }
+}
+
+TEST_F(GraphInterchangeTest, GraphMLRoundTrip) {
+    auto energy = std::make_unique<Concept>("c1", "Energy <E> & \"friends\"", "Line one\nLine two");
+    energy->addTag("physics");
+    energy->setPosition(Position(3.5, -1.25));
+    model->addConcept(std::move(energy));
+    model->addConcept(std::make_unique<Concept>("c2", "Work", ""));
+    model->addRelationship(std::make_unique<Relationship>("r1", "c1", "c2", "enables", false, 0.75));
+
+    std::string xml;
+    GraphExporter::writeGraphML(*model, appendTo(xml));
+    QByteArray bytes = QByteArray::fromStdString(xml);
+    QBuffer buffer(&bytes);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+
+    MentalModel loaded("Loaded");
+    auto result = GraphImporter::importGraphML(loaded, buffer);
+    EXPECT_EQ(result.concepts, 2u);
+    EXPECT_EQ(result.relationships, 1u);
+    const Concept* concept = loaded.getConcept("c1");
+    ASSERT_NE(concept, nullptr);
+    EXPECT_EQ(concept->getName(), "Energy <E> & \"friends\"");
+    EXPECT_EQ(concept->getDescription(), "Line one\nLine two");
+    EXPECT_EQ(concept->getTags(), std::vector<std::string>{"physics"});
+    EXPECT_DOUBLE_EQ(concept->getPosition().x, 3.5);
+    const Relationship* relationship = loaded.getRelationship("r1");
+    ASSERT_NE(relationship, nullptr);
+    EXPECT_EQ(relationship->getType(), "enables");
+    EXPECT_FALSE(relationship->getIsDirected());
+    EXPECT_DOUBLE_EQ(relationship->getWeight(), 0.75);
+}
+
+TEST_F(GraphInterchangeTest, GraphMLFromOtherToolsGoesByKeyNames) {
+    QByteArray bytes(R"(<?xml version="1.0" encoding="UTF-8"?>
+<graphml xmlns="http://graphml.graphdrawing.org/xmlns">
+  <key id="d0" for="node" attr.name="label" attr.type="string"/>
+  <key id="d1" for="edge" attr.name="Label" attr.type="string"/>
+  <key id="d2" for="edge" attr.name="weight" attr.type="double"/>
+  <graph id="G" edgedefault="undirected">
+    <node id="n0"><data key="d0">Rain</data></node>
+    <node id="n1"><data key="d0">Flood</data><graph id="nested"><node id="inner"/></graph></node>
+    <edge source="n0" target="n1"><data key="d1">causes</data><data key="d2">2.5</data></edge>
+    <edge source="n1" target="n2" directed="true"/>
+  </graph>
+</graphml>)");
+    QBuffer buffer(&bytes);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+
+    auto result = GraphImporter::importGraphML(*model, buffer);
+    EXPECT_EQ(result.concepts, 3u); // n0, n1 and the undeclared n2
+    EXPECT_EQ(result.relationships, 2u);
+    EXPECT_EQ(model->getConcept("inner"), nullptr);
+    EXPECT_EQ(model->getConcept("n0")->getName(), "Rain");
+
+    const Relationship* causes = model->getRelationship("edge_0");
+    ASSERT_NE(causes, nullptr);
+    EXPECT_EQ(causes->getType(), "causes");
+    EXPECT_FALSE(causes->getIsDirected());
+    EXPECT_DOUBLE_EQ(causes->getWeight(), 2.5);
+    EXPECT_TRUE(model->getRelationship("edge_1")->getIsDirected());
+}
+
+TEST_F(GraphInterchangeTest, MalformedGraphMLThrows) {
+    QByteArray bytes("<graphml><graph><node id=\"n0\"></graph></graphml>");
+    QBuffer buffer(&bytes);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+    EXPECT_THROW(GraphImporter::importGraphML(*model, buffer), ParseException);
+    EXPECT_EQ(model->getConceptCount(), 0u);
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include "../../core/persistence/JsonStream.h"
+#include "../../core/common/QLinkException.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+using namespace qlink;
+
+namespace {
+
+// Feeds input in small pieces so records straddle chunk boundaries
+JsonRecordReader::ReadFunction readFrom(const std::string& input, size_t pieceSize = 7) {
+    auto offset = std::make_shared<size_t>(0);
+    return [input, offset, pieceSize](char* buffer, size_t capacity) {
+        size_t count = std::min({capacity, pieceSize, input.size() - *offset});
+        std::memcpy(buffer, input.data() + *offset, count);
+        *offset += count;
+        return static_cast<int64_t>(count);
+    };
+}
+
+struct Collected {
+    int models = 0;
+    std::string name;
+    std::vector<std::string> concepts;
+    std::vector<std::string> relationships;
+
+    JsonRecordReader::Handler handler() {
+        JsonRecordReader::Handler handler;
+        handler.onModelBegin = [this]() {
+            ++models;
+            name.clear();
+            concepts.clear();
+            relationships.clear();
+        };
+        handler.onModelName = [this](const std::string& text) { name = text; };
+        handler.onConcept = [this](const std::string& json) { concepts.push_back(json); };
+        handler.onRelationship = [this](const std::string& json) { relationships.push_back(json); };
+        return handler;
+    }
+};
+
+Collected parse(const std::string& input, size_t chunkSize = 16) {
+    Collected collected;
+    JsonRecordReader reader(readFrom(input), chunkSize);
+    reader.parse(collected.handler());
+    return collected;
+}
+
+} // namespace
+
+TEST(JsonRecordReaderTest, ReportsRecordsAsRawJson) {
+    auto collected = parse(R"({
+        "name": "Physics",
+        "version": "1.0",
+        "concepts": [
+            {"id": "c1", "name": "Energy", "tags": ["a", "b"], "position": {"x": 1, "y": 2}},
+            {"id": "c2", "name": "Work \"done\"", "tags": []}
+        ],
+        "relationships": [{"id": "r1", "sourceConceptId": "c1", "targetConceptId": "c2"}],
+        "statistics": {"conceptCount": 2}
+    })");
+
+    EXPECT_EQ(collected.models, 1);
+    EXPECT_EQ(collected.name, "Physics");
+    ASSERT_EQ(collected.concepts.size(), 2u);
+    EXPECT_EQ(collected.concepts[0],
+              R"({"id": "c1", "name": "Energy", "tags": ["a", "b"], "position": {"x": 1, "y": 2}})");
+    EXPECT_EQ(collected.concepts[1], R"({"id": "c2", "name": "Work \"done\"", "tags": []})");
+    ASSERT_EQ(collected.relationships.size(), 1u);
+}
+
+TEST(JsonRecordReaderTest, ModelWrapperReplacesRoot) {
+    auto collected = parse(R"({
+        "concepts": [{"id": "root"}],
+        "model": {"name": "Wrapped", "concepts": [{"id": "c1"}]},
+        "relationships": [{"id": "ignored"}]
+    })");
+
+    EXPECT_EQ(collected.models, 2);
+    EXPECT_EQ(collected.name, "Wrapped");
+    ASSERT_EQ(collected.concepts.size(), 1u);
+    EXPECT_EQ(collected.concepts[0], R"({"id": "c1"})");
+    EXPECT_TRUE(collected.relationships.empty());
+}
+
+TEST(JsonRecordReaderTest, NonObjectModelKeyIsIgnored) {
+    auto collected = parse(R"({"model": "v2", "name": "Root", "concepts": [{"id": "c1"}]})");
+
+    EXPECT_EQ(collected.models, 1);
+    EXPECT_EQ(collected.name, "Root");
+    EXPECT_EQ(collected.concepts.size(), 1u);
+}
+
+TEST(JsonRecordReaderTest, DecodesEscapesInName) {
+    auto collected = parse(R"({"name": "Caf\u00e9 \ud83d\ude00 \\ \/ \n"})");
+    EXPECT_EQ(collected.name, "Caf\xC3\xA9 \xF0\x9F\x98\x80 \\ / \n");
+}
+
+TEST(JsonRecordReaderTest, RejectsUnpairedSurrogatesInName) {
+    EXPECT_THROW(parse(R"({"name": "\ud83d"})"), FileIOException);
+    EXPECT_THROW(parse(R"({"name": "\ud83d\u0041"})"), FileIOException);
+    EXPECT_THROW(parse(R"({"name": "\ude00"})"), FileIOException);
+    EXPECT_THROW(parse(R"({"name": "\ude00\ud83d"})"), FileIOException);
+}
+
+TEST(JsonRecordReaderTest, SkipsUnknownValuesAndNonObjectEntries) {
+    auto collected = parse(R"({"extra": [1, {"a": "]}"}, true, null, -2.5e3],
+                               "concepts": [1, "two", {"id": "c1"}, null]})");
+    ASSERT_EQ(collected.concepts.size(), 1u);
+    EXPECT_EQ(collected.concepts[0], R"({"id": "c1"})");
+}
+
+TEST(JsonRecordReaderTest, RejectsMalformedInput) {
+    EXPECT_THROW(parse("[]"), FileIOException);
+    EXPECT_THROW(parse(""), FileIOException);
+    EXPECT_THROW(parse(R"({"concepts": [{"id": "c1"})"), FileIOException);
+    EXPECT_THROW(parse(R"({"concepts": [{"id": "c1"]]})"), FileIOException);
+    EXPECT_THROW(parse(R"({"name": "x"} trailing)"), FileIOException);
+    EXPECT_THROW(parse(R"({"name" "x"})"), FileIOException);
+}
+
+TEST(JsonRecordReaderTest, MemoryIsBoundedByTheLargestRecord) {
+    std::string input = R"({"concepts": [)";
+    for (int i = 0; i < 1000; ++i) {
+        if (i > 0) input += ",";
+        input += R"({"id": "c)" + std::to_string(i) + R"(", "name": "Concept"})";
+    }
+    input += "]}";
+
+    Collected collected;
+    JsonRecordReader reader(readFrom(input, 4096), 4096);
+    reader.parse(collected.handler());
+
+    EXPECT_EQ(collected.concepts.size(), 1000u);
+    EXPECT_LT(reader.getLargestRecord(), 40u);
+}
+
+TEST(JsonRecordWriterTest, WritesIndentedDocumentInPieces) {
+    std::string output;
+    size_t writes = 0;
+    JsonRecordWriter writer([&](const char* data, size_t size) {
+        output.append(data, size);
+        ++writes;
+        return true;
+    }, 16);
+
+    writer.beginObject();
+    writer.writeString("name", "A \"quoted\"\nname");
+    writer.beginArray("concepts");
+    writer.writeRecord(R"({"id":"c1"})");
+    writer.writeRecord(R"({"id":"c2"})");
+    writer.endArray();
+    writer.beginArray("relationships");
+    writer.endArray();
+    writer.writeBool("done", true);
+    writer.endObject();
+    writer.finish();
+
+    EXPECT_EQ(output,
+              "{\n"
+              "    \"name\": \"A \\\"quoted\\\"\\nname\",\n"
+              "    \"concepts\": [\n"
+              "        {\"id\":\"c1\"},\n"
+              "        {\"id\":\"c2\"}\n"
+              "    ],\n"
+              "    \"relationships\": [],\n"
+              "    \"done\": true\n"
+              "}\n");
+    EXPECT_GT(writes, 1u);
+}
+
+TEST(JsonRecordWriterTest, OutputReadsBack) {
+    std::string output;
+    JsonRecordWriter writer([&](const char* data, size_t size) {
+        output.append(data, size);
+        return true;
+    });
+    writer.beginObject();
+    writer.writeString("name", std::string("Tab\tand \x01 control"));
+    writer.beginArray("concepts");
+    writer.writeRecord(R"({"id":"c1"})");
+    writer.endArray();
+    writer.endObject();
+    writer.finish();
+
+    auto collected = parse(output);
+    EXPECT_EQ(collected.name, "Tab\tand \x01 control");
+    EXPECT_EQ(collected.concepts.size(), 1u);
+}
+
+TEST(JsonRecordWriterTest, FailedWriteThrows) {
+    JsonRecordWriter writer([](const char*, size_t) { return false; });
+    writer.beginObject();
+    writer.endObject();
+    EXPECT_THROW(writer.finish(), FileIOException);
+}
+
+TEST(JsonRecordReaderTest, ReportsRecordSpans) {
+    std::string input = R"({"concepts": [{"id": "c1", "name": "A \"}\""}, {"id": "c2"}], "relationships": [{"id": "r1"}]})";
+    std::vector<std::string> concepts;
+    std::vector<std::string> relationships;
+    JsonRecordReader::Handler handler;
+    handler.onConceptSpan = [&](uint64_t offset, size_t length) { concepts.push_back(input.substr(offset, length)); };
+    handler.onRelationshipSpan = [&](uint64_t offset, size_t length) {
+        relationships.push_back(input.substr(offset, length));
+    };
+
+    JsonRecordReader reader(readFrom(input), 16);
+    reader.parse(handler);
+    EXPECT_EQ(concepts, (std::vector<std::string>{R"({"id": "c1", "name": "A \"}\""})", R"({"id": "c2"})"}));
+    EXPECT_EQ(relationships, std::vector<std::string>{R"({"id": "r1"})"});
+}
@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+#include "../../core/persistence/ModelJournal.h"
+#include "../../core/model/MentalModel.h"
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+
+using namespace qlink;
+
+class ModelJournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(dir.isValid());
+        path = dir.filePath("model.json.qlj").toStdString();
+    }
+
+    // The model as its base file holds it
+    std::unique_ptr<MentalModel> makeBase() {
+        auto model = std::make_unique<MentalModel>("Physics");
+        model->addConcept(std::make_unique<Concept>("c1", "Energy", "Capacity to do work"));
+        model->addConcept(std::make_unique<Concept>("c2", "Work", ""));
+        model->addRelationship(std::make_unique<Relationship>("r1", "c1", "c2", "enables", true, 0.5));
+        return model;
+    }
+
+    qint64 fileSize() const {
+        return QFileInfo(QString::fromStdString(path)).size();
+    }
+
+    QTemporaryDir dir;
+    std::string path;
+};
+
+TEST_F(ModelJournalTest, ReplaysSavedChanges) {
+    Concept power("c3", "Power", "Rate of work");
+    power.addTag("physics");
+    power.setPosition(Position(4.0, -2.5));
+    {
+        ModelJournal journal(path);
+        journal.open(42);
+        journal.recordConcept(power);
+        journal.recordRelationship(Relationship("r2", "c3", "c2", "measures", false, 2.0));
+        journal.recordSavePoint();
+        journal.sync();
+    }
+
+    auto model = makeBase();
+    auto result = ModelJournal::replay(path, 42, *model);
+    EXPECT_TRUE(result.matched);
+    EXPECT_EQ(result.applied, 2u);
+    EXPECT_EQ(result.recovered, 0u);
+
+    const Concept* replayed = model->getConcept("c3");
+    ASSERT_NE(replayed, nullptr);
+    EXPECT_EQ(replayed->getDescription(), "Rate of work");
+    EXPECT_EQ(replayed->getTags(), std::vector<std::string>{"physics"});
+    EXPECT_DOUBLE_EQ(replayed->getPosition().y, -2.5);
+
+    const Relationship* measures = model->getRelationship("r2");
+    ASSERT_NE(measures, nullptr);
+    EXPECT_FALSE(measures->getIsDirected());
+    EXPECT_DOUBLE_EQ(measures->getWeight(), 2.0);
+}
+
+TEST_F(ModelJournalTest, LaterRecordsReplaceEarlierState) {
+    Concept energy("c1", "Energy", "Capacity to do work");
+    energy.addTag("old");
+    ModelJournal journal(path);
+    journal.open(7);
+    journal.recordConcept(energy);
+    energy.setName("Kinetic Energy");
+    energy.removeTag("old");
+    energy.addTag("new");
+    journal.recordConcept(energy);
+    journal.recordRelationship(Relationship("r1", "c1", "c2", "requires", false, 0.25));
+    journal.recordConceptRemoved("c2");
+    journal.recordSavePoint();
+    journal.sync();
+
+    auto model = makeBase();
+    ModelJournal::replay(path, 7, *model);
+    ASSERT_NE(model->getConcept("c1"), nullptr);
+    EXPECT_EQ(model->getConcept("c1")->getName(), "Kinetic Energy");
+    EXPECT_EQ(model->getConcept("c1")->getTags(), std::vector<std::string>{"new"});
+    EXPECT_EQ(model->getConcept("c2"), nullptr);
+    EXPECT_EQ(model->getRelationshipCount(), 0u); // Removed with its concept
+}
+
+TEST_F(ModelJournalTest, ReplayKeepsTimesAndMarksEditsDirty) {
+    Concept energy("c1", "Kinetic Energy", "Capacity to do work");
+    energy.setTimestamps(1000, 5000);
+    Relationship enables("r1", "c1", "c2", "enables", true, 0.75);
+    enables.setTimestamps(2000, 6000);
+    {
+        ModelJournal journal(path);
+        journal.open(9);
+        journal.recordConcept(energy);
+        journal.recordRelationship(enables);
+        journal.recordSavePoint();
+        journal.sync();
+    }
+
+    auto model = makeBase();
+    model->markClean();
+    ModelJournal::replay(path, 9, *model);
+
+    EXPECT_EQ(model->getConcept("c1")->getCreated(), 1000);
+    EXPECT_EQ(model->getConcept("c1")->getModified(), 5000);
+    EXPECT_EQ(model->getRelationship("r1")->getModified(), 6000);
+
+    // Changes to the base, for the next save to write
+    ModelChanges changes = model->getChanges();
+    EXPECT_TRUE(changes.keepsStructure());
+    EXPECT_EQ(changes.modifiedConcepts.size(), 1u);
+    EXPECT_EQ(changes.modifiedRelationships.size(), 1u);
+}
+
+TEST_F(ModelJournalTest, UnsavedChangesAreRecoveredUntilRolledBack) {
+    ModelJournal journal(path);
+    journal.open(7);
+    journal.recordConcept(Concept("c3", "Power", ""));
+    journal.recordSavePoint();
+    journal.recordConcept(Concept("c4", "Heat", ""));
+    journal.sync();
+
+    auto recovered = makeBase();
+    auto result = ModelJournal::replay(path, 7, *recovered);
+    EXPECT_EQ(result.applied, 2u);
+    EXPECT_EQ(result.recovered, 1u);
+    EXPECT_NE(recovered->getConcept("c4"), nullptr);
+
+    journal.recordRollback();
+    journal.sync();
+
+    auto discarded = makeBase();
+    result = ModelJournal::replay(path, 7, *discarded);
+    EXPECT_EQ(result.recovered, 0u);
+    EXPECT_NE(discarded->getConcept("c3"), nullptr);
+    EXPECT_EQ(discarded->getConcept("c4"), nullptr);
+}
+
+TEST_F(ModelJournalTest, IgnoresJournalOfAnotherBase) {
+    ModelJournal journal(path);
+    journal.open(1);
+    journal.recordConceptRemoved("c1");
+    journal.recordSavePoint();
+    journal.sync();
+
+    auto model = makeBase();
+    auto result = ModelJournal::replay(path, 2, *model);
+    EXPECT_FALSE(result.matched);
+    EXPECT_NE(model->getConcept("c1"), nullptr);
+
+    // Opening it for the other base starts over
+    journal.open(2);
+    EXPECT_EQ(fileSize(), static_cast<qint64>(journal.getSize()));
+    EXPECT_EQ(ModelJournal::replay(path, 2, *model).applied, 0u);
+}
+
+TEST_F(ModelJournalTest, StopsAtTornTail) {
+    {
+        ModelJournal journal(path);
+        journal.open(7);
+        journal.recordConcept(Concept("c3", "Power", ""));
+        journal.recordConcept(Concept("c4", "Heat", ""));
+        journal.sync();
+    }
+    // A crash cut the last record short
+    QFile file(QString::fromStdString(path));
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.resize(file.size() - 3));
+    file.close();
+
+    auto model = makeBase();
+    auto result = ModelJournal::replay(path, 7, *model);
+    EXPECT_EQ(result.recovered, 1u);
+    EXPECT_NE(model->getConcept("c3"), nullptr);
+    EXPECT_EQ(model->getConcept("c4"), nullptr);
+
+    // New records go after the last complete one
+    ModelJournal reopened(path);
+    reopened.open(7);
+    reopened.recordConcept(Concept("c5", "Force", ""));
+    reopened.sync();
+
+    model = makeBase();
+    result = ModelJournal::replay(path, 7, *model);
+    EXPECT_EQ(result.recovered, 2u);
+    EXPECT_NE(model->getConcept("c5"), nullptr);
+}
+
+TEST_F(ModelJournalTest, RecordsWaitForABase) {
+    ModelJournal journal(path);
+    journal.recordConcept(Concept("c3", "Power", ""));
+    journal.sync();
+    EXPECT_FALSE(journal.hasBase());
+    EXPECT_FALSE(QFile::exists(QString::fromStdString(path)));
+
+    journal.reset(9, true);
+    journal.sync();
+    auto model = makeBase();
+    auto result = ModelJournal::replay(path, 9, *model);
+    EXPECT_EQ(result.recovered, 1u);
+    EXPECT_NE(model->getConcept("c3"), nullptr);
+}
+
+TEST_F(ModelJournalTest, RebaseKeepsRecordsAfterTheSnapshot) {
+    ModelJournal journal(path);
+    journal.open(1);
+    journal.recordConcept(Concept("c3", "Power", ""));
+    journal.recordSavePoint();
+    journal.sync();
+    uint64_t snapshotOffset = journal.getSize();
+    journal.recordConcept(Concept("c4", "Heat", "")); // Made while the new base is written
+
+    journal.beginRebase(2, snapshotOffset);
+    journal.finishRebase(2, snapshotOffset);
+
+    // The new base already holds c3
+    auto model = makeBase();
+    model->addConcept(std::make_unique<Concept>("c3", "Power", ""));
+    auto result = ModelJournal::replay(path, 2, *model);
+    EXPECT_TRUE(result.matched);
+    EXPECT_EQ(result.applied, 1u);
+    EXPECT_NE(model->getConcept("c4"), nullptr);
+    EXPECT_FALSE(ModelJournal::replay(path, 1, *makeBase()).matched);
+}
+
+TEST_F(ModelJournalTest, InterruptedRebaseReplaysFromTheSnapshot) {
+    uint64_t snapshotOffset;
+    {
+        ModelJournal journal(path);
+        journal.open(1);
+        journal.recordConcept(Concept("c3", "Power", ""));
+        journal.recordSavePoint();
+        journal.sync();
+        snapshotOffset = journal.getSize();
+        journal.recordConcept(Concept("c4", "Heat", ""));
+        journal.beginRebase(2, snapshotOffset);
+        // Crash: the new base replaced the old one, the journal was not rewritten
+    }
+
+    auto model = makeBase();
+    auto result = ModelJournal::replay(path, 2, *model);
+    EXPECT_TRUE(result.matched);
+    EXPECT_EQ(result.applied, 1u);
+    EXPECT_EQ(model->getConcept("c3"), nullptr);
+    EXPECT_NE(model->getConcept("c4"), nullptr);
+
+    // Crash before the new base was in place: the old base still replays everything
+    auto old = makeBase();
+    EXPECT_EQ(ModelJournal::replay(path, 1, *old).applied, 2u);
+
+    // Opening it for the new base finishes the rebase
+    ModelJournal journal(path);
+    journal.open(2);
+    EXPECT_LT(journal.getSize(), snapshotOffset);
+    model = makeBase();
+    EXPECT_EQ(ModelJournal::replay(path, 2, *model).applied, 1u);
+    EXPECT_NE(model->getConcept("c4"), nullptr);
+}
+
+TEST_F(ModelJournalTest, ChangesBetweenSyncsShareOneRecordPerEntity) {
+    ModelJournal journal(path);
+    journal.open(3);
+    Concept power("c3", "Power", "");
+    for (int i = 0; i < 100; ++i) {
+        power.setPosition(Position(i, i));
+        journal.recordConcept(power);
+    }
+    // A relationship to a concept added after it was first recorded
+    journal.recordRelationshipRemoved("r1");
+    journal.recordConcept(Concept("c4", "Heat", ""));
+    journal.recordRelationship(Relationship("r1", "c3", "c4", "produces", true, 1.0));
+    journal.recordSavePoint();
+    journal.sync();
+
+    auto model = makeBase();
+    auto result = ModelJournal::replay(path, 3, *model);
+    EXPECT_EQ(result.applied, 3u);
+    EXPECT_DOUBLE_EQ(model->getConcept("c3")->getPosition().x, 99.0);
+    ASSERT_NE(model->getRelationship("r1"), nullptr);
+    EXPECT_EQ(model->getRelationship("r1")->getTargetConceptId(), "c4");
+}
+
+TEST_F(ModelJournalTest, ConceptRemovedAndAddedBetweenSyncsLosesItsRelationships) {
+    ModelJournal journal(path);
+    journal.open(5);
+    // Removing c1 drops r1 with it, without a record of its own
+    journal.recordConceptRemoved("c1");
+    journal.recordConcept(Concept("c1", "Energy", "Added again"));
+    journal.recordSavePoint();
+    journal.sync();
+
+    auto model = makeBase();
+    auto result = ModelJournal::replay(path, 5, *model);
+    EXPECT_EQ(result.applied, 2u);
+    ASSERT_NE(model->getConcept("c1"), nullptr);
+    EXPECT_EQ(model->getConcept("c1")->getDescription(), "Added again");
+    EXPECT_EQ(model->getRelationship("r1"), nullptr);
+}
@@ -0,0 +1,506 @@
+#include <gtest/gtest.h>
+#include "../../core/persistence/ModelManager.h"
+#include "../../core/persistence/SaveJob.h"
+#include "../../core/persistence/ModelJournal.h"
+#include "../../core/persistence/ModelOverlay.h"
+#include "../../core/persistence/BinaryModelFormat.h"
+#include "../../core/model/MentalModel.h"
+#include "../../core/common/QLinkException.h"
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+#include <QThreadPool>
+#include <functional>
+#include <set>
+
+using namespace qlink;
+
+namespace {
+
+bool waitUntil(const std::function<bool()>& condition, int timeoutMs = 5000) {
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while (!condition()) {
+        if (elapsed.elapsed() > timeoutMs) return false;
+        QEventLoop loop;
+        QTimer::singleShot(5, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+    return true;
+}
+
+} // namespace
+
+class ModelManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(dir.isValid());
+    }
+
+    QString writeFile(const QString& name, const QByteArray& contents) {
+        QString path = dir.filePath(name);
+        QFile file(path);
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(contents);
+        return path;
+    }
+
+    QTemporaryDir dir;
+    ModelManager manager;
+};
+
+TEST_F(ModelManagerTest, JsonRoundTripKeepsIds) {
+    MentalModel model("Physics");
+    auto energy = std::make_unique<Concept>("c1", "Energy", "Capacity to do work");
+    energy->addTag("physics");
+    model.addConcept(std::move(energy));
+    model.addConcept(std::make_unique<Concept>("c2", "Work", ""));
+    model.addRelationship(std::make_unique<Relationship>("r1", "c1", "c2", "enables", true, 0.5));
+
+    QString path = dir.filePath("model.json");
+    ASSERT_TRUE(manager.saveModel(model, path));
+
+    auto loaded = manager.loadModel(path);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getModelName(), "Physics");
+    ASSERT_NE(loaded->getConcept("c1"), nullptr);
+    EXPECT_EQ(loaded->getConcept("c1")->getTags(), std::vector<std::string>{"physics"});
+
+    const Relationship* enables = loaded->getRelationship("r1");
+    ASSERT_NE(enables, nullptr);
+    EXPECT_TRUE(enables->getIsDirected());
+    EXPECT_DOUBLE_EQ(enables->getWeight(), 0.5);
+}
+
+TEST_F(ModelManagerTest, SavingUnchangedModelWritesTheSameBytes) {
+    MentalModel model("Stable");
+    auto energy = std::make_unique<Concept>("c1", "Energy", "");
+    energy->setTimestamps(1714555800000, 1714555800250);
+    model.addConcept(std::move(energy));
+
+    QString path = dir.filePath("model.json");
+    auto contents = [&path]() {
+        QFile file(path);
+        EXPECT_TRUE(file.open(QIODevice::ReadOnly));
+        return file.readAll();
+    };
+    ASSERT_TRUE(manager.saveModel(model, path));
+    QByteArray first = contents();
+    ASSERT_TRUE(manager.saveModel(model, path));
+    EXPECT_EQ(contents(), first);
+
+    auto loaded = manager.loadModel(path);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getConcept("c1")->getCreated(), 1714555800000);
+    EXPECT_EQ(loaded->getConcept("c1")->getModified(), 1714555800250);
+    EXPECT_FALSE(loaded->hasChanges());
+}
+
+TEST_F(ModelManagerTest, LoadsModelWrapper) {
+    QString path = writeFile("wrapped.json", R"({
+        "app": "Qlink",
+        "model": {
+            "name": "Wrapped",
+            "relationships": [{"sourceConceptId": "c1", "targetConceptId": "c2", "type": "uses"}],
+            "concepts": [{"id": "c1", "name": "A"}, {"id": "c2", "name": "B"}]
+        }
+    })");
+
+    auto loaded = manager.loadModel(path);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getModelName(), "Wrapped");
+    EXPECT_EQ(loaded->getConceptCount(), 2u);
+    EXPECT_EQ(loaded->getRelationshipCount(), 1u);
+}
+
+TEST_F(ModelManagerTest, MalformedJsonReportsError) {
+    QString path = writeFile("broken.json", R"({"concepts": [{"id": "c1", "name": "A"})");
+
+    QString error;
+    QObject::connect(&manager, &ModelManager::errorOccurred, [&error](const QString& message) { error = message; });
+
+    EXPECT_EQ(manager.loadModel(path), nullptr);
+    EXPECT_TRUE(error.contains("JSON parse error"));
+}
+
+TEST_F(ModelManagerTest, BackgroundSaveWritesTheSnapshot) {
+    MentalModel model("Snapshot");
+    model.addConcept(std::make_unique<Concept>("c1", "Before", ""));
+
+    QString savedPath;
+    QObject::connect(&manager, &ModelManager::modelSaved, [&savedPath](const QString& path) { savedPath = path; });
+
+    SaveJob* job = manager.saveModelInBackground(model, dir.filePath("snapshot"));
+    EXPECT_EQ(job->getFilePath(), dir.filePath("snapshot.json"));
+    EXPECT_EQ(job->getModelVersion(), model.getVersion());
+    EXPECT_TRUE(manager.isSaving());
+
+    // Edits after the save started are not part of it
+    model.getConcept("c1")->setName("After");
+    model.addConcept(std::make_unique<Concept>("c2", "Added", ""));
+
+    ASSERT_TRUE(waitUntil([&]() { return !savedPath.isEmpty(); }));
+    EXPECT_FALSE(manager.isSaving());
+    EXPECT_EQ(savedPath, dir.filePath("snapshot.json"));
+    EXPECT_TRUE(manager.getRecentFiles().contains(savedPath));
+
+    // The added concept was journaled as an unsaved change
+    manager.stopJournal();
+    auto loaded = manager.loadModel(savedPath);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getConceptCount(), 2u);
+    EXPECT_EQ(manager.getRecoveredChanges(), 1u);
+
+    QFile::remove(QString::fromStdString(ModelJournal::pathFor(savedPath.toStdString())));
+    loaded = manager.loadModel(savedPath);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getConceptCount(), 1u);
+    EXPECT_EQ(loaded->getConcept("c1")->getName(), "Before");
+}
+
+TEST_F(ModelManagerTest, BackgroundSaveReportsProgress) {
+    MentalModel model("Large");
+    for (int i = 0; i < 2000; ++i) {
+        model.addConcept(std::make_unique<Concept>("c" + std::to_string(i), "Concept", ""));
+    }
+
+    SaveJob* job = manager.saveModelInBackground(model, dir.filePath("large.qlinkb"));
+    EXPECT_EQ(job->getTotalRecords(), 2000);
+
+    int lastWritten = -1;
+    bool finished = false;
+    QObject::connect(job, &SaveJob::progressChanged, [&lastWritten](int written, int) { lastWritten = written; });
+    QObject::connect(job, &SaveJob::finished, [&finished]() { finished = true; });
+
+    ASSERT_TRUE(waitUntil([&]() { return finished; }));
+    EXPECT_EQ(lastWritten, 2000);
+    EXPECT_NE(manager.loadModel(dir.filePath("large.qlinkb")), nullptr);
+}
+
+TEST_F(ModelManagerTest, FailedSaveKeepsTheOldFile) {
+    MentalModel model("Original");
+    QString path = dir.filePath("model.json");
+    ASSERT_TRUE(manager.saveModel(model, path));
+
+    // A directory where the temporary file would go cannot be written
+    QString blocked = dir.filePath("missing/model.json");
+    QString error;
+    QObject::connect(&manager, &ModelManager::errorOccurred, [&error](const QString& message) { error = message; });
+    manager.saveModelInBackground(model, blocked);
+    ASSERT_TRUE(waitUntil([&]() { return !error.isEmpty(); }));
+    EXPECT_FALSE(QFile::exists(blocked));
+
+    EXPECT_EQ(manager.loadModel(path)->getModelName(), "Original");
+}
+
+TEST_F(ModelManagerTest, FailedBackgroundSaveKeepsChangesUnsaved) {
+    MentalModel model("Edited");
+    model.addConcept(std::make_unique<Concept>("c1", "Energy", ""));
+    QString path = dir.filePath("model.qlinkb");
+    ASSERT_TRUE(manager.saveModel(model, path));
+    model.addConcept(std::make_unique<Concept>("c2", "Work", ""));
+    model.getConcept("c1")->setName("Power");
+
+    QString error;
+    QObject::connect(&manager, &ModelManager::errorOccurred, [&error](const QString& message) { error = message; });
+    manager.saveModelInBackground(model, dir.filePath("missing/model.qlinkb"));
+    EXPECT_FALSE(model.hasChanges());
+    ASSERT_TRUE(waitUntil([&]() { return !error.isEmpty(); }));
+
+    // Nothing the failed save took as written is lost to the next save
+    EXPECT_TRUE(model.hasChanges());
+    EXPECT_TRUE(model.getConcept("c2")->isDirty());
+    ASSERT_TRUE(manager.saveModel(model, path));
+    auto loaded = manager.loadModel(path);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getConceptCount(), 2u);
+    EXPECT_EQ(loaded->getConcept("c1")->getName(), "Power");
+}
+
+TEST_F(ModelManagerTest, IncrementalSaveAppendsToTheJournal) {
+    MentalModel model("Journaled");
+    model.addConcept(std::make_unique<Concept>("c1", "Energy", ""));
+    QString path = dir.filePath("model.json");
+    ASSERT_TRUE(manager.saveModel(model, path));
+    EXPECT_FALSE(manager.saveIncrementally(model, path)); // Not journaled yet
+
+    ASSERT_TRUE(manager.startJournal(model, path));
+    qint64 baseSize = QFileInfo(path).size();
+    model.addConcept(std::make_unique<Concept>("c2", "Work", ""));
+    model.addRelationship(std::make_unique<Relationship>("r1", "c1", "c2", "enables", true, 1.0));
+    ASSERT_TRUE(manager.saveIncrementally(model, path));
+    EXPECT_EQ(QFileInfo(path).size(), baseSize);
+
+    ModelManager reader;
+    auto loaded = reader.loadModel(path);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getConceptCount(), 2u);
+    EXPECT_NE(loaded->getRelationship("r1"), nullptr);
+    EXPECT_EQ(reader.getRecoveredChanges(), 0u);
+}
+
+TEST_F(ModelManagerTest, IncrementalSavePatchesABinaryBase) {
+    MentalModel model("Patched");
+    model.addConcept(std::make_unique<Concept>("c1", "Energy", ""));
+    model.addConcept(std::make_unique<Concept>("c2", "Work", ""));
+    QString path = dir.filePath("model.qlinkb");
+    QString journalPath = QString::fromStdString(ModelJournal::pathFor(path.toStdString()));
+    ASSERT_TRUE(manager.saveModel(model, path));
+    ASSERT_TRUE(manager.startJournal(model, path));
+    qint64 emptyJournal = QFileInfo(journalPath).size();
+
+    model.getConcept("c1")->setName("Kinetic energy");
+    model.notifyConceptModified("c1");
+    ASSERT_TRUE(manager.saveIncrementally(model, path));
+    EXPECT_FALSE(model.hasChanges());
+    EXPECT_EQ(QFileInfo(journalPath).size(), emptyJournal); // The base holds the change
+
+    // Added concepts need a new base, so they stay in the journal
+    model.addConcept(std::make_unique<Concept>("c3", "Power", ""));
+    ASSERT_TRUE(manager.saveIncrementally(model, path));
+    EXPECT_TRUE(model.hasChanges());
+    manager.stopJournal();
+
+    ModelManager reader;
+    auto loaded = reader.loadModel(path);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getConcept("c1")->getName(), "Kinetic energy");
+    EXPECT_EQ(loaded->getConcept("c1")->getModified(), model.getConcept("c1")->getModified());
+    EXPECT_NE(loaded->getConcept("c3"), nullptr);
+    EXPECT_EQ(reader.getRecoveredChanges(), 0u);
+}
+
+TEST_F(ModelManagerTest, RecoversUnsavedChanges) {
+    QString path = dir.filePath("model.json");
+    {
+        MentalModel model("Journaled");
+        ASSERT_TRUE(manager.saveModel(model, path));
+        ASSERT_TRUE(manager.startJournal(model, path));
+        model.addConcept(std::make_unique<Concept>("c1", "Energy", ""));
+        // The model goes away without being saved; its journal is synced
+    }
+
+    ModelManager reader;
+    auto loaded = reader.loadModel(path);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_NE(loaded->getConcept("c1"), nullptr);
+    EXPECT_EQ(reader.getRecoveredChanges(), 1u);
+
+    // Discarded changes are not offered again
+    ASSERT_TRUE(reader.startJournal(*loaded, path));
+    reader.discardUnsaved();
+    reader.stopJournal();
+    loaded = reader.loadModel(path);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getConceptCount(), 0u);
+}
+
+TEST_F(ModelManagerTest, CompactionFoldsTheJournalIntoTheBase) {
+    MentalModel model("Compacted");
+    QString path = dir.filePath("model.qlinkb");
+    ASSERT_TRUE(manager.saveModel(model, path));
+    ASSERT_TRUE(manager.startJournal(model, path));
+    manager.setJournalCompaction(0.0, 0);
+
+    model.addConcept(std::make_unique<Concept>("c1", "Energy", ""));
+    ASSERT_TRUE(manager.saveIncrementally(model, path));
+    EXPECT_TRUE(manager.isCompacting());
+    model.addConcept(std::make_unique<Concept>("c2", "Work", "")); // While the new base is written
+    ASSERT_TRUE(waitUntil([&]() { return !manager.isCompacting(); }));
+    manager.stopJournal();
+
+    ModelManager reader;
+    auto loaded = reader.loadModel(path);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getConceptCount(), 2u);
+    EXPECT_EQ(reader.getRecoveredChanges(), 1u);
+
+    // The base alone holds everything saved
+    QFile::remove(QString::fromStdString(ModelJournal::pathFor(path.toStdString())));
+    loaded = reader.loadModel(path);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getConceptCount(), 1u);
+    EXPECT_NE(loaded->getConcept("c1"), nullptr);
+}
+
+TEST_F(ModelManagerTest, ParallelParseMatchesStreamingLoad) {
+    // Enough records for several decode chunks
+    MentalModel model("Large");
+    std::string description(200, 'd');
+    for (int i = 0; i < 10000; ++i) {
+        auto concept = std::make_unique<Concept>("c" + std::to_string(i), "Concept " + std::to_string(i), description);
+        concept->addTag("tag" + std::to_string(i % 7));
+        model.addConcept(std::move(concept));
+    }
+    for (int i = 1; i < 10000; ++i) {
+        model.addRelationship(std::make_unique<Relationship>("r" + std::to_string(i), "c" + std::to_string(i - 1),
+                                                             "c" + std::to_string(i), "precedes", true, 1.0));
+    }
+    QString path = dir.filePath("large.json");
+    uint64_t writtenHash = ModelManager::writeModelFile(model, path);
+
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    QByteArray bytes = file.readAll();
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    uint64_t parsedHash = 0;
+    auto parsed = ModelManager::parseModel(bytes.constData(), static_cast<size_t>(bytes.size()), &pool, &parsedHash);
+    EXPECT_EQ(parsedHash, writtenHash);
+
+    auto streamed = manager.loadModel(dir.filePath("large.json"));
+    ASSERT_NE(streamed, nullptr);
+    ASSERT_EQ(parsed->getConceptCount(), streamed->getConceptCount());
+    ASSERT_EQ(parsed->getRelationshipCount(), 9999u);
+    for (size_t i = 0; i < parsed->getConceptCount(); ++i) {
+        EXPECT_EQ(parsed->getConcepts()[i]->getId(), streamed->getConcepts()[i]->getId());
+    }
+    EXPECT_EQ(parsed->getConcept("c42")->getTags(), std::vector<std::string>{"tag0"});
+    EXPECT_NE(parsed->getRelationship("r9999"), nullptr);
+}
+
+TEST_F(ModelManagerTest, ParallelParseGivesRelationshipsWithoutIdsDistinctIds) {
+    // Several decode chunks, whose workers generate the missing ids concurrently
+    std::string json = R"({"concepts": [)";
+    for (int i = 0; i < 2000; ++i) {
+        if (i) json += ",";
+        json += R"({"id": "c)" + std::to_string(i) + R"(", "name": "Concept )" + std::to_string(i) + R"("})";
+    }
+    json += R"(], "relationships": [)";
+    for (int i = 1; i < 40000; ++i) {
+        if (i > 1) json += ",";
+        json += R"({"sourceConceptId": "c)" + std::to_string(i % 2000) + R"(", "targetConceptId": "c)" +
+                std::to_string((i + 1) % 2000) + R"(", "type": "precedes"})";
+    }
+    json += "]}";
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    auto parsed = ModelManager::parseModel(json.data(), json.size(), &pool);
+    ASSERT_EQ(parsed->getRelationshipCount(), 39999u);
+    std::set<std::string> ids;
+    for (const auto& relationship : parsed->getRelationships()) {
+        EXPECT_EQ(relationship->getId().rfind("rel_", 0), 0u);
+        ids.insert(relationship->getId());
+    }
+    EXPECT_EQ(ids.size(), 39999u);
+}
+
+TEST_F(ModelManagerTest, LazyParseLeavesPayloadsInTheDocument) {
+    MentalModel model("Lazy");
+    for (int i = 0; i < 100; ++i) {
+        auto concept = std::make_unique<Concept>("c" + std::to_string(i), "Concept " + std::to_string(i),
+                                                 "About " + std::to_string(i));
+        concept->addTag("tag" + std::to_string(i % 3));
+        model.addConcept(std::move(concept));
+    }
+    QString path = dir.filePath("lazy.json");
+    ModelManager::writeModelFile(model, path);
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    auto retained = std::make_shared<std::string>(file.readAll().toStdString());
+    const char* data = retained->data();
+
+    auto parsed = ModelManager::parseModel(data, retained->size(), nullptr, nullptr,
+                                           std::shared_ptr<const char>(retained, data), 8);
+    retained.reset();
+    ASSERT_EQ(parsed->getConceptCount(), 100u);
+    EXPECT_FALSE(parsed->getConcept("c42")->isPayloadLoaded());
+    for (int i = 0; i < 100; ++i) {
+        const Concept* concept = parsed->getConcept("c" + std::to_string(i));
+        EXPECT_EQ(concept->getDescription(), "About " + std::to_string(i));
+        EXPECT_EQ(concept->getTags(), std::vector<std::string>{"tag" + std::to_string(i % 3)});
+    }
+    EXPECT_EQ(parsed->getPayloadCache()->getLoadedCount(), 8u);
+}
+
+TEST_F(ModelManagerTest, LazyLoadedBinaryModelSavesWhatItRead) {
+    MentalModel model("Lazy");
+    for (int i = 0; i < 20; ++i) {
+        model.addConcept(std::make_unique<Concept>("c" + std::to_string(i), "Concept " + std::to_string(i),
+                                                   "About " + std::to_string(i)));
+    }
+    QString path = dir.filePath("model.qlinkb");
+    ASSERT_TRUE(manager.saveModel(model, path));
+
+    manager.setLazyLoading(true, 4);
+    auto loaded = manager.loadModel(path);
+    ASSERT_NE(loaded, nullptr);
+    ASSERT_NE(loaded->getPayloadCache(), nullptr);
+    EXPECT_EQ(loaded->getPayloadCache()->getLoadCount(), 0u);
+
+    loaded->getConcept("c3")->setDescription("Edited");
+    loaded->notifyConceptModified("c3");
+    QString copyPath = dir.filePath("copy.json");
+    ASSERT_TRUE(manager.saveModel(*loaded, copyPath));
+
+    manager.setLazyLoading(false);
+    auto reloaded = manager.loadModel(copyPath);
+    ASSERT_NE(reloaded, nullptr);
+    EXPECT_EQ(reloaded->getPayloadCache(), nullptr);
+    EXPECT_EQ(reloaded->getConcept("c3")->getDescription(), "Edited");
+    EXPECT_EQ(reloaded->getConcept("c19")->getDescription(), "About 19");
+}
+
+TEST_F(ModelManagerTest, LayeredModelSavesOnlyItsOverlay) {
+    MentalModel ontology("Ontology");
+    for (int i = 0; i < 1000; ++i) {
+        ontology.addConcept(std::make_unique<Concept>("c" + std::to_string(i), "Concept " + std::to_string(i),
+                                                      std::string(100, 'd')));
+    }
+    QString basePath = dir.filePath("ontology.qlinkb");
+    ModelManager::writeModelFile(ontology, basePath);
+
+    auto first = manager.loadLayered(basePath);
+    auto second = manager.loadLayered(basePath);
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(ModelOverlay::baseOf(*first), ModelOverlay::baseOf(*second));
+
+    first->addConcept(std::make_unique<Concept>("mine", "Mine", "Added"));
+    first->removeConcept("c1");
+    QString overlayPath = dir.filePath("analyst.qlinko");
+    ASSERT_TRUE(manager.saveModel(*first, overlayPath));
+    EXPECT_LT(QFileInfo(overlayPath).size(), 1024);
+
+    auto reloaded = manager.loadModel(overlayPath);
+    ASSERT_NE(reloaded, nullptr);
+    EXPECT_EQ(reloaded->getConceptCount(), 1000u);
+    EXPECT_EQ(reloaded->getConcept("mine")->getDescription(), "Added");
+    EXPECT_EQ(reloaded->getConcept("c1"), nullptr);
+    EXPECT_EQ(reloaded->getConcept("c2")->getDescription(), std::string(100, 'd'));
+    EXPECT_EQ(ModelOverlay::baseOf(*reloaded), ModelOverlay::baseOf(*first));
+
+    // An overlay needs a base to be relative to
+    EXPECT_FALSE(manager.saveModel(ontology, dir.filePath("standalone.qlinko")));
+}
+
+TEST_F(ModelManagerTest, OverlayOnAChangedBaseIsRefused) {
+    MentalModel ontology("Ontology");
+    ontology.addConcept(std::make_unique<Concept>("c1", "Energy", ""));
+    QString basePath = dir.filePath("ontology.qlinkb");
+    ModelManager::writeModelFile(ontology, basePath);
+
+    auto layered = manager.loadLayered(basePath);
+    ASSERT_NE(layered, nullptr);
+    QString overlayPath = dir.filePath("analyst.qlinko");
+    ASSERT_TRUE(manager.saveModel(*layered, overlayPath));
+    layered.reset();
+
+    ontology.addConcept(std::make_unique<Concept>("c2", "Work", ""));
+    ModelManager::writeModelFile(ontology, basePath);
+    EXPECT_EQ(manager.loadModel(overlayPath), nullptr);
+}
+
+TEST_F(ModelManagerTest, ParallelParseReportsBadRecords) {
+    std::string json = R"({"concepts": [{"id": "c1", "name": "A"}, {"id": "c2", "name": }]})";
+    try {
+        ModelManager::parseModel(json.data(), json.size());
+        FAIL() << "Expected a parse error";
+    } catch (const FileIOException& e) {
+        EXPECT_NE(std::string(e.what()).find("JSON parse error at byte"), std::string::npos);
+    }
+}
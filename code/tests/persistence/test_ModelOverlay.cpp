@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "../../core/persistence/ModelOverlay.h"
+#include "../../core/persistence/BinaryModelFormat.h"
+#include "../../core/model/MentalModel.h"
+#include "../../core/common/QLinkException.h"
+
+using namespace qlink;
+
+class ModelOverlayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MentalModel ontology("Ontology");
+        for (int i = 0; i < 50; ++i) {
+            auto concept = std::make_unique<Concept>("c" + std::to_string(i), "Concept " + std::to_string(i),
+                                                     "About " + std::to_string(i));
+            concept->addTag("tag" + std::to_string(i % 5));
+            concept->setTimestamps(1714555800000, 1714555800000 + i);
+            ontology.addConcept(std::move(concept));
+        }
+        for (int i = 1; i < 50; ++i) {
+            auto relationship = std::make_unique<Relationship>("r" + std::to_string(i), "c" + std::to_string(i - 1),
+                                                               "c" + std::to_string(i), "precedes", true, 1.0);
+            relationship->setTimestamps(1714555800000, 1714555800000);
+            ontology.addRelationship(std::move(relationship));
+        }
+        encoded = BinaryModelWriter::encode(ontology);
+        base = std::make_shared<const BinaryModelView>(encoded.data(), encoded.size());
+    }
+
+    std::unique_ptr<MentalModel> layered() {
+        return BinaryModelView::toLazyModel(base, 8);
+    }
+
+    std::string encoded;
+    std::shared_ptr<const BinaryModelView> base;
+};
+
+TEST_F(ModelOverlayTest, UnchangedModelHasAnEmptyOverlay) {
+    auto model = layered();
+    std::string overlay = ModelOverlay::encode(*model, *base, "ontology.qlinkb");
+
+    EXPECT_NE(overlay.find(R"("concepts":[],"relationships":[],"removedConcepts":[],"removedRelationships":[])"),
+              std::string::npos);
+    EXPECT_EQ(model->getPayloadCache()->getLoadCount(), 0u);
+    EXPECT_EQ(ModelOverlay::baseOf(*model), base);
+    EXPECT_EQ(ModelOverlay::readBase(overlay).path, "ontology.qlinkb");
+    EXPECT_EQ(ModelOverlay::readBase(overlay).contentHash, BinaryModelView::contentHash(encoded.data(), encoded.size()));
+}
+
+TEST_F(ModelOverlayTest, OverlayHoldsOnlyTheDifferences) {
+    auto model = layered();
+    model->getConcept("c3")->setDescription("Edited");
+    model->getConcept("c4")->setPosition(Position(5.0, 5.0));
+    model->removeConcept("c10"); // And with it r10 and r11
+    model->removeRelationship("r20");
+    model->getRelationship("r30")->setWeight(0.5);
+    model->addConcept(std::make_unique<Concept>("mine", "Mine", "Added"));
+    model->addRelationship(std::make_unique<Relationship>("r-mine", "mine", "c0", "extends", true, 1.0));
+
+    std::string overlay = ModelOverlay::encode(*model, *base, "ontology.qlinkb");
+    EXPECT_EQ(overlay.find(R"("id":"c5")"), std::string::npos);
+    EXPECT_NE(overlay.find(R"("removedConcepts":["c10"])"), std::string::npos);
+    EXPECT_NE(overlay.find(R"("removedRelationships":["r10","r11","r20"])"), std::string::npos);
+
+    auto reloaded = layered();
+    ModelOverlay::apply(overlay, *reloaded);
+    EXPECT_EQ(reloaded->getConceptCount(), model->getConceptCount());
+    EXPECT_EQ(reloaded->getRelationshipCount(), model->getRelationshipCount());
+    EXPECT_EQ(reloaded->getConcept("c3")->getDescription(), "Edited");
+    EXPECT_EQ(reloaded->getConcept("c3")->getTags(), std::vector<std::string>{"tag3"});
+    EXPECT_EQ(reloaded->getConcept("c4")->getPosition(), Position(5.0, 5.0));
+    EXPECT_EQ(reloaded->getConcept("c10"), nullptr);
+    EXPECT_EQ(reloaded->getRelationship("r20"), nullptr);
+    EXPECT_DOUBLE_EQ(reloaded->getRelationship("r30")->getWeight(), 0.5);
+    EXPECT_EQ(reloaded->getConcept("mine")->getDescription(), "Added");
+    EXPECT_NE(reloaded->getRelationship("r-mine"), nullptr);
+    EXPECT_EQ(reloaded->getConcept("c5")->getModified(), model->getConcept("c5")->getModified());
+
+    // Applied, the overlay reproduces itself
+    EXPECT_EQ(ModelOverlay::encode(*reloaded, *base, "ontology.qlinkb"), overlay);
+}
+
+TEST_F(ModelOverlayTest, ReaddedConceptReplacesTheBaseOne) {
+    auto model = layered();
+    model->removeConcept("c7");
+    model->addConcept(std::make_unique<Concept>("c7", "Replacement", ""));
+
+    std::string overlay = ModelOverlay::encode(*model, *base, "ontology.qlinkb");
+    auto reloaded = layered();
+    ModelOverlay::apply(overlay, *reloaded);
+    EXPECT_EQ(reloaded->getConcept("c7")->getName(), "Replacement");
+    EXPECT_EQ(reloaded->getConcept("c7")->getDescription(), "");
+    EXPECT_EQ(reloaded->getRelationship("r7"), nullptr);
+}
+
+TEST_F(ModelOverlayTest, ModelsWithoutABaseHaveNone) {
+    MentalModel standalone("Standalone");
+    EXPECT_EQ(ModelOverlay::baseOf(standalone), nullptr);
+    EXPECT_THROW(ModelOverlay::readBase(R"({"concepts": []})"), ParseException);
+    EXPECT_THROW(ModelOverlay::readBase(R"({"overlay": 1, "base": "b.qlinkb", "baseHash": "xyz"})"), ParseException);
+}
@@ -1,9 +1,13 @@
 #include <gtest/gtest.h>
+#include <QCoreApplication>
 
 int main(int argc, char **argv) {
+    // Network and timer based tests need a Qt application object
+    QCoreApplication app(argc, argv);
+    
     // Initialize Google Test
     ::testing::InitGoogleTest(&argc, argv);
     
     // Run tests
     return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
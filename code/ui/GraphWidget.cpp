@@ -23,16 +23,23 @@
 #include <QMenu>
 #include <QAction>
 #include <QMessageBox>
+#include <QPointer>
+#include <algorithm>
 #include <cmath>
+#include <memory>
 
 namespace qlink {
 
 GraphWidget::GraphWidget(QWidget *parent)
-    : QGraphicsView(parent), model(nullptr), zoomFactor(1.0), 
+    : QGraphicsView(parent), model(nullptr), aiAssistant(nullptr), hoverTimer(new QTimer(this)), zoomFactor(1.0), 
       selectedConcept(nullptr), isDragging(false),
       totalMovement(0.0), stableIterations(0) {
     setupView();
     setupScene();
+    
+    hoverTimer->setSingleShot(true);
+    hoverTimer->setInterval(HOVER_PREFETCH_DELAY_MS);
+    connect(hoverTimer, &QTimer::timeout, this, &GraphWidget::prefetchHoveredConcept);
 }
 
 GraphWidget::~GraphWidget() = default;
@@ -64,6 +71,8 @@ void GraphWidget::setModel(MentalModel* newModel) {
     }
     
     model = newModel;
+    prefetcher.cancel();
+    hoveredConceptId.clear();
     
     if (model) {
         // Connect to new model signals
@@ -77,6 +86,11 @@ void GraphWidget::setModel(MentalModel* newModel) {
     }
 }
 
+void GraphWidget::setAIAssistant(AIAssistant* assistant) {
+    prefetcher.setAssistant(assistant);
+    aiAssistant = assistant;
+}
+
 void GraphWidget::rebuildGraph() {
     if (!model) return;
     
@@ -236,10 +250,53 @@ void GraphWidget::mouseMoveEvent(QMouseEvent* event) {
         for (auto item : relationshipItems) {
             item->updatePosition();
         }
+    } else {
+        updateHoveredConcept(event->pos());
     }
     QGraphicsView::mouseMoveEvent(event);
 }
 
+void GraphWidget::updateHoveredConcept(const QPoint& pos) {
+    QGraphicsItem* item = itemAt(pos);
+    auto conceptItem = dynamic_cast<ConceptGraphicsItem*>(item);
+    if (!conceptItem && item) {
+        // The label sits on top of the node
+        conceptItem = dynamic_cast<ConceptGraphicsItem*>(item->parentItem());
+    }
+    
+    std::string conceptId = conceptItem ? conceptItem->getConcept()->getId() : std::string();
+    if (conceptId == hoveredConceptId) return;
+    
+    // Leaving a node keeps its prefetches; only a new node replaces them
+    hoveredConceptId = conceptId;
+    if (conceptId.empty()) {
+        hoverTimer->stop();
+    } else {
+        hoverTimer->start();
+    }
+}
+
+void GraphWidget::prefetchHoveredConcept() {
+    if (!model || !aiAssistant || hoveredConceptId.empty()) return;
+    
+    // The strongest relationships are the likeliest to be asked about
+    auto relationships = model->getConceptRelationships(hoveredConceptId);
+    std::sort(relationships.begin(), relationships.end(), [](const Relationship* a, const Relationship* b) {
+        return a->getWeight() > b->getWeight();
+    });
+    
+    std::vector<AIAssistant::ConceptPair> pairs;
+    for (const Relationship* relationship : relationships) {
+        if (pairs.size() >= HOVER_PREFETCH_COUNT) break;
+        const Concept* source = model->getConcept(relationship->getSourceConceptId());
+        const Concept* target = model->getConcept(relationship->getTargetConceptId());
+        if (source && target) {
+            pairs.emplace_back(source, target);
+        }
+    }
+    prefetcher.prefetch(pairs);
+}
+
 void GraphWidget::mouseReleaseEvent(QMouseEvent* event) {
     if (event->button() == Qt::LeftButton) {
         isDragging = false;
@@ -330,8 +387,13 @@ ConceptGraphicsItem::ConceptGraphicsItem(const Concept* concept, QGraphicsItem*
     QRectF textRect = textItem->boundingRect();
     textItem->setPos(-textRect.width() / 2, 40);
     
-    // Set tooltip
+    // The tooltip is set on hover, so a lazily loaded description is read only when shown
+    setAcceptHoverEvents(true);
+}
+
+void ConceptGraphicsItem::hoverEnterEvent(QGraphicsSceneHoverEvent* event) {
     setToolTip(QString::fromStdString(concept->getDescription()));
+    QGraphicsEllipseItem::hoverEnterEvent(event);
 }
 
 QVariant ConceptGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value) {
@@ -493,90 +555,105 @@ void GraphWidget::contextMenuEvent(QContextMenuEvent* event) {
 void GraphWidget::showConceptAIExplanation(ConceptGraphicsItem* conceptItem) {
     if (!conceptItem || !model) return;
     
-    AIAssistant assistant;
-    if (!assistant.isServiceAvailable()) {
+    if (!aiAssistant || !aiAssistant->isServiceAvailable()) {
         QMessageBox::information(this, "AI Assistant", 
             "AI service is not available. Please set the COHERE_API_KEY environment variable.");
         return;
     }
     
-    const Concept* concept = conceptItem->getConcept();
-    std::string description = assistant.generateConceptDescription(concept->getName());
-    
-    QMessageBox::information(this, "AI Concept Explanation", 
-        QString("Concept: %1\n\n%2")
-        .arg(QString::fromStdString(concept->getName()))
-        .arg(QString::fromStdString(description)));
+    // The reply arrives later; keep the UI responsive meanwhile
+    QString conceptName = QString::fromStdString(conceptItem->getConcept()->getName());
+    aiAssistant->generateConceptDescriptionAsync(conceptName.toStdString(),
+        [this, conceptName](const std::string& description) {
+            QMessageBox::information(this, "AI Concept Explanation", 
+                QString("Concept: %1\n\n%2")
+                .arg(conceptName)
+                .arg(QString::fromStdString(description)));
+        });
 }
 
 void GraphWidget::generateConceptDescription(ConceptGraphicsItem* conceptItem) {
     if (!conceptItem || !model) return;
     
-    AIAssistant assistant;
-    if (!assistant.isServiceAvailable()) {
+    if (!aiAssistant || !aiAssistant->isServiceAvailable()) {
         QMessageBox::information(this, "AI Assistant", 
             "AI service is not available. Please set the COHERE_API_KEY environment variable.");
         return;
     }
     
     const Concept* concept = conceptItem->getConcept();
-    std::string description = assistant.generateConceptDescription(concept->getName());
-    
-    // Update the concept's description in the model
-    Concept* mutableConcept = model->getConcept(concept->getId());
-    if (mutableConcept) {
-        mutableConcept->setDescription(description);
-        QMessageBox::information(this, "Generated Description", 
-            QString("Generated and saved description for '%1':\n\n%2")
-            .arg(QString::fromStdString(concept->getName()))
-            .arg(QString::fromStdString(description)));
-    }
+    std::string conceptId = concept->getId();
+    aiAssistant->generateConceptDescriptionAsync(concept->getName(),
+        [this, conceptId](const std::string& description) {
+            // The concept may have been removed while we were waiting
+            Concept* mutableConcept = model ? model->getConcept(conceptId) : nullptr;
+            if (mutableConcept) {
+                mutableConcept->setDescription(description);
+                model->notifyConceptModified(conceptId);
+                QMessageBox::information(this, "Generated Description", 
+                    QString("Generated and saved description for '%1':\n\n%2")
+                    .arg(QString::fromStdString(mutableConcept->getName()))
+                    .arg(QString::fromStdString(description)));
+            }
+        });
 }
 
 void GraphWidget::suggestRelatedConcepts(ConceptGraphicsItem* conceptItem) {
     if (!conceptItem || !model) return;
     
-    AIAssistant assistant;
-    if (!assistant.isServiceAvailable()) {
+    if (!aiAssistant || !aiAssistant->isServiceAvailable()) {
         QMessageBox::information(this, "AI Assistant", 
             "AI service is not available. Please set the COHERE_API_KEY environment variable.");
         return;
     }
     
     const Concept* concept = conceptItem->getConcept();
-    std::vector<std::string> suggestions = assistant.suggestRelatedConcepts(*concept);
-    
-    QString suggestionsText = "Suggested related concepts:\n\n";
-    for (const auto& suggestion : suggestions) {
-        suggestionsText += "• " + QString::fromStdString(suggestion) + "\n";
-    }
-    
-    QMessageBox::information(this, "Concept Suggestions", suggestionsText);
+    aiAssistant->suggestRelatedConceptsAsync(*concept,
+        [this](const std::vector<std::string>& suggestions) {
+            QString suggestionsText = "Suggested related concepts:\n\n";
+            for (const auto& suggestion : suggestions) {
+                suggestionsText += "• " + QString::fromStdString(suggestion) + "\n";
+            }
+            
+            QMessageBox::information(this, "Concept Suggestions", suggestionsText);
+        });
 }
 
 void GraphWidget::showRelationshipAIExplanation(RelationshipGraphicsItem* relationshipItem) {
-    if (!relationshipItem || !model) return;
-    
-    AIAssistant assistant;
-    if (!assistant.isServiceAvailable()) {
-        QMessageBox::information(this, "AI Assistant", 
-            "AI service is not available. Please set the COHERE_API_KEY environment variable.");
-        return;
-    }
+    // Without the AI service the assistant still explains from the graph
+    if (!relationshipItem || !model || !aiAssistant) return;
     
     const Relationship* relationship = relationshipItem->getRelationship();
     const Concept* sourceConcept = model->getConcept(relationship->getSourceConceptId());
     const Concept* targetConcept = model->getConcept(relationship->getTargetConceptId());
     
     if (sourceConcept && targetConcept) {
-        std::string explanation = assistant.explainConnection(*sourceConcept, *targetConcept);
-        
-        QMessageBox::information(this, "AI Relationship Explanation", 
-            QString("Connection: %1 → %2\nType: %3\n\n%4")
+        QString header = QString("Connection: %1 → %2\nType: %3")
             .arg(QString::fromStdString(sourceConcept->getName()))
             .arg(QString::fromStdString(targetConcept->getName()))
-            .arg(QString::fromStdString(relationship->getType()))
-            .arg(QString::fromStdString(explanation)));
+            .arg(QString::fromStdString(relationship->getType()));
+        
+        // Show the graph's own explanation at once; the AI's replaces it as it streams in
+        QString local = QString::fromStdString(aiAssistant->explainConnectionLocally(*sourceConcept, *targetConcept));
+        QPointer<QMessageBox> box = new QMessageBox(QMessageBox::Information, "AI Relationship Explanation",
+                                                    QString("%1\n\n%2").arg(header).arg(local), QMessageBox::Ok, this);
+        box->setAttribute(Qt::WA_DeleteOnClose);
+        box->setModal(false);
+        box->show();
+        
+        auto text = std::make_shared<QString>();
+        AIAssistant* assistant = aiAssistant;
+        AIAssistant::RequestId id = assistant->explainConnectionStreaming(*sourceConcept, *targetConcept,
+            [box, header, text](const std::string& token) {
+                *text += QString::fromStdString(token);
+                if (box) box->setText(QString("%1\n\n%2").arg(header).arg(*text));
+            },
+            [box, header](const std::string& explanation) {
+                if (box) box->setText(QString("%1\n\n%2").arg(header).arg(QString::fromStdString(explanation)));
+            });
+        if (id != 0) {
+            connect(box, &QObject::destroyed, this, [assistant, id]() { assistant->cancelRequest(id); });
+        }
     }
 }
 
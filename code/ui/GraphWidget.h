@@ -7,9 +7,11 @@
 #include <QMap>
 #include <QTimer>
 #include <QContextMenuEvent>
+#include <memory>
 #include "../core/model/MentalModel.h"
 #include "../core/model/Concept.h"
 #include "../core/model/Relationship.h"
+#include "../core/ai/ExplanationPrefetcher.h"
 
 namespace qlink {
 
@@ -27,6 +29,11 @@ public:
     ~GraphWidget();
 
     void setModel(MentalModel* model);
+    
+    /**
+     * Assistant for the AI actions; not owned, null disables them
+     */
+    void setAIAssistant(AIAssistant* assistant);
 
 public slots:
     void zoomIn();
@@ -56,6 +63,8 @@ private:
     void createRelationshipItem(const Relationship* relationship);
     void initializePositions();
     void scaleView(double scaleFactor);
+    void updateHoveredConcept(const QPoint& pos);
+    void prefetchHoveredConcept();
     
     // AI Assistant methods
     void showConceptAIExplanation(ConceptGraphicsItem* conceptItem);
@@ -66,6 +75,14 @@ private:
     // Core components
     QGraphicsScene* scene;
     MentalModel* model;
+    AIAssistant* aiAssistant;
+    
+    // Explanations for the concept under the mouse are fetched after a short dwell
+    ExplanationPrefetcher prefetcher;
+    QTimer* hoverTimer;
+    std::string hoveredConceptId;
+    static constexpr int HOVER_PREFETCH_DELAY_MS = 300;
+    static constexpr size_t HOVER_PREFETCH_COUNT = 3;
 
     // Visual items
     QMap<std::string, ConceptGraphicsItem*> conceptItems;
@@ -94,6 +111,7 @@ public:
 
 protected:
     QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
+    void hoverEnterEvent(QGraphicsSceneHoverEvent* event) override;
 
 private:
     const Concept* concept;
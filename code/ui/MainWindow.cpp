@@ -2,6 +2,8 @@
 #include "GraphWidget.h"
 #include "SuggestionPanel.h"
 #include "../core/persistence/ModelManager.h"
+#include "../core/persistence/SaveJob.h"
+#include "../core/ai/AIAssistant.h"
 #include "../core/nlp/CommandFactory.h"
 #include "../core/nlp/ICommand.h"
 #include "../core/nlp/Commands.h"
@@ -29,14 +31,18 @@
 #include <QStandardPaths>
 #include <QInputDialog>
 #include <QDateTime>
+#include <QPointer>
+#include <algorithm>
 
 namespace qlink {
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), mentalModel(std::make_unique<MentalModel>("New Model")), 
+      aiAssistant(std::make_unique<AIAssistant>()),
+      modelManager(std::make_unique<ModelManager>()),
       graphWidget(nullptr), suggestionPanel(nullptr), 
       commandInput(nullptr), executeButton(nullptr), clearHistoryButton(nullptr), commandHistory(nullptr),
-      modelModified(false), undoRedoHistoryIndex(-1) {
+      modelModified(false), modifiedGeneration(0), undoRedoHistoryIndex(-1) {
     try {
         setupUI();
         setupNaturalLanguagePanel();
@@ -55,7 +61,11 @@ MainWindow::MainWindow(QWidget *parent)
     }
 }
 
-MainWindow::~MainWindow() = default;
+MainWindow::~MainWindow() {
+    // The child widgets are deleted after our members; detach them from the assistant first
+    if (graphWidget) graphWidget->setAIAssistant(nullptr);
+    if (suggestionPanel) suggestionPanel->setAIAssistant(nullptr);
+}
 
 void MainWindow::setupUI() {
     // Set window properties
@@ -75,10 +85,13 @@ void MainWindow::setupUI() {
     // Create graph widget
     graphWidget = new GraphWidget(this);
     graphWidget->setModel(mentalModel.get());
+    graphWidget->setAIAssistant(aiAssistant.get());
+    aiAssistant->setModel(mentalModel.get());
 
     // Create suggestion panel
     suggestionPanel = new SuggestionPanel(this);
     suggestionPanel->setMinimumWidth(280);
+    suggestionPanel->setAIAssistant(aiAssistant.get());
 
     // Add widgets to splitter
     splitter->addWidget(graphWidget);
@@ -188,6 +201,10 @@ void MainWindow::setupMenus() {
 
     fileMenu->addSeparator();
 
+    importAction = new QAction("&Import...", this);
+    importAction->setStatusTip("Import a graph from CSV, TSV or GraphML");
+    fileMenu->addAction(importAction);
+
     exportAction = new QAction("&Export...", this);
     exportAction->setStatusTip("Export model to various formats");
     fileMenu->addAction(exportAction);
@@ -309,6 +326,7 @@ void MainWindow::setupConnections() {
     connect(openAction, &QAction::triggered, this, &MainWindow::openModel);
     connect(saveAction, &QAction::triggered, this, &MainWindow::saveModel);
     connect(saveAsAction, &QAction::triggered, this, &MainWindow::saveAsModel);
+    connect(importAction, &QAction::triggered, this, &MainWindow::importModel);
     connect(exportAction, &QAction::triggered, this, &MainWindow::exportModel);
     connect(exitAction, &QAction::triggered, this, &QWidget::close);
 
@@ -349,10 +367,26 @@ void MainWindow::setupConnections() {
                 this, [this](const LinkSuggestion& suggestion) {
                     statusBar()->showMessage("Suggestion rejected", 2000);
                 });
+        connect(suggestionPanel, &SuggestionPanel::generationProgress,
+                this, [this](int processedVertices, int totalVertices) {
+                    progressBar->setRange(0, std::max(1, totalVertices));
+                    progressBar->setValue(processedVertices);
+                });
+        connect(suggestionPanel, &SuggestionPanel::suggestionsGenerated,
+                this, [this](int count) {
+                    progressBar->setVisible(false);
+                    statusBar()->showMessage(QString("%1 suggestions generated").arg(count), 2000);
+                });
+        connect(suggestionPanel, &SuggestionPanel::generationCancelled,
+                this, [this]() {
+                    progressBar->setVisible(false);
+                    statusBar()->showMessage("Suggestion generation cancelled", 2000);
+                });
     }
 }
 
 void MainWindow::setModelModified(bool modified) {
+    ++modifiedGeneration;
     if (modelModified != modified) {
         modelModified = modified;
         updateWindowTitle();
@@ -372,12 +406,54 @@ void MainWindow::newModel() {
             saveModel();
         } else if (reply == QMessageBox::Cancel) {
             return; // User cancelled, don't create new model
+        } else {
+            modelManager->discardUnsaved(); // Not offered for recovery next time
         }
     }
     
+    replaceModel(std::make_unique<MentalModel>("New Model"));
+    
+    currentFilePath.clear();
+    setModelModified(false);
+    updateWindowTitle();
+    updateStatusBar();
+    statusBar()->showMessage("New model created", 2000);
+}
+
+void MainWindow::openModel() {
+    QString fileName = QFileDialog::getOpenFileName(this,
+        "Open Mental Model", "",
+        "Mental Models (*.json *.qlinkb *.qlinko);;JSON Files (*.json);;Binary Models (*.qlinkb);;"
+        "Overlays (*.qlinko)");
+    if (!fileName.isEmpty()) {
+        auto loadedModel = modelManager->loadModel(fileName);
+        if (loadedModel) {
+            replaceModel(std::move(loadedModel));
+            
+            currentFilePath = fileName;
+            modelManager->startJournal(*mentalModel, currentFilePath);
+            size_t recovered = modelManager->getRecoveredChanges();
+            setModelModified(recovered > 0);
+            updateWindowTitle();
+            updateStatusBar();
+            statusBar()->showMessage("Model loaded successfully: " + QFileInfo(fileName).baseName(), 2000);
+            if (recovered > 0) {
+                QMessageBox::information(this, "Recovered Changes",
+                    QString("Recovered %1 unsaved changes from the last session.").arg(recovered));
+            }
+        } else {
+            QMessageBox::warning(this, "Load Error", 
+                QString("Failed to load model from file: %1").arg(fileName));
+        }
+    }
+}
+
+void MainWindow::replaceModel(std::unique_ptr<MentalModel> model) {
     // Disconnect widgets from old model before destroying it
+    modelManager->stopJournal();
     if (mentalModel) {
         disconnect(mentalModel.get(), nullptr, this, nullptr);
+        aiAssistant->setModel(nullptr);
         if (graphWidget) {
             graphWidget->setModel(nullptr);  // Clear old model first
         }
@@ -386,10 +462,10 @@ void MainWindow::newModel() {
         }
     }
     
-    // Create new model
-    mentalModel = std::make_unique<MentalModel>("New Model");
+    mentalModel = std::move(model);
     
     // Set new model in widgets
+    aiAssistant->setModel(mentalModel.get());
     if (graphWidget) {
         graphWidget->setModel(mentalModel.get());
     }
@@ -400,106 +476,139 @@ void MainWindow::newModel() {
     // Reconnect signals to new model
     connectModelSignals();
     
-    // Clear command history
+    // Command history belongs to the old model
     undoRedoHistory.clear();
     undoRedoHistoryIndex = -1;
     updateUndoRedoActions();
-    
-    currentFilePath.clear();
-    setModelModified(false);
-    updateWindowTitle();
-    updateStatusBar();
-    statusBar()->showMessage("New model created", 2000);
-}
-
-void MainWindow::openModel() {
-    QString fileName = QFileDialog::getOpenFileName(this,
-        "Open Mental Model", "", "JSON Files (*.json)");
-    if (!fileName.isEmpty()) {
-        ModelManager manager;
-        auto loadedModel = manager.loadModel(fileName);
-        if (loadedModel) {
-            // Disconnect widgets from old model before destroying it
-            if (mentalModel) {
-                disconnect(mentalModel.get(), nullptr, this, nullptr);
-                if (graphWidget) {
-                    graphWidget->setModel(nullptr);  // Clear old model first
-                }
-                if (suggestionPanel) {
-                    suggestionPanel->setModel(nullptr);  // Clear old model first
-                }
-            }
-            
-            // Create new model
-            mentalModel = std::move(loadedModel);
-            
-            // Set new model in widgets
-            if (graphWidget) {
-                graphWidget->setModel(mentalModel.get());
-            }
-            if (suggestionPanel) {
-                suggestionPanel->setModel(mentalModel.get());
-            }
-            
-            // Reconnect signals to new model
-            connectModelSignals();
-            
-            // Clear command history when loading a new model
-            undoRedoHistory.clear();
-            undoRedoHistoryIndex = -1;
-            updateUndoRedoActions();
-            
-            currentFilePath = fileName;
-            setModelModified(false);
-            updateWindowTitle();
-            updateStatusBar();
-            statusBar()->showMessage("Model loaded successfully: " + QFileInfo(fileName).baseName(), 2000);
-        } else {
-            QMessageBox::warning(this, "Load Error", 
-                QString("Failed to load model from file: %1").arg(fileName));
-        }
-    }
 }
 
 void MainWindow::saveModel() {
     if (currentFilePath.isEmpty()) {
         saveAsModel();
+    } else if (modelManager->saveIncrementally(*mentalModel, currentFilePath)) {
+        // Only the journal was appended to; nothing is left running
+        setModelModified(false);
+        statusBar()->showMessage("Model saved: " + QFileInfo(currentFilePath).baseName(), 2000);
     } else {
-        ModelManager manager;
-        if (manager.saveModel(*mentalModel, currentFilePath)) {
-            setModelModified(false);
-            statusBar()->showMessage("Model saved: " + QFileInfo(currentFilePath).baseName(), 2000);
-        } else {
-            QMessageBox::warning(this, "Save Error", 
-                QString("Failed to save model: Check file permissions and disk space."));
-        }
+        startSave(currentFilePath);
     }
 }
 
 void MainWindow::saveAsModel() {
     QString fileName = QFileDialog::getSaveFileName(this,
-        "Save Mental Model", "", "JSON Files (*.json)");
+        "Save Mental Model", "", "JSON Files (*.json);;Binary Models (*.qlinkb);;Overlays (*.qlinko)");
     if (!fileName.isEmpty()) {
-        ModelManager manager;
-        if (manager.saveModel(*mentalModel, fileName)) {
-            currentFilePath = fileName;
-            setModelModified(false);
+        startSave(fileName);
+    }
+}
+
+void MainWindow::startSave(const QString& filePath) {
+    // The manager copies the model, so editing can continue while it is written
+    SaveJob* job = modelManager->saveModelInBackground(*mentalModel, filePath);
+    uint64_t savedGeneration = modifiedGeneration;
+    QPointer<MentalModel> savedModel(mentalModel.get());
+
+    progressBar->setVisible(true);
+    progressBar->setRange(0, 0); // Indeterminate until the first progress report
+    statusBar()->showMessage("Saving model...");
+
+    connect(job, &SaveJob::progressChanged, this, [this](int writtenRecords, int totalRecords) {
+        progressBar->setRange(0, std::max(1, totalRecords));
+        progressBar->setValue(writtenRecords);
+    });
+    connect(job, &SaveJob::finished, this, [this, savedGeneration, savedModel](const QString& savedPath) {
+        progressBar->setVisible(false);
+        // The file is the model's only once it has been written, and only if
+        // the window still shows that model
+        if (savedModel && savedModel == mentalModel.get()) {
+            currentFilePath = savedPath;
             updateWindowTitle();
-            statusBar()->showMessage("Model saved as: " + QFileInfo(fileName).baseName(), 2000);
-        } else {
-            QMessageBox::warning(this, "Save Error", 
-                QString("Failed to save model: Check file permissions and disk space."));
         }
+        // Edits made, or a model opened, while the file was written are still unsaved
+        if (modifiedGeneration == savedGeneration) {
+            setModelModified(false);
+        }
+        statusBar()->showMessage("Model saved: " + QFileInfo(savedPath).baseName(), 2000);
+    });
+    connect(job, &SaveJob::failed, this, [this](const QString& error) {
+        progressBar->setVisible(false);
+        statusBar()->clearMessage();
+        QMessageBox::warning(this, "Save Error", 
+            QString("Failed to save model: %1").arg(error));
+    });
+}
+
+void MainWindow::importModel() {
+    const QString edgeCsvFilter = "Edge List CSV (*.csv)";
+    const QString edgeTsvFilter = "Edge List TSV (*.tsv *.txt)";
+    const QString nodeCsvFilter = "Node CSV (*.csv)";
+    const QString graphMLFilter = "GraphML (*.graphml *.xml)";
+    QString selectedFilter;
+    QString fileName = QFileDialog::getOpenFileName(this,
+        "Import Graph", "",
+        QStringList{edgeCsvFilter, edgeTsvFilter, nodeCsvFilter, graphMLFilter}.join(";;"), &selectedFilter);
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    ImportFormat format = ImportFormat::EDGE_LIST_CSV;
+    if (selectedFilter == graphMLFilter) {
+        format = ImportFormat::GRAPHML;
+    } else if (selectedFilter == edgeTsvFilter) {
+        format = ImportFormat::EDGE_LIST_TSV;
+    } else if (selectedFilter == nodeCsvFilter) {
+        format = ImportFormat::NODE_CSV;
     }
+
+    auto importedModel = modelManager->importModel(fileName, format);
+    if (!importedModel) {
+        QMessageBox::warning(this, "Import Error",
+            QString("Failed to import graph from file: %1").arg(fileName));
+        return;
+    }
+
+    replaceModel(std::move(importedModel));
+
+    // Not saved anywhere yet; saving asks for a file
+    currentFilePath.clear();
+    setModelModified(true);
+    updateWindowTitle();
+    updateStatusBar();
+    const ImportResult& result = modelManager->getLastImport();
+    QString message = QString("Imported %1 concepts and %2 relationships")
+        .arg(result.concepts).arg(result.relationships);
+    if (result.skipped > 0) {
+        message += QString(", skipped %1 rows").arg(result.skipped);
+    }
+    statusBar()->showMessage(message, 5000);
 }
 
 void MainWindow::exportModel() {
+    const QString jsonFilter = "JSON Files (*.json)";
+    const QString binaryFilter = "Binary Models (*.qlinkb)";
+    const QString edgeCsvFilter = "Edge List CSV (*.csv)";
+    const QString edgeTsvFilter = "Edge List TSV (*.tsv)";
+    const QString nodeCsvFilter = "Node CSV (*.csv)";
+    const QString graphMLFilter = "GraphML (*.graphml)";
+    QString selectedFilter;
     QString fileName = QFileDialog::getSaveFileName(this,
         "Export Mental Model", "", 
-        "JSON Files (*.json)");
+        QStringList{jsonFilter, binaryFilter, edgeCsvFilter, edgeTsvFilter, nodeCsvFilter, graphMLFilter}.join(";;"),
+        &selectedFilter);
     if (!fileName.isEmpty()) {
-        ModelManager manager;
-        bool success = manager.exportModel(*mentalModel, fileName, ExportFormat::JSON);
+        ExportFormat format = ExportFormat::JSON;
+        if (selectedFilter == binaryFilter || fileName.endsWith(".qlinkb", Qt::CaseInsensitive)) {
+            format = ExportFormat::BINARY;
+        } else if (selectedFilter == edgeCsvFilter) {
+            format = ExportFormat::EDGE_LIST_CSV;
+        } else if (selectedFilter == edgeTsvFilter) {
+            format = ExportFormat::EDGE_LIST_TSV;
+        } else if (selectedFilter == nodeCsvFilter) {
+            format = ExportFormat::NODE_CSV;
+        } else if (selectedFilter == graphMLFilter) {
+            format = ExportFormat::GRAPHML;
+        }
+        bool success = modelManager->exportModel(*mentalModel, fileName, format);
         
         if (success) {
             QFileInfo fileInfo(fileName);
@@ -659,17 +768,11 @@ void MainWindow::validateModel() {
 
 void MainWindow::generateSuggestions() {
     progressBar->setVisible(true);
-    progressBar->setRange(0, 0); // Indeterminate progress
+    progressBar->setRange(0, 0); // Indeterminate until the first progress report
     statusBar()->showMessage("Generating concept suggestions...");
 
-    // Trigger suggestion generation in the panel
+    // Runs in the background; the panel reports progress and completion
     suggestionPanel->generateSuggestions();
-
-    // Hide progress after a delay
-    QTimer::singleShot(2000, [this]() {
-        progressBar->setVisible(false);
-        statusBar()->showMessage("Suggestions generated", 2000);
-    });
 }
 
 void MainWindow::showStatistics() {
@@ -20,6 +20,8 @@ namespace qlink {
 class GraphWidget;
 class SuggestionPanel;
 class ICommand;
+class AIAssistant;
+class ModelManager;
 
 /**
  * Main application window
@@ -37,6 +39,7 @@ private slots:
     void openModel();
     void saveModel();
     void saveAsModel();
+    void importModel();
     void exportModel();
 
     // Edit operations
@@ -73,6 +76,8 @@ private:
     void setupConnections();
     void updateWindowTitle();
     void setModelModified(bool modified = true);
+    void startSave(const QString& filePath);
+    void replaceModel(std::unique_ptr<MentalModel> model);
     void connectModelSignals();
     void addCommandToHistory(const QString& command, bool success, const QString& message);
     void executeCommand(std::shared_ptr<ICommand> command);
@@ -80,6 +85,8 @@ private:
 
     // Core components
     std::unique_ptr<MentalModel> mentalModel;
+    std::unique_ptr<AIAssistant> aiAssistant; // Shared so both views hit the same cache
+    std::unique_ptr<ModelManager> modelManager; // Outlives background saves; waits for them on exit
     GraphWidget* graphWidget;
     SuggestionPanel* suggestionPanel;
     QSplitter* splitter;
@@ -93,6 +100,7 @@ private:
     // File management
     QString currentFilePath;
     bool modelModified;
+    uint64_t modifiedGeneration; // Bumped by every setModelModified(), so a save can tell if it is stale
     
     // Command history for undo/redo
     std::vector<std::shared_ptr<ICommand>> undoRedoHistory;
@@ -103,6 +111,7 @@ private:
     QAction* openAction;
     QAction* saveAction;
     QAction* saveAsAction;
+    QAction* importAction;
     QAction* exportAction;
     QAction* exitAction;
     QAction* undoAction;
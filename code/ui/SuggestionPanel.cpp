@@ -2,6 +2,8 @@
 #include "../core/ai/CommonNeighborPredictor.h"
 #include "../core/ai/JaccardCoefficientPredictor.h"
 #include "../core/ai/PreferentialAttachmentPredictor.h"
+#include "../core/ai/GraphSnapshot.h"
+#include "../core/ai/SuggestionJob.h"
 #include <QMessageBox>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -11,6 +13,7 @@
 #include <QPushButton>
 #include <QProgressBar>
 #include <QComboBox>
+#include <QCheckBox>
 #include <QLineEdit>
 #include <QGroupBox>
 #include <QSplitter>
@@ -19,16 +22,38 @@
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
 #include <QDebug>
+#include <algorithm>
 
 namespace qlink {
 
+namespace {
+
+// Algorithm combo box keys, in display order
+const std::vector<std::pair<QString, LinkPredictorFactory::AlgorithmType>> ALGORITHM_KEYS = {
+    {"common_neighbors", LinkPredictorFactory::AlgorithmType::COMMON_NEIGHBORS},
+    {"jaccard", LinkPredictorFactory::AlgorithmType::JACCARD_COEFFICIENT},
+    {"preferential", LinkPredictorFactory::AlgorithmType::PREFERENTIAL_ATTACHMENT},
+    {"adamic_adar", LinkPredictorFactory::AlgorithmType::ADAMIC_ADAR},
+    {"resource_allocation", LinkPredictorFactory::AlgorithmType::RESOURCE_ALLOCATION},
+    {"salton", LinkPredictorFactory::AlgorithmType::SALTON_INDEX},
+    {"sorensen", LinkPredictorFactory::AlgorithmType::SORENSEN_INDEX},
+    {"hub_promoted", LinkPredictorFactory::AlgorithmType::HUB_PROMOTED_INDEX}
+};
+
+} // namespace
+
 SuggestionPanel::SuggestionPanel(QWidget *parent)
-    : QWidget(parent), model(nullptr) {
+    : QWidget(parent), model(nullptr), aiAssistant(nullptr), activeMinConfidence(0.5), activeModelVersion(0),
+      completedVertices(0), totalVertices(0) {
     setupUI();
     setupConnections();
 }
 
-SuggestionPanel::~SuggestionPanel() = default;
+SuggestionPanel::~SuggestionPanel() {
+    for (auto job : activeJobs) {
+        job->cancel();
+    }
+}
 
 void SuggestionPanel::setupUI() {
     auto mainLayout = new QVBoxLayout(this);
@@ -51,9 +76,10 @@ void SuggestionPanel::setupControlsSection(QVBoxLayout* mainLayout) {
     auto algorithmLayout = new QHBoxLayout();
     algorithmLayout->addWidget(new QLabel("Algorithm:"));
     algorithmCombo = new QComboBox();
-    algorithmCombo->addItem("Common Neighbors", "common_neighbors");
-    algorithmCombo->addItem("Jaccard Coefficient", "jaccard");
-    algorithmCombo->addItem("Preferential Attachment", "preferential");
+    for (const auto& entry : ALGORITHM_KEYS) {
+        algorithmCombo->addItem(QString::fromStdString(LinkPredictorFactory::getAlgorithmName(entry.second)),
+                                entry.first);
+    }
     algorithmCombo->addItem("All Algorithms", "all");
     algorithmLayout->addWidget(algorithmCombo);
     controlsLayout->addLayout(algorithmLayout);
@@ -67,15 +93,38 @@ void SuggestionPanel::setupControlsSection(QVBoxLayout* mainLayout) {
     thresholdLayout->addStretch();
     controlsLayout->addLayout(thresholdLayout);
     
+    // How relationships are read
+    auto graphOptionsLayout = new QHBoxLayout();
+    weightedCheck = new QCheckBox("Use weights");
+    weightedCheck->setToolTip("Strong relationships count more than weak ones");
+    graphOptionsLayout->addWidget(weightedCheck);
+    directedCheck = new QCheckBox("Respect direction");
+    directedCheck->setToolTip("Follow directed relationships from source to target only");
+    graphOptionsLayout->addWidget(directedCheck);
+    graphOptionsLayout->addStretch();
+    controlsLayout->addLayout(graphOptionsLayout);
+    
+    auto typesLayout = new QHBoxLayout();
+    typesLayout->addWidget(new QLabel("Relationship Types:"));
+    relationshipTypesEdit = new QLineEdit();
+    relationshipTypesEdit->setPlaceholderText("All (or comma separated list)");
+    typesLayout->addWidget(relationshipTypesEdit);
+    controlsLayout->addLayout(typesLayout);
+    
     // Generate button
     generateButton = new QPushButton("Generate Suggestions");
     generateButton->setMinimumHeight(36);
     controlsLayout->addWidget(generateButton);
     
-    // Progress bar
+    // Progress bar (vertices scored) and cancel button, shown while generating
+    auto progressLayout = new QHBoxLayout();
     progressBar = new QProgressBar();
     progressBar->setVisible(false);
-    controlsLayout->addWidget(progressBar);
+    progressLayout->addWidget(progressBar);
+    cancelButton = new QPushButton("Cancel");
+    cancelButton->setVisible(false);
+    progressLayout->addWidget(cancelButton);
+    controlsLayout->addLayout(progressLayout);
     
     mainLayout->addWidget(controlsGroup, 0); // No stretch - fixed size
 }
@@ -136,6 +185,7 @@ void SuggestionPanel::setupActionButtons(QVBoxLayout* mainLayout) {
 
 void SuggestionPanel::setupConnections() {
     connect(generateButton, &QPushButton::clicked, this, &SuggestionPanel::generateSuggestions);
+    connect(cancelButton, &QPushButton::clicked, this, &SuggestionPanel::cancelGeneration);
     connect(acceptButton, &QPushButton::clicked, this, &SuggestionPanel::acceptSuggestion);
     connect(rejectButton, &QPushButton::clicked, this, &SuggestionPanel::rejectSuggestion);
     connect(clearButton, &QPushButton::clicked, this, &SuggestionPanel::clearSuggestions);
@@ -151,7 +201,21 @@ void SuggestionPanel::setupConnections() {
 }
 
 void SuggestionPanel::setModel(MentalModel* newModel) {
+    stopJobs();
+    if (model && model != newModel) {
+        disconnect(model, nullptr, this, nullptr);
+    }
+    
     model = newModel;
+    suggestionCache.clear(); // Versions of different models aren't comparable
+    
+    if (model) {
+        connect(model, &MentalModel::modelChanged, this, [this](const ModelChangeEvent& event) {
+            if (model) {
+                suggestionCache.onModelChanged(event, *model);
+            }
+        });
+    }
     clearSuggestions();
 }
 
@@ -194,7 +258,14 @@ void SuggestionPanel::addSuggestion(const LinkSuggestion& suggestion) {
     updateSuggestionCount();
 }
 
+void SuggestionPanel::setAIAssistant(AIAssistant* assistant) {
+    prefetcher.setAssistant(assistant);
+    aiAssistant = assistant;
+    prefetchExplanations();
+}
+
 void SuggestionPanel::clearSuggestions() {
+    prefetcher.cancel();
     suggestions.clear();
     suggestionsTree->clear();
     acceptButton->setEnabled(false);
@@ -209,151 +280,270 @@ void SuggestionPanel::generateSuggestions() {
     }
     
     try {
+        // A new request supersedes whatever is still running
+        stopJobs();
         clearSuggestions();
-        
-        // Show progress
-        if (progressBar) {
-            progressBar->setVisible(true);
-            progressBar->setRange(0, 0); // Indeterminate
-        }
-        if (generateButton) {
-            generateButton->setEnabled(false);
-            generateButton->setText("Generating...");
-        }
+        jobResults.clear();
         
         // Get selected algorithm
-        QString algorithm = algorithmCombo ? algorithmCombo->currentData().toString() : "common_neighbors";
-        double minConfidence = confidenceThreshold ? confidenceThreshold->text().toDouble() : 0.5;
-        
-        // Generate suggestions using the selected algorithm
-        if (algorithm == "all") {
-            generateCombinedSuggestions(minConfidence);
-        } else {
-            generateRealSuggestions(algorithm, minConfidence);
+        activeAlgorithm = algorithmCombo ? algorithmCombo->currentData().toString() : "common_neighbors";
+        activeMinConfidence = confidenceThreshold ? confidenceThreshold->text().toDouble() : 0.5;
+        activeModelVersion = model->getVersion();
+        activeOptions = LinkPredictionOptions();
+        activeOptions.weighted = weightedCheck && weightedCheck->isChecked();
+        activeOptions.directed = directedCheck && directedCheck->isChecked();
+        if (relationshipTypesEdit) {
+            for (const QString& type : relationshipTypesEdit->text().split(',', Qt::SkipEmptyParts)) {
+                if (!type.trimmed().isEmpty()) {
+                    activeOptions.relationshipTypes.insert(type.trimmed().toStdString());
+                }
+            }
         }
         
-        // Hide progress
-        if (progressBar) {
-            progressBar->setVisible(false);
+        // Repeated requests on an unchanged model are answered from the cache
+        std::vector<LinkSuggestion> cached;
+        if (suggestionCache.find(*model, resultCacheName(), 10, activeMinConfidence, cached)) {
+            for (const auto& suggestion : cached) {
+                addSuggestion(suggestion);
+            }
+            filterSuggestions();
+            emit suggestionsGenerated(suggestions.size());
+            return;
         }
-        if (generateButton) {
-            generateButton->setEnabled(true);
-            generateButton->setText("Generate Suggestions");
+        
+        // Run each algorithm on a worker pool against an immutable snapshot
+        auto snapshot = GraphSnapshot::fromModel(*model, activeOptions.relationshipTypes);
+        completedVertices = 0;
+        totalVertices = 0;
+        for (auto type : selectedAlgorithms()) {
+            std::string name = LinkPredictorFactory::getAlgorithmName(type);
+            std::vector<LinkSuggestion> raw;
+            if (suggestionCache.find(*model, cacheName(name), 10, 0.0, raw)) {
+                jobResults[name] = raw;
+            } else {
+                startJob(snapshot, type);
+            }
         }
         
-        emit suggestionsGenerated(suggestions.size());
+        if (activeJobs.isEmpty()) {
+            finishGeneration();
+            return;
+        }
+        setGenerating(true);
+        updateGenerationProgress();
     } catch (const std::exception& e) {
         QMessageBox::warning(this, "Error", 
             QString("Error generating suggestions: %1").arg(e.what()));
-        // Reset UI state
-        if (progressBar) {
-            progressBar->setVisible(false);
-        }
-        if (generateButton) {
-            generateButton->setEnabled(true);
-            generateButton->setText("Generate Suggestions");
-        }
+        // The run ends without results, so listeners reset as for a cancel
+        stopJobs();
+        emit generationCancelled();
     }
 }
 
+void SuggestionPanel::cancelGeneration() {
+    if (activeJobs.isEmpty()) return;
+    
+    // Keep the best suggestions found so far on screen
+    stopJobs();
+    emit generationCancelled();
+}
 
+void SuggestionPanel::stopJobs() {
+    if (activeJobs.isEmpty()) return;
+    
+    for (auto job : activeJobs) {
+        disconnect(job, nullptr, this, nullptr);
+        job->cancel();
+        job->deleteLater(); // Workers keep their own reference to the shared state
+    }
+    activeJobs.clear();
+    setGenerating(false);
+}
 
-void SuggestionPanel::generateRealSuggestions(const QString& algorithm, double minConfidence) {
-    if (!model) return;
+void SuggestionPanel::startJob(const std::shared_ptr<const GraphSnapshot>& snapshot,
+                               LinkPredictorFactory::AlgorithmType type) {
+    auto job = new SuggestionJob(snapshot, type, 10, activeOptions, this);
+    
+    connect(job, &SuggestionJob::progressChanged, this, &SuggestionPanel::updateGenerationProgress);
+    connect(job, &SuggestionJob::partialResults, this,
+            [this, job](const std::vector<LinkSuggestion>& partial) {
+                jobResults[job->getAlgorithmName()] = partial;
+                showResults();
+            });
+    connect(job, &SuggestionJob::finished, this,
+            [this, job](const std::vector<LinkSuggestion>& results) {
+                onJobFinished(job, results);
+            });
+    
+    totalVertices += job->getTotalVertices();
+    activeJobs.append(job);
+    job->start();
+}
+
+void SuggestionPanel::onJobFinished(SuggestionJob* job, const std::vector<LinkSuggestion>& results) {
+    std::string name = job->getAlgorithmName();
+    jobResults[name] = results;
+    
+    // Only cache if the model didn't move on while we were computing
+    if (model && model->getVersion() == job->getModelVersion()) {
+        bool local = LinkPredictorFactory::isNeighborhoodLocal(job->getAlgorithm());
+        suggestionCache.store(*model, cacheName(name), 10, 0.0, results, local);
+    }
     
-    try {
-        std::unique_ptr<ILinkPredictor> predictor;
-        
-        // Create the appropriate predictor based on algorithm selection
-        if (algorithm == "common_neighbors") {
-            predictor = std::make_unique<CommonNeighborPredictor>(this);
-        } else if (algorithm == "jaccard") {
-            predictor = std::make_unique<JaccardCoefficientPredictor>(this);
-        } else if (algorithm == "preferential") {
-            predictor = std::make_unique<PreferentialAttachmentPredictor>(this);
-        } else {
-            // Default to common neighbors
-            predictor = std::make_unique<CommonNeighborPredictor>(this);
-        }
-        
-        // Generate suggestions using the selected predictor
-        auto predictedLinks = predictor->predictLinks(*model, 10);
-        
-        // Filter by confidence threshold and add to UI
-        for (const auto& suggestion : predictedLinks) {
-            if (suggestion.confidence >= minConfidence) {
-                addSuggestion(suggestion);
-            }
-        }
-        
-    } catch (const std::exception& e) {
-        qDebug() << "Error in generateRealSuggestions:" << e.what();
+    completedVertices += job->getTotalVertices();
+    activeJobs.removeOne(job);
+    job->deleteLater();
+    
+    if (activeJobs.isEmpty()) {
+        finishGeneration();
+    } else {
+        showResults();
+        updateGenerationProgress();
     }
 }
 
-void SuggestionPanel::generateCombinedSuggestions(double minConfidence) {
-    if (!model) return;
+void SuggestionPanel::updateGenerationProgress() {
+    int processed = completedVertices;
+    for (auto job : activeJobs) {
+        processed += job->getProcessedVertices();
+    }
     
-    try {
-        // Create all predictors
-        auto commonNeighbor = std::make_unique<CommonNeighborPredictor>(this);
-        auto jaccard = std::make_unique<JaccardCoefficientPredictor>(this);
-        auto preferential = std::make_unique<PreferentialAttachmentPredictor>(this);
-        
-        // Get suggestions from each algorithm
-        auto cnSuggestions = commonNeighbor->predictLinks(*model, 10);
-        auto jcSuggestions = jaccard->predictLinks(*model, 10);
-        auto paSuggestions = preferential->predictLinks(*model, 10);
-        
-        // Combine and deduplicate suggestions
-        std::map<std::pair<std::string, std::string>, std::vector<LinkSuggestion>> combinedMap;
-        
-        for (const auto& suggestion : cnSuggestions) {
-            auto key = std::make_pair(suggestion.sourceConceptId, suggestion.targetConceptId);
-            combinedMap[key].push_back(suggestion);
+    if (progressBar) {
+        progressBar->setRange(0, std::max(1, totalVertices));
+        progressBar->setValue(processed);
+    }
+    emit generationProgress(processed, totalVertices);
+}
+
+std::vector<LinkSuggestion> SuggestionPanel::currentResults() const {
+    std::vector<LinkSuggestion> results;
+    
+    if (activeAlgorithm != "all") {
+        // Filter by confidence threshold
+        for (const auto& pair : jobResults) {
+            for (const auto& suggestion : pair.second) {
+                if (suggestion.confidence >= activeMinConfidence) {
+                    results.push_back(suggestion);
+                }
+            }
         }
-        
-        for (const auto& suggestion : jcSuggestions) {
+        return results;
+    }
+    
+    // Combine and deduplicate suggestions
+    std::map<std::pair<std::string, std::string>, std::vector<LinkSuggestion>> combinedMap;
+    for (const auto& pair : jobResults) {
+        for (const auto& suggestion : pair.second) {
             auto key = std::make_pair(suggestion.sourceConceptId, suggestion.targetConceptId);
             combinedMap[key].push_back(suggestion);
         }
+    }
+    
+    // Create combined suggestions with averaged confidence
+    for (const auto& pair : combinedMap) {
+        const auto& suggestions = pair.second;
+        if (suggestions.empty()) continue;
         
-        for (const auto& suggestion : paSuggestions) {
-            auto key = std::make_pair(suggestion.sourceConceptId, suggestion.targetConceptId);
-            combinedMap[key].push_back(suggestion);
-        }
+        double avgConfidence = 0.0;
+        std::string combinedExplanation = "Combined prediction from multiple algorithms:\n";
         
-        // Create combined suggestions with averaged confidence
-        for (const auto& pair : combinedMap) {
-            const auto& suggestions = pair.second;
-            if (suggestions.empty()) continue;
-            
-            double avgConfidence = 0.0;
-            std::string combinedExplanation = "Combined prediction from multiple algorithms:\n";
-            
-            for (const auto& suggestion : suggestions) {
-                avgConfidence += suggestion.confidence;
-                combinedExplanation += "- " + suggestion.explanation + "\n";
-            }
-            
-            avgConfidence /= suggestions.size();
-            
-            if (avgConfidence >= minConfidence) {
-                LinkSuggestion combined(
-                    suggestions[0].sourceConceptId,
-                    suggestions[0].targetConceptId,
-                    "predicted_relationship",
-                    avgConfidence,
-                    combinedExplanation,
-                    "Combined Algorithms"  // Algorithm name for combined suggestions
-                );
-                
-                addSuggestion(combined);
-            }
+        for (const auto& suggestion : suggestions) {
+            avgConfidence += suggestion.confidence;
+            combinedExplanation += "- " + suggestion.explanation + "\n";
         }
         
-    } catch (const std::exception& e) {
-        qDebug() << "Error in generateCombinedSuggestions:" << e.what();
+        avgConfidence /= suggestions.size();
+        
+        if (avgConfidence >= activeMinConfidence) {
+            results.emplace_back(
+                suggestions[0].sourceConceptId,
+                suggestions[0].targetConceptId,
+                "predicted_relationship",
+                avgConfidence,
+                combinedExplanation,
+                "Combined Algorithms"  // Algorithm name for combined suggestions
+            );
+        }
+    }
+    return results;
+}
+
+std::vector<LinkPredictorFactory::AlgorithmType> SuggestionPanel::selectedAlgorithms() const {
+    if (activeAlgorithm == "all") {
+        return LinkPredictorFactory::getAvailableAlgorithms();
+    }
+    for (const auto& entry : ALGORITHM_KEYS) {
+        if (entry.first == activeAlgorithm) {
+            return {entry.second};
+        }
+    }
+    // Default to common neighbors
+    return {LinkPredictorFactory::AlgorithmType::COMMON_NEIGHBORS};
+}
+
+std::string SuggestionPanel::resultCacheName() const {
+    if (activeAlgorithm == "all") return cacheName("Combined Algorithms");
+    return cacheName(LinkPredictorFactory::getAlgorithmName(selectedAlgorithms().front()));
+}
+
+std::string SuggestionPanel::cacheName(const std::string& algorithmName) const {
+    // Results for different graph options must not share cache entries
+    std::string name = algorithmName;
+    if (activeOptions.weighted) name += " [weighted]";
+    if (activeOptions.directed) name += " [directed]";
+    for (const auto& type : activeOptions.relationshipTypes) {
+        name += " [type:" + type + "]";
+    }
+    return name;
+}
+
+void SuggestionPanel::showResults() {
+    // Only the top few suggestions are shown, so rebuilding is cheap
+    suggestionsTree->setUpdatesEnabled(false);
+    suggestionsTree->setSortingEnabled(false);
+    suggestions.clear();
+    suggestionsTree->clear();
+    for (const auto& suggestion : currentResults()) {
+        addSuggestion(suggestion);
+    }
+    suggestionsTree->setSortingEnabled(true);
+    filterSuggestions();
+    suggestionsTree->setUpdatesEnabled(true);
+    
+    acceptButton->setEnabled(false);
+    rejectButton->setEnabled(false);
+}
+
+void SuggestionPanel::finishGeneration() {
+    showResults();
+    
+    if (model && model->getVersion() == activeModelVersion) {
+        std::vector<LinkSuggestion> displayed(suggestions.begin(), suggestions.end());
+        bool local = true;
+        for (auto type : selectedAlgorithms()) {
+            local = local && LinkPredictorFactory::isNeighborhoodLocal(type);
+        }
+        suggestionCache.store(*model, resultCacheName(), 10, activeMinConfidence, displayed, local);
+    }
+    
+    setGenerating(false);
+    emit suggestionsGenerated(suggestions.size());
+}
+
+void SuggestionPanel::setGenerating(bool generating) {
+    if (progressBar) {
+        progressBar->setVisible(generating);
+        if (generating) {
+            progressBar->setRange(0, std::max(1, totalVertices));
+            progressBar->setValue(0);
+        }
+    }
+    if (generateButton) {
+        generateButton->setEnabled(!generating);
+        generateButton->setText(generating ? "Generating..." : "Generate Suggestions");
+    }
+    if (cancelButton) {
+        cancelButton->setVisible(generating);
     }
 }
 
@@ -383,6 +573,7 @@ void SuggestionPanel::acceptSuggestion() {
     
     // Update UI
     updateSuggestionCount();
+    prefetchExplanations();
     acceptButton->setEnabled(false);
     rejectButton->setEnabled(false);
     
@@ -404,6 +595,7 @@ void SuggestionPanel::rejectSuggestion() {
     
     // Update UI
     updateSuggestionCount();
+    prefetchExplanations();
     acceptButton->setEnabled(false);
     rejectButton->setEnabled(false);
     
@@ -426,9 +618,11 @@ void SuggestionPanel::onSelectionChanged() {
     // Get concept names for details display
     std::string sourceName = suggestion.sourceConceptId;
     std::string targetName = suggestion.targetConceptId;
+    const Concept* sourceConcept = nullptr;
+    const Concept* targetConcept = nullptr;
     if (model) {
-        auto sourceConcept = model->getConcept(suggestion.sourceConceptId);
-        auto targetConcept = model->getConcept(suggestion.targetConceptId);
+        sourceConcept = model->getConcept(suggestion.sourceConceptId);
+        targetConcept = model->getConcept(suggestion.targetConceptId);
         if (sourceConcept) sourceName = sourceConcept->getName();
         if (targetConcept) targetName = targetConcept->getName();
     }
@@ -456,7 +650,23 @@ void SuggestionPanel::onSelectionChanged() {
     detailsDialog.setText(details);
     detailsDialog.setIcon(QMessageBox::Information);
     detailsDialog.setStandardButtons(QMessageBox::Ok);
+    
+    // Usually prefetched already, in which case the callback runs right here;
+    // otherwise the graph's own explanation shows until the AI answers
+    AIAssistant::RequestId explanationRequest = 0;
+    if (aiAssistant && sourceConcept && targetConcept) {
+        QString aiSection = "<h4 style='margin-top:15px;'>AI Explanation:</h4><p style='margin-left:10px;'>%1</p>";
+        QString local = QString::fromStdString(aiAssistant->explainConnectionLocally(*sourceConcept, *targetConcept));
+        detailsDialog.setText(details + aiSection.arg(local.toHtmlEscaped()));
+        explanationRequest = aiAssistant->explainConnectionAsync(*sourceConcept, *targetConcept,
+            [&detailsDialog, details, aiSection](const std::string& explanation) {
+                detailsDialog.setText(details + aiSection.arg(QString::fromStdString(explanation).toHtmlEscaped()));
+            });
+    }
     detailsDialog.exec();
+    if (explanationRequest != 0) {
+        aiAssistant->cancelRequest(explanationRequest);
+    }
     acceptButton->setEnabled(true);
     rejectButton->setEnabled(true);
 }
@@ -472,6 +682,7 @@ void SuggestionPanel::filterSuggestions() {
                       item->text(2).toLower().contains(filterText);
         item->setHidden(!visible);
     }
+    prefetchExplanations();
 }
 
 void SuggestionPanel::sortSuggestions() {
@@ -484,6 +695,28 @@ void SuggestionPanel::sortSuggestions() {
     else if (sortBy == "algorithm") column = 2;
     
     suggestionsTree->sortItems(column, Qt::DescendingOrder);
+    prefetchExplanations();
+}
+
+void SuggestionPanel::prefetchExplanations() {
+    if (!model || !aiAssistant) return;
+    
+    // In display order, so the rows the user sees first are fetched first
+    std::vector<AIAssistant::ConceptPair> pairs;
+    for (int i = 0; i < suggestionsTree->topLevelItemCount() && static_cast<int>(pairs.size()) < PREFETCH_COUNT; ++i) {
+        auto item = suggestionsTree->topLevelItem(i);
+        if (item->isHidden()) continue;
+        
+        int index = item->data(0, Qt::UserRole).toInt();
+        if (index < 0 || index >= suggestions.size()) continue;
+        
+        const Concept* source = model->getConcept(suggestions[index].sourceConceptId);
+        const Concept* target = model->getConcept(suggestions[index].targetConceptId);
+        if (source && target) {
+            pairs.emplace_back(source, target);
+        }
+    }
+    prefetcher.prefetch(pairs);
 }
 
 void SuggestionPanel::updateSuggestionCount() {
@@ -2,12 +2,18 @@
 
 #include <QWidget>
 #include <QList>
+#include <map>
+#include <memory>
 #include "../core/model/MentalModel.h"
 #include "../core/common/DataStructures.h"
+#include "../core/ai/SuggestionCache.h"
+#include "../core/ai/ILinkPredictor.h"
+#include "../core/ai/ExplanationPrefetcher.h"
 
 class QVBoxLayout;
 class QHBoxLayout;
 class QComboBox;
+class QCheckBox;
 class QLineEdit;
 class QPushButton;
 class QProgressBar;
@@ -17,6 +23,9 @@ class QTextEdit;
 
 namespace qlink {
 
+class GraphSnapshot;
+class SuggestionJob;
+
 /**
  * Panel for displaying and managing AI generated link suggestions
  */
@@ -28,16 +37,25 @@ public:
     ~SuggestionPanel();
 
     void setModel(MentalModel* model);
+    
+    /**
+     * Assistant that explains suggestions; not owned, null disables explanations
+     */
+    void setAIAssistant(AIAssistant* assistant);
+    
     void addSuggestion(const LinkSuggestion& suggestion);
     void clearSuggestions();
 
 signals:
     void suggestionsGenerated(int count);
+    void generationProgress(int processedVertices, int totalVertices);
+    void generationCancelled();
     void suggestionAccepted(const LinkSuggestion& suggestion);
     void suggestionRejected(const LinkSuggestion& suggestion);
 
 public slots:
     void generateSuggestions();
+    void cancelGeneration();
 
 private slots:
     void acceptSuggestion();
@@ -52,18 +70,49 @@ private:
     void setupSuggestionsSection(QVBoxLayout* mainLayout);
     void setupActionButtons(QVBoxLayout* mainLayout);
     void setupConnections();
-    void generateRealSuggestions(const QString& algorithm, double minConfidence);
-    void generateCombinedSuggestions(double minConfidence);
+    void startJob(const std::shared_ptr<const GraphSnapshot>& snapshot,
+                  LinkPredictorFactory::AlgorithmType type);
+    void onJobFinished(SuggestionJob* job, const std::vector<LinkSuggestion>& results);
+    void stopJobs(); // Unlike cancelGeneration(), for restarts: emits nothing
+    void updateGenerationProgress();
+    void showResults();
+    void finishGeneration();
+    void setGenerating(bool generating);
+    std::vector<LinkSuggestion> currentResults() const;
+    std::vector<LinkPredictorFactory::AlgorithmType> selectedAlgorithms() const;
+    std::string resultCacheName() const;
+    std::string cacheName(const std::string& algorithmName) const;
     void updateSuggestionCount();
+    void prefetchExplanations();
 
     // Core components
     MentalModel* model;
     QList<LinkSuggestion> suggestions;
+    SuggestionCache suggestionCache;
+    
+    // The top visible suggestions get their explanations fetched ahead of a click
+    AIAssistant* aiAssistant;
+    ExplanationPrefetcher prefetcher;
+    static constexpr int PREFETCH_COUNT = 3;
+    
+    // Background generation state
+    QList<SuggestionJob*> activeJobs;
+    std::map<std::string, std::vector<LinkSuggestion>> jobResults; // Algorithm name -> best so far
+    QString activeAlgorithm;
+    double activeMinConfidence;
+    LinkPredictionOptions activeOptions;
+    uint64_t activeModelVersion;
+    int completedVertices;
+    int totalVertices;
 
     // UI components
     QComboBox* algorithmCombo;
     QLineEdit* confidenceThreshold;
+    QCheckBox* weightedCheck;
+    QCheckBox* directedCheck;
+    QLineEdit* relationshipTypesEdit;
     QPushButton* generateButton;
+    QPushButton* cancelButton;
     QProgressBar* progressBar;
     
     QLineEdit* filterEdit;